@@ -18,6 +18,7 @@
 #include <usml/beampatterns/beampattern_utilities.h>
 #include <usml/beampatterns/bp_arb.h>
 #include <usml/beampatterns/bp_cardioid.h>
+#include <usml/beampatterns/bp_directivity.h>
 #include <usml/beampatterns/bp_gaussian.h>
 #include <usml/beampatterns/bp_grid.h>
 #include <usml/beampatterns/bp_line.h>
@@ -27,4 +28,5 @@
 #include <usml/beampatterns/bp_piston.h>
 #include <usml/beampatterns/bp_planar.h>
 #include <usml/beampatterns/bp_solid.h>
+#include <usml/beampatterns/bp_table.h>
 #include <usml/beampatterns/bp_trig.h>
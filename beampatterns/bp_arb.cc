@@ -4,13 +4,20 @@
  */
 
 #include <usml/beampatterns/bp_arb.h>
+#include <usml/ublas/matrix_prod.h>
 
+#include <algorithm>
 #include <boost/numeric/ublas/vector_expression.hpp>
 #include <cmath>
+#include <cstddef>
+#include <vector>
 #include <ext/type_traits.h>
 
 using namespace usml::beampatterns;
 
+/// Number of arrivals in each block of the batched calculations.
+std::size_t bp_arb::block_size = 256;
+
 /**
  * Computes the beam level gain for an arrival vector in the body coordinates
  * of the array,
@@ -54,3 +61,96 @@ void bp_arb::beam_level(const bvector& arrival,
         (*level)(f) = std::norm(acc) * scale;
     }
 }
+
+/**
+ * Computes the beam level gain for a batch of arrival vectors,
+ * one frequency at a time.
+ */
+void bp_arb::beam_levels(const vector<double>& front,
+                         const vector<double>& right,
+                         const vector<double>& up,
+                         const seq_vector::csptr& frequencies,
+                         matrix<double>* level, const bvector& steering,
+                         double sound_speed) const {
+    level->resize(front.size(), frequencies->size(), false);
+    const std::vector<bvector> steerings(1, steering);
+    for (std::size_t f = 0; f < frequencies->size(); ++f) {
+        const double wavenumber = 2.0 * M_PI * (*frequencies)(f) / sound_speed;
+        array_power(front, right, up, wavenumber, steerings, level, f);
+    }
+}
+
+/**
+ * Computes the beam level gain for a batch of arrival vectors and a list
+ * of steering vectors at a single frequency.
+ */
+void bp_arb::steered_levels(const vector<double>& front,
+                            const vector<double>& right,
+                            const vector<double>& up, double frequency,
+                            const std::vector<bvector>& steerings,
+                            matrix<double>* level, double sound_speed) const {
+    level->resize(front.size(), steerings.size(), false);
+    const double wavenumber = 2.0 * M_PI * frequency / sound_speed;
+    array_power(front, right, up, wavenumber, steerings, level, 0);
+}
+
+/**
+ * Computes the normalized power of the array response for a batch of
+ * arrivals at a single frequency.
+ */
+void bp_arb::array_power(const vector<double>& front,
+                         const vector<double>& right, const vector<double>& up,
+                         double wavenumber,
+                         const std::vector<bvector>& steerings,
+                         matrix<double>* level, std::size_t column) const {
+    const std::size_t num_elem = _elem_locs.size1();
+    const std::size_t num_beams = steerings.size();
+
+    // normalize power to peak of one
+
+    double scale = abs(sum(_weights));
+    scale = 1.0 / (scale * scale);
+
+    // steered weight of each element, for each steering vector
+
+    matrix<complex<double> > weights(num_elem, num_beams);
+    for (std::size_t e = 0; e < num_elem; ++e) {
+        for (std::size_t s = 0; s < num_beams; ++s) {
+            const double dot = steerings[s].front() * _elem_locs(e, 0) +
+                               steerings[s].right() * _elem_locs(e, 1) +
+                               steerings[s].up() * _elem_locs(e, 2);
+            weights(e, s) = _weights(e) * std::polar(1.0, wavenumber * dot);
+        }
+    }
+
+    // phase of each element, for each arrival in the block,
+    // arrivals in the backplane are zero when baffle is on
+
+    matrix<complex<double> > phase;
+    matrix<complex<double> > response;
+    for (std::size_t n0 = 0; n0 < front.size(); n0 += block_size) {
+        const std::size_t n1 = std::min(n0 + block_size, front.size());
+        phase.resize(n1 - n0, num_elem, false);
+        for (std::size_t n = n0; n < n1; ++n) {
+            const bool baffled = _back_baffle && front(n) <= 0.0;
+            for (std::size_t e = 0; e < num_elem; ++e) {
+                const double dot = front(n) * _elem_locs(e, 0) +
+                                   right(n) * _elem_locs(e, 1) +
+                                   up(n) * _elem_locs(e, 2);
+                phase(n - n0, e) = baffled
+                                       ? complex<double>(0.0)
+                                       : std::polar(1.0, -wavenumber * dot);
+            }
+        }
+
+        // sum over elements as a matrix product
+
+        blocked_prod(phase, weights, &response);
+        for (std::size_t n = n0; n < n1; ++n) {
+            for (std::size_t s = 0; s < num_beams; ++s) {
+                const complex<double>& value = response(n - n0, s);
+                (*level)(n, column + s) = std::norm(value) * scale;
+            }
+        }
+    }
+}
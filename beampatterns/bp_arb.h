@@ -12,6 +12,8 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <complex>
+#include <cstddef>
+#include <vector>
 
 namespace usml {
 namespace beampatterns {
@@ -44,9 +46,27 @@ namespace beampatterns {
  * beam_level(). It is perfectly accurate, but can be slow if the number of
  * elements is large. The bp_k_grid class models arbitrary arrays faster, but it
  * is less accurate.
+ *
+ * The beam_levels() and steered_levels() methods evaluate the summation for
+ * a batch of arrivals as a complex matrix product. Like beam_level(), they
+ * use the conjugate of the phase above, which does not change the power.
+ * The steering term is separated from the arrival term, such that
+ * \f[
+ *      \sum_{n=1}^N w_n \exp \left[ -i k \Delta \vec{u} \cdot \vec{r}_n
+ *      \right] = \sum_{n=1}^N A_{m,n} W_{n,s}
+ * \f]
+ * where \f$ A_{m,n} = \exp(-i k \vec{u}_m \cdot \vec{r}_n) \f$ is the
+ * phase of element n for arrival m, and \f$ W_{n,s} = w_n \exp(i k
+ * \vec{u}_s \cdot \vec{r}_n) \f$ is the steered weight of element n for
+ * steering s. The product is computed by blocked_prod() for blocks of
+ * block_size arrivals, which limits the size of the arrival phase matrix
+ * for arrays with hundreds of elements.
  */
 class USML_DECLSPEC bp_arb : public bp_model {
    public:
+    /// Number of arrivals in each block of the batched calculations.
+    static std::size_t block_size;
+
     /**
      * Constructs a beam pattern based on arbitrary 3D element locations
      * with complex weights and a uniform element pattern.
@@ -104,7 +124,52 @@ class USML_DECLSPEC bp_arb : public bp_model {
                     const bvector &steering = bvector(1.0, 0.0, 0.0),
                     double sound_speed = 1500.0) const override;
 
+    void beam_levels(const vector<double> &front, const vector<double> &right,
+                     const vector<double> &up,
+                     const seq_vector::csptr &frequencies,
+                     matrix<double> *level,
+                     const bvector &steering = bvector(1.0, 0.0, 0.0),
+                     double sound_speed = 1500.0) const override;
+
+    /**
+     * Computes the beam level gain for a batch of arrival vectors and a list
+     * of steering vectors at a single frequency. Steering vectors form the
+     * columns of the right hand matrix in the product, so forming a
+     * large set of beams costs little more than forming a single beam.
+     *
+     * @param front         Front component of each arrival vector.
+     * @param right         Right component of each arrival vector.
+     * @param up            Up component of each arrival vector.
+     * @param frequency     Frequency to compute beam level for (Hz).
+     * @param steerings     List of steering vectors relative to body.
+     * @param level         Beam level output for each arrival (row) and
+     *                      steering (column) in linear units.
+     * @param sound_speed   Speed of sound in water (m/s).
+     */
+    void steered_levels(const vector<double> &front,
+                        const vector<double> &right, const vector<double> &up,
+                        double frequency, const std::vector<bvector> &steerings,
+                        matrix<double> *level,
+                        double sound_speed = 1500.0) const;
+
    private:
+    /**
+     * Computes the normalized power of the array response for a batch of
+     * arrivals at a single frequency, using blocked_prod().
+     *
+     * @param front         Front component of each arrival vector.
+     * @param right         Right component of each arrival vector.
+     * @param up            Up component of each arrival vector.
+     * @param wavenumber    Wave number of the incoming plane wave (1/m).
+     * @param steerings     List of steering vectors relative to body.
+     * @param level         Beam level output (linear units).
+     * @param column        Column of level that stores the first steering.
+     */
+    void array_power(const vector<double> &front, const vector<double> &right,
+                     const vector<double> &up, double wavenumber,
+                     const std::vector<bvector> &steerings,
+                     matrix<double> *level, std::size_t column) const;
+
     /// The number elements in the array.
     const double _N_elements;
 
@@ -5,7 +5,9 @@
 
 #include <usml/beampatterns/bp_cardioid.h>
 
+#include <algorithm>
 #include <boost/numeric/ublas/detail/definitions.hpp>
+#include <cstddef>
 
 using namespace usml::beampatterns;
 
@@ -30,3 +32,21 @@ void bp_cardioid::directivity(const seq_vector::csptr& frequencies,
                               double /*sound_speed*/) const {
     noalias(*level) = scalar_vector<double>(frequencies->size(), _directivity);
 }
+
+/**
+ * Computes the beam level gain for a batch of arrival vectors.
+ */
+void bp_cardioid::beam_levels(const vector<double>& front,
+                             const vector<double>& /*right*/,
+                             const vector<double>& /*up*/,
+                             const seq_vector::csptr& frequencies,
+                             matrix<double>* level, const bvector& /*steering*/,
+                             double /*sound_speed*/) const {
+    const std::size_t num_freq = frequencies->size();
+    level->resize(front.size(), num_freq, false);
+    double* row = level->data().begin();
+    for (std::size_t n = 0; n < front.size(); ++n, row += num_freq) {
+        const double P = (1.0 + _factor * front(n)) / (1.0 + _factor);
+        std::fill_n(row, num_freq, P * P);
+    }
+}
@@ -0,0 +1,118 @@
+/**
+ * @file bp_directivity.cc
+ * Thread-safe cache of directivity gains for beam patterns.
+ */
+
+#include <usml/beampatterns/bp_directivity.h>
+#include <usml/types/seq_data.h>
+
+#include <boost/numeric/ublas/vector.hpp>
+#include <vector>
+
+using namespace usml::beampatterns;
+
+/// Maximum number of entries kept, least recently used are discarded.
+std::size_t bp_directivity::max_cache_size = 4096;
+
+/// Cache of directivity gains used by find().
+std::map<bp_directivity::key_type, bp_directivity::cache_entry>
+    bp_directivity::_cache;
+
+/// Counter used to find the least recently used entry.
+std::atomic<std::uint64_t> bp_directivity::_cache_clock(0);
+
+/// Mutex to lock access to the cache.
+read_write_lock bp_directivity::_cache_mutex;
+
+/// Number of frequencies found in the cache.
+std::atomic<std::size_t> bp_directivity::_hits(0);
+
+/// Number of frequencies computed.
+std::atomic<std::size_t> bp_directivity::_misses(0);
+
+/**
+ * Finds the directivity gain in the cache, or computes it for the
+ * frequencies that are not there yet.
+ */
+void bp_directivity::find(const bp_model::csptr& pattern,
+                          const seq_vector::csptr& frequencies,
+                          vector<double>* level, const bvector& steering,
+                          double sound_speed) {
+    // copy cached values into result, and list the missing frequencies
+
+    std::vector<std::size_t> missing;
+    {
+        read_lock_guard guard(_cache_mutex);
+        for (std::size_t f = 0; f < frequencies->size(); ++f) {
+            const key_type key(pattern.get(), (*frequencies)(f),
+                               steering.front(), steering.right(),
+                               steering.up(), sound_speed);
+            auto iter = _cache.find(key);
+            if (iter == _cache.end()) {
+                missing.push_back(f);
+            } else {
+                (*level)(f) = iter->second.level;
+                iter->second.last_used = ++_cache_clock;
+            }
+        }
+    }
+    _hits += frequencies->size() - missing.size();
+    if (missing.empty()) {
+        return;
+    }
+    _misses += missing.size();
+
+    // compute missing values without holding the lock,
+    // because this can be slow
+
+    vector<double> freq(missing.size());
+    for (std::size_t n = 0; n < missing.size(); ++n) {
+        freq(n) = (*frequencies)(missing[n]);
+    }
+    const seq_vector::csptr missing_freq(new seq_data(freq));
+    vector<double> values(missing.size(), 0.0);
+    pattern->directivity(missing_freq, &values, steering, sound_speed);
+
+    // add new values to result and cache
+
+    write_lock_guard guard(_cache_mutex);
+    for (std::size_t n = 0; n < missing.size(); ++n) {
+        (*level)(missing[n]) = values(n);
+        const key_type key(pattern.get(), freq(n), steering.front(),
+                           steering.right(), steering.up(), sound_speed);
+        if (_cache.count(key) == 0) {
+            while (!_cache.empty() && _cache.size() >= max_cache_size) {
+                auto oldest = _cache.begin();
+                for (auto iter = _cache.begin(); iter != _cache.end();
+                     ++iter) {
+                    if (iter->second.last_used < oldest->second.last_used) {
+                        oldest = iter;
+                    }
+                }
+                _cache.erase(oldest);
+            }
+        }
+        cache_entry& entry = _cache[key];
+        entry.pattern = pattern;
+        entry.level = values(n);
+        entry.last_used = ++_cache_clock;
+    }
+}
+
+/**
+ * Number of pattern and frequency combinations in the cache.
+ */
+std::size_t bp_directivity::cache_size() {
+    read_lock_guard guard(_cache_mutex);
+    return _cache.size();
+}
+
+/**
+ * Removes all entries from the cache, and resets hits and misses.
+ */
+void bp_directivity::clear_cache() {
+    write_lock_guard guard(_cache_mutex);
+    _cache.clear();
+    _hits = 0;
+    _misses = 0;
+}
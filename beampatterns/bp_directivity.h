@@ -0,0 +1,119 @@
+/**
+ * @file bp_directivity.h
+ * Thread-safe cache of directivity gains for beam patterns.
+ */
+#pragma once
+
+#include <usml/beampatterns/bp_model.h>
+#include <usml/threads/read_write_lock.h>
+#include <usml/types/bvector.h>
+#include <usml/types/seq_vector.h>
+#include <usml/usml_config.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <tuple>
+
+namespace usml {
+namespace beampatterns {
+
+using namespace usml::threads;
+using namespace usml::types;
+
+/// @ingroup beampatterns
+/// @{
+
+/**
+ * Thread-safe cache of directivity gains for beam patterns. The directivity
+ * gain of patterns like bp_model and bp_arb is computed by numerical
+ * integration over all solid angles, which is too slow to repeat every time
+ * a sensor needs its noise gain. Because beam patterns are immutable, the
+ * directivity gain for a specific pattern, frequency, steering, and sound
+ * speed never changes. This class memoizes the results of
+ * bp_model::directivity() for each of these keys.
+ *
+ * Each frequency is cached separately, so that lists of frequencies which
+ * only partially overlap can reuse previous results. Only the frequencies
+ * missing from the cache are passed to bp_model::directivity(), in a single
+ * call, outside of the cache lock.
+ *
+ * Each cache entry holds a reference to its pattern, so that its address
+ * can not be reused by another pattern while it is in the cache.
+ * The least recently used entries are discarded when the cache grows past
+ * max_cache_size entries.
+ */
+class USML_DECLSPEC bp_directivity {
+   public:
+    /// Maximum number of entries kept, least recently used are discarded.
+    static std::size_t max_cache_size;
+
+    /**
+     * Finds the directivity gain in the cache, or computes it for the
+     * frequencies that are not there yet.
+     *
+     * @param pattern       Beam pattern to compute directivity for.
+     * @param frequencies   List of frequencies.
+     * @param level         Directivity gain for these frequency (output).
+     * @param steering      Steering vector relative to body.
+     * @param sound_speed   Speed of sound in water (m/s).
+     */
+    static void find(const bp_model::csptr& pattern,
+                     const seq_vector::csptr& frequencies,
+                     vector<double>* level,
+                     const bvector& steering = bvector(1.0, 0.0, 0.0),
+                     double sound_speed = 1500.0);
+
+    /// Number of pattern and frequency combinations in the cache.
+    static std::size_t cache_size();
+
+    /// Number of frequencies found in the cache since last clear_cache().
+    static std::size_t hits() { return _hits; }
+
+    /// Number of frequencies computed since last clear_cache().
+    static std::size_t misses() { return _misses; }
+
+    /// Removes all entries from the cache, and resets hits and misses.
+    static void clear_cache();
+
+   private:
+    /// Hide default constructor, all members are static.
+    bp_directivity() {}
+
+    /// Cache key: pattern, frequency, steering, sound speed.
+    typedef std::tuple<const bp_model*, double, double, double, double,
+                       double>
+        key_type;
+
+    /// Directivity gain for a single key.
+    struct cache_entry {
+        /// Beam pattern for this key.
+        bp_model::csptr pattern;
+
+        /// Directivity gain for this key.
+        double level{0.0};
+
+        /// Value of _cache_clock when this entry was last used.
+        mutable std::atomic<std::uint64_t> last_used{0};
+    };
+
+    /// Cache of directivity gains used by find().
+    static std::map<key_type, cache_entry> _cache;
+
+    /// Counter used to find the least recently used entry.
+    static std::atomic<std::uint64_t> _cache_clock;
+
+    /// Mutex to lock access to the cache.
+    static read_write_lock _cache_mutex;
+
+    /// Number of frequencies found in the cache.
+    static std::atomic<std::size_t> _hits;
+
+    /// Number of frequencies computed.
+    static std::atomic<std::size_t> _misses;
+};
+
+/// @}
+}  // namespace beampatterns
+}  // namespace usml
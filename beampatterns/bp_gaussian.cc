@@ -12,6 +12,7 @@
 #include <boost/numeric/ublas/detail/definitions.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <cmath>
+#include <cstddef>
 
 using namespace usml::beampatterns;
 
@@ -41,3 +42,33 @@ void bp_gaussian::beam_level(const bvector& arrival,
     const double value = exp(-0.5 * (de * de + az * az));
     noalias(*level) = scalar_vector<double>(frequencies->size(), value);
 }
+
+/**
+ * Computes the beam level gain for a batch of arrival vectors.
+ */
+void bp_gaussian::beam_levels(const vector<double>& front,
+                             const vector<double>& right,
+                             const vector<double>& up,
+                             const seq_vector::csptr& frequencies,
+                             matrix<double>* level, const bvector& steering,
+                             double /*sound_speed*/) const {
+    const std::size_t num_freq = frequencies->size();
+    level->resize(front.size(), num_freq, false);
+    const double steer_de = asin(steering.up());
+    const double steer_az = atan2(steering.front(), steering.right());
+    double* row = level->data().begin();
+    for (std::size_t n = 0; n < front.size(); ++n, row += num_freq) {
+        double de = 0.0;
+        if (_vert_half < 90.0) {
+            de = abs(to_degrees(asin(up(n)) - steer_de));
+            de /= (_vert_half * 2.0);
+        }
+        double az = 0.0;
+        if (_horz_half < 180.0) {
+            az = to_degrees(atan2(front(n), right(n)) - steer_az);
+            az = abs(fmod(az + 180.0, 360.0) - 180);
+            az /= (_horz_half * 2.0);
+        }
+        std::fill_n(row, num_freq, exp(-0.5 * (de * de + az * az)));
+    }
+}
@@ -3,6 +3,10 @@
  * Vertical and horizontal line arrays in closed form.
  */
 #include <usml/beampatterns/bp_line.h>
+#include <usml/beampatterns/bp_line_level.h>
+
+#include <cmath>
+#include <cstddef>
 
 using namespace usml::beampatterns;
 
@@ -24,13 +28,14 @@ void bp_line::beam_level(const bvector& arrival,
 }
 
 /**
- * Estimates the directivity gain for line array.
+ * Estimates the directivity gain for line array. The double summation over
+ * element pairs only depends on the difference between element indices,
+ * and there are N-k pairs with a difference of k. Summing over this
+ * difference reduces the computation from N^2 to N terms.
  */
 void bp_line::directivity(const seq_vector::csptr& frequencies,
                           vector<double>* level, const bvector& steering,
                           double sound_speed) const {
-    const scalar_vector<double> one(frequencies->size(), 1.0);
-
     // steering relative to first element
     const double str = (_type == HLA) ? steering.front() : steering.up();
 
@@ -38,20 +43,41 @@ void bp_line::directivity(const seq_vector::csptr& frequencies,
     vector<double> alpha = frequencies->data();
     alpha *= (M_PI * _spacing / sound_speed * 2.0);
 
-    // compute double summation over number of elements
-    noalias(*level) = scalar_vector<double>(frequencies->size(), 0.0);
-    for (double n = 1.0; n <= _num_elements; ++n) {
-        for (double m = 1.0; m <= _num_elements; ++m) {
-            if (n == m) {
-                *level += one;
-            } else {
-                const vector<double> anm(alpha * (n - m));
-                *level +=
-                    element_div(element_prod(cos(anm * str), sin(anm)), anm);
-            }
+    // compute summation over differences in element index
+    for (std::size_t f = 0; f < frequencies->size(); ++f) {
+        double sum = _num_elements;
+        for (double k = 1.0; k < _num_elements; ++k) {
+            const double ak = alpha(f) * k;
+            sum += 2.0 * (_num_elements - k) * cos(ak * str) * sin(ak) / ak;
         }
+        (*level)(f) = sum;
     }
 
     // normalize to number elements
     *level /= (_num_elements * _num_elements);
 }
+
+/**
+ * Computes the beam level gain for a batch of arrival vectors.
+ */
+void bp_line::beam_levels(const vector<double>& front,
+                         const vector<double>& /*right*/,
+                         const vector<double>& up,
+                         const seq_vector::csptr& frequencies,
+                         matrix<double>* level, const bvector& steering,
+                         double sound_speed) const {
+    const std::size_t num_freq = frequencies->size();
+    level->resize(front.size(), num_freq, false);
+    const vector<double> freq = frequencies->data();
+    const vector<double>& axis = (_type == bp_line_type::HLA) ? front : up;
+    const double str =
+        (_type == bp_line_type::HLA) ? steering.front() : steering.up();
+
+    double* row = level->data().begin();
+    for (std::size_t n = 0; n < front.size(); ++n, row += num_freq) {
+        const double kd = M_PI * _spacing / sound_speed * (axis(n) - str);
+        for (std::size_t f = 0; f < num_freq; ++f) {
+            row[f] = bp_line_level(freq(f) * kd, _num_elements);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+/**
+ * @file bp_line_level.h
+ * Beam level of a uniform line array, shared by the closed form patterns.
+ */
+#pragma once
+
+#include <cmath>
+
+namespace usml {
+namespace beampatterns {
+
+/// @ingroup beampatterns
+/// @{
+
+/**
+ * Beam level of a uniform line array, for a phase difference of kd
+ * between neighboring elements. Used internally by bp_line and bp_planar
+ * to compute beam levels one arrival at a time. Small offsets in the
+ * numerator and denominator avoid division by zero at broadside.
+ *
+ * @param kd            Phase difference between neighboring elements.
+ * @param num_elements  Number of elements in the line.
+ * @return              Beam level (linear units).
+ */
+inline double bp_line_level(double kd, double num_elements) {
+    const double value = (std::sin(num_elements * kd) + 1e-200) /
+                         (std::sin(kd) * num_elements + 1e-200);
+    return value * value;
+}
+
+/// @}
+}  // namespace beampatterns
+}  // namespace usml
@@ -5,7 +5,9 @@
 
 #include <usml/beampatterns/bp_model.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <utility>
 
 using namespace usml::beampatterns;
@@ -24,29 +26,66 @@ void bp_model::beam_level(const bvector& arrival, const orientation& orient,
 }
 
 /**
- * Computes the directivity gain for this beam pattern.
+ * Computes the beam level gain for a batch of arrival vectors,
+ * one arrival at a time.
+ */
+void bp_model::beam_levels(const vector<double>& front,
+                           const vector<double>& right,
+                           const vector<double>& up,
+                           const seq_vector::csptr& frequencies,
+                           matrix<double>* level, const bvector& steering,
+                           double sound_speed) const {
+    const std::size_t num_freq = frequencies->size();
+    level->resize(front.size(), num_freq, false);
+    vector<double> beam(num_freq);
+    for (std::size_t n = 0; n < front.size(); ++n) {
+        const bvector arrival(front(n), right(n), up(n));
+        beam_level(arrival, frequencies, &beam, steering, sound_speed);
+        std::copy(beam.begin(), beam.end(), &(*level)(n, 0));
+    }
+}
+
+/**
+ * Computes the directivity gain for this beam pattern. All of the solid
+ * angles are evaluated in one call to beam_levels().
  */
 void bp_model::directivity(const seq_vector::csptr& frequencies,
                            vector<double>* level, const bvector& steering,
                            double sound_speed) const {
-    // loop over all solid angles
+    // build list of all solid angles
 
-    vector<double> beam(frequencies->size(), 0.0);
     const double dangle = M_PI / 180.0;  // both dtheta and dphi
+    std::size_t num_angles = 0;
     for (double az = 0.0; az <= TWO_PI; az += dangle) {
         for (double de = -M_PI_2; de <= M_PI_2; de += dangle) {
-            // compute angle terms
+            ++num_angles;
+        }
+    }
+    vector<double> front(num_angles);
+    vector<double> right(num_angles);
+    vector<double> up(num_angles);
+    vector<double> weight(num_angles);
+    std::size_t n = 0;
+    for (double az = 0.0; az <= TWO_PI; az += dangle) {
+        for (double de = -M_PI_2; de <= M_PI_2; de += dangle, ++n) {
             const double cos_de = cos(de);
-            const double sin_de = sin(de);
-            const double cos_az = cos(az);
-            const double sin_az = sin(az);
+            front(n) = cos_de * cos(az);
+            right(n) = cos_de * sin(az);
+            up(n) = sin(de);
+            weight(n) = cos_de * dangle * dangle;
+        }
+    }
+
+    // compute beam level at all DE and AZ angles
+
+    matrix<double> beam;
+    beam_levels(front, right, up, frequencies, &beam, steering, sound_speed);
 
-            // compute beam level at this DE and AZ angle
-            bvector arrival(cos_de * cos_az, cos_de * sin_az, sin_de);
-            beam_level(arrival, frequencies, &beam, steering, sound_speed);
+    // add contribution to integral at each frequency
 
-            // add contribution to integral at each frequency
-            *level += beam * (cos_de * dangle * dangle);
+    for (n = 0; n < num_angles; ++n) {
+        for (std::size_t f = 0; f < frequencies->size(); ++f) {
+            (*level)(f) += beam(n, f) * weight(n);
         }
     }
 
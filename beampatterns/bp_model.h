@@ -9,6 +9,7 @@
 #include <usml/types/seq_vector.h>
 #include <usml/usml_config.h>
 
+#include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <memory>
 
@@ -81,6 +82,32 @@ class USML_DECLSPEC bp_model {
                     const bvector& steering = bvector(1.0, 0.0, 0.0),
                     double sound_speed = 1500.0) const;
 
+    /**
+     * Computes the beam level gain for a batch of arrival vectors. The
+     * arrival vectors are passed as separate front, right, and up
+     * components, which must all be the same size. The level matrix is
+     * resized to have one row for each arrival and one column for each
+     * frequency. The default behavior calls beam_level() for each arrival.
+     * Sub-classes override this with loops that avoid the virtual call and
+     * memory allocation for each arrival.
+     *
+     * @param front         Front component of each arrival vector.
+     * @param right         Right component of each arrival vector.
+     * @param up            Up component of each arrival vector.
+     * @param frequencies   List of frequencies to compute beam level for.
+     * @param level         Beam level output for each arrival (row) and
+     *                      frequency (column) in linear units.
+     * @param steering      Steering vector relative to body.
+     * @param sound_speed   Speed of sound in water (m/s).
+     */
+    virtual void beam_levels(const vector<double>& front,
+                             const vector<double>& right,
+                             const vector<double>& up,
+                             const seq_vector::csptr& frequencies,
+                             matrix<double>* level,
+                             const bvector& steering = bvector(1.0, 0.0, 0.0),
+                             double sound_speed = 1500.0) const;
+
     /**
      * Compute the directivity gain for this beam pattern.
      * The default behavior integrates beam level over a grid of DE and AZ
@@ -4,6 +4,8 @@
  */
 #include <usml/beampatterns/bp_omni.h>
 
+#include <algorithm>
+
 using namespace usml::beampatterns;
 
 /**
@@ -25,3 +27,16 @@ void bp_omni::directivity(const seq_vector::csptr& frequencies,
                           double /*sound_speed*/) const {
     noalias(*level) = scalar_vector<double>(frequencies->size(), 1.0);
 }
+
+/**
+ * Computes the beam level gain for a batch of arrival vectors.
+ */
+void bp_omni::beam_levels(const vector<double>& front,
+                         const vector<double>& /*right*/,
+                         const vector<double>& /*up*/,
+                         const seq_vector::csptr& frequencies,
+                         matrix<double>* level, const bvector& /*steering*/,
+                         double /*sound_speed*/) const {
+    level->resize(front.size(), frequencies->size(), false);
+    std::fill(level->data().begin(), level->data().end(), 1.0);
+}
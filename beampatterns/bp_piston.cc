@@ -7,9 +7,11 @@
 #include <usml/types/bvector.h>
 #include <usml/types/seq_vector.h>
 
+#include <algorithm>
 #include <boost/numeric/ublas/vector.hpp>
 #include <cmath>
 #include <memory>
+#include <vector>
 
 using namespace usml::beampatterns;
 
@@ -51,3 +53,36 @@ void bp_piston::directivity(const seq_vector::csptr& frequencies,
         *level *= 0.5;
     }
 }
+
+/**
+ * Computes the beam level gain for a batch of arrival vectors.
+ */
+void bp_piston::beam_levels(const vector<double>& front,
+                           const vector<double>& /*right*/,
+                           const vector<double>& /*up*/,
+                           const seq_vector::csptr& frequencies,
+                           matrix<double>* level, const bvector& /*steering*/,
+                           double sound_speed) const {
+    const std::size_t num_freq = frequencies->size();
+    level->resize(front.size(), num_freq, false);
+
+    // wave number scaling, computed once for all arrivals
+    std::vector<double> kscale(num_freq);
+    for (std::size_t f = 0; f < num_freq; ++f) {
+        kscale[f] = M_PI * _diameter / (sound_speed / (*frequencies)(f));
+    }
+
+    double* row = level->data().begin();
+    for (std::size_t n = 0; n < front.size(); ++n, row += num_freq) {
+        if (_back_baffle && front(n) <= 0.0) {
+            std::fill_n(row, num_freq, 0.0);
+            continue;
+        }
+        const double sinA = sqrt(1.0 - front(n) * front(n));
+        for (std::size_t f = 0; f < num_freq; ++f) {
+            const double P1 = kscale[f] * sinA + 1e-17;
+            const double P2 = 2.0 * std::cyl_bessel_j(1.0, P1);
+            row[f] = pow(P2 / P1, 2);
+        }
+    }
+}
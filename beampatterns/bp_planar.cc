@@ -4,14 +4,17 @@
  */
 
 #include <usml/beampatterns/bp_planar.h>
+#include <usml/beampatterns/bp_line_level.h>
 #include <usml/types/bvector.h>
 #include <usml/types/seq_vector.h>
 #include <usml/ublas/vector_math.h>
 
+#include <algorithm>
 #include <boost/numeric/ublas/expression_types.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/vector_expression.hpp>
 #include <cmath>
+#include <cstddef>
 
 using namespace usml::beampatterns;
 
@@ -76,3 +79,36 @@ void bp_planar::directivity(const seq_vector::csptr& frequencies,
         *level *= 0.5;
     }
 }
+
+/**
+ * Computes the beam level gain for a batch of arrival vectors.
+ */
+void bp_planar::beam_levels(const vector<double>& front,
+                           const vector<double>& right,
+                           const vector<double>& up,
+                           const seq_vector::csptr& frequencies,
+                           matrix<double>* level, const bvector& steering,
+                           double sound_speed) const {
+    const std::size_t num_freq = frequencies->size();
+    level->resize(front.size(), num_freq, false);
+    const vector<double> freq = frequencies->data();
+
+    double* row = level->data().begin();
+    for (std::size_t n = 0; n < front.size(); ++n, row += num_freq) {
+        // set gain to zero in backplane when baffle is on
+        if (_back_baffle && front(n) <= 0.0) {
+            std::fill_n(row, num_freq, 0.0);
+            continue;
+        }
+
+        // product of line arrays in up and right directions
+        const double kd_up =
+            M_PI * _spacing_up / sound_speed * (up(n) - steering.up());
+        const double kd_right = M_PI * _spacing_right / sound_speed *
+                                (right(n) - steering.right());
+        for (std::size_t f = 0; f < num_freq; ++f) {
+            row[f] = bp_line_level(freq(f) * kd_up, _num_elem_up) *
+                     bp_line_level(freq(f) * kd_right, _num_elem_right);
+        }
+    }
+}
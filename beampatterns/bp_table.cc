@@ -0,0 +1,252 @@
+/**
+ * @file bp_table.cc
+ * Lookup table of beam levels for a fixed frequency and steering.
+ */
+
+#include <usml/beampatterns/bp_table.h>
+#include <usml/types/seq_linear.h>
+#include <usml/ublas/math_traits.h>
+
+#include <algorithm>
+#include <boost/numeric/ublas/vector.hpp>
+#include <cmath>
+
+using namespace usml::beampatterns;
+
+/// Default grid spacing for new tables (deg).
+double bp_table::default_spacing = 2.0;
+
+/// Smallest grid spacing used to satisfy the error tolerance (deg).
+double bp_table::min_spacing = 0.25;
+
+/// Maximum memory used by tables kept by find(), in bytes.
+std::size_t bp_table::max_cache_bytes = 128 << 20;
+
+/// Cache of tables used by find().
+std::map<bp_table::key_type, bp_table::cache_entry> bp_table::_cache;
+
+/// Number of tables in the cache, not including rejected keys.
+std::size_t bp_table::_cache_tables = 0;
+
+/// Memory used by entries in the cache, in bytes.
+std::size_t bp_table::_cache_bytes = 0;
+
+/// Counter used to find the least recently used entry.
+std::atomic<std::uint64_t> bp_table::_cache_clock{0};
+
+/// Mutex to lock access to the cache.
+read_write_lock bp_table::_cache_mutex;
+
+/**
+ * Builds a table for a beam pattern, refining the grid until the
+ * interpolation error is less than the tolerance.
+ */
+bp_table::bp_table(const bp_model::csptr& pattern, double frequency,
+                   const bvector& steering, double sound_speed,
+                   double tolerance, double spacing)
+    : _pattern(pattern), _frequency(frequency) {
+    spacing = std::max(spacing, min_spacing);
+    while (true) {
+        build(spacing, steering, sound_speed);
+        if (_max_error <= tolerance || spacing <= min_spacing) {
+            break;
+        }
+        spacing = std::max(0.5 * spacing, min_spacing);
+    }
+}
+
+/**
+ * Finds a table in the cache, or builds a new one if it does not exist.
+ */
+bp_table::csptr bp_table::find(const bp_model::csptr& pattern,
+                               double frequency, const bvector& steering,
+                               double sound_speed, double tolerance) {
+    const key_type key(pattern.get(), frequency, steering.front(),
+                       steering.right(), steering.up(), sound_speed, tolerance);
+    {
+        read_lock_guard guard(_cache_mutex);
+        auto iter = _cache.find(key);
+        if (iter != _cache.end()) {
+            iter->second.last_used = ++_cache_clock;
+            return iter->second.table;
+        }
+    }
+
+    // build new table without holding the lock, because this can be slow
+    // keys for tables that fail their tolerance, or that are too big to
+    // keep, are cached with a nominal size, so they are not built again
+
+    csptr table(
+        new bp_table(pattern, frequency, steering, sound_speed, tolerance));
+    std::size_t bytes = table->bytes();
+    if (table->max_error() > tolerance || bytes > max_cache_bytes) {
+        table = nullptr;
+        bytes = sizeof(key_type) + sizeof(cache_entry);
+    }
+    write_lock_guard guard(_cache_mutex);
+    auto iter = _cache.find(key);
+    if (iter != _cache.end()) {
+        return iter->second.table;  // built by another thread at the same time
+    }
+    while (!_cache.empty() && _cache_bytes + bytes > max_cache_bytes) {
+        auto oldest = _cache.begin();
+        for (auto entry = _cache.begin(); entry != _cache.end(); ++entry) {
+            if (entry->second.last_used < oldest->second.last_used) {
+                oldest = entry;
+            }
+        }
+        _cache_bytes -= oldest->second.bytes;
+        if (oldest->second.table != nullptr) {
+            --_cache_tables;
+        }
+        _cache.erase(oldest);
+    }
+    cache_entry& entry = _cache[key];
+    entry.table = table;
+    entry.pattern = pattern;
+    entry.bytes = bytes;
+    entry.last_used = ++_cache_clock;
+    _cache_bytes += bytes;
+    if (table != nullptr) {
+        ++_cache_tables;
+    }
+    return table;
+}
+
+/**
+ * Number of tables in the cache, not including rejected keys.
+ */
+std::size_t bp_table::cache_size() {
+    read_lock_guard guard(_cache_mutex);
+    return _cache_tables;
+}
+
+/**
+ * Memory used by entries in the cache, in bytes.
+ */
+std::size_t bp_table::cache_bytes() {
+    read_lock_guard guard(_cache_mutex);
+    return _cache_bytes;
+}
+
+/**
+ * Removes all tables, and rejected keys, from the cache.
+ */
+void bp_table::clear_cache() {
+    write_lock_guard guard(_cache_mutex);
+    _cache.clear();
+    _cache_tables = 0;
+    _cache_bytes = 0;
+}
+
+/**
+ * Interpolates the beam level for an arrival direction.
+ */
+double bp_table::level(const bvector& arrival) const {
+    const double up = std::max(-1.0, std::min(1.0, arrival.up()));
+    const double de = to_degrees(asin(up));
+    const double az = to_degrees(atan2(arrival.right(), arrival.front()));
+    return interpolate(de, az);
+}
+
+/**
+ * Samples the beam pattern on a grid with a specific spacing.
+ */
+void bp_table::build(double spacing, const bvector& steering,
+                     double sound_speed) {
+    // round spacing so that DE and AZ end points fall on the grid
+
+    const auto num_cells = (std::size_t)std::ceil(180.0 / spacing - 1e-9);
+    _spacing = spacing = 180.0 / (double)num_cells;
+    _num_de = num_cells + 1;
+    _num_az = 2 * num_cells + 1;
+    _levels.resize(_num_de * _num_az);
+
+    const seq_vector::csptr frequencies(new seq_linear(_frequency, 1.0, 1));
+    matrix<double> beam;
+    sample(0.0, 0.0, spacing, _num_de, _num_az, frequencies, &beam, steering,
+           sound_speed);
+    std::copy(beam.data().begin(), beam.data().end(), _levels.begin());
+
+    // measure interpolation error at the center of each cell,
+    // and at the midpoints of the cell edges along DE and AZ
+
+    _max_error = std::max(
+        {measure_error(0.5, 0.5, _num_de - 1, _num_az - 1, frequencies,
+                       steering, sound_speed),
+         measure_error(0.5, 0.0, _num_de - 1, _num_az, frequencies, steering,
+                       sound_speed),
+         measure_error(0.0, 0.5, _num_de, _num_az - 1, frequencies, steering,
+                       sound_speed)});
+}
+
+/**
+ * Largest difference between the interpolated and exact beam levels
+ * on a grid of DE and AZ angles.
+ */
+double bp_table::measure_error(double de_offset, double az_offset,
+                               std::size_t num_de, std::size_t num_az,
+                               const seq_vector::csptr& frequencies,
+                               const bvector& steering,
+                               double sound_speed) const {
+    matrix<double> beam;
+    sample(de_offset, az_offset, _spacing, num_de, num_az, frequencies, &beam,
+           steering, sound_speed);
+    double max_error = 0.0;
+    std::size_t n = 0;
+    for (std::size_t d = 0; d < num_de; ++d) {
+        const double de =
+            std::min(90.0, -90.0 + ((double)d + de_offset) * _spacing);
+        for (std::size_t a = 0; a < num_az; ++a, ++n) {
+            const double az =
+                std::min(180.0, -180.0 + ((double)a + az_offset) * _spacing);
+            const double error = std::abs(beam(n, 0) - interpolate(de, az));
+            max_error = std::max(max_error, error);
+        }
+    }
+    return max_error;
+}
+
+/**
+ * Computes beam levels for all arrivals on a grid of DE and AZ angles,
+ * using a single batched call to the beam pattern.
+ */
+void bp_table::sample(double de_offset, double az_offset, double spacing,
+                      std::size_t num_de, std::size_t num_az,
+                      const seq_vector::csptr& frequencies,
+                      matrix<double>* level, const bvector& steering,
+                      double sound_speed) const {
+    vector<double> front(num_de * num_az);
+    vector<double> right(num_de * num_az);
+    vector<double> up(num_de * num_az);
+    std::size_t n = 0;
+    for (std::size_t d = 0; d < num_de; ++d) {
+        const double de =
+            std::min(90.0, -90.0 + ((double)d + de_offset) * spacing);
+        for (std::size_t a = 0; a < num_az; ++a, ++n) {
+            const double az =
+                std::min(180.0, -180.0 + ((double)a + az_offset) * spacing);
+            const bvector arrival(de, az);
+            front(n) = arrival.front();
+            right(n) = arrival.right();
+            up(n) = arrival.up();
+        }
+    }
+    _pattern->beam_levels(front, right, up, frequencies, level, steering,
+                          sound_speed);
+}
+
+/**
+ * Interpolates the beam level at a DE and AZ angle.
+ */
+double bp_table::interpolate(double de, double az) const {
+    const double x = std::max(0.0, (de + 90.0) / _spacing);
+    const double y = std::max(0.0, (az + 180.0) / _spacing);
+    auto d = std::min((std::size_t)x, _num_de - 2);
+    auto a = std::min((std::size_t)y, _num_az - 2);
+    const double u = std::min(1.0, x - (double)d);
+    const double v = std::min(1.0, y - (double)a);
+    const double* row = &_levels[d * _num_az + a];
+    return (1.0 - u) * ((1.0 - v) * row[0] + v * row[1]) +
+           u * ((1.0 - v) * row[_num_az] + v * row[_num_az + 1]);
+}
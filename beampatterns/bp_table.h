@@ -0,0 +1,270 @@
+/**
+ * @file bp_table.h
+ * Lookup table of beam levels for a fixed frequency and steering.
+ */
+#pragma once
+
+#include <usml/beampatterns/bp_model.h>
+#include <usml/threads/read_write_lock.h>
+#include <usml/types/bvector.h>
+#include <usml/types/seq_vector.h>
+#include <usml/usml_config.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace usml {
+namespace beampatterns {
+
+using namespace usml::threads;
+using namespace usml::types;
+
+/// @ingroup beampatterns
+/// @{
+
+/**
+ * Lookup table of beam levels for a fixed frequency, steering, and sound
+ * speed. For a fixed set of these parameters, the beam level depends only on
+ * the arrival direction. This table samples the beam pattern on a regular
+ * grid of DE and AZ angles in body coordinates, and uses bilinear
+ * interpolation to compute the beam level for any other arrival direction.
+ * This replaces the full trigonometric evaluation of patterns like bp_line
+ * or bp_arb with a few multiplies, when the same pattern is evaluated for a
+ * large number of arrivals, such as in reverberation synthesis.
+ *
+ * DE angles range from -90 deg down to +90 deg up, and AZ angles range from
+ * -180 deg to +180 deg. Both end points are included in the grid.
+ *
+ * The accuracy of the table is estimated, when the table is built, by
+ * comparing the interpolated level to the exact beam level at the center of
+ * every grid cell, and at the midpoint of every cell edge. If the largest
+ * difference exceeds the requested tolerance, the grid spacing is halved and
+ * the table is rebuilt, down to a minimum spacing of min_spacing. The
+ * largest difference found is reported by max_error(). This is an estimate,
+ * not a strict bound, because patterns can have features that are narrower
+ * than the grid spacing.
+ *
+ * Tables are immutable once constructed. The find() method provides a
+ * thread-safe cache of tables, keyed by pattern, frequency, steering, sound
+ * speed, and tolerance, so that tables can be shared between threads and
+ * reused in later calculations. The cache is limited by the memory used for
+ * beam levels, rather than the number of tables, because a table refined
+ * down to min_spacing is several MB. The least recently used tables are
+ * discarded when a new table does not fit. The cache also remembers the
+ * keys for tables that could not meet their tolerance, so that callers
+ * fall back to the exact pattern without building these tables again.
+ */
+class USML_DECLSPEC bp_table {
+   public:
+    /// Alias for shared const reference to bp_table.
+    typedef std::shared_ptr<const bp_table> csptr;
+
+    /// Default grid spacing for new tables (deg).
+    static double default_spacing;
+
+    /// Smallest grid spacing used to satisfy the error tolerance (deg).
+    static double min_spacing;
+
+    /// Maximum memory used by tables kept by find(), in bytes.
+    /// Least recently used tables are discarded to stay under this limit.
+    static std::size_t max_cache_bytes;
+
+    /**
+     * Builds a table for a beam pattern, refining the grid until the
+     * interpolation error is less than the tolerance, or until the grid
+     * spacing reaches min_spacing.
+     *
+     * @param pattern       Beam pattern to be sampled.
+     * @param frequency     Frequency at which beam levels are computed (Hz).
+     * @param steering      Steering vector relative to body.
+     * @param sound_speed   Speed of sound in water (m/s).
+     * @param tolerance     Maximum interpolation error (linear units).
+     * @param spacing       Initial grid spacing for DE and AZ (deg).
+     */
+    bp_table(const bp_model::csptr& pattern, double frequency,
+             const bvector& steering = bvector(1.0, 0.0, 0.0),
+             double sound_speed = 1500.0, double tolerance = 1e-3,
+             double spacing = default_spacing);
+
+    /**
+     * Finds a table in the cache, or builds a new one if it does not exist.
+     * Returns nullptr if the table can not meet the tolerance, even at
+     * min_spacing, or if it is larger than max_cache_bytes. These keys are
+     * remembered, so that later calls for the same parameters return
+     * nullptr immediately, and callers evaluate the exact pattern instead.
+     *
+     * @param pattern       Beam pattern to be sampled.
+     * @param frequency     Frequency at which beam levels are computed (Hz).
+     * @param steering      Steering vector relative to body.
+     * @param sound_speed   Speed of sound in water (m/s).
+     * @param tolerance     Maximum interpolation error (linear units).
+     * @return              Shared reference to the table, or nullptr if
+     *                      the exact pattern should be used instead.
+     */
+    static csptr find(const bp_model::csptr& pattern, double frequency,
+                      const bvector& steering = bvector(1.0, 0.0, 0.0),
+                      double sound_speed = 1500.0, double tolerance = 1e-3);
+
+    /// Number of tables in the cache, not including rejected keys.
+    static std::size_t cache_size();
+
+    /// Memory used by tables in the cache, in bytes.
+    static std::size_t cache_bytes();
+
+    /// Removes all tables, and rejected keys, from the cache.
+    static void clear_cache();
+
+    /**
+     * Interpolates the beam level for an arrival direction.
+     *
+     * @param arrival       Arrival vector relative to body (out from array).
+     * @return              Beam level (linear units).
+     */
+    double level(const bvector& arrival) const;
+
+    /// Beam pattern sampled by this table.
+    const bp_model::csptr& pattern() const { return _pattern; }
+
+    /// Frequency at which beam levels were computed (Hz).
+    double frequency() const { return _frequency; }
+
+    /// Grid spacing for DE and AZ (deg).
+    double spacing() const { return _spacing; }
+
+    /// Memory used by this table, in bytes.
+    std::size_t bytes() const {
+        return sizeof(bp_table) + _levels.size() * sizeof(double);
+    }
+
+    /**
+     * Largest difference between the interpolated and exact beam levels,
+     * measured at the center of every grid cell and the midpoint of every
+     * cell edge (linear units).
+     */
+    double max_error() const { return _max_error; }
+
+   private:
+    /**
+     * Samples the beam pattern on a grid with a specific spacing, and
+     * measures the interpolation error at the center of each cell and
+     * the midpoint of each cell edge.
+     *
+     * @param spacing       Grid spacing for DE and AZ (deg).
+     * @param steering      Steering vector relative to body.
+     * @param sound_speed   Speed of sound in water (m/s).
+     */
+    void build(double spacing, const bvector& steering, double sound_speed);
+
+    /**
+     * Computes beam levels for all arrivals on a grid of DE and AZ angles.
+     * Grid points are ordered with DE as the slowest changing index.
+     *
+     * @param de_offset     Offset of the first DE, in units of spacing.
+     * @param az_offset     Offset of the first AZ, in units of spacing.
+     * @param spacing       Grid spacing for DE and AZ (deg).
+     * @param num_de        Number of DE angles in the grid.
+     * @param num_az        Number of AZ angles in the grid.
+     * @param frequencies   List of frequencies to compute beam level for.
+     * @param level         Beam level for each grid point and frequency.
+     * @param steering      Steering vector relative to body.
+     * @param sound_speed   Speed of sound in water (m/s).
+     */
+    void sample(double de_offset, double az_offset, double spacing,
+                std::size_t num_de, std::size_t num_az,
+                const seq_vector::csptr& frequencies, matrix<double>* level,
+                const bvector& steering, double sound_speed) const;
+
+    /**
+     * Largest difference between the interpolated and exact beam levels
+     * on a grid of DE and AZ angles.
+     *
+     * @param de_offset     Offset of the first DE, in units of spacing.
+     * @param az_offset     Offset of the first AZ, in units of spacing.
+     * @param num_de        Number of DE angles in the grid.
+     * @param num_az        Number of AZ angles in the grid.
+     * @param frequencies   Single frequency at which levels are computed.
+     * @param steering      Steering vector relative to body.
+     * @param sound_speed   Speed of sound in water (m/s).
+     */
+    double measure_error(double de_offset, double az_offset,
+                         std::size_t num_de, std::size_t num_az,
+                         const seq_vector::csptr& frequencies,
+                         const bvector& steering, double sound_speed) const;
+
+    /**
+     * Interpolates the beam level at a DE and AZ angle.
+     *
+     * @param de    Depression/elevation angle (deg).
+     * @param az    Azimuthal angle (deg).
+     */
+    double interpolate(double de, double az) const;
+
+    /// Beam pattern sampled by this table.
+    const bp_model::csptr _pattern;
+
+    /// Frequency at which beam levels were computed (Hz).
+    const double _frequency;
+
+    /// Grid spacing for DE and AZ (deg).
+    double _spacing{0.0};
+
+    /// Number of DE angles in the grid.
+    std::size_t _num_de{0};
+
+    /// Number of AZ angles in the grid.
+    std::size_t _num_az{0};
+
+    /// Beam levels with DE as the row and AZ as the column.
+    std::vector<double> _levels;
+
+    /// Largest interpolation error measured at cell centers and edges.
+    double _max_error{0.0};
+
+    /// Cache key: pattern, frequency, steering, sound speed, tolerance.
+    typedef std::tuple<const bp_model*, double, double, double, double,
+                       double, double>
+        key_type;
+
+    /**
+     * Table, or rejected key, stored in the cache. Rejected keys keep a
+     * reference to their pattern, like tables do, so that its address
+     * can not be reused by another pattern while it is in the cache.
+     */
+    struct cache_entry {
+        /// Table for this key, nullptr if the key was rejected.
+        csptr table;
+
+        /// Beam pattern for this key.
+        bp_model::csptr pattern;
+
+        /// Memory charged to the cache for this entry, in bytes.
+        std::size_t bytes{0};
+
+        /// Value of _cache_clock when this entry was last used.
+        mutable std::atomic<std::uint64_t> last_used{0};
+    };
+
+    /// Cache of tables used by find().
+    static std::map<key_type, cache_entry> _cache;
+
+    /// Number of tables in the cache, not including rejected keys.
+    static std::size_t _cache_tables;
+
+    /// Memory used by entries in the cache, in bytes.
+    static std::size_t _cache_bytes;
+
+    /// Counter used to find the least recently used entry.
+    static std::atomic<std::uint64_t> _cache_clock;
+
+    /// Mutex to lock access to the cache.
+    static read_write_lock _cache_mutex;
+};
+
+/// @}
+}  // namespace beampatterns
+}  // namespace usml
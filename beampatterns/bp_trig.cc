@@ -5,7 +5,9 @@
 
 #include <usml/beampatterns/bp_trig.h>
 
+#include <algorithm>
 #include <boost/numeric/ublas/detail/definitions.hpp>
+#include <cstddef>
 
 using namespace usml::beampatterns;
 
@@ -31,3 +33,22 @@ void bp_trig::directivity(const seq_vector::csptr& frequencies,
                           double /*sound_speed*/) const {
     noalias(*level) = scalar_vector<double>(frequencies->size(), _directivity);
 }
+
+/**
+ * Computes the beam level gain for a batch of arrival vectors.
+ */
+void bp_trig::beam_levels(const vector<double>& front,
+                         const vector<double>& right,
+                         const vector<double>& /*up*/,
+                         const seq_vector::csptr& frequencies,
+                         matrix<double>* level, const bvector& /*steering*/,
+                         double /*sound_speed*/) const {
+    const std::size_t num_freq = frequencies->size();
+    level->resize(front.size(), num_freq, false);
+    const vector<double>& axis = (_type == bp_trig_type::sine) ? right : front;
+    double* row = level->data().begin();
+    for (std::size_t n = 0; n < front.size(); ++n, row += num_freq) {
+        const double dot = axis(n);
+        std::fill_n(row, num_freq, _null + _gain * dot * dot);
+    }
+}
@@ -62,6 +62,13 @@ class USML_DECLSPEC bp_trig : public bp_model {
                     const bvector& steering = bvector(1.0, 0.0, 0.0),
                     double sound_speed = 1500.0) const override;
 
+    void beam_levels(const vector<double>& front, const vector<double>& right,
+                     const vector<double>& up,
+                     const seq_vector::csptr& frequencies,
+                     matrix<double>* level,
+                     const bvector& steering = bvector(1.0, 0.0, 0.0),
+                     double sound_speed = 1500.0) const override;
+
     void directivity(const seq_vector::csptr& frequencies,
                      vector<double>* level,
                      const bvector& steering = bvector(1.0, 0.0, 0.0),
@@ -566,6 +566,359 @@ BOOST_AUTO_TEST_CASE(bp_gaussian_test) {
     BOOST_CHECK_CLOSE(level(0), 25.0, 1.0);
 }
 
+/**
+ * Tests the accuracy and caching of bp_table lookups. Builds a table for an
+ * 8 element horizontal line array, steered 30 deg to the right, with an
+ * error tolerance of 1e-3. Compares the table to the exact pattern on a grid
+ * of arrivals that are offset from the table samples, and times both
+ * methods.
+ *
+ * This test passes if:
+ *   - the measured max_error() meets the requested tolerance
+ *   - the table is within twice this tolerance at every test arrival
+ *   - find() returns the same table for the same parameters
+ *   - the cache reports the memory used by its tables
+ *   - tables that can not meet their tolerance are not returned or cached,
+ *     but their keys are remembered
+ *   - the least recently used table is discarded when the cache is full
+ *   - an omni-directional table is exactly one everywhere
+ */
+BOOST_AUTO_TEST_CASE(bp_table_test) {
+    cout << "=== beampattern_test: bp_table_test ===" << endl;
+    const double tolerance = 1e-3;
+    bp_model::csptr hla(new bp_line(8, spacing, bp_line_type::HLA));
+    bvector steering(0.0, 30.0);
+
+    bp_table::clear_cache();
+    auto table = bp_table::find(hla, freq, steering, sound_speed, tolerance);
+    cout << "spacing=" << table->spacing()
+         << " max_error=" << table->max_error() << endl;
+    BOOST_CHECK_LE(table->max_error(), tolerance);
+    BOOST_CHECK_EQUAL(
+        bp_table::find(hla, freq, steering, sound_speed, tolerance), table);
+    BOOST_CHECK_EQUAL(bp_table::cache_size(), 1);
+    BOOST_CHECK_EQUAL(bp_table::cache_bytes(), table->bytes());
+
+    // tolerance that can not be met at min_spacing
+
+    BOOST_CHECK(bp_table::find(hla, freq, steering, sound_speed, 1e-12) ==
+                nullptr);
+    BOOST_CHECK_EQUAL(bp_table::cache_size(), 1);
+    const size_t rejected_bytes = bp_table::cache_bytes() - table->bytes();
+    BOOST_CHECK_GT(rejected_bytes, 0);
+    BOOST_CHECK_LT(rejected_bytes, 1024);
+    BOOST_CHECK(bp_table::find(hla, freq, steering, sound_speed, 1e-12) ==
+                nullptr);
+    BOOST_CHECK_EQUAL(bp_table::cache_bytes(), table->bytes() + rejected_bytes);
+
+    // least recently used table is discarded when the cache is full
+
+    const size_t max_cache_bytes = bp_table::max_cache_bytes;
+    bp_table::max_cache_bytes = 2 * table->bytes() + rejected_bytes;
+    auto second =
+        bp_table::find(hla, freq, bvector(0.0, -30.0), sound_speed, tolerance);
+    BOOST_REQUIRE(second != nullptr);
+    BOOST_REQUIRE_EQUAL(second->bytes(), table->bytes());
+    BOOST_CHECK_EQUAL(bp_table::cache_size(), 2);
+    BOOST_CHECK_EQUAL(
+        bp_table::find(hla, freq, steering, sound_speed, tolerance), table);
+    auto third =
+        bp_table::find(hla, freq, bvector(0.0, 60.0), sound_speed, tolerance);
+    BOOST_REQUIRE(third != nullptr);
+    BOOST_CHECK_EQUAL(bp_table::cache_size(), 2);
+    BOOST_CHECK_LE(bp_table::cache_bytes(), bp_table::max_cache_bytes);
+    BOOST_CHECK_EQUAL(
+        bp_table::find(hla, freq, steering, sound_speed, tolerance), table);
+    BOOST_CHECK(bp_table::find(hla, freq, bvector(0.0, -30.0), sound_speed,
+                               tolerance) != second);
+    bp_table::max_cache_bytes = max_cache_bytes;
+
+    // compare table to exact pattern
+
+    seq_vector::csptr frequencies(new seq_linear(freq, 1.0, 1));
+    vector<double> level(1);
+    double max_diff = 0.0;
+    for (double de = -89.7; de < 90.0; de += 1.3) {
+        for (double az = -179.9; az < 180.0; az += 1.7) {
+            bvector arrival(de, az);
+            hla->beam_level(arrival, frequencies, &level, steering);
+            max_diff = max(max_diff, abs(table->level(arrival) - level(0)));
+        }
+    }
+    cout << "max_diff=" << max_diff << endl;
+    BOOST_CHECK_LE(max_diff, 2.0 * tolerance);
+
+    // compare execution speed
+
+    const int num_loops = 200000;
+    bvector arrival(10.0, 20.0);
+    double sum = 0.0;
+    {
+        boost::timer::auto_cpu_timer timer("exact: %w secs\n");
+        for (int n = 0; n < num_loops; ++n) {
+            hla->beam_level(arrival, frequencies, &level, steering);
+            sum += level(0);
+        }
+    }
+    {
+        boost::timer::auto_cpu_timer timer("table: %w secs\n");
+        for (int n = 0; n < num_loops; ++n) {
+            sum -= table->level(arrival);
+        }
+    }
+    BOOST_CHECK_SMALL(sum / num_loops, 2.0 * tolerance);
+
+    // omni patterns are flat
+
+    bp_model::csptr omni(new bp_omni());
+    bp_table omni_table(omni, freq);
+    BOOST_CHECK_EQUAL(omni_table.max_error(), 0.0);
+    BOOST_CHECK_CLOSE(omni_table.level(bvector(33.0, -123.0)), 1.0, 1e-10);
+    bp_table::clear_cache();
+}
+
+/**
+ * Compares batched beam levels to the one-arrival-at-a-time beam levels for
+ * every type of beam pattern, and times both methods for the patterns that
+ * have their own batched implementation. Arrivals are a 1 deg grid of DE and
+ * AZ angles. The bp_multi pattern exercises the generic fallback in
+ * bp_model.
+ *
+ * This test passes if the batched and single arrival results agree
+ * to within 1e-12 at every arrival and frequency.
+ */
+BOOST_AUTO_TEST_CASE(bp_batch_test) {
+    cout << "=== beampattern_test: bp_batch_test ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(freq / 2.0, freq / 4.0, 5));
+    const bvector steering(-10.0, 20.0);
+
+    // build arrivals in front, right, up components
+
+    const size_t num_de = 181;
+    const size_t num_az = 361;
+    vector<double> front(num_de * num_az);
+    vector<double> right(num_de * num_az);
+    vector<double> up(num_de * num_az);
+    size_t n = 0;
+    for (size_t d = 0; d < num_de; ++d) {
+        for (size_t a = 0; a < num_az; ++a, ++n) {
+            const bvector arrival(-90.0 + (double)d, -180.0 + (double)a);
+            front(n) = arrival.front();
+            right(n) = arrival.right();
+            up(n) = arrival.up();
+        }
+    }
+
+    // build a list of patterns
+
+    matrix<double> elem_locs(7, 3);
+    bp_con_uniform(1, 0.0, 1, 0.0, 7, spacing, &elem_locs);
+    std::list<bp_model::csptr> multi_list;
+    multi_list.push_back(bp_model::csptr(new bp_trig(bp_trig_type::sine)));
+    multi_list.push_back(bp_model::csptr(new bp_cardioid()));
+
+    const std::list<std::pair<const char*, bp_model::csptr> > patterns = {
+        {"omni", bp_model::csptr(new bp_omni())},
+        {"line", bp_model::csptr(new bp_line(8, spacing, bp_line_type::HLA))},
+        {"planar",
+         bp_model::csptr(new bp_planar(4, spacing, 6, spacing, true))},
+        {"piston", bp_model::csptr(new bp_piston(0.5, true))},
+        {"cardioid", bp_model::csptr(new bp_cardioid(sqrt(3.0)))},
+        {"trig", bp_model::csptr(new bp_trig(bp_trig_type::sine))},
+        {"gaussian", bp_model::csptr(new bp_gaussian(10.0, 20.0))},
+        {"arb", bp_model::csptr(new bp_arb(elem_locs, true))},
+        {"multi", bp_model::csptr(new bp_multi(multi_list))}};
+
+    // compare batched results to single arrival results
+
+    for (const auto& entry : patterns) {
+        const bp_model::csptr& pattern = entry.second;
+        matrix<double> batch;
+        {
+            cout << entry.first << " batch: ";
+            boost::timer::auto_cpu_timer timer("%w secs, ");
+            pattern->beam_levels(front, right, up, frequencies, &batch,
+                                 steering, sound_speed);
+        }
+        BOOST_REQUIRE_EQUAL(batch.size1(), front.size());
+        BOOST_REQUIRE_EQUAL(batch.size2(), frequencies->size());
+
+        vector<double> level(frequencies->size());
+        double max_diff = 0.0;
+        {
+            cout << "single: ";
+            boost::timer::auto_cpu_timer timer("%w secs\n");
+            for (n = 0; n < front.size(); ++n) {
+                const bvector arrival(front(n), right(n), up(n));
+                pattern->beam_level(arrival, frequencies, &level, steering,
+                                    sound_speed);
+                for (size_t f = 0; f < frequencies->size(); ++f) {
+                    max_diff = max(max_diff, abs(batch(n, f) - level(f)));
+                }
+            }
+        }
+        BOOST_CHECK_SMALL(max_diff, 1e-12);
+    }
+}
+
+/**
+ * Tests the closed form directivity of line arrays, and the caching of
+ * directivity gains by bp_directivity. Compares the bp_line directivity
+ * for a 256 element array to a direct summation over all pairs of
+ * elements, and times the first and second calls to bp_directivity::find()
+ * for a bp_arb version of an 8 element line array.
+ *
+ * This test passes if:
+ *   - the bp_line directivity matches the double summation to 1e-10
+ *   - the second call to find() is satisfied entirely from the cache
+ *   - cached values match the directivity computed by the pattern
+ *   - the least recently used frequency is discarded when the cache is full
+ */
+BOOST_AUTO_TEST_CASE(bp_directivity_test) {
+    cout << "=== beampattern_test: bp_directivity_test ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(freq / 2.0, freq / 4.0, 5));
+    const bvector steering(0.0, 30.0);
+
+    // compare line array to double summation over elements
+
+    const unsigned num_elements = 256;
+    bp_line hla(num_elements, spacing, bp_line_type::HLA);
+    vector<double> level(frequencies->size(), 0.0);
+    {
+        boost::timer::auto_cpu_timer timer("bp_line: %w secs\n");
+        hla.directivity(frequencies, &level, steering, sound_speed);
+    }
+    for (size_t f = 0; f < frequencies->size(); ++f) {
+        const double alpha = (*frequencies)(f) * 2.0 * M_PI * spacing /
+                             sound_speed;
+        double sum = 0.0;
+        for (double n = 1.0; n <= num_elements; ++n) {
+            for (double m = 1.0; m <= num_elements; ++m) {
+                const double anm = alpha * (n - m);
+                sum += (n == m) ? 1.0
+                                : cos(anm * steering.front()) * sin(anm) / anm;
+            }
+        }
+        sum /= (num_elements * num_elements);
+        BOOST_CHECK_CLOSE(level(f), sum, 1e-10);
+    }
+
+    // compare first and second calls to cache
+
+    matrix<double> elem_locs(8, 3);
+    bp_con_uniform(8, spacing, 1, 0.0, 1, 0.0, &elem_locs);
+    bp_model::csptr arb(new bp_arb(elem_locs));
+    bp_directivity::clear_cache();
+    vector<double> first(frequencies->size(), 0.0);
+    {
+        boost::timer::auto_cpu_timer timer("first find: %w secs\n");
+        bp_directivity::find(arb, frequencies, &first, steering, sound_speed);
+    }
+    BOOST_CHECK_EQUAL(bp_directivity::misses(), frequencies->size());
+    BOOST_CHECK_EQUAL(bp_directivity::hits(), 0);
+
+    vector<double> second(frequencies->size(), 0.0);
+    {
+        boost::timer::auto_cpu_timer timer("second find: %w secs\n");
+        bp_directivity::find(arb, frequencies, &second, steering, sound_speed);
+    }
+    BOOST_CHECK_EQUAL(bp_directivity::misses(), frequencies->size());
+    BOOST_CHECK_EQUAL(bp_directivity::hits(), frequencies->size());
+    BOOST_CHECK_EQUAL(bp_directivity::cache_size(), frequencies->size());
+
+    level.clear();
+    arb->directivity(frequencies, &level, steering, sound_speed);
+    for (size_t f = 0; f < frequencies->size(); ++f) {
+        BOOST_CHECK_EQUAL(first(f), level(f));
+        BOOST_CHECK_EQUAL(second(f), level(f));
+    }
+
+    // discard least recently used frequency when cache is full
+
+    const size_t max_cache_size = bp_directivity::max_cache_size;
+    bp_directivity::max_cache_size = frequencies->size();
+    vector<double> single(1, 0.0);
+    bp_directivity::find(
+        arb, seq_vector::csptr(new seq_linear(3.0 * freq, 1.0, 1)), &single,
+        steering, sound_speed);
+    BOOST_CHECK_EQUAL(bp_directivity::misses(), frequencies->size() + 1);
+    BOOST_CHECK_EQUAL(bp_directivity::cache_size(), frequencies->size());
+    bp_directivity::find(
+        arb, seq_vector::csptr(new seq_linear((*frequencies)(1), 1.0, 1)),
+        &single, steering, sound_speed);
+    BOOST_CHECK_EQUAL(bp_directivity::misses(), frequencies->size() + 1);
+    BOOST_CHECK_EQUAL(single(0), level(1));
+    bp_directivity::find(
+        arb, seq_vector::csptr(new seq_linear((*frequencies)(0), 1.0, 1)),
+        &single, steering, sound_speed);
+    BOOST_CHECK_EQUAL(bp_directivity::misses(), frequencies->size() + 2);
+    BOOST_CHECK_EQUAL(single(0), level(0));
+    bp_directivity::max_cache_size = max_cache_size;
+    bp_directivity::clear_cache();
+}
+
+/**
+ * Tests the formation of many beams from a 500 element towed array using
+ * the matrix product in bp_arb::steered_levels(). Forms 32 beams, steered
+ * from forward to aft, for a 2 deg grid of arrivals in the horizontal
+ * plane and below it. Compares these to the one-arrival-at-a-time beam
+ * levels, and times both methods.
+ *
+ * This test passes if the two methods agree to within 1e-10 at every
+ * arrival and steering.
+ */
+BOOST_AUTO_TEST_CASE(bp_arb_steered_test) {
+    cout << "=== beampattern_test: bp_arb_steered_test ===" << endl;
+    const size_t num_elements = 500;
+    matrix<double> elem_locs(num_elements, 3);
+    bp_con_uniform(num_elements, spacing, 1, 0.0, 1, 0.0, &elem_locs);
+    bp_arb arb(elem_locs);
+
+    std::vector<bvector> steerings;
+    for (double az = 0.0; az <= 180.0; az += 180.0 / 31.0) {
+        steerings.push_back(bvector(0.0, az));
+    }
+
+    vector<double> front(46 * 180);
+    vector<double> right(46 * 180);
+    vector<double> up(46 * 180);
+    size_t n = 0;
+    for (double de = -90.0; de <= 0.0; de += 2.0) {
+        for (double az = -180.0; az < 180.0; az += 2.0, ++n) {
+            const bvector arrival(de, az);
+            front(n) = arrival.front();
+            right(n) = arrival.right();
+            up(n) = arrival.up();
+        }
+    }
+
+    matrix<double> level;
+    {
+        boost::timer::auto_cpu_timer timer("steered_levels: %w secs\n");
+        arb.steered_levels(front, right, up, freq, steerings, &level,
+                           sound_speed);
+    }
+    BOOST_REQUIRE_EQUAL(level.size1(), front.size());
+    BOOST_REQUIRE_EQUAL(level.size2(), steerings.size());
+
+    seq_vector::csptr frequencies(new seq_linear(freq, 1.0, 1));
+    vector<double> single(1);
+    double max_diff = 0.0;
+    {
+        boost::timer::auto_cpu_timer timer("beam_level: %w secs\n");
+        for (n = 0; n < front.size(); ++n) {
+            const bvector arrival(front(n), right(n), up(n));
+            for (size_t s = 0; s < steerings.size(); ++s) {
+                arb.beam_level(arrival, frequencies, &single, steerings[s],
+                               sound_speed);
+                max_diff = max(max_diff, abs(level(n, s) - single(0)));
+            }
+        }
+    }
+    cout << "max_diff=" << max_diff << endl;
+    BOOST_CHECK_SMALL(max_diff, 1e-10);
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
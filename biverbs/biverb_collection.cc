@@ -4,6 +4,8 @@
  */
 
 #include <usml/biverbs/biverb_collection.h>
+#include <usml/types/archive.h>
+#include <usml/types/seq_data.h>
 #include <usml/types/seq_vector.h>
 #include <usml/types/wposition1.h>
 #include <usml/ublas/math_traits.h>
@@ -12,11 +14,14 @@
 #include <boost/numeric/ublas/expression_types.hpp>
 #include <boost/numeric/ublas/storage.hpp>
 #include <boost/numeric/ublas/vector_expression.hpp>
+#include <algorithm>
 #include <cmath>
 #include <list>
 #include <netcdf>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 using namespace usml::biverbs;
 
@@ -32,9 +37,10 @@ double biverb_collection::power_threshold = 1e-20;
  */
 biverb_list biverb_collection::biverbs(size_t interface) const {
     read_lock_guard guard(_mutex);
+    const biverb_columns& columns = _collection[interface];
     biverb_list list;
-    for (const auto& pair : _collection[interface]) {
-        list.push_back(pair.second);
+    for (size_t n = 0; n < columns.size(); ++n) {
+        list.push_back(columns.biverb(n));
     }
     return list;
 }
@@ -46,18 +52,149 @@ void biverb_collection::add_biverb(const eigenverb_model::csptr& src_verb,
                                    const eigenverb_model::csptr& rcv_verb,
                                    const vector<double>& scatter,
                                    size_t interface) {
+    biverb_columns list;
+    if (make_biverb(*src_verb, *rcv_verb, scatter, &list)) {
+        add_biverbs(list, interface);
+    }
+}
+
+/**
+ * Adds a list of biverbs to this collection.
+ */
+void biverb_collection::add_biverbs(const biverb_columns& list,
+                                    size_t interface) {
     write_lock_guard guard(_mutex);
+    biverb_columns& columns = _collection[interface];
+    const size_t first = columns.size();
+    columns.append(list);
+    columns.sort(first);
+}
+
+/**
+ * Constructs a new bistatic eigenverb without adding it to a collection.
+ */
+biverb_model::csptr biverb_collection::make_biverb(
+    const eigenverb_model::csptr& src_verb,
+    const eigenverb_model::csptr& rcv_verb, const vector<double>& scatter) {
+    biverb_columns list;
+    if (!make_biverb(*src_verb, *rcv_verb, scatter, &list)) {
+        return nullptr;
+    }
+    return list.biverb(0);
+}
 
+/**
+ * Constructs a new bistatic eigenverb and appends it to a columnar list.
+ */
+bool biverb_collection::make_biverb(const eigenverb_model& src_verb,
+                                    const eigenverb_model& rcv_verb,
+                                    const vector<double>& scatter,
+                                    biverb_columns* columns) {
+    double duration;
+    const double overlap_scale =
+        gaussian_overlap(src_verb, rcv_verb, &duration);
+    return make_biverb(src_verb, rcv_verb, scatter, overlap_scale, duration,
+                       columns);
+}
+
+/**
+ * Constructs a new bistatic eigenverb, using an overlap that has already
+ * been computed, and appends it to a columnar list.
+ */
+bool biverb_collection::make_biverb(const eigenverb_model& src_verb,
+                                    const eigenverb_model& rcv_verb,
+                                    const vector<double>& scatter,
+                                    double overlap_scale, double duration,
+                                    biverb_columns* columns) {
+    // scale power by the overlap of the Gaussian profiles,
+    // discard biverbs that are too weak to contribute
+
+    if (columns->frequencies == nullptr) {
+        columns->frequencies = rcv_verb.frequencies;
+    }
+    const size_t num_freq = rcv_verb.power.size();
+    std::vector<double>& power = columns->power_data;
+    const size_t offset = power.size();
+    double peak = 0.0;
+    for (size_t f = 0; f < num_freq; ++f) {
+        double value = 0.25 * 0.5 * src_verb.power[f];
+        value *= rcv_verb.power[f];
+        value *= scatter[f];
+        value *= overlap_scale;
+        power.push_back(value);
+        peak = std::max(peak, std::abs(value));
+    }
+#ifdef DEBUG_BIVERB
+    cout << "\tcontribution duration=" << duration
+         << " power=" << (10.0 * log10(peak)) << endl;
+#endif
+    if (peak < power_threshold) {
+        power.resize(offset);
+        return false;
+    }
+
+    // copy data from source and receiver eigenverbs
+
+    columns->travel_time.push_back(src_verb.travel_time +
+                                   rcv_verb.travel_time);
+    columns->duration.push_back(duration);
+    columns->de_index.push_back(rcv_verb.de_index);
+    columns->az_index.push_back(rcv_verb.az_index);
+
+    columns->source_de.push_back(src_verb.source_de);
+    columns->source_az.push_back(src_verb.source_az);
+    columns->source_paths.insert(
+        columns->source_paths.end(),
+        {src_verb.surface, src_verb.bottom, src_verb.caustic, src_verb.upper,
+         src_verb.lower});
+
+    columns->receiver_de.push_back(rcv_verb.source_de);
+    columns->receiver_az.push_back(rcv_verb.source_az);
+    columns->receiver_paths.insert(
+        columns->receiver_paths.end(),
+        {rcv_verb.surface, rcv_verb.bottom, rcv_verb.caustic, rcv_verb.upper,
+         rcv_verb.lower});
+    return true;
+}
+
+/**
+ * Tests whether a source eigenverb is inside the search area of a receiver
+ * eigenverb, and can create a biverb above the power threshold.
+ */
+bool biverb_collection::can_overlap(const eigenverb_model& src_verb,
+                                    const eigenverb_model& rcv_verb,
+                                    const vector<double>& max_scatter) {
+    if (!eigenverb_collection::in_search_area(rcv_verb, src_verb)) {
+        return false;
+    }
+    const size_t num_freq = rcv_verb.power.size();
+    double peak = 0.0;
+    for (size_t f = 0; f < num_freq; ++f) {
+        double value = 0.25 * 0.5 * src_verb.power[f];
+        value *= rcv_verb.power[f];
+        value *= max_scatter[f];
+        peak = std::max(peak, std::abs(value));
+    }
+    return peak * gaussian_overlap(src_verb, rcv_verb) >= power_threshold;
+}
+
+/**
+ * Computes the overlap of the Gaussian profiles for a source and receiver
+ * eigenverb.
+ */
+double biverb_collection::gaussian_overlap(const eigenverb_model& src_verb,
+                                           const eigenverb_model& rcv_verb,
+                                           double* duration) {
     // determine relative range and bearing between Gaussians
 
     double bearing;
     const double range =
-        rcv_verb->position.gc_range(src_verb->position, &bearing);
+        rcv_verb.position.gc_range(src_verb.position, &bearing);
 
     if (range < 1e-6) {
         bearing = 0;  // fixes bearing = NaN
     }
-    bearing -= rcv_verb->direction;  // relative bearing
+    bearing -= rcv_verb.direction;  // relative bearing
 
     const double ys = range * cos(bearing);
     const double ys2 = ys * ys;
@@ -67,71 +204,45 @@ void biverb_collection::add_biverb(const eigenverb_model::csptr& src_verb,
 
 #ifdef DEBUG_BIVERB
     cout << "biverb_generator::compute_overlap() " << endl
-         << "\txs2=" << xs2 << " ys2=" << ys2 << " scatter=" << scatter << endl
+         << "\txs2=" << xs2 << " ys2=" << ys2 << endl
          << "\tsrc_verb"
-         << " t=" << src_verb->travel_time
-         << " de=" << to_degrees(src_verb->source_de)
-         << " az=" << to_degrees(src_verb->source_az)
-         << " direction=" << to_degrees(src_verb->direction)
-         << " grazing=" << to_degrees(src_verb->grazing) << endl
-         << "\tpower=" << 10.0 * log10(src_verb->power)
-         << " length=" << src_verb->length << " width=" << src_verb->width
-         << " surface=" << src_verb->surface << " bottom=" << src_verb->bottom
-         << " caustic=" << src_verb->caustic << endl
+         << " t=" << src_verb.travel_time
+         << " de=" << to_degrees(src_verb.source_de)
+         << " az=" << to_degrees(src_verb.source_az)
+         << " direction=" << to_degrees(src_verb.direction)
+         << " grazing=" << to_degrees(src_verb.grazing) << endl
+         << "\tpower=" << 10.0 * log10(src_verb.power)
+         << " length=" << src_verb.length << " width=" << src_verb.width
+         << " surface=" << src_verb.surface << " bottom=" << src_verb.bottom
+         << " caustic=" << src_verb.caustic << endl
          << "\trcv_verb"
-         << " t=" << rcv_verb->travel_time
-         << " de=" << to_degrees(rcv_verb->source_de)
-         << " az=" << to_degrees(rcv_verb->source_az)
-         << " direction=" << to_degrees(rcv_verb->direction)
-         << " grazing=" << to_degrees(rcv_verb->grazing) << endl
-         << "\tpower=" << 10.0 * log10(rcv_verb->power)
-         << " length=" << rcv_verb->length << " width=" << rcv_verb->width
-         << " surface=" << rcv_verb->surface << " bottom=" << rcv_verb->bottom
-         << " caustic=" << rcv_verb->caustic << endl;
+         << " t=" << rcv_verb.travel_time
+         << " de=" << to_degrees(rcv_verb.source_de)
+         << " az=" << to_degrees(rcv_verb.source_az)
+         << " direction=" << to_degrees(rcv_verb.direction)
+         << " grazing=" << to_degrees(rcv_verb.grazing) << endl
+         << "\tpower=" << 10.0 * log10(rcv_verb.power)
+         << " length=" << rcv_verb.length << " width=" << rcv_verb.width
+         << " surface=" << rcv_verb.surface << " bottom=" << rcv_verb.bottom
+         << " caustic=" << rcv_verb.caustic << endl;
 #endif
-    // copy data from source and receiver eigenverbs
-
-    auto* biverb = new biverb_model();
-    biverb->travel_time = src_verb->travel_time + rcv_verb->travel_time;
-    biverb->frequencies = rcv_verb->frequencies;
-    biverb->de_index = rcv_verb->de_index;
-    biverb->az_index = rcv_verb->az_index;
-
-    biverb->source_de = src_verb->source_de;
-    biverb->source_az = src_verb->source_az;
-
-    biverb->source_surface = src_verb->surface;
-    biverb->source_bottom = src_verb->bottom;
-    biverb->source_caustic = src_verb->caustic;
-    biverb->source_upper = src_verb->upper;
-    biverb->source_lower = src_verb->lower;
-
-    biverb->receiver_de = rcv_verb->source_de;
-    biverb->receiver_az = rcv_verb->source_az;
-
-    biverb->receiver_surface = rcv_verb->surface;
-    biverb->receiver_bottom = rcv_verb->bottom;
-    biverb->receiver_caustic = rcv_verb->caustic;
-    biverb->receiver_upper = rcv_verb->upper;
-    biverb->receiver_lower = rcv_verb->lower;
-
     // determine the relative tilt between the projected Gaussians
 
-    const double alpha = src_verb->direction - rcv_verb->direction;
+    const double alpha = src_verb.direction - rcv_verb.direction;
     const double cos2alpha = cos(2.0 * alpha);
     const double sin2alpha = sin(2.0 * alpha);
 
     // compute commonly used terms in the intersection of the Gaussian
     // profiles
 
-    auto src_length2 = src_verb->length * src_verb->length;
-    auto src_width2 = src_verb->width * src_verb->width;
+    auto src_length2 = src_verb.length * src_verb.length;
+    auto src_width2 = src_verb.width * src_verb.width;
     const double src_sum = src_length2 + src_width2;
     const double src_diff = src_length2 - src_width2;
     const double src_prod = src_length2 * src_width2;
 
-    auto rcv_length2 = rcv_verb->length * rcv_verb->length;
-    auto rcv_width2 = rcv_verb->width * rcv_verb->width;
+    auto rcv_length2 = rcv_verb.length * rcv_verb.length;
+    auto rcv_width2 = rcv_verb.width * rcv_verb.width;
     const double rcv_sum = rcv_length2 + rcv_width2;
     const double rcv_diff = rcv_length2 - rcv_width2;
     const double rcv_prod = rcv_length2 * rcv_width2;
@@ -141,7 +252,6 @@ void biverb_collection::add_biverb(const eigenverb_model::csptr& src_verb,
 
     double det_sr = 0.5 * (2.0 * (src_prod + rcv_prod) + (src_sum * rcv_sum) -
                            (src_diff * rcv_diff) * cos2alpha);
-    biverb->power = 0.25 * 0.5 * src_verb->power * rcv_verb->power * scatter;
 
     // compute the power of the exponential
     // equation (28) from the paper
@@ -153,12 +263,12 @@ void biverb_collection::add_biverb(const eigenverb_model::csptr& src_verb,
                           2.0 * sqrt(xs2 * ys2) * src_diff * sin2alpha) /
                          det_sr;
 #ifdef DEBUG_BIVERB
-    cout << "\tdet_sr=" << det_sr << " kappa=" << kappa
-         << " scatter=" << (10.0 * log10(scatter))
-         << " power=" << (10.0 * log10(biverb->power)) << endl;
+    cout << "\tdet_sr=" << det_sr << " kappa=" << kappa << endl;
 #endif
     const double overlap_scale = exp(kappa) / sqrt(det_sr);
-    biverb->power *= overlap_scale;
+    if (duration == nullptr) {
+        return overlap_scale;
+    }
 
     // compute the square of the duration of the overlap
     // equation (41) from the paper
@@ -173,19 +283,9 @@ void biverb_collection::add_biverb(const eigenverb_model::csptr& src_verb,
     // combine duration of the overlap with pulse length
     // equation (33) from the paper
 
-    const double factor = cos(rcv_verb->grazing) / rcv_verb->sound_speed;
-    biverb->duration = 0.5 * factor * sqrt(sigma);
-#ifdef DEBUG_BIVERB
-    cout << "\tcontribution duration=" << biverb->duration
-         << " power=" << (10.0 * log10(biverb->power)) << endl;
-#endif
-
-    // add to collection
-
-    auto verb = biverb_model::csptr(biverb);
-    if (norm_inf(biverb->power) >= power_threshold) {
-        _collection[interface].insert({verb->travel_time, verb});
-    }
+    const double factor = cos(rcv_verb.grazing) / rcv_verb.sound_speed;
+    *duration = 0.5 * factor * sqrt(sigma);
+    return overlap_scale;
 }
 
 /**
@@ -342,3 +442,158 @@ void biverb_collection::write_netcdf(const char* filename,
         // clang-format on
     }
 }
+
+/**
+ * Reads the biverbs for a single interface from a netcdf file.
+ */
+void biverb_collection::read_netcdf(const char* filename, size_t interface) {
+    netCDF::NcFile nc_file(filename, netCDF::NcFile::read);
+    netCDF::NcDim biverb_dim = nc_file.getDim("eigenverbs");
+    netCDF::NcDim freq_dim = nc_file.getDim("frequencies");
+    if (biverb_dim.isNull() || freq_dim.isNull()) {
+        return;  // no biverbs for this interface
+    }
+    const size_t num_verbs = biverb_dim.getSize();
+    const size_t num_freq = freq_dim.getSize();
+
+    // read each variable with a single call
+
+    auto read = [&](const char* name, auto* values, size_t size) {
+        values->resize(size);
+        if (size > 0) {
+            nc_file.getVar(name).getVar(values->data());
+        }
+    };
+    std::vector<double> frequencies;
+    read("frequencies", &frequencies, num_freq);
+    biverb_columns list;
+    list.frequencies.reset(new seq_data(frequencies.data(), num_freq));
+    read("travel_time", &list.travel_time, num_verbs);
+    read("power", &list.power_data, num_verbs * num_freq);
+    read("duration", &list.duration, num_verbs);
+    read("source_de", &list.source_de, num_verbs);
+    read("source_az", &list.source_az, num_verbs);
+    read("receiver_de", &list.receiver_de, num_verbs);
+    read("receiver_az", &list.receiver_az, num_verbs);
+
+    std::vector<int> index;
+    read("de_index", &index, num_verbs);
+    list.de_index.assign(index.begin(), index.end());
+    read("az_index", &index, num_verbs);
+    list.az_index.assign(index.begin(), index.end());
+
+    // convert to the units used by biverb_columns
+
+    for (double& power : list.power_data) {
+        power = pow(10.0, power / 10.0);
+    }
+    for (auto* angles : {&list.source_de, &list.source_az, &list.receiver_de,
+                         &list.receiver_az}) {
+        for (double& angle : *angles) {
+            angle = to_radians(angle);
+        }
+    }
+
+    // interleave path counts, five values per biverb
+
+    const char* const names[] = {"surface", "bottom", "caustic", "upper",
+                                 "lower"};
+    list.source_paths.resize(num_verbs * 5);
+    list.receiver_paths.resize(num_verbs * 5);
+    std::vector<int> counts;
+    for (size_t p = 0; p < 5; ++p) {
+        read((std::string("source_") + names[p]).c_str(), &counts, num_verbs);
+        for (size_t n = 0; n < num_verbs; ++n) {
+            list.source_paths[n * 5 + p] = counts[n];
+        }
+        read((std::string("receiver_") + names[p]).c_str(), &counts,
+             num_verbs);
+        for (size_t n = 0; n < num_verbs; ++n) {
+            list.receiver_paths[n * 5 + p] = counts[n];
+        }
+    }
+    add_biverbs(list, interface);
+}
+
+/**
+ * Writes the biverbs for all interfaces to a binary archive.
+ */
+void biverb_collection::write_archive(const char* filename) const {
+    read_lock_guard guard(_mutex);
+    archive_writer archive(filename, "biverbs");
+    archive.write_value("num_interfaces", (uint64_t)_collection.size());
+    for (size_t interface = 0; interface < _collection.size(); ++interface) {
+        const biverb_columns& columns = _collection[interface];
+        const std::string prefix =
+            "interface" + std::to_string(interface) + "/";
+        std::vector<double> frequencies;
+        if (columns.frequencies != nullptr) {
+            const auto data = columns.frequencies->data();
+            frequencies.assign(data.begin(), data.end());
+        }
+        archive.write(prefix + "frequencies", frequencies);
+        archive.write(prefix + "travel_time", columns.travel_time);
+        archive.write(prefix + "power", columns.power_data);
+        archive.write(prefix + "duration", columns.duration);
+        archive.write(prefix + "de_index", columns.de_index);
+        archive.write(prefix + "az_index", columns.az_index);
+        archive.write(prefix + "source_de", columns.source_de);
+        archive.write(prefix + "source_az", columns.source_az);
+        archive.write(prefix + "receiver_de", columns.receiver_de);
+        archive.write(prefix + "receiver_az", columns.receiver_az);
+        archive.write(prefix + "source_paths", columns.source_paths);
+        archive.write(prefix + "receiver_paths", columns.receiver_paths);
+    }
+    archive.close();
+}
+
+/**
+ * Replaces the biverbs for all interfaces with the contents of a
+ * binary archive.
+ */
+void biverb_collection::read_archive(const char* filename) {
+    archive_reader archive(filename, "biverbs");
+    const auto num_interfaces = archive.value<uint64_t>("num_interfaces");
+    std::vector<biverb_columns> collection(num_interfaces);
+    for (size_t interface = 0; interface < num_interfaces; ++interface) {
+        biverb_columns& columns = collection[interface];
+        const std::string prefix =
+            "interface" + std::to_string(interface) + "/";
+        size_t num_freq;
+        const double* freq =
+            archive.data<double>(prefix + "frequencies", &num_freq);
+        if (num_freq > 0) {
+            columns.frequencies.reset(new seq_data(freq, num_freq));
+        }
+        archive.read(prefix + "travel_time", &columns.travel_time);
+        archive.read(prefix + "power", &columns.power_data);
+        archive.read(prefix + "duration", &columns.duration);
+        archive.read(prefix + "de_index", &columns.de_index);
+        archive.read(prefix + "az_index", &columns.az_index);
+        archive.read(prefix + "source_de", &columns.source_de);
+        archive.read(prefix + "source_az", &columns.source_az);
+        archive.read(prefix + "receiver_de", &columns.receiver_de);
+        archive.read(prefix + "receiver_az", &columns.receiver_az);
+        archive.read(prefix + "source_paths", &columns.source_paths);
+        archive.read(prefix + "receiver_paths", &columns.receiver_paths);
+
+        const size_t num_verbs = columns.size();
+        const bool valid = columns.power_data.size() == num_verbs * num_freq &&
+                           columns.duration.size() == num_verbs &&
+                           columns.de_index.size() == num_verbs &&
+                           columns.az_index.size() == num_verbs &&
+                           columns.source_de.size() == num_verbs &&
+                           columns.source_az.size() == num_verbs &&
+                           columns.receiver_de.size() == num_verbs &&
+                           columns.receiver_az.size() == num_verbs &&
+                           columns.source_paths.size() == num_verbs * 5 &&
+                           columns.receiver_paths.size() == num_verbs * 5;
+        if (!valid) {
+            throw std::invalid_argument(std::string("biverb archive ") +
+                                        filename + ": bad " + prefix +
+                                        "columns");
+        }
+    }
+    write_lock_guard guard(_mutex);
+    _collection.swap(collection);
+}
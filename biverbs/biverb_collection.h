@@ -4,14 +4,15 @@
  */
 #pragma once
 
+#include <usml/biverbs/biverb_columns.h>
 #include <usml/biverbs/biverb_model.h>
+#include <usml/eigenverbs/eigenverb_collection.h>
 #include <usml/eigenverbs/eigenverb_model.h>
 #include <usml/threads/read_write_lock.h>
 #include <usml/usml_config.h>
 
 #include <boost/numeric/ublas/vector.hpp>
 #include <cstddef>
-#include <map>
 #include <memory>
 #include <vector>
 
@@ -35,15 +36,16 @@ using namespace usml::threads;
  *      volume scattering layer, if it exists.
  *    - Subsequent columns provide the upper and lower
  *      interfaces for additional volume scattering layers.
+ *
+ * The biverbs for each interface are stored in a biverb_columns structure,
+ * sorted by travel time. Biverbs are normally added in bulk, using
+ * add_biverbs(), so that each interface is only sorted once per addition.
  */
 class USML_DECLSPEC biverb_collection {
    public:
     /// Shared const pointer to an biverb _collection.
     typedef std::shared_ptr<const biverb_collection> csptr;
 
-    /// Map of biverbs, sorted by time.
-    typedef std::multimap<double, biverb_model::csptr> map;
-
     /**
      * Threshold for minimum biverb power.
      */
@@ -76,7 +78,21 @@ class USML_DECLSPEC biverb_collection {
     }
 
     /**
-     * Creates list of biverbs for a specific interface.
+     * Columnar storage for the biverbs of a specific interface, sorted by
+     * travel time. Does not lock the collection, so the reference is only
+     * valid while no biverbs are being added.
+     *
+     * @param interface Interface number of the desired list of biverbs.
+     *                  See the class header for documentation on interpreting
+     *                  this number.
+     */
+    const biverb_columns& columns(size_t interface) const {
+        return _collection[interface];
+    }
+
+    /**
+     * Creates list of biverbs for a specific interface. Creates a new
+     * biverb_model for each biverb, use columns() to avoid this overhead.
      *
      * @param interface Interface number of the desired list of biverbs.
      *                  See the class header for documentation on interpreting
@@ -98,6 +114,96 @@ class USML_DECLSPEC biverb_collection {
                     const eigenverb_model::csptr& rcv_verb,
                     const vector<double>& scatter, size_t interface);
 
+    /**
+     * Constructs a new bistatic eigenverb without adding it to a collection.
+     * Does not lock the collection, so it can be used by multiple threads
+     * to build up private lists of biverbs that are later merged using
+     * add_biverbs().
+     *
+     * @param src_verb	Source eigenverb to be processed.
+     * @param rcv_verb	Receiver eigenverb to be processed.
+     * @param scatter	Scattering strength vs. frequency.
+     * @return          New biverb, nullptr if its power is below
+     *                  power_threshold at all frequencies.
+     */
+    static biverb_model::csptr make_biverb(
+        const eigenverb_model::csptr& src_verb,
+        const eigenverb_model::csptr& rcv_verb, const vector<double>& scatter);
+
+    /**
+     * Constructs a new bistatic eigenverb and appends it to a columnar list
+     * of biverbs, without creating a biverb_model. Does not sort the list.
+     * Does not lock the collection, so it can be used by multiple threads
+     * to build up private lists of biverbs that are later merged using
+     * add_biverbs().
+     *
+     * @param src_verb	Source eigenverb to be processed.
+     * @param rcv_verb	Receiver eigenverb to be processed.
+     * @param scatter	Scattering strength vs. frequency.
+     * @param columns   List of biverbs to append new biverb to.
+     * @return          False if its power is below power_threshold at
+     *                  all frequencies, and the biverb was not added.
+     */
+    static bool make_biverb(const eigenverb_model& src_verb,
+                            const eigenverb_model& rcv_verb,
+                            const vector<double>& scatter,
+                            biverb_columns* columns);
+
+    /**
+     * Constructs a new bistatic eigenverb, using an overlap that has already
+     * been computed, and appends it to a columnar list of biverbs. Used with
+     * the results of biverb_overlap, which computes the overlap for many
+     * source eigenverbs at once.
+     *
+     * @param src_verb	    Source eigenverb to be processed.
+     * @param rcv_verb	    Receiver eigenverb to be processed.
+     * @param scatter	    Scattering strength vs. frequency.
+     * @param overlap_scale Overlap scale factor from biverb_overlap.
+     * @param duration      Duration of the overlap from biverb_overlap.
+     * @param columns       List of biverbs to append new biverb to.
+     * @return              False if its power is below power_threshold at
+     *                      all frequencies, and the biverb was not added.
+     */
+    static bool make_biverb(const eigenverb_model& src_verb,
+                            const eigenverb_model& rcv_verb,
+                            const vector<double>& scatter,
+                            double overlap_scale, double duration,
+                            biverb_columns* columns);
+
+    /**
+     * Tests whether a source eigenverb is close enough to a receiver
+     * eigenverb to create a biverb above power_threshold. The source
+     * eigenverb must be inside the same oriented diamond as
+     * eigenverb_collection::find_eigenverbs(), centered on the receiver
+     * eigenverb and scaled by eigenverb_collection::search_scale. Then the
+     * exact Gaussian overlap of make_biverb() is combined with an upper
+     * limit on the scattering strength, from
+     * scattering_model::max_scattering(), to compute an upper limit on the
+     * biverb power. Because the scattering strength passed to make_biverb()
+     * is never larger than this limit, pairs rejected by this test would
+     * also be rejected by make_biverb().
+     *
+     * @param src_verb	    Source eigenverb to be processed.
+     * @param rcv_verb	    Receiver eigenverb to be processed.
+     * @param max_scatter   Upper limit on scattering strength vs. frequency,
+     *                      for the interface of these eigenverbs.
+     * @return              False if make_biverb() would discard this pair.
+     */
+    static bool can_overlap(const eigenverb_model& src_verb,
+                            const eigenverb_model& rcv_verb,
+                            const vector<double>& max_scatter);
+
+    /**
+     * Adds a list of biverbs, created by make_biverb(), to this collection.
+     * Locks the collection once for the whole list, and sorts the interface
+     * once. Biverbs with the same travel time are kept in the order that
+     * they were added.
+     *
+     * @param list      Biverbs to add to the collection.
+     * @param interface Interface number for this addition.
+     */
+    void add_biverbs(const biverb_columns& list, size_t interface);
+
     /**
      * Writes the biverbs for an individual interface to a netcdf file.
      * There are separate variables for each biverb component,
@@ -106,12 +212,60 @@ class USML_DECLSPEC biverb_collection {
      */
     void write_netcdf(const char* filename, size_t interface) const;
 
+    /**
+     * Reads the biverbs for a single interface from a netCDF file created
+     * by write_netcdf(), and adds them to this collection. Each variable is
+     * read with a single call. Files for interfaces without biverbs are
+     * ignored.
+     *
+     * @param filename      Filename used to retrieve this data.
+     * @param interface     Interface number for this list of biverbs.
+     */
+    void read_netcdf(const char* filename, size_t interface);
+
+    /**
+     * Writes the biverbs for all interfaces to a binary archive. Each
+     * column of the biverb_columns for each interface is written as a
+     * single contiguous array, in travel time order. Archives are much
+     * faster to write and read than netCDF files, but they can only be
+     * read on hosts with the same byte order.
+     *
+     * @param filename      Name of the archive file.
+     */
+    void write_archive(const char* filename) const;
+
+    /**
+     * Replaces the biverbs for all interfaces with the contents of a
+     * binary archive created by write_archive(). Uses one bulk copy per
+     * column, and does not need to sort the biverbs again.
+     *
+     * @param filename          Name of the archive file.
+     * @throws invalid_argument If the file is not a biverb archive.
+     */
+    void read_archive(const char* filename);
+
    private:
+    /**
+     * Computes the overlap of the Gaussian profiles for a source and
+     * receiver eigenverb. Implements equations (26), (28), (33), and (41)
+     * from the paper.
+     *
+     * @param src_verb	Source eigenverb to be processed.
+     * @param rcv_verb	Receiver eigenverb to be processed.
+     * @param duration  Duration of the overlap (output), not computed if
+     *                  this is nullptr.
+     * @return          Scale factor applied to the product of the source
+     *                  and receiver power.
+     */
+    static double gaussian_overlap(const eigenverb_model& src_verb,
+                                   const eigenverb_model& rcv_verb,
+                                   double* duration = nullptr);
+
     /// Mutex to that locks object during changes.
     mutable read_write_lock _mutex;
 
-    /// Spatial index for each interface.
-    std::vector<map> _collection;
+    /// Biverbs for each interface, sorted by travel time.
+    std::vector<biverb_columns> _collection;
 };
 
 /// @}
@@ -0,0 +1,173 @@
+/**
+ * @file biverb_columns.cc
+ * Columnar storage for a list of biverbs, sorted by travel time.
+ */
+
+#include <usml/biverbs/biverb_columns.h>
+
+#include <algorithm>
+#include <boost/numeric/ublas/vector.hpp>
+#include <numeric>
+
+using namespace usml::biverbs;
+
+namespace {
+
+/// Number of path counts stored for each biverb.
+const size_t NUM_PATHS = 5;
+
+/**
+ * Reorders an array with a stride of "width" values per biverb.
+ */
+template <class T>
+void permute(std::vector<T>* values, const std::vector<size_t>& order,
+             size_t width = 1) {
+    std::vector<T> result(values->size());
+    auto dest = result.begin();
+    for (size_t index : order) {
+        auto src = values->begin() + index * width;
+        dest = std::copy(src, src + width, dest);
+    }
+    values->swap(result);
+}
+
+}  // namespace
+
+/**
+ * Appends a single biverb to the end of this list.
+ */
+void biverb_columns::push_back(const biverb_model& verb) {
+    if (frequencies == nullptr) {
+        frequencies = verb.frequencies;
+    }
+    travel_time.push_back(verb.travel_time);
+    power_data.insert(power_data.end(), verb.power.begin(), verb.power.end());
+    duration.push_back(verb.duration);
+    de_index.push_back(verb.de_index);
+    az_index.push_back(verb.az_index);
+    source_de.push_back(verb.source_de);
+    source_az.push_back(verb.source_az);
+    receiver_de.push_back(verb.receiver_de);
+    receiver_az.push_back(verb.receiver_az);
+    source_paths.insert(source_paths.end(),
+                        {verb.source_surface, verb.source_bottom,
+                         verb.source_caustic, verb.source_upper,
+                         verb.source_lower});
+    receiver_paths.insert(receiver_paths.end(),
+                          {verb.receiver_surface, verb.receiver_bottom,
+                           verb.receiver_caustic, verb.receiver_upper,
+                           verb.receiver_lower});
+}
+
+/**
+ * Appends another list of biverbs to the end of this one.
+ */
+void biverb_columns::append(const biverb_columns& other) {
+    if (other.empty()) {
+        return;
+    }
+    if (frequencies == nullptr) {
+        frequencies = other.frequencies;
+    }
+    auto join = [](auto* dest, const auto& src) {
+        dest->insert(dest->end(), src.begin(), src.end());
+    };
+    join(&travel_time, other.travel_time);
+    join(&power_data, other.power_data);
+    join(&duration, other.duration);
+    join(&de_index, other.de_index);
+    join(&az_index, other.az_index);
+    join(&source_de, other.source_de);
+    join(&source_az, other.source_az);
+    join(&receiver_de, other.receiver_de);
+    join(&receiver_az, other.receiver_az);
+    join(&source_paths, other.source_paths);
+    join(&receiver_paths, other.receiver_paths);
+}
+
+/**
+ * Stable sort of the biverbs by travel time.
+ */
+void biverb_columns::sort(size_t first) {
+    if (std::is_sorted(travel_time.begin(), travel_time.end())) {
+        return;
+    }
+
+    // sort new biverbs, and merge them with the ones already sorted
+
+    first = std::min(first, size());
+    std::vector<size_t> order(size());
+    std::iota(order.begin(), order.end(), 0);
+    auto compare = [this](size_t a, size_t b) {
+        return travel_time[a] < travel_time[b];
+    };
+    std::stable_sort(order.begin() + first, order.end(), compare);
+    std::inplace_merge(order.begin(), order.begin() + first, order.end(),
+                       compare);
+
+    // move each column into sorted order
+
+    permute(&travel_time, order);
+    permute(&power_data, order, num_frequencies());
+    permute(&duration, order);
+    permute(&de_index, order);
+    permute(&az_index, order);
+    permute(&source_de, order);
+    permute(&source_az, order);
+    permute(&receiver_de, order);
+    permute(&receiver_az, order);
+    permute(&source_paths, order, NUM_PATHS);
+    permute(&receiver_paths, order, NUM_PATHS);
+}
+
+/**
+ * Creates a new biverb_model from a single element of this list.
+ */
+biverb_model::csptr biverb_columns::biverb(size_t index) const {
+    auto* verb = new biverb_model();
+    verb->travel_time = travel_time[index];
+    verb->frequencies = frequencies;
+    const size_t num_freq = num_frequencies();
+    verb->power.resize(num_freq);
+    std::copy(power(index), power(index) + num_freq, verb->power.begin());
+    verb->duration = duration[index];
+    verb->de_index = de_index[index];
+    verb->az_index = az_index[index];
+    verb->source_de = source_de[index];
+    verb->source_az = source_az[index];
+    verb->receiver_de = receiver_de[index];
+    verb->receiver_az = receiver_az[index];
+
+    const int* paths = &source_paths[index * NUM_PATHS];
+    verb->source_surface = paths[0];
+    verb->source_bottom = paths[1];
+    verb->source_caustic = paths[2];
+    verb->source_upper = paths[3];
+    verb->source_lower = paths[4];
+
+    paths = &receiver_paths[index * NUM_PATHS];
+    verb->receiver_surface = paths[0];
+    verb->receiver_bottom = paths[1];
+    verb->receiver_caustic = paths[2];
+    verb->receiver_upper = paths[3];
+    verb->receiver_lower = paths[4];
+    return biverb_model::csptr(verb);
+}
+
+/**
+ * Removes all biverbs from this list.
+ */
+void biverb_columns::clear() {
+    frequencies = nullptr;
+    travel_time.clear();
+    power_data.clear();
+    duration.clear();
+    de_index.clear();
+    az_index.clear();
+    source_de.clear();
+    source_az.clear();
+    receiver_de.clear();
+    receiver_az.clear();
+    source_paths.clear();
+    receiver_paths.clear();
+}
@@ -0,0 +1,145 @@
+/**
+ * @file biverb_columns.h
+ * Columnar storage for a list of biverbs, sorted by travel time.
+ */
+#pragma once
+
+#include <usml/biverbs/biverb_model.h>
+#include <usml/types/seq_vector.h>
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace usml {
+namespace biverbs {
+
+using namespace usml::types;
+
+/// @ingroup biverbs
+/// @{
+
+/**
+ * Columnar storage for a list of biverbs. Each attribute of biverb_model is
+ * stored in its own contiguous array, and the power of all biverbs is
+ * stored in a single row major matrix, with one row per biverb and one
+ * column per frequency. This avoids the heap allocation of a biverb_model,
+ * a shared pointer control block, and a power vector for each biverb.
+ * It also allows loops over biverbs, like the reverberation time series
+ * calculation, to read memory sequentially.
+ *
+ * Biverbs are appended in bulk, and then sorted by travel time once,
+ * using a stable sort so that biverbs with the same travel time are kept in
+ * the order that they were added. All biverbs in a list must use the same
+ * frequencies. Elements are retrieved by their position in the list, from 0
+ * to size()-1. The biverb() method converts a single element back into a
+ * biverb_model, for code that needs the old interface.
+ */
+class USML_DECLSPEC biverb_columns {
+   public:
+    /**
+     * Number of biverbs in this list.
+     */
+    size_t size() const { return travel_time.size(); }
+
+    /**
+     * True if this list has no biverbs.
+     */
+    bool empty() const { return travel_time.empty(); }
+
+    /**
+     * Number of frequencies in each row of the power matrix.
+     */
+    size_t num_frequencies() const {
+        return (frequencies == nullptr) ? 0 : frequencies->size();
+    }
+
+    /**
+     * Pointer to the power of a single biverb, one value per frequency.
+     *
+     * @param index     Position of the biverb in this list.
+     */
+    const double* power(size_t index) const {
+        return &power_data[index * num_frequencies()];
+    }
+
+    /**
+     * Appends a single biverb to the end of this list. Does not sort the
+     * list, callers must use sort() when all biverbs have been appended.
+     *
+     * @param verb      Biverb to be appended.
+     */
+    void push_back(const biverb_model& verb);
+
+    /**
+     * Appends another list of biverbs to the end of this one. Does not sort
+     * the list, callers must use sort() when all biverbs have been appended.
+     *
+     * @param other     List of biverbs to be appended.
+     */
+    void append(const biverb_columns& other);
+
+    /**
+     * Stable sort of the biverbs by travel time. Assumes that all biverbs
+     * before the position "first" are already sorted, so that only the
+     * new biverbs need to be sorted before they are merged with the
+     * existing ones. Does nothing if the list is already in order.
+     *
+     * @param first     Position of the first biverb that may be out of order.
+     */
+    void sort(size_t first = 0);
+
+    /**
+     * Creates a new biverb_model from a single element of this list.
+     *
+     * @param index     Position of the biverb in this list.
+     */
+    biverb_model::csptr biverb(size_t index) const;
+
+    /**
+     * Removes all biverbs from this list.
+     */
+    void clear();
+
+    /// Frequencies of the wavefront (Hz), shared by all biverbs.
+    seq_vector::csptr frequencies;
+
+    /// Two way travel time for each biverb (sec).
+    std::vector<double> travel_time;
+
+    /// Power for each biverb and frequency, row major.
+    std::vector<double> power_data;
+
+    /// Echo duration for each biverb (sec).
+    std::vector<double> duration;
+
+    /// Index number of the launch DE at the receiver.
+    std::vector<size_t> de_index;
+
+    /// Index number of the launch AZ at the receiver.
+    std::vector<size_t> az_index;
+
+    /// Launch DE angle at the source (radians, positive is up).
+    std::vector<double> source_de;
+
+    /// Launch AZ angle at the source (radians, clockwise from true north).
+    std::vector<double> source_az;
+
+    /// Launch DE angle at the receiver (radians, positive is up).
+    std::vector<double> receiver_de;
+
+    /// Launch AZ angle at the receiver (radians, clockwise from true north).
+    std::vector<double> receiver_az;
+
+    /// Number of surface, bottom, caustic, upper, and lower vertices along
+    /// the source path, five values per biverb.
+    std::vector<int> source_paths;
+
+    /// Number of surface, bottom, caustic, upper, and lower vertices along
+    /// the receiver path, five values per biverb.
+    std::vector<int> receiver_paths;
+};
+
+/// @}
+}  // end of namespace biverbs
+}  // end of namespace usml
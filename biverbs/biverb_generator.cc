@@ -4,21 +4,47 @@
  */
 
 #include <usml/biverbs/biverb_generator.h>
+#include <usml/biverbs/biverb_overlap.h>
 #include <usml/eigenverbs/eigenverb_model.h>
 #include <usml/managed/managed_obj.h>
 #include <usml/ocean/ocean_model.h>
 #include <usml/ocean/ocean_shared.h>
 #include <usml/sensors/sensor_manager.h>
+#include <usml/threads/parallel_for.h>
 #include <usml/types/seq_vector.h>
 
+#include <algorithm>
 #include <boost/numeric/ublas/vector.hpp>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <vector>
 
 using namespace usml::biverbs;
 
 #define DEBUG_BIVERB
 
+/**
+ * Number of receiver eigenverbs processed as a single unit of parallel work.
+ */
+size_t biverb_generator::chunk_size = 64;
+
+/**
+ * Extra time added to the end of the travel time window used by the
+ * sensor_pair.
+ */
+double biverb_generator::time_padding(const transmit_list& schedule,
+                                      double duration) {
+    if (schedule.empty()) {
+        return std::numeric_limits<double>::max();
+    }
+    double pulse = 0.0;
+    for (const auto& transmit : schedule) {
+        pulse = std::max(pulse, transmit->duration);
+    }
+    return 5.0 * (pulse + duration);
+}
+
 /**
  * Copies time series computation parameters from static memory into
  * this specific task.
@@ -26,10 +52,13 @@ using namespace usml::biverbs;
 biverb_generator::biverb_generator(
     const sensor_pair::sptr& pair,
     const eigenverb_collection::csptr& src_eigenverbs,
-    const eigenverb_collection::csptr& rcv_eigenverbs)
+    const eigenverb_collection::csptr& rcv_eigenverbs, double time_minimum,
+    double time_maximum)
     : _sensor_pair(pair),
       _src_eigenverbs(src_eigenverbs),
-      _rcv_eigenverbs(rcv_eigenverbs) {
+      _rcv_eigenverbs(rcv_eigenverbs),
+      _time_minimum(time_minimum),
+      _time_maximum(time_maximum) {
     add_listener(pair.get());
 }
 
@@ -45,35 +74,89 @@ void biverb_generator::run() {
     cout << "task #" << id()
          << " biverb_generator: " << _sensor_pair->description() << endl;
 
-    // initialize workspace for results
+    // split receiver eigenverbs into chunks for each interface
 
+    struct chunk {
+        size_t interface;
+        size_t first;
+        size_t last;
+    };
     auto ocean = ocean_shared::current();
-    auto freq = sensor_manager::instance()->frequencies();
-    const size_t num_freq = freq->size();
-    vector<double> scatter(num_freq, 0.0);
-    auto* collection = new biverb_collection(ocean->num_volume());
-
-    // loop through eigenverbs for each interface
-
+    const size_t num_freq = sensor_manager::instance()->frequencies()->size();
+    const size_t max_size = std::max((size_t)1, chunk_size);
     auto num_interfaces = _rcv_eigenverbs->num_interfaces();
+    std::vector<chunk> chunks;
     for (size_t interface = 0; interface < num_interfaces; ++interface) {
-        for (const auto& rcv_verb : _rcv_eigenverbs->eigenverbs(interface)) {
-            eigenverb_list found_verbs =
-                _src_eigenverbs->find_eigenverbs(rcv_verb, interface);
-            for (const auto& src_verb : found_verbs) {
-                ocean->scattering(interface, rcv_verb->position,
-                                  rcv_verb->frequencies, src_verb->grazing,
-                                  rcv_verb->grazing, src_verb->direction,
-                                  rcv_verb->direction, &scatter);
-                collection->add_biverb(src_verb, rcv_verb, scatter, interface);
-                if (_abort) {
-                    cout << "task #" << id()
-                         << " biverb_generator *** aborted during execution ***"
-                         << endl;
-                    return;
-                }
+        const size_t num_verbs = _rcv_eigenverbs->size(interface);
+        for (size_t first = 0; first < num_verbs; first += max_size) {
+            chunks.push_back(
+                {interface, first, std::min(first + max_size, num_verbs)});
+        }
+    }
+
+    // compute the biverbs for each chunk in parallel,
+    // each chunk writes to its own list of results,
+    // and reuses the same memory for the search results and eigenverbs
+
+    std::vector<biverb_columns> results(chunks.size());
+    auto body = [&](size_t n) {
+        const chunk& work = chunks[n];
+        const eigenverb_columns& rcv_columns =
+            _rcv_eigenverbs->columns(work.interface);
+        const eigenverb_columns& src_columns =
+            _src_eigenverbs->columns(work.interface);
+        vector<double> scatter(num_freq, 0.0);
+        vector<double> max_scatter(num_freq, 0.0);
+        ocean->max_scattering(work.interface, rcv_columns.frequencies,
+                              &max_scatter);
+        std::vector<size_t> found;
+        biverb_overlap overlap;
+        eigenverb_model rcv_verb;
+        eigenverb_model src_verb;
+        for (size_t r = work.first; r < work.last; ++r) {
+            const double rcv_time = rcv_columns.travel_time[r];
+            if (rcv_time > _time_maximum) {
+                continue;
+            }
+            rcv_columns.eigenverb(r, &rcv_verb);
+            _src_eigenverbs->find_eigenverbs(rcv_verb, work.interface, &found,
+                                             _time_minimum - rcv_time,
+                                             _time_maximum - rcv_time);
+            overlap.compute(rcv_verb, *_src_eigenverbs, work.interface, found,
+                            max_scatter);
+            for (size_t k = 0; k < overlap.size(); ++k) {
+                src_columns.eigenverb(overlap.index(k), &src_verb);
+                ocean->scattering(work.interface, rcv_verb.position,
+                                  rcv_verb.frequencies, src_verb.grazing,
+                                  rcv_verb.grazing, src_verb.direction,
+                                  rcv_verb.direction, &scatter);
+                biverb_collection::make_biverb(
+                    src_verb, rcv_verb, scatter, overlap.overlap_scale(k),
+                    overlap.duration(k), &results[n]);
             }
         }
+    };
+    if (!parallel_for::run(chunks.size(), body, &_abort, priority())) {
+        cout << "task #" << id()
+             << " biverb_generator *** aborted during execution ***" << endl;
+        return;
+    }
+
+    // merge the results of each chunk, in order,
+    // so that each interface is only sorted once
+
+    auto* collection = new biverb_collection(ocean->num_volume());
+    for (size_t first = 0; first < chunks.size();) {
+        const size_t interface = chunks[first].interface;
+        biverb_columns& merged = results[first];
+        size_t last = first + 1;
+        for (; last < chunks.size() && chunks[last].interface == interface;
+             ++last) {
+            merged.append(results[last]);
+            results[last].clear();
+        }
+        collection->add_biverbs(merged, interface);
+        first = last;
     }
     _collection = biverb_collection::csptr(collection);
     _done = true;
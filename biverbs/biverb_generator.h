@@ -9,8 +9,11 @@
 #include <usml/managed/update_notifier.h>
 #include <usml/sensors/sensor_pair.h>
 #include <usml/threads/thread_task.h>
+#include <usml/transmit/transmit_model.h>
 #include <usml/usml_config.h>
 
+#include <limits>
+
 namespace usml {
 namespace biverbs {
 
@@ -18,6 +21,7 @@ using namespace usml::eigenverbs;
 using namespace usml::managed;
 using namespace usml::sensors;
 using namespace usml::threads;
+using namespace usml::transmit;
 
 /// @ingroup biverbs
 /// @{
@@ -29,11 +33,51 @@ using namespace usml::threads;
  * aborted before the new background task is created. Results are stored in the
  * sensor_pair that invoked this background task, unless the task is aborted
  * prior to completion.
+ *
+ * The receiver eigenverbs are split into chunks of chunk_size eigenverbs,
+ * which are processed in parallel using parallel_for. Each chunk accumulates
+ * its biverbs in a private biverb_columns buffer, and these buffers are merged
+ * into the biverb_collection, in chunk order, once all chunks are complete.
+ * Each interface is sorted by travel time once, after all of its chunks
+ * have been merged. This produces results that are identical to a serial
+ * calculation, without locking the collection on each insert.
+ *
+ * The calculation can be limited to a window of travel times. Biverbs are
+ * only formed for pairs of eigenverbs whose combined travel time is inside
+ * this window. The source eigenverbs are searched using an index of
+ * latitude, longitude, and travel time, so that source eigenverbs outside
+ * of the window are never paired with the receiver eigenverb.
  */
 class USML_DECLSPEC biverb_generator
     : public thread_task,
       public update_notifier<biverb_collection::csptr> {
    public:
+    /**
+     * Number of receiver eigenverbs processed as a single unit of parallel
+     * work. Abort requests are checked between chunks. Defaults to 64.
+     */
+    static size_t chunk_size;
+
+    /**
+     * Extra time added to the end of the travel time window used by the
+     * sensor_pair, to include the leading edge of biverbs that arrive just
+     * after the end of the reverberation time series. The rvbts_collection
+     * spreads each biverb over five times the sum of the biverb and pulse
+     * durations, on either side of its arrival. So the padding is five
+     * times the sum of the longest pulse in the schedule, and the upper
+     * limit on biverb duration. If the schedule is empty, the padding is
+     * unlimited, so that biverbs computed before the schedule is defined
+     * are not truncated.
+     *
+     * @param schedule  List of pulses transmitted by the source.
+     * @param duration  Upper limit on biverb duration, usually from
+     *                  eigenverb_collection::duration_maximum() for the
+     *                  receiver eigenverbs (sec).
+     * @return          Time added to the end of the window (sec).
+     */
+    static double time_padding(const transmit_list& schedule,
+                               double duration);
+
     /**
      * Initialize model parameters and reserve memory. Note that passing the
      * src_eigenverbs and rcv_eigenverbs of the pair as their own arguments
@@ -43,10 +87,15 @@ class USML_DECLSPEC biverb_generator
      * @param pair       		Object to notify when complete.
      * @param src_eigenverbs 	Interface collisions for source.
      * @param rcv_eigenverbs 	Interface collisions for receiver.
+     * @param time_minimum      Earliest travel time of biverbs (sec).
+     * @param time_maximum      Latest travel time of biverbs (sec).
      */
-    biverb_generator(const sensor_pair::sptr& pair,
-                     const eigenverb_collection::csptr& src_eigenverbs,
-                     const eigenverb_collection::csptr& rcv_eigenverbs);
+    biverb_generator(
+        const sensor_pair::sptr& pair,
+        const eigenverb_collection::csptr& src_eigenverbs,
+        const eigenverb_collection::csptr& rcv_eigenverbs,
+        double time_minimum = 0.0,
+        double time_maximum = std::numeric_limits<double>::max());
 
     /**
      * Virtual destructor
@@ -60,12 +109,16 @@ class USML_DECLSPEC biverb_generator
      * First, it computes the great circle range and bearing of the source
      * relative to the receiver.  The combination is skipped if the location of
      * the source (its peak intensity) is more than three (3) times the
-     * length/width of the receiver eigenverb,
+     * length/width of the receiver eigenverb, or if the combined travel
+     * time is outside of the travel time window.
      * Next, it computes the scattering strength and beam patterns for
      * this source/receiver combination.
      * Finally, it uses the evelope_collection.add_contribution() method
      * to add this this source/receiver combination to the reverberation
      * time series.
+     *
+     * Receiver eigenverbs are processed in parallel chunks, see class header
+     * for details.
      */
     virtual void run();
 
@@ -87,6 +140,16 @@ class USML_DECLSPEC biverb_generator
      */
     eigenverb_collection::csptr _rcv_eigenverbs;
 
+    /**
+     * Earliest travel time of biverbs generated by this calculation.
+     */
+    const double _time_minimum;
+
+    /**
+     * Latest travel time of biverbs generated by this calculation.
+     */
+    const double _time_maximum;
+
     /**
      * Collection of bistatic eigenverbs generated by this calculation.
      */
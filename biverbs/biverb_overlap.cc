@@ -0,0 +1,159 @@
+/**
+ * @file biverb_overlap.cc
+ * Batched overlap of one receiver eigenverb with many source eigenverbs.
+ */
+
+#include <usml/biverbs/biverb_collection.h>
+#include <usml/biverbs/biverb_overlap.h>
+#include <usml/types/wposition.h>
+#include <usml/ublas/math_traits.h>
+
+#include <algorithm>
+#include <boost/numeric/ublas/vector.hpp>
+#include <cmath>
+
+using namespace usml::biverbs;
+
+/**
+ * Computes the overlap of a receiver eigenverb with a list of source
+ * eigenverbs, and keeps the pairs that can create a biverb.
+ */
+size_t biverb_overlap::compute(const eigenverb_model& rcv_verb,
+                               const eigenverb_collection& src_verbs,
+                               size_t interface,
+                               const std::vector<size_t>& found,
+                               const vector<double>& max_scatter) {
+    const size_t N = found.size();
+    _latitude.resize(N);
+    _longitude.resize(N);
+    _direction.resize(N);
+    _length2.resize(N);
+    _width2.resize(N);
+    _power.resize(N);
+    _ys2.resize(N);
+    _xs2.resize(N);
+    _cos2alpha.resize(N);
+    _det_sr.resize(N);
+    _scale.resize(N);
+    _index.clear();
+    _overlap_scale.clear();
+    _duration.clear();
+
+    // gather source eigenverbs from the columns of the collection,
+    // and compute the upper limit on biverb power, using the same
+    // order of operations as make_biverb()
+
+    const eigenverb_columns& columns = src_verbs.columns(interface);
+    const size_t num_freq = rcv_verb.power.size();
+    for (size_t n = 0; n < N; ++n) {
+        const size_t index = found[n];
+        _latitude[n] = to_radians(columns.latitude[index]);
+        _longitude[n] = to_radians(columns.longitude[index]);
+        _direction[n] = columns.direction[index];
+        _length2[n] = columns.length[index] * columns.length[index];
+        _width2[n] = columns.width[index] * columns.width[index];
+        const double* src_power = columns.power(index);
+        double peak = 0.0;
+        for (size_t f = 0; f < num_freq; ++f) {
+            double value = 0.25 * 0.5 * src_power[f];
+            value *= rcv_verb.power[f];
+            value *= max_scatter[f];
+            peak = std::max(peak, std::abs(value));
+        }
+        _power[n] = peak;
+    }
+
+    // determine relative range and bearing between Gaussians,
+    // using the same Haversine formula as wposition1::gc_range()
+
+    const double lat1 = to_radians(rcv_verb.position.latitude());
+    const double lng1 = to_radians(rcv_verb.position.longitude());
+    const double R = wposition::earth_radius + rcv_verb.position.altitude();
+    const double cos_lat1 = cos(lat1);
+    const double sin_lat1 = sin(lat1);
+    const double pole = (lat1 > 0) ? M_PI : 0.0;
+    const bool at_pole = std::abs(lat1) < 1e-10;
+    const double rcv_direction = rcv_verb.direction;
+    for (size_t n = 0; n < N; ++n) {
+        const double lat2 = _latitude[n];
+        const double lng2 = _longitude[n];
+        double hav1at = sin(0.5 * (lat1 - lat2));
+        hav1at *= hav1at;
+        double havlng = sin(0.5 * (lng1 - lng2));
+        havlng *= havlng;
+        const double cos_lat2 = cos(lat2);
+        const double angle =
+            2.0 * asin(sqrt(hav1at + cos_lat1 * cos_lat2 * havlng));
+        double bearing = atan2(sin(lng1 - lng2) * cos_lat2,
+                               cos_lat1 * sin(lat2) -
+                                   sin_lat1 * cos_lat2 * cos(lng1 - lng2));
+        bearing = fmod(TWO_PI - bearing, TWO_PI);
+        bearing = (std::abs(angle) < 1e-6 || at_pole) ? pole : bearing;
+
+        const double range = angle * R;
+        bearing = (range < 1e-6) ? 0.0 : bearing;  // fixes bearing = NaN
+        bearing -= rcv_direction;                   // relative bearing
+
+        const double ys = range * cos(bearing);
+        _ys2[n] = ys * ys;
+        const double xs = range * sin(bearing);
+        _xs2[n] = xs * xs;
+    }
+
+    // compute the scaling and power of the exponential
+    // equations (26) and (28) from the paper
+
+    const double rcv_length2 = rcv_verb.length * rcv_verb.length;
+    const double rcv_width2 = rcv_verb.width * rcv_verb.width;
+    const double rcv_sum = rcv_length2 + rcv_width2;
+    const double rcv_diff = rcv_length2 - rcv_width2;
+    const double rcv_prod = rcv_length2 * rcv_width2;
+    for (size_t n = 0; n < N; ++n) {
+        const double alpha = _direction[n] - rcv_direction;
+        const double cos2alpha = cos(2.0 * alpha);
+        const double sin2alpha = sin(2.0 * alpha);
+        const double src_sum = _length2[n] + _width2[n];
+        const double src_diff = _length2[n] - _width2[n];
+        const double src_prod = _length2[n] * _width2[n];
+        const double det_sr =
+            0.5 * (2.0 * (src_prod + rcv_prod) + (src_sum * rcv_sum) -
+                   (src_diff * rcv_diff) * cos2alpha);
+        const double new_prod = src_diff * cos2alpha;
+        const double xs2 = _xs2[n];
+        const double ys2 = _ys2[n];
+        const double kappa = -0.25 *
+                             (xs2 * (src_sum + new_prod + 2.0 * rcv_length2) +
+                              ys2 * (src_sum - new_prod + 2.0 * rcv_width2) -
+                              2.0 * sqrt(xs2 * ys2) * src_diff * sin2alpha) /
+                             det_sr;
+        _cos2alpha[n] = cos2alpha;
+        _det_sr[n] = det_sr;
+        _scale[n] = exp(kappa) / sqrt(det_sr);
+    }
+
+    // keep the pairs that can reach the power threshold,
+    // and compute the duration of their overlap
+    // equations (33) and (41) from the paper
+
+    const double threshold = biverb_collection::power_threshold;
+    const double factor = cos(rcv_verb.grazing) / rcv_verb.sound_speed;
+    for (size_t n = 0; n < N; ++n) {
+        if (_power[n] * _scale[n] < threshold) {
+            continue;
+        }
+        const double src_length2 = _length2[n];
+        const double src_width2 = _width2[n];
+        const double det_sr =
+            _det_sr[n] / (src_length2 * src_width2 * rcv_prod);
+        const double sigma = 0.5 *
+                             ((1.0 / src_width2 + 1.0 / src_length2) +
+                              (1.0 / src_width2 - 1.0 / src_length2) *
+                                  _cos2alpha[n] +
+                              2.0 / rcv_width2) /
+                             det_sr;
+        _index.push_back(found[n]);
+        _overlap_scale.push_back(_scale[n]);
+        _duration.push_back(0.5 * factor * sqrt(sigma));
+    }
+    return _index.size();
+}
@@ -0,0 +1,125 @@
+/**
+ * @file biverb_overlap.h
+ * Batched overlap of one receiver eigenverb with many source eigenverbs.
+ */
+#pragma once
+
+#include <usml/eigenverbs/eigenverb_collection.h>
+#include <usml/eigenverbs/eigenverb_model.h>
+#include <usml/usml_config.h>
+
+#include <boost/numeric/ublas/vector.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace usml {
+namespace biverbs {
+
+using namespace usml::eigenverbs;
+
+/// @ingroup biverbs
+/// @{
+
+/**
+ * Batched overlap of one receiver eigenverb with many source eigenverbs.
+ * Computes the same Gaussian overlap as biverb_collection::make_biverb(),
+ * including the great circle range and bearing between eigenverbs, for all
+ * of the source eigenverbs found near a receiver eigenverb. Pairs that can
+ * not create a biverb above biverb_collection::power_threshold, even with
+ * the upper limit on scattering strength from
+ * scattering_model::max_scattering(), are removed in the same pass, so that
+ * the caller only computes the scattering strength, and calls
+ * make_biverb(), for the pairs that remain.
+ *
+ * The attributes of the source eigenverbs are gathered from the columns of
+ * the eigenverb_collection into a structure of arrays, and each step of the
+ * calculation is a separate loop over these arrays. This keeps
+ * the branches out of the inner loops, and lets the compiler use SIMD
+ * instructions where the math library supports them. The arrays are
+ * reused from one receiver eigenverb to the next, so that memory is only
+ * allocated while the arrays grow to their working size. Each thread needs
+ * its own instance of this class.
+ *
+ * Each element uses the same equations as make_biverb(), in the same order,
+ * so the results agree to within the rounding differences between the
+ * vectorized and scalar versions of the math functions.
+ */
+class USML_DECLSPEC biverb_overlap {
+   public:
+    /**
+     * Computes the overlap of a receiver eigenverb with a list of source
+     * eigenverbs, and keeps the pairs that can create a biverb.
+     *
+     * @param rcv_verb      Receiver eigenverb to be processed.
+     * @param src_verbs     Collection of source eigenverbs.
+     * @param interface     Interface number of the source eigenverbs.
+     * @param found         Position of each source eigenverb in the
+     *                      collection, usually from find_eigenverbs().
+     * @param max_scatter   Upper limit on scattering strength vs. frequency,
+     *                      for this interface.
+     * @return              Number of pairs kept.
+     */
+    size_t compute(const eigenverb_model& rcv_verb,
+                   const eigenverb_collection& src_verbs, size_t interface,
+                   const std::vector<size_t>& found,
+                   const vector<double>& max_scatter);
+
+    /// Number of pairs kept by the last call to compute().
+    size_t size() const { return _index.size(); }
+
+    /// Position of a kept source eigenverb in the collection.
+    size_t index(size_t n) const { return _index[n]; }
+
+    /// Scale factor applied to the product of source and receiver power.
+    double overlap_scale(size_t n) const { return _overlap_scale[n]; }
+
+    /// Duration of the overlap for a kept pair (sec).
+    double duration(size_t n) const { return _duration[n]; }
+
+   private:
+    /// Latitude of each source eigenverb (radians).
+    std::vector<double> _latitude;
+
+    /// Longitude of each source eigenverb (radians).
+    std::vector<double> _longitude;
+
+    /// Direction of each source eigenverb (radians).
+    std::vector<double> _direction;
+
+    /// Square of the length of each source eigenverb (m^2).
+    std::vector<double> _length2;
+
+    /// Square of the width of each source eigenverb (m^2).
+    std::vector<double> _width2;
+
+    /// Upper limit on biverb power, before the overlap, for each pair.
+    std::vector<double> _power;
+
+    /// Square of the range in the receiver's direction (m^2).
+    std::vector<double> _ys2;
+
+    /// Square of the range across the receiver's direction (m^2).
+    std::vector<double> _xs2;
+
+    /// Cosine of twice the relative tilt between eigenverbs.
+    std::vector<double> _cos2alpha;
+
+    /// Determinant of the combined Gaussian for each pair.
+    std::vector<double> _det_sr;
+
+    /// Overlap scale factor for each source eigenverb.
+    std::vector<double> _scale;
+
+    /// Position of each kept source eigenverb in the collection.
+    std::vector<size_t> _index;
+
+    /// Overlap scale factor for each kept pair.
+    std::vector<double> _overlap_scale;
+
+    /// Duration of the overlap for each kept pair (sec).
+    std::vector<double> _duration;
+};
+
+/// @}
+}  // end of namespace biverbs
+}  // end of namespace usml
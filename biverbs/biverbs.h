@@ -18,5 +18,7 @@
 #pragma once
 
 #include <usml/biverbs/biverb_collection.h>
+#include <usml/biverbs/biverb_columns.h>
 #include <usml/biverbs/biverb_generator.h>
 #include <usml/biverbs/biverb_model.h>
+#include <usml/biverbs/biverb_overlap.h>
@@ -2,14 +2,19 @@
  * @example biverbs/test/biverbs_test.cc
  */
 
+#include <usml/biverbs/biverb_columns.h>
 #include <usml/biverbs/biverb_model.h>
 #include <usml/biverbs/biverbs.h>
 #include <usml/eigenverbs/eigenverb_collection.h>
 #include <usml/eigenverbs/eigenverb_model.h>
 #include <usml/ocean/ocean_utils.h>
+#include <usml/ocean/scattering_lambert.h>
 #include <usml/sensors/sensor_manager.h>
 #include <usml/sensors/test/simple_sonobuoy.h>
+#include <usml/threads/thread_controller.h>
 #include <usml/threads/thread_task.h>
+#include <usml/transmit/transmit_cw.h>
+#include <usml/transmit/transmit_model.h>
 #include <usml/types/seq_linear.h>
 #include <usml/types/seq_vector.h>
 #include <usml/types/wposition.h>
@@ -87,6 +92,11 @@ eigenverb_model::csptr create_eigenverb(const wposition1 source_pos,
  *
  * Launches update_wavefront_data() background task to compute biverbs. Extracts
  * biverbs, writes them to disk, and counts entries in biverbs collection.
+ * Test fails if any biverb arrives after the travel time window set by the
+ * time_maximum of the sensor. The sensor has no transmit schedule, so the
+ * window is unlimited, and the biverb count is the same as it is without a
+ * window. Also checks that the window is padded by five times the sum of
+ * the longest pulse in a transmit schedule and the longest biverb.
  */
 BOOST_AUTO_TEST_CASE(update_wavefront_data) {
     cout << "=== biverbs_test: update_wavefront_data ===" << endl;
@@ -144,8 +154,24 @@ BOOST_AUTO_TEST_CASE(update_wavefront_data) {
 
     auto collection = pair->biverbs();
     biverb_list verb_list = collection->biverbs(eigenverb_model::BOTTOM);
-    BOOST_CHECK_EQUAL(verb_list.size(), 182);
-    BOOST_CHECK_EQUAL(collection->size(eigenverb_model::BOTTOM), 182);
+    BOOST_CHECK_EQUAL(verb_list.size(), 109);
+    BOOST_CHECK_EQUAL(collection->size(eigenverb_model::BOTTOM), 109);
+    const double padding = biverb_generator::time_padding(
+        sensor->transmit_schedule(), verb_collection->duration_maximum());
+    for (const auto& verb : verb_list) {
+        BOOST_CHECK_LE(verb->travel_time, sensor->time_maximum() + padding);
+    }
+
+    // check that the window grows with the longest pulse in the schedule,
+    // and with the longest biverb
+
+    transmit_list schedule;
+    schedule.push_back(
+        transmit_model::csptr(new transmit_cw("CW", 0.1, 3000.0)));
+    schedule.push_back(
+        transmit_model::csptr(new transmit_cw("CW", 0.4, 3000.0, 1.0)));
+    BOOST_CHECK_CLOSE(biverb_generator::time_padding(schedule, 0.1), 2.5,
+                      1e-12);
     {
         std::ostringstream filename;
         filename << ncname << "biverbs_test.nc";
@@ -156,6 +182,303 @@ BOOST_AUTO_TEST_CASE(update_wavefront_data) {
     sensor_manager::reset();
 }
 
+/**
+ * Tests that the parallel implementation of biverb_generator produces the
+ * same results as a serial calculation. Uses the same hard-coded eigenverbs
+ * as the update_wavefront_data test. First computes the biverbs using a
+ * single chunk, which is equivalent to the serial calculation, and then
+ * computes them again using one eigenverb per chunk in a four thread pool.
+ * Test fails if the biverbs are not identical, in the same order.
+ */
+BOOST_AUTO_TEST_CASE(parallel_biverbs) {
+    cout << "=== biverbs_test: parallel_biverbs ===" << endl;
+    sensor_manager* smgr = sensor_manager::instance();
+
+    ocean_utils::make_iso(depth);
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    smgr->frequencies(frequencies);
+
+    sensor_model* sensor_ptr = new test::simple_sonobuoy(1, "simple_sonobuoy");
+    sensor_ptr->time_maximum(7.0);
+    sensor_ptr->compute_reverb(true);
+    sensor_model::sptr sensor(sensor_ptr);
+    smgr->add_sensor(sensor);
+    sensor_pair::sptr pair = *(smgr->find_source(1).begin());
+
+    auto* verb_collection = new eigenverb_collection(eigenverb_model::BOTTOM);
+    for (double az = 0.0; az <= 90.0; az += az_spacing) {
+        for (double de = -90.0 + de_spacing; de < 0.0; de += de_spacing) {
+            verb_collection->add_eigenverb(
+                create_eigenverb(sensor->position(), depth, de, az,
+                                 frequencies),
+                eigenverb_model::BOTTOM);
+        }
+    }
+    eigenverb_collection::csptr verbs(verb_collection);
+    wposition1 pos1 = sensor->position();
+    wposition pos(pos1);
+    eigenray_collection::csptr rays(
+        new eigenray_collection(frequencies, pos1, pos));
+
+    // compute biverbs serially, and then in parallel
+
+    biverb_list results[2];
+    const size_t chunk_sizes[2] = {1000000, 1};
+    for (size_t n = 0; n < 2; ++n) {
+        biverb_generator::chunk_size = chunk_sizes[n];
+        thread_controller::reset(4);
+        pair->update_wavefront_data(sensor.get(), rays, verbs);
+        thread_task::wait();
+        results[n] = pair->biverbs()->biverbs(eigenverb_model::BOTTOM);
+    }
+    biverb_generator::chunk_size = 64;
+    thread_controller::reset();
+
+    // compare results
+
+    BOOST_CHECK_EQUAL(results[0].size(), 109);
+    BOOST_REQUIRE_EQUAL(results[0].size(), results[1].size());
+    auto serial = results[0].begin();
+    auto parallel = results[1].begin();
+    for (; serial != results[0].end(); ++serial, ++parallel) {
+        BOOST_CHECK_EQUAL((*serial)->travel_time, (*parallel)->travel_time);
+        BOOST_CHECK_EQUAL((*serial)->duration, (*parallel)->duration);
+        BOOST_CHECK_EQUAL((*serial)->power[0], (*parallel)->power[0]);
+        BOOST_CHECK_EQUAL((*serial)->source_az, (*parallel)->source_az);
+        BOOST_CHECK_EQUAL((*serial)->receiver_de, (*parallel)->receiver_de);
+    }
+
+    sensor_manager::reset();
+}
+
+/**
+ * Tests the overlap test used to select pairs of eigenverbs. Uses the same
+ * hard-coded eigenverbs as the update_wavefront_data test, a Lambert
+ * scattering model, and a power threshold that rejects some of the pairs.
+ * Compares can_overlap(), using the upper limit from max_scattering(), to
+ * make_biverb(), using the scattering strength of each pair.
+ *
+ * This test passes if:
+ *   - no pair that make_biverb() keeps is rejected by can_overlap(),
+ *   - can_overlap() never keeps a pair outside of the search area used by
+ *     find_eigenverbs(), and
+ *   - the power limit rejects some of the pairs in the search area.
+ */
+BOOST_AUTO_TEST_CASE(overlap_prefilter) {
+    cout << "=== biverbs_test: overlap_prefilter ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    wposition1 source_pos(15.0, 35.0, 0.0);
+    scattering_lambert model;
+    vector<double> scatter(frequencies->size());
+    vector<double> max_scatter(frequencies->size());
+    model.max_scattering(frequencies, &max_scatter);
+
+    eigenverb_collection verbs(0);
+    for (double az = 0.0; az <= 90.0; az += az_spacing) {
+        for (double de = -90.0 + de_spacing; de < 0.0; de += de_spacing) {
+            verbs.add_eigenverb(
+                create_eigenverb(source_pos, depth, de, az, frequencies),
+                eigenverb_model::BOTTOM);
+        }
+    }
+    const size_t num_verbs = verbs.size(eigenverb_model::BOTTOM);
+
+    const double threshold = biverb_collection::power_threshold;
+    biverb_collection::power_threshold = 1e-13;
+    size_t num_inside = 0;
+    size_t num_kept = 0;
+    size_t num_biverbs = 0;
+    size_t num_dropped = 0;
+    size_t num_outside = 0;
+    std::vector<size_t> found;
+    for (size_t r = 0; r < num_verbs; ++r) {
+        const auto rcv_verb = verbs.eigenverb(eigenverb_model::BOTTOM, r);
+        verbs.find_eigenverbs(*rcv_verb, eigenverb_model::BOTTOM, &found);
+        std::vector<bool> inside(num_verbs, false);
+        for (size_t index : found) {
+            inside[index] = true;
+        }
+        for (size_t s = 0; s < num_verbs; ++s) {
+            const auto src_verb = verbs.eigenverb(eigenverb_model::BOTTOM, s);
+            const bool kept = biverb_collection::can_overlap(
+                *src_verb, *rcv_verb, max_scatter);
+            model.scattering(rcv_verb->position, frequencies,
+                             src_verb->grazing, rcv_verb->grazing,
+                             src_verb->direction, rcv_verb->direction,
+                             &scatter);
+            biverb_columns list;
+            const bool made = biverb_collection::make_biverb(
+                *src_verb, *rcv_verb, scatter, &list);
+            if (inside[s]) {
+                ++num_inside;
+                if (made) {
+                    ++num_biverbs;
+                }
+            }
+            if (kept) {
+                ++num_kept;
+            }
+            if (inside[s] && made && !kept) {
+                ++num_dropped;
+            }
+            if (kept && !inside[s]) {
+                ++num_outside;
+            }
+        }
+    }
+    biverb_collection::power_threshold = threshold;
+    cout << "kept " << num_kept << " of " << num_inside
+         << " pairs in the search area, " << num_biverbs << " biverbs"
+         << endl;
+    BOOST_CHECK_GT(num_biverbs, 0);
+    BOOST_CHECK_GE(num_kept, num_biverbs);
+    BOOST_CHECK_LT(num_kept, num_inside);
+    BOOST_CHECK_EQUAL(num_dropped, 0);
+    BOOST_CHECK_EQUAL(num_outside, 0);
+}
+
+/**
+ * Tests the batched overlap kernel used by biverb_generator. Uses the same
+ * hard-coded eigenverbs as the update_wavefront_data test, and a power
+ * threshold that rejects some of the pairs. Computes the overlap of each
+ * receiver eigenverb with all of the source eigenverbs in a single batch,
+ * and compares it to make_biverb() for each pair, with a scattering
+ * strength, and an upper limit on scattering strength, of one.
+ *
+ * This test passes if the batch keeps every pair that make_biverb() keeps,
+ * rejects some of the pairs, and if biverbs built from the batched overlap
+ * have the same power and duration as those built by make_biverb(), to
+ * within 1e-12 relative error. It also checks that no biverb duration is
+ * larger than the limit used by eigenverb_collection::duration_maximum(). The results are not bit for bit identical,
+ * because the compiler is free to vectorize the batched loops differently.
+ */
+BOOST_AUTO_TEST_CASE(overlap_kernel) {
+    cout << "=== biverbs_test: overlap_kernel ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    wposition1 source_pos(15.0, 35.0, 0.0);
+    vector<double> scatter(frequencies->size(), 1.0);
+
+    eigenverb_collection verbs(0);
+    for (double az = 0.0; az <= 90.0; az += az_spacing) {
+        for (double de = -90.0 + de_spacing; de < 0.0; de += de_spacing) {
+            verbs.add_eigenverb(
+                create_eigenverb(source_pos, depth, de, az, frequencies),
+                eigenverb_model::BOTTOM);
+        }
+    }
+    const size_t num_verbs = verbs.size(eigenverb_model::BOTTOM);
+    std::vector<size_t> found(num_verbs);
+    for (size_t n = 0; n < num_verbs; ++n) {
+        found[n] = n;
+    }
+
+    const double threshold = biverb_collection::power_threshold;
+    biverb_collection::power_threshold = 1e-12;
+    biverb_overlap overlap;
+    size_t num_batched = 0;
+    size_t num_kept = 0;
+    size_t num_dropped = 0;
+    for (size_t r = 0; r < num_verbs; ++r) {
+        const auto rcv_verb = verbs.eigenverb(eigenverb_model::BOTTOM, r);
+        overlap.compute(*rcv_verb, verbs, eigenverb_model::BOTTOM, found,
+                        scatter);
+        num_batched += overlap.size();
+        const double max_duration = 0.5 * rcv_verb->length *
+                                    cos(rcv_verb->grazing) /
+                                    rcv_verb->sound_speed;
+        std::vector<size_t> position(num_verbs, num_verbs);
+        for (size_t k = 0; k < overlap.size(); ++k) {
+            position[overlap.index(k)] = k;
+            BOOST_CHECK_LE(overlap.duration(k), max_duration * (1.0 + 1e-12));
+        }
+        for (size_t s = 0; s < num_verbs; ++s) {
+            const auto src_verb = verbs.eigenverb(eigenverb_model::BOTTOM, s);
+            biverb_columns expected;
+            bool kept = biverb_collection::make_biverb(*src_verb, *rcv_verb,
+                                                       scatter, &expected);
+            if (!kept) {
+                continue;
+            }
+            ++num_kept;
+            const size_t k = position[s];
+            if (k == num_verbs) {
+                ++num_dropped;
+                continue;
+            }
+            biverb_columns actual;
+            bool batched = biverb_collection::make_biverb(
+                *src_verb, *rcv_verb, scatter, overlap.overlap_scale(k),
+                overlap.duration(k), &actual);
+            BOOST_REQUIRE(batched);
+            BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+            BOOST_CHECK_CLOSE(actual.power(0)[0], expected.power(0)[0], 1e-10);
+            BOOST_CHECK_CLOSE(actual.duration[0], expected.duration[0], 1e-10);
+        }
+    }
+    biverb_collection::power_threshold = threshold;
+    cout << "batch kept " << num_batched << " of " << num_verbs * num_verbs
+         << " pairs, make_biverb kept " << num_kept << endl;
+    BOOST_CHECK_GT(num_kept, 0);
+    BOOST_CHECK_GE(num_batched, num_kept);
+    BOOST_CHECK_LT(num_batched, num_verbs * num_verbs);
+    BOOST_CHECK_EQUAL(num_dropped, 0);
+}
+
+/**
+ * Tests the columnar storage of biverbs. Appends two batches of biverbs
+ * with travel times that are out of order, and that include duplicates.
+ * Each biverb is tagged with its insertion order in de_index and its power.
+ *
+ * This test passes if:
+ *   - biverbs are sorted by travel time after each batch,
+ *   - biverbs with the same travel time stay in insertion order, and
+ *   - biverb() recreates the power and path counts of each biverb.
+ */
+BOOST_AUTO_TEST_CASE(biverb_columns_sort) {
+    cout << "=== biverbs_test: biverb_columns_sort ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(1000.0, 1000.0, 2));
+    const double times[] = {3.0, 1.0, 2.0, 1.0, 0.5, 2.0, 1.0};
+    const size_t num_verbs = sizeof(times) / sizeof(times[0]);
+    const size_t batch = 4;
+
+    biverb_columns columns;
+    for (size_t n = 0; n < num_verbs; ++n) {
+        if (n == batch) {
+            columns.sort();
+        }
+        biverb_model verb{};
+        verb.travel_time = times[n];
+        verb.frequencies = frequencies;
+        verb.power = vector<double>(2);
+        verb.power[0] = (double)n;
+        verb.power[1] = 10.0 * (double)n;
+        verb.de_index = n;
+        verb.source_bottom = (int)n;
+        verb.receiver_lower = (int)(2 * n);
+        biverb_columns single;
+        single.push_back(verb);
+        const size_t first = columns.size();
+        columns.append(single);
+        if (n >= batch) {
+            columns.sort(first);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(columns.size(), num_verbs);
+    BOOST_CHECK_EQUAL(columns.num_frequencies(), 2);
+
+    const size_t expected[] = {4, 1, 3, 6, 2, 5, 0};
+    for (size_t n = 0; n < num_verbs; ++n) {
+        const size_t tag = expected[n];
+        BOOST_CHECK_EQUAL(columns.travel_time[n], times[tag]);
+        BOOST_CHECK_EQUAL(columns.de_index[n], tag);
+        auto verb = columns.biverb(n);
+        BOOST_CHECK_EQUAL(verb->power[0], (double)tag);
+        BOOST_CHECK_EQUAL(verb->power[1], 10.0 * (double)tag);
+        BOOST_CHECK_EQUAL(verb->source_bottom, (int)tag);
+        BOOST_CHECK_EQUAL(verb->receiver_lower, (int)(2 * tag));
+    }
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
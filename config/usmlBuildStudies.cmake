@@ -22,3 +22,6 @@ target_link_libraries( dead_reckon_test usml )
 
 add_executable( simple_wedge studies/simple_wedge/simple_wedge.cc )
 target_link_libraries( simple_wedge usml )
+
+add_executable( archive_convert studies/archive_convert/archive_convert.cc )
+target_link_libraries( archive_convert usml )
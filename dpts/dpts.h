@@ -0,0 +1,21 @@
+/**
+ * @file dpts.h Direct path time series for a bistatic pair.
+ * @defgroup dpts dpts
+ *
+ * Synthesizes the signal received from the direct paths between a source
+ * and receiver. Builds a complex baseband impulse response from the
+ * eigenrays of each transmission, for each receiver channel, and convolves
+ * it with the transmit waveform using FFT overlap-add. This is the direct
+ * path counterpart of the rvbts module.
+ *
+ * @defgroup dpts_test Direct Path Time Series Tests
+ * @ingroup dpts
+ *
+ * Regression tests for the dpts module.
+ */
+#pragma once
+
+#include <usml/dpts/dpts_block.h>
+#include <usml/dpts/dpts_collection.h>
+#include <usml/dpts/dpts_generator.h>
+#include <usml/dpts/overlap_add.h>
@@ -0,0 +1,56 @@
+/**
+ * @file dpts_block.h
+ * Block of completed samples in a direct path time series.
+ */
+#pragma once
+
+#include <usml/dpts/dpts_collection.h>
+#include <usml/usml_config.h>
+
+#include <cstddef>
+
+namespace usml {
+namespace dpts {
+
+/// @ingroup dpts
+/// @{
+
+/**
+ * Block of completed samples in a direct path time series. Delivered to the
+ * update listeners of the dpts_generator as soon as every transmission has
+ * been added to this part of the time series. Refers to the samples in the
+ * collection, instead of copying them, so these samples should be used
+ * before the notify_update() call returns, or the collection should be
+ * kept alive by copying its shared pointer. Samples in a completed block are
+ * never modified by the generator, so listeners can read them while later
+ * blocks are being computed.
+ */
+struct USML_DECLSPEC dpts_block {
+    /// Collection that holds the time series for all channels.
+    dpts_collection::csptr collection;
+
+    /// Sample number at the start of the block.
+    size_t first;
+
+    /// Number of samples in the block.
+    size_t size;
+
+    /// Number of receiver channels.
+    size_t num_channels() const { return collection->time_series().size1(); }
+
+    /// Travel time of the first sample in the block (sec).
+    double time() const { return (*collection->travel_times())[first]; }
+
+    /**
+     * Pointer to the samples in this block for a single channel.
+     *
+     * @param channel   Channel number, index into rcv_keys().
+     */
+    const dpts_collection::complex* samples(size_t channel) const {
+        return &collection->time_series()(channel, first);
+    }
+};
+
+/// @}
+}  // namespace dpts
+}  // namespace usml
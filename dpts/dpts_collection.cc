@@ -0,0 +1,202 @@
+/**
+ * @file dpts_collection.cc
+ * Computes and stores direct path time series for each receiver channel.
+ */
+
+#include <usml/dpts/dpts_collection.h>
+#include <usml/types/seq_linear.h>
+#include <usml/ublas/math_traits.h>
+
+#include <boost/numeric/ublas/vector.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace usml::dpts;
+
+/**
+ * Threshold for minimum arrival amplitude.
+ */
+double dpts_collection::amplitude_threshold = 1e-20;
+
+/**
+ * Number of taps in the fractional delay filter used for each arrival.
+ */
+size_t dpts_collection::delay_taps = 8;
+
+/**
+ * Initialize model parameters with state of sensor_pair at the time that
+ * direct path generator was created.
+ */
+dpts_collection::dpts_collection(
+    const sensor_model::sptr &source, const wposition1 source_pos,
+    const orientation &source_orient, const double source_speed,
+    const sensor_model::sptr &receiver, const wposition1 receiver_pos,
+    const orientation &receiver_orient, const double receiver_speed,
+    double fsample, double fband, const seq_vector::csptr &travel_times)
+    : _source(source),
+      _source_pos(source_pos),
+      _source_orient(source_orient),
+      _source_speed(source_speed),
+      _receiver(receiver),
+      _receiver_pos(receiver_pos),
+      _receiver_orient(receiver_orient),
+      _receiver_speed(receiver_speed),
+      _fsample(fsample),
+      _fband(fband),
+      _travel_times(travel_times),
+      _time_series(receiver->rcv_num_keys(), travel_times->size()) {
+    _time_series.clear();
+    for (int key : source->src_keys()) {
+        _src_beams[key] = source->src_beam(key);
+    }
+    for (int key : receiver->rcv_keys()) {
+        _rcv_keys.push_back(key);
+        _rcv_beams.push_back(receiver->rcv_beam(key));
+        _rcv_steering.push_back(receiver->rcv_steering(key));
+    }
+}
+
+/**
+ * Single frequency axis for a transmit frequency.
+ */
+const seq_vector::csptr &dpts_collection::workspace::frequency(
+    double fcenter) {
+    for (const auto &entry : frequencies) {
+        if (entry.first == fcenter) {
+            return entry.second;
+        }
+    }
+    frequencies.emplace_back(fcenter,
+                             seq_vector::csptr(new seq_linear(fcenter, 1.0, 1)));
+    return frequencies.back().second;
+}
+
+/**
+ * Computes the complex baseband impulse response of a single transmission
+ * for one receiver channel.
+ */
+void dpts_collection::impulse_response(const eigenray_view &rays,
+                                       const transmit_model &transmit,
+                                       double start, const bvector &steering,
+                                       size_t channel, tap_list *taps,
+                                       workspace *scratch) const {
+    taps->clear();
+    auto beam = _src_beams.find(transmit.transmit_mode);
+    if (beam == _src_beams.end() || beam->second == nullptr || rays.empty() ||
+        _travel_times->size() == 0) {
+        return;
+    }
+    const seq_vector::csptr &frequencies = scratch->frequency(transmit.fcenter);
+    vector<double> &level = scratch->level;
+
+    // interpolation weights for the transmit frequency
+
+    const seq_vector &axis = *rays.columns()->frequencies;
+    size_t f = 0;
+    double u = 0.0;
+    if (axis.size() > 1) {
+        f = std::min(axis.find_index(transmit.fcenter), axis.size() - 2);
+        u = (transmit.fcenter - axis[f]) / axis.increment(f);
+        u = std::max(0.0, std::min(1.0, u));
+    }
+
+    // convert each eigenray into the taps of a fractional delay filter,
+    // with the nodes of the Lagrange polynomial centered on the arrival
+
+    const double time_minimum = (*_travel_times)[0];
+    const auto num_samples = (double)_travel_times->size();
+    const size_t num_taps = std::max((size_t)1, delay_taps);
+    const auto first_node = -(double)((num_taps - 1) / 2);
+    for (size_t index : rays) {
+        const double time = start + rays.travel_time(index);
+        const double position = (time - time_minimum) * _fsample;
+        const double offset = (num_taps % 2 == 1) ? std::round(position)
+                                                  : std::floor(position);
+        if (offset + first_node + (double)num_taps <= 0.0 ||
+            offset + first_node >= num_samples) {
+            continue;
+        }
+
+        bvector src_arrival(rays.source_de(index), rays.source_az(index));
+        src_arrival.rotate(_source_orient, src_arrival);
+        beam->second->beam_level(src_arrival, frequencies, &level, steering);
+        const double src_level = level[0];
+
+        bvector rcv_arrival(rays.target_de(index), rays.target_az(index));
+        rcv_arrival.rotate(_receiver_orient, rcv_arrival);
+        _rcv_beams[channel]->beam_level(rcv_arrival, frequencies, &level,
+                                        _rcv_steering[channel]);
+        const double beam_level = std::max(0.0, src_level * level[0]);
+
+        const double *intensity = rays.intensity(index);
+        const double *phase = rays.phase(index);
+        double loss = intensity[f];
+        double shift = phase[f];
+        if (axis.size() > 1) {
+            loss = u * intensity[f + 1] + (1 - u) * loss;
+            shift = u * phase[f + 1] + (1 - u) * shift;
+        }
+        const double amplitude =
+            pow(10.0, (transmit.source_level - loss) / 20.0) *
+            sqrt(beam_level);
+        if (amplitude < amplitude_threshold) {
+            continue;
+        }
+        const complex value =
+            std::polar(amplitude, TWO_PI * _fband * time - shift);
+        const double fraction = position - offset;
+        for (size_t k = 0; k < num_taps; ++k) {
+            const double node = first_node + (double)k;
+            const double sample = offset + node;
+            if (sample < 0.0 || sample >= num_samples) {
+                continue;
+            }
+            double weight = 1.0;
+            for (size_t j = 0; j < num_taps; ++j) {
+                if (j != k) {
+                    const double other = first_node + (double)j;
+                    weight *= (fraction - other) / (node - other);
+                }
+            }
+            if (weight != 0.0) {
+                taps->push_back({(size_t)sample, weight * value});
+            }
+        }
+    }
+    std::sort(taps->begin(), taps->end(),
+              [](const tap &a, const tap &b) { return a.index < b.index; });
+}
+
+/**
+ * Adds the convolution of an impulse response with a transmit waveform
+ * to one receiver channel.
+ */
+void dpts_collection::add_block(const tap_list &taps, const overlap_add &kernel,
+                                size_t channel, size_t first, size_t count,
+                                workspace *scratch) {
+    const size_t num_samples = _time_series.size2();
+    if (first >= num_samples) {
+        return;
+    }
+    count = std::min(count, kernel.block_size());
+
+    // find the taps in this block
+
+    auto compare = [](const tap &a, size_t index) { return a.index < index; };
+    auto begin = std::lower_bound(taps.begin(), taps.end(), first, compare);
+    auto end = std::lower_bound(begin, taps.end(), first + count, compare);
+    if (begin == end) {
+        return;
+    }
+
+    // convolve dense copy of the block with the transmit waveform
+
+    std::vector<complex> &block = scratch->block;
+    block.assign(count, complex(0.0, 0.0));
+    for (auto iter = begin; iter != end; ++iter) {
+        block[iter->index - first] += iter->value;
+    }
+    complex *row = &_time_series(channel, first);
+    kernel.convolve(block.data(), count, row, num_samples - first,
+                    &scratch->fft);
+}
@@ -0,0 +1,297 @@
+/**
+ * @file dpts_collection.h
+ * Computes and stores direct path time series for each receiver channel.
+ */
+#pragma once
+
+#include <usml/beampatterns/bp_model.h>
+#include <usml/dpts/overlap_add.h>
+#include <usml/eigenrays/eigenray_columns.h>
+#include <usml/sensors/sensor_model.h>
+#include <usml/transmit/transmit_model.h>
+#include <usml/types/bvector.h>
+#include <usml/types/orientation.h>
+#include <usml/types/seq_vector.h>
+#include <usml/types/wposition1.h>
+#include <usml/usml_config.h>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <complex>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace usml {
+namespace dpts {
+
+using namespace usml::beampatterns;
+using namespace usml::eigenrays;
+using namespace usml::sensors;
+using namespace usml::transmit;
+using namespace usml::types;
+
+/// @ingroup dpts
+/// @{
+
+/**
+ * Computes and stores direct path time series for each receiver channel.
+ * This is the direct path counterpart of rvbts_collection. The received
+ * signal is stored as complex baseband samples, centered on the fband
+ * frequency, at a fixed sampling rate.
+ *
+ * The signal for each channel is computed in two steps. First, the eigenrays
+ * for this pair are converted into a sparse, complex baseband impulse
+ * response for each transmission. Then, each impulse response is convolved
+ * with its transmit waveform using FFT overlap-add. Like rvbts_collection,
+ * this implementation supports beam level simulations where each receiver
+ * channel has its own beam pattern and steering.
+ */
+class USML_DECLSPEC dpts_collection {
+   public:
+    /**
+     * Data type used for reference to a dpts_collection.
+     */
+    typedef std::shared_ptr<const dpts_collection> csptr;
+
+    /// Complex sample type.
+    typedef std::complex<double> complex;
+
+    /**
+     * Threshold for minimum arrival amplitude.
+     */
+    static double amplitude_threshold;
+
+    /**
+     * Number of taps in the fractional delay filter used for each arrival.
+     * Arrivals are interpolated between samples with a Lagrange polynomial
+     * of order delay_taps-1, centered on the arrival time. Set to one to
+     * round each arrival to the nearest sample. Defaults to 8.
+     */
+    static size_t delay_taps;
+
+    /**
+     * Single arrival in a sparse impulse response.
+     */
+    struct tap {
+        /// Sample number of the arrival, index into travel_times().
+        size_t index;
+
+        /// Complex baseband amplitude of the arrival.
+        complex value;
+    };
+
+    /// Sparse impulse response, sorted by sample number.
+    typedef std::vector<tap> tap_list;
+
+    /**
+     * Scratch memory used by impulse_response() and add_block(). Each thread
+     * that adds to a collection needs its own workspace. Reusing the same
+     * workspace for every block avoids memory allocation in the inner loop
+     * once the buffers have grown to their working size.
+     */
+    struct workspace {
+        /// Beam level at a single frequency.
+        vector<double> level{vector<double>(1)};
+
+        /// Single frequency axis for each transmit frequency seen so far.
+        std::vector<std::pair<double, seq_vector::csptr> > frequencies;
+
+        /**
+         * Single frequency axis for a transmit frequency. Only allocated the
+         * first time that each transmit frequency is used.
+         *
+         * @param fcenter   Transmit frequency (Hz).
+         */
+        const seq_vector::csptr& frequency(double fcenter);
+
+        /// Dense copy of the impulse response over one block of samples.
+        std::vector<complex> block;
+
+        /// FFT buffer for overlap_add::convolve().
+        std::vector<complex> fft;
+    };
+
+    /**
+     * Initialize model parameters with state of sensor_pair at the time that
+     * direct path generator was created.
+     *
+     * @param source      	  Reference to source sensor
+     * @param source_pos      Source position at this time.
+     * @param source_orient   Source orientation at this time.
+     * @param source_speed    Source speed at this time.
+     * @param receiver        Reference to receiver sensor
+     * @param receiver_pos    Receiver position at this time.
+     * @param receiver_orient Receiver orientation at this time.
+     * @param receiver_speed  Receiver speed at this time.
+     * @param fsample         Sampling rate for time series (Hz).
+     * @param fband           Center of the frequency band for complex
+     *                        basebanding (Hz).
+     * @param travel_times    Times at which time series is sampled (sec).
+     *                        Must be evenly spaced at the sampling rate.
+     */
+    dpts_collection(
+        const sensor_model::sptr& source, const wposition1 source_pos,
+        const orientation& source_orient, const double source_speed,
+        const sensor_model::sptr& receiver, const wposition1 receiver_pos,
+        const orientation& receiver_orient, const double receiver_speed,
+        double fsample, double fband, const seq_vector::csptr& travel_times);
+
+    // Reference to source sensor.
+    sensor_model::sptr source() const { return _source; }
+
+    /// Source position at time that class constructed.
+    const wposition1& source_pos() const { return _source_pos; }
+
+    /// Source orientation at time that class constructed.
+    const orientation& source_orient() const { return _source_orient; }
+
+    /// Source speed at time that class constructed.
+    double source_speed() const { return _source_speed; }
+
+    // Reference to receiver sensor.
+    sensor_model::sptr receiver() const { return _receiver; }
+
+    /// Receiver position at time that class constructed.
+    const wposition1& receiver_pos() const { return _receiver_pos; }
+
+    /// Receiver orientation at time that class constructed.
+    const orientation& receiver_orient() const { return _receiver_orient; }
+
+    /// Receiver speed at time that class constructed (m/s).
+    double receiver_speed() const { return _receiver_speed; }
+
+    /// Sampling rate for time series (Hz).
+    double fsample() const { return _fsample; }
+
+    /// Center of the frequency band for complex basebanding (Hz).
+    double fband() const { return _fband; }
+
+    /// Receiver times at which time series is sampled (sec).
+    seq_vector::csptr travel_times() const { return _travel_times; }
+
+    /// Complex baseband time series, one row for each receiver channel.
+    const matrix<complex>& time_series() const { return _time_series; }
+
+    /// Receiver channel keys at time that class constructed.
+    const std::vector<int>& rcv_keys() const { return _rcv_keys; }
+
+    /**
+     * Computes the complex baseband impulse response of a single transmission
+     * for one receiver channel.
+     * \f[
+     *      h(t) = \sum_k \sqrt{ 10^{(SL-I_k)/10} B_s B_r }
+     *              e^{ -i ( \phi_k - 2\pi f_b \tau_k ) } \delta(t-\tau_k)
+     * \f]
+     *
+     * where
+     * 	- \f$ SL \f$ = source level of the transmission (dB),
+     * 	- \f$ I_k \f$ = propagation loss of eigenray k (dB),
+     * 	- \f$ B_s \f$ = source beam level for eigenray k,
+     * 	- \f$ B_r \f$ = receiver beam level for eigenray k,
+     * 	- \f$ \phi_k \f$ = phase change of eigenray k,
+     * 	- \f$ f_b \f$ = center of the frequency band for basebanding,
+     * 	- \f$ \tau_k \f$ = start of transmission plus travel time of eigenray k.
+     *
+     * The signs of the phase terms follow transmit_model::asignal(), which
+     * represents \f$ \sin(\omega t + \phi) \f$ as
+     * \f$ i e^{-i(\omega t + \phi)} \f$.
+     *
+     * Interpolates eigenray intensity and phase to the transmit frequency.
+     * Each arrival is spread over delay_taps samples by a fractional delay
+     * filter, so that the arrival is not moved to the nearest sample. Taps
+     * outside of the travel time window, and arrivals weaker than
+     * amplitude_threshold, are ignored.
+     *
+     * @param rays	   	Direct path eigenrays from source to receiver.
+     * @param transmit	Single waveform in a transmission schedule.
+     * @param start	    Time at which transmission starts (sec).
+     * @param steering 	Transmit steering relative to source array.
+     * @param channel 	Channel number, index into rcv_keys().
+     * @param taps 	    Sparse impulse response, sorted by sample number.
+     * @param scratch 	Scratch memory for this thread.
+     */
+    void impulse_response(const eigenray_view& rays,
+                          const transmit_model& transmit, double start,
+                          const bvector& steering, size_t channel,
+                          tap_list* taps, workspace* scratch) const;
+
+    /**
+     * Adds the convolution of an impulse response with a transmit waveform
+     * to one receiver channel. Only the taps in a single block of samples
+     * are convolved, and the result is added to the time series starting at
+     * the first sample of that block. Blocks are skipped if they have no
+     * taps. Calls for different channels only write to their own rows of the
+     * time series, so they can be made from different threads without
+     * locking, as long as each thread uses its own workspace.
+     *
+     * The time series before the start of the next block is complete once
+     * every block up to and including this one has been added, for every
+     * transmission.
+     *
+     * @param taps 	    Sparse impulse response, sorted by sample number.
+     * @param kernel 	Transmit waveform for this impulse response.
+     * @param channel 	Channel number, index into rcv_keys().
+     * @param first 	Sample number at the start of the block.
+     * @param count 	Number of samples in block, at most
+     *                  kernel.block_size().
+     * @param scratch 	Scratch memory for this thread.
+     */
+    void add_block(const tap_list& taps, const overlap_add& kernel,
+                   size_t channel, size_t first, size_t count,
+                   workspace* scratch);
+
+   private:
+    // Reference to source sensor
+    const sensor_model::sptr _source;
+
+    /// Source position at time that class constructed.
+    const wposition1 _source_pos;
+
+    /// Source orientation at time that class constructed.
+    const orientation _source_orient;
+
+    /// Source speed at time that class constructed (m/s).
+    const double _source_speed;
+
+    /// Reference to receiver sensor
+    const sensor_model::sptr _receiver;
+
+    /// Receiver position at time that class constructed.
+    const wposition1 _receiver_pos;
+
+    /// Receiver orientation at time that class constructed.
+    const orientation _receiver_orient;
+
+    /// Receiver speed at time that class constructed (m/s).
+    const double _receiver_speed;
+
+    /// Sampling rate for time series (Hz).
+    const double _fsample;
+
+    /// Center of the frequency band for complex basebanding (Hz).
+    const double _fband;
+
+    /// Receiver times at which time series is sampled (sec).
+    const seq_vector::csptr _travel_times;
+
+    /// Source beam patterns, by transmit mode, at time that class constructed.
+    std::map<int, bp_model::csptr> _src_beams;
+
+    /// Receiver channel keys at time that class constructed.
+    std::vector<int> _rcv_keys;
+
+    /// Receiver beam pattern for each channel in _rcv_keys.
+    std::vector<bp_model::csptr> _rcv_beams;
+
+    /// Receiver steering for each channel in _rcv_keys.
+    std::vector<bvector> _rcv_steering;
+
+    /// Complex baseband time series, one row for each receiver channel.
+    matrix<complex> _time_series;
+};
+
+/// @}
+}  // namespace dpts
+}  // namespace usml
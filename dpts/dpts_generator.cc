@@ -0,0 +1,167 @@
+/**
+ * @file dpts_generator.cc
+ * Background task to compute direct path time series for a bistatic pair.
+ */
+
+#include <usml/dpts/dpts_generator.h>
+#include <usml/dpts/overlap_add.h>
+#include <usml/threads/parallel_for.h>
+#include <usml/threads/thread_controller.h>
+#include <usml/threads/thread_pool.h>
+#include <usml/types/bvector.h>
+#include <usml/types/seq_linear.h>
+
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <list>
+#include <vector>
+
+using namespace usml::dpts;
+
+/**
+ * Initialize model parameters with state of sensor_pair at this time.
+ */
+dpts_generator::dpts_generator(const sensor_model::sptr& source,
+                               const sensor_model::sptr& receiver,
+                               const eigenray_collection::csptr& dirpaths,
+                               double fsample, double fband, size_t fft_size)
+    : _description(source->description() + " -> " + receiver->description()),
+      _source(source),
+      _source_pos(source->position()),
+      _source_orient(source->orient()),
+      _source_speed(source->speed()),
+      _transmit_schedule(source->transmit_schedule()),
+      _receiver(receiver),
+      _receiver_pos(receiver->position()),
+      _receiver_orient(receiver->orient()),
+      _receiver_speed(receiver->speed()),
+      _dirpaths(dirpaths),
+      _fsample(fsample),
+      _fband(fband),
+      _fft_size(fft_size),
+      _travel_times(new seq_linear(
+          receiver->time_minimum(), 1.0 / fsample,
+          (size_t)std::max(
+              1.0, std::floor((receiver->time_maximum() -
+                               receiver->time_minimum()) *
+                              fsample) +
+                       1.0))),
+      _source_steering(
+          source->src_steering(_transmit_schedule, _source_orient)) {}
+
+/**
+ * Compute direct path time series for a bistatic pair.
+ */
+void dpts_generator::run() {
+    if (_abort) {
+        cout << "task #" << id()
+             << " dpts_generator: *** aborted before execution ***" << endl;
+        return;
+    }
+
+    auto* collection = new dpts_collection(
+        _source, _source_pos, _source_orient, _source_speed, _receiver,
+        _receiver_pos, _receiver_orient, _receiver_speed, _fsample, _fband,
+        _travel_times);
+    dpts_collection::csptr result(collection);
+
+    cout << "task #" << id() << " dpts_generator: " << _description << endl;
+
+    // create the waveform for each transmission, with the phase of each
+    // waveform starting at the end phase of the previous one
+
+    const std::vector<double> starts = start_times(_transmit_schedule);
+    std::vector<cdvector> waveforms;
+    std::vector<bvector> steerings;
+    double phase = 0.0;
+    size_t kernel_size = 1;
+    for (const auto& transmit : _transmit_schedule) {
+        waveforms.push_back(transmit->asignal(_fsample, _fband, phase, &phase));
+        kernel_size = std::max(kernel_size, waveforms.back().size());
+        steerings.emplace_back(matrix_column<matrix<double> >(
+            _source_steering, waveforms.size() - 1));
+    }
+    const size_t num_pings = waveforms.size();
+
+    // use the same FFT size for all waveforms, so that they can share
+    // the same block size
+
+    const size_t fft_size =
+        std::max(_fft_size, (_fft_size == 0) ? 4 * kernel_size : kernel_size);
+    std::vector<overlap_add> kernels;
+    for (const auto& waveform : waveforms) {
+        kernels.emplace_back(waveform, fft_size);
+    }
+    const size_t block_size =
+        (num_pings == 0) ? 1 : kernels.front().fft_size() - kernel_size + 1;
+
+    // split receiver channels into contiguous groups, one per thread,
+    // so that each thread updates its own rows of the time series
+
+    const size_t num_channels = collection->rcv_keys().size();
+    const size_t num_groups = std::max(
+        (size_t)1,
+        std::min(num_channels, thread_controller::instance()->num_threads()));
+    std::vector<dpts_collection::workspace> scratch(num_groups);
+
+    // compute impulse response for each channel and transmission
+
+    const eigenray_view rays =
+        (_dirpaths == nullptr) ? eigenray_view() : _dirpaths->view();
+    std::vector<dpts_collection::tap_list> taps(num_channels * num_pings);
+    auto impulse = [&](size_t group) {
+        const size_t first = group * num_channels / num_groups;
+        const size_t last = (group + 1) * num_channels / num_groups;
+        for (size_t channel = first; channel < last; ++channel) {
+            size_t n = 0;
+            for (const auto& transmit : _transmit_schedule) {
+                collection->impulse_response(
+                    rays, *transmit, starts[n], steerings[n], channel,
+                    &taps[channel * num_pings + n], &scratch[group]);
+                ++n;
+            }
+        }
+    };
+    if (!parallel_for::run(num_groups, impulse, &_abort, priority()) ||
+        _abort) {
+        cout << "task #" << id()
+             << " dpts_generator *** aborted during execution ***" << endl;
+        return;
+    }
+
+    // convolve each block of samples with the transmit waveforms, and
+    // notify block listeners as each block is completed
+
+    const size_t num_samples = _travel_times->size();
+    for (size_t block = 0; block < num_samples; block += block_size) {
+        const size_t count = std::min(block_size, num_samples - block);
+        auto body = [&](size_t group) {
+            const size_t first = group * num_channels / num_groups;
+            const size_t last = (group + 1) * num_channels / num_groups;
+            for (size_t channel = first; channel < last; ++channel) {
+                for (size_t n = 0; n < num_pings; ++n) {
+                    collection->add_block(taps[channel * num_pings + n],
+                                          kernels[n], channel, block, count,
+                                          &scratch[group]);
+                }
+            }
+        };
+        if (!parallel_for::run(num_groups, body, &_abort, priority()) ||
+            _abort) {
+            cout << "task #" << id()
+                 << " dpts_generator *** aborted during execution ***"
+                 << endl;
+            return;
+        }
+        dpts_block completed{result, block, count};
+        notify_update(&completed);
+    }
+
+    // notify listeners of results
+
+    _done = true;
+    notify_update(&result);
+    cout << "task #" << id() << " dpts_generator: done" << endl;
+}
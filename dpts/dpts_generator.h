@@ -0,0 +1,154 @@
+/**
+ * @file dpts_generator.h
+ * Background task to compute direct path time series for a bistatic pair.
+ */
+#pragma once
+
+#include <usml/dpts/dpts_block.h>
+#include <usml/dpts/dpts_collection.h>
+#include <usml/eigenrays/eigenray_collection.h>
+#include <usml/managed/update_notifier.h>
+#include <usml/sensors/sensor_model.h>
+#include <usml/threads/thread_task.h>
+#include <usml/transmit/transmit_model.h>
+#include <usml/types/orientation.h>
+#include <usml/types/seq_vector.h>
+#include <usml/types/wposition1.h>
+#include <usml/usml_config.h>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <cstddef>
+#include <string>
+
+namespace usml {
+namespace dpts {
+
+using namespace usml::eigenrays;
+using namespace usml::managed;
+using namespace usml::sensors;
+using namespace usml::threads;
+using namespace usml::transmit;
+using namespace usml::types;
+
+/// @ingroup dpts
+/// @{
+
+/**
+ * Background task to compute direct path time series for a bistatic pair.
+ * Builds the complex baseband impulse response of each transmission, for
+ * each receiver channel, from the direct path eigenrays. Then convolves
+ * them with the transmit waveforms using FFT overlap-add.
+ *
+ * The time series is computed one block of samples at a time. The receiver
+ * channels are split into contiguous groups, one for each thread in the
+ * thread_controller pool, and the groups are processed in parallel using
+ * parallel_for. Each group only writes to its own rows of the
+ * dpts_collection time series, so no locking is needed. Listeners for
+ * dpts_block updates are notified as each block is completed, so that
+ * they can start to use the signal before the whole time series has been
+ * computed. Listeners for dpts_collection updates are notified when the
+ * computation is complete.
+ */
+class USML_DECLSPEC dpts_generator
+    : public thread_task,
+      public update_notifier<dpts_collection::csptr>,
+      public update_notifier<dpts_block> {
+   public:
+    using update_notifier<dpts_collection::csptr>::add_listener;
+    using update_notifier<dpts_collection::csptr>::remove_listener;
+    using update_notifier<dpts_collection::csptr>::notify_update;
+    using update_notifier<dpts_block>::add_listener;
+    using update_notifier<dpts_block>::remove_listener;
+    using update_notifier<dpts_block>::notify_update;
+
+    /**
+     * Initialize generator with state of sensor_pair at this time. Makes copies
+     * of the position, orientation, speed, and transmit pulses at the time that
+     * the generator is constructed to ensure that the state of the sensor pair
+     * is consistent throughout the calculation. The time series is sampled
+     * from the receiver's time_minimum() to its time_maximum().
+     *
+     * Each transmission starts after the completion of the previous pulse,
+     * plus the delay of this pulse, as computed by start_times(). The
+     * rvbts_generator uses the same timing. The phase of each waveform
+     * starts at the end phase of the previous waveform.
+     *
+     * @param source      	Reference to the source for this pair.
+     * @param receiver    	Reference to the receiver for this pair.
+     * @param dirpaths		Direct path eigenrays from source to receiver,
+     *                      like those from sensor_pair::dirpaths().
+     * @param fsample       Sampling rate for time series (Hz).
+     * @param fband         Center of the frequency band for complex
+     *                      basebanding (Hz).
+     * @param fft_size      Minimum FFT size for overlap-add. Uses four times
+     *                      the longest waveform if zero.
+     */
+    dpts_generator(const sensor_model::sptr& source,
+                   const sensor_model::sptr& receiver,
+                   const eigenray_collection::csptr& dirpaths, double fsample,
+                   double fband, size_t fft_size = 0);
+
+    /**
+     * Compute direct path time series for a bistatic pair. Computes the
+     * impulse response of each transmission for each receiver channel, and
+     * then convolves them with their waveforms, one block at a time.
+     */
+    virtual void run();
+
+   private:
+    /// Human readable name for this object instance.
+    const std::string _description;
+
+    /// Reference to source sensor
+    const sensor_model::sptr _source;
+
+    /// Source position at time that class constructed.
+    const wposition1 _source_pos;
+
+    /// Source orientation at time that class constructed.
+    const orientation _source_orient;
+
+    /// Source speed at time that class constructed (m/s).
+    const double _source_speed;
+
+    /// List of transmit pulses for this source.
+    transmit_list _transmit_schedule;
+
+    /// Reference to receiver sensor
+    const sensor_model::sptr _receiver;
+
+    /// Receiver position at time that class constructed.
+    const wposition1 _receiver_pos;
+
+    /// Receiver orientation at time that class constructed.
+    const orientation _receiver_orient;
+
+    /// Receiver speed at time that class constructed (m/s).
+    const double _receiver_speed;
+
+    /// Direct path eigenrays from source to receiver.
+    const eigenray_collection::csptr _dirpaths;
+
+    /// Sampling rate for time series (Hz).
+    const double _fsample;
+
+    /// Center of the frequency band for complex basebanding (Hz).
+    const double _fband;
+
+    /// Minimum FFT size for overlap-add.
+    const size_t _fft_size;
+
+    /// Receiver times at which time series is sampled (sec).
+    const seq_vector::csptr _travel_times;
+
+    /**
+     * Source steerings relative to source array orientation. The rows represent
+     * front, right, and up coordinates.  There is a column for each pulse in
+     * the transmit schedule.
+     */
+    matrix<double> _source_steering;
+};
+
+/// @}
+}  // end of namespace dpts
+}  // end of namespace usml
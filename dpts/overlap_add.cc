@@ -0,0 +1,117 @@
+/**
+ * @file overlap_add.cc
+ * FFT overlap-add convolution of complex signals with a fixed kernel.
+ */
+
+#include <usml/dpts/overlap_add.h>
+#include <usml/ublas/math_traits.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace usml::dpts;
+
+/**
+ * Computes the spectrum of a convolution kernel.
+ */
+overlap_add::overlap_add(const cdvector& kernel, size_t fft_size)
+    : _kernel_size(std::max((size_t)1, kernel.size())),
+      _fft_size(next_pow2(
+          std::max(_kernel_size, fft_size == 0 ? 4 * _kernel_size : fft_size))),
+      _reverse(_fft_size),
+      _twiddle(_fft_size / 2),
+      _spectrum(_fft_size, complex(0.0, 0.0)) {
+    // bit reversal table
+
+    size_t bits = 0;
+    while (((size_t)1 << bits) < _fft_size) {
+        ++bits;
+    }
+    for (size_t n = 0; n < _fft_size; ++n) {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            r |= ((n >> b) & 1) << (bits - 1 - b);
+        }
+        _reverse[n] = r;
+    }
+
+    // twiddle factors
+
+    for (size_t k = 0; k < _twiddle.size(); ++k) {
+        _twiddle[k] = std::polar(1.0, -TWO_PI * (double)k / (double)_fft_size);
+    }
+
+    // spectrum of kernel, with inverse FFT normalization folded in
+
+    std::copy(kernel.begin(), kernel.end(), _spectrum.begin());
+    transform(_spectrum.data(), false);
+    const double scale = 1.0 / (double)_fft_size;
+    for (auto& value : _spectrum) {
+        value *= scale;
+    }
+}
+
+/**
+ * Adds the convolution of a block of input samples with the kernel to
+ * an output buffer.
+ */
+void overlap_add::convolve(const complex* input, size_t count, complex* output,
+                           size_t num_output,
+                           std::vector<complex>* scratch) const {
+    count = std::min(count, block_size());
+    scratch->resize(_fft_size);
+    complex* data = scratch->data();
+    std::copy(input, input + count, data);
+    std::fill(data + count, data + _fft_size, complex(0.0, 0.0));
+
+    transform(data, false);
+    for (size_t n = 0; n < _fft_size; ++n) {
+        data[n] *= _spectrum[n];
+    }
+    transform(data, true);
+
+    const size_t num = std::min(num_output, count + _kernel_size - 1);
+    for (size_t n = 0; n < num; ++n) {
+        output[n] += data[n];
+    }
+}
+
+/**
+ * In-place FFT with a length of fft_size().
+ */
+void overlap_add::transform(complex* data, bool inverse) const {
+    for (size_t n = 0; n < _fft_size; ++n) {
+        const size_t r = _reverse[n];
+        if (n < r) {
+            std::swap(data[n], data[r]);
+        }
+    }
+    for (size_t length = 2; length <= _fft_size; length <<= 1) {
+        const size_t half = length / 2;
+        const size_t step = _fft_size / length;
+        for (size_t start = 0; start < _fft_size; start += length) {
+            complex* lower = data + start;
+            complex* upper = lower + half;
+            for (size_t k = 0; k < half; ++k) {
+                const complex& twiddle = _twiddle[k * step];
+                const complex w = inverse ? std::conj(twiddle) : twiddle;
+                const complex u = lower[k];
+                const complex v = upper[k] * w;
+                lower[k] = u + v;
+                upper[k] = u - v;
+            }
+        }
+    }
+}
+
+/**
+ * Smallest power of two that is greater than or equal to a value.
+ */
+size_t overlap_add::next_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file overlap_add.h
+ * FFT overlap-add convolution of complex signals with a fixed kernel.
+ */
+#pragma once
+
+#include <usml/transmit/transmit_model.h>
+#include <usml/usml_config.h>
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace usml {
+namespace dpts {
+
+using namespace usml::transmit;
+
+/// @ingroup dpts
+/// @{
+
+/**
+ * FFT overlap-add convolution of complex signals with a fixed kernel.
+ * A long input signal is split into blocks of block_size() samples. Each
+ * block is padded with zeros to the FFT size, transformed, multiplied by the
+ * spectrum of the kernel, and transformed back. The result for each block
+ * is kernel_size()-1 samples longer than the block itself, and this tail is
+ * added to the start of the result for the next block.
+ *
+ * Uses an iterative radix-2 FFT, so the FFT size is always a power of two.
+ * The bit reversal table, twiddle factors, and kernel spectrum are computed
+ * once, when the object is constructed. The convolve() method does not
+ * modify the object, so a single overlap_add can be shared by multiple
+ * threads, as long as each thread uses its own scratch memory.
+ */
+class USML_DECLSPEC overlap_add {
+   public:
+    /// Complex sample type.
+    typedef std::complex<double> complex;
+
+    /**
+     * Computes the spectrum of a convolution kernel.
+     *
+     * @param kernel    Convolution kernel, like a transmit waveform.
+     * @param fft_size  Minimum FFT size. Rounded up to the next power of two
+     *                  that is at least as large as the kernel. Uses four
+     *                  times the kernel size if zero.
+     */
+    overlap_add(const cdvector& kernel, size_t fft_size = 0);
+
+    /// Number of samples in the convolution kernel.
+    size_t kernel_size() const { return _kernel_size; }
+
+    /// Number of samples in each FFT.
+    size_t fft_size() const { return _fft_size; }
+
+    /// Maximum number of input samples that can be convolved at once.
+    size_t block_size() const { return _fft_size - _kernel_size + 1; }
+
+    /**
+     * Adds the convolution of a block of input samples with the kernel to
+     * an output buffer. The full result has count+kernel_size()-1 samples,
+     * but it is truncated if it would extend past the end of the output.
+     *
+     * @param input         Block of input samples.
+     * @param count         Number of input samples, at most block_size().
+     * @param output        Output buffer, result is added to its contents.
+     * @param num_output    Number of samples available in the output.
+     * @param scratch       Scratch memory for this thread.
+     */
+    void convolve(const complex* input, size_t count, complex* output,
+                  size_t num_output, std::vector<complex>* scratch) const;
+
+    /**
+     * In-place FFT with a length of fft_size(). The inverse transform is not
+     * scaled by the length of the FFT.
+     *
+     * @param data      Samples to be transformed.
+     * @param inverse   Compute the inverse transform if true.
+     */
+    void transform(complex* data, bool inverse) const;
+
+    /**
+     * Smallest power of two that is greater than or equal to a value.
+     *
+     * @param value     Value to be rounded up.
+     */
+    static size_t next_pow2(size_t value);
+
+   private:
+    /// Number of samples in the convolution kernel.
+    const size_t _kernel_size;
+
+    /// Number of samples in each FFT.
+    const size_t _fft_size;
+
+    /// Bit reversed index for each sample in the FFT.
+    std::vector<size_t> _reverse;
+
+    /// Forward twiddle factors, exp(-2 pi i k / N) for k < N/2.
+    std::vector<complex> _twiddle;
+
+    /// Spectrum of the kernel, scaled by 1/N to normalize the inverse FFT.
+    std::vector<complex> _spectrum;
+};
+
+/// @}
+}  // namespace dpts
+}  // namespace usml
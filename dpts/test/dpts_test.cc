@@ -0,0 +1,320 @@
+/**
+ * @example dpts/test/dpts_test.cc
+ */
+
+#include <usml/beampatterns/bp_omni.h>
+#include <usml/dpts/dpts.h>
+#include <usml/eigenrays/eigenray_collection.h>
+#include <usml/eigenrays/eigenray_model.h>
+#include <usml/managed/update_listener.h>
+#include <usml/sensors/sensor_model.h>
+#include <usml/threads/thread_controller.h>
+#include <usml/transmit/transmit_cw.h>
+#include <usml/transmit/transmit_model.h>
+#include <usml/types/seq_linear.h>
+#include <usml/types/wposition.h>
+#include <usml/types/wposition1.h>
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(dpts_test)
+
+using namespace usml::dpts;
+using namespace usml::sensors;
+using namespace usml::transmit;
+
+/**
+ * Records the blocks delivered by a dpts_generator.
+ */
+class block_listener : public update_listener<dpts_block> {
+   public:
+    /**
+     * Store the position of each block.
+     *
+     * @param block  Reference to completed block.
+     */
+    void notify_update(const dpts_block* block) override {
+        first.push_back(block->first);
+        size.push_back(block->size);
+        collection = block->collection;
+    }
+
+    /// Sample number at the start of each block.
+    std::vector<size_t> first;
+
+    /// Number of samples in each block.
+    std::vector<size_t> size;
+
+    /// Collection that holds the time series.
+    dpts_collection::csptr collection;
+};
+
+/**
+ * @ingroup dpts_test
+ * @{
+ */
+
+/**
+ * Compares FFT overlap-add convolution to a direct convolution in the time
+ * domain. Convolves a long signal, one block at a time, with kernels whose
+ * length is not a power of two. Test fails if any sample of the overlap-add
+ * result differs from the direct convolution by more than 1e-9.
+ */
+BOOST_AUTO_TEST_CASE(overlap_add_convolve) {
+    cout << "=== dpts_test: overlap_add_convolve ===" << endl;
+    typedef std::complex<double> complex;
+    const size_t num_input = 1000;
+    std::vector<complex> input(num_input);
+    for (size_t n = 0; n < num_input; ++n) {
+        input[n] = complex(sin(0.1 * n) + cos(0.037 * n * n), cos(0.3 * n));
+    }
+    for (size_t kernel_size : {1, 7, 100}) {
+        cdvector kernel(kernel_size);
+        for (size_t n = 0; n < kernel_size; ++n) {
+            kernel[n] = complex(1.0 / (1.0 + n), sin(0.5 * n));
+        }
+        overlap_add convolver(kernel);
+        BOOST_CHECK_EQUAL(convolver.fft_size(),
+                          overlap_add::next_pow2(4 * kernel_size));
+
+        const size_t num_output = num_input + kernel_size - 1;
+        std::vector<complex> output(num_output, complex(0.0, 0.0));
+        std::vector<complex> scratch;
+        for (size_t first = 0; first < num_input;
+             first += convolver.block_size()) {
+            const size_t count =
+                std::min(convolver.block_size(), num_input - first);
+            convolver.convolve(&input[first], count, &output[first],
+                               num_output - first, &scratch);
+        }
+        for (size_t n = 0; n < num_output; ++n) {
+            complex expected(0.0, 0.0);
+            for (size_t k = 0; k < kernel_size; ++k) {
+                if (n >= k && n - k < num_input) {
+                    expected += kernel[k] * input[n - k];
+                }
+            }
+            BOOST_CHECK_SMALL(std::abs(output[n] - expected), 1e-9);
+        }
+    }
+}
+
+/**
+ * Synthesizes the direct path signal for two eigenrays and two CW pulses,
+ * using a receiver with three omni-directional channels. The FFT size is
+ * chosen so that the pulses span several blocks. Arrivals are rounded to the
+ * nearest sample, so that the result can be compared to a direct sum of
+ * sampled waveforms.
+ *
+ * This test passes if:
+ *   - the blocks delivered to the listener are contiguous and cover the
+ *     whole time series,
+ *   - each channel matches a direct time domain sum of delayed, scaled,
+ *     and phase shifted copies of the transmit waveforms, and
+ *   - all channels are identical.
+ */
+BOOST_AUTO_TEST_CASE(synthesize_dirpaths) {
+    cout << "=== dpts_test: synthesize_dirpaths ===" << endl;
+    typedef std::complex<double> complex;
+    thread_controller::reset(2);
+    dpts_collection::delay_taps = 1;
+    const double fsample = 1000.0;
+    const double fband = 900.0;
+    auto beam = bp_model::csptr(new bp_omni());
+
+    sensor_model::sptr source(new sensor_model(1, "source"));
+    source->src_beam(0, beam);
+    transmit_list transmits;
+    transmits.push_back(transmit_model::csptr(
+        new transmit_cw("CW", 0.1, 1000.0, 0.0, 200.0)));
+    transmits.push_back(transmit_model::csptr(
+        new transmit_cw("CW", 0.05, 950.0, 0.2, 190.0)));
+    source->transmit_schedule(transmits);
+
+    sensor_model::sptr receiver(new sensor_model(2, "receiver"));
+    receiver->time_maximum(1.0);
+    for (int channel = 0; channel < 3; ++channel) {
+        receiver->rcv_beam(channel, beam);
+    }
+
+    // direct path eigenrays from source to receiver
+
+    seq_vector::csptr frequencies(new seq_linear(900.0, 100.0, 3));
+    matrix<uint64_t> targetIDs(1, 1);
+    targetIDs(0, 0) = 2;
+    auto* collection = new eigenray_collection(
+        frequencies, source->position(), wposition(1, 1), 1, targetIDs);
+    const double travel_time[] = {0.1234, 0.3017};
+    const double loss[] = {60.0, 66.0};
+    for (size_t n = 0; n < 2; ++n) {
+        auto* ray = new eigenray_model();
+        ray->travel_time = travel_time[n];
+        ray->frequencies = frequencies;
+        ray->intensity = scalar_vector<double>(3, loss[n]);
+        ray->phase = scalar_vector<double>(3, n * M_PI / 2.0);
+        collection->add_eigenray(0, 0, eigenray_model::csptr(ray));
+    }
+    collection->sum_eigenrays();
+    eigenray_collection::csptr dirpaths(collection);
+
+    // synthesize time series in blocks
+
+    block_listener listener;
+    dpts_generator generator(source, receiver, dirpaths, fsample, fband, 128);
+    generator.add_listener(&listener);
+    generator.run();
+    BOOST_REQUIRE(listener.collection != nullptr);
+    const auto& series = listener.collection->time_series();
+    BOOST_REQUIRE_EQUAL(series.size1(), 3);
+    BOOST_REQUIRE_EQUAL(series.size2(), 1001);
+    BOOST_CHECK_GT(listener.first.size(), 1);
+    size_t next = 0;
+    for (size_t b = 0; b < listener.first.size(); ++b) {
+        BOOST_CHECK_EQUAL(listener.first[b], next);
+        next += listener.size[b];
+    }
+    BOOST_CHECK_EQUAL(next, series.size2());
+
+    // compare to direct time domain synthesis
+
+    std::vector<complex> expected(series.size2(), complex(0.0, 0.0));
+    double start = 0.0;
+    double phase = 0.0;
+    for (const auto& transmit : transmits) {
+        start += transmit->delay;
+        cdvector waveform = transmit->asignal(fsample, fband, phase, &phase);
+        for (size_t n = 0; n < 2; ++n) {
+            const double time = start + travel_time[n];
+            const auto offset = (size_t)std::round(time * fsample);
+            const complex value = std::polar(
+                pow(10.0, (transmit->source_level - loss[n]) / 20.0),
+                TWO_PI * fband * time - n * M_PI / 2.0);
+            for (size_t k = 0; k < waveform.size(); ++k) {
+                if (offset + k < expected.size()) {
+                    expected[offset + k] += value * waveform[k];
+                }
+            }
+        }
+        start += transmit->duration;
+    }
+    double peak = 0.0;
+    for (const auto& value : expected) {
+        peak = std::max(peak, std::abs(value));
+    }
+    BOOST_CHECK_GT(peak, 1e6);
+    for (size_t t = 0; t < series.size2(); ++t) {
+        BOOST_CHECK_SMALL(std::abs(series(0, t) - expected[t]), 1e-9 * peak);
+        for (size_t channel = 1; channel < series.size1(); ++channel) {
+            BOOST_CHECK_EQUAL(series(channel, t), series(0, t));
+        }
+    }
+    dpts_collection::delay_taps = 8;
+    thread_controller::reset();
+}
+
+/**
+ * Compares the direct path signal for a single eigenray to an analytic
+ * model of two CW pulses. The eigenray arrives between samples, and the
+ * second pulse starts at its delay after the end of the first pulse. The
+ * received signal for each pulse is
+ * \f$ A \sin( 2\pi f_c (t-\tau) + \theta + \phi ) \f$
+ * for \f$ \tau \le t < \tau + T \f$, where \f$ \tau \f$ is the start of
+ * the pulse plus the travel time, \f$ \theta \f$ is the phase at the end
+ * of the previous pulse, and \f$ \phi \f$ is the phase of the eigenray.
+ * Its complex baseband form, in the convention of transmit_model::asignal(),
+ * is
+ * \f[
+ *      s(t) = i A e^{ -i ( 2\pi (f_c - f_b)(t - \tau) + \theta + \phi
+ *                          - 2\pi f_b \tau ) }
+ * \f]
+ *
+ * This test passes if the samples inside of each pulse, away from its
+ * edges, match the analytic signal to within 1e-4 of its amplitude.
+ */
+BOOST_AUTO_TEST_CASE(analytic_arrival) {
+    cout << "=== dpts_test: analytic_arrival ===" << endl;
+    typedef std::complex<double> complex;
+    const double fsample = 1000.0;
+    const double fband = 900.0;
+    auto beam = bp_model::csptr(new bp_omni());
+
+    const double duration[] = {0.1, 0.05};
+    const double fcenter[] = {1000.0, 950.0};
+    const double delay[] = {0.0, 0.2};
+    const double level[] = {200.0, 190.0};
+    sensor_model::sptr source(new sensor_model(1, "source"));
+    source->src_beam(0, beam);
+    transmit_list transmits;
+    for (size_t n = 0; n < 2; ++n) {
+        transmits.push_back(transmit_model::csptr(new transmit_cw(
+            "CW", duration[n], fcenter[n], delay[n], level[n])));
+    }
+    source->transmit_schedule(transmits);
+
+    sensor_model::sptr receiver(new sensor_model(2, "receiver"));
+    receiver->time_maximum(1.0);
+    receiver->rcv_beam(0, beam);
+
+    // single eigenray that arrives between samples
+
+    const double travel_time = 0.12345;
+    const double loss = 60.0;
+    const double ray_phase = 0.3;
+    seq_vector::csptr frequencies(new seq_linear(900.0, 100.0, 3));
+    matrix<uint64_t> targetIDs(1, 1);
+    targetIDs(0, 0) = 2;
+    auto* collection = new eigenray_collection(
+        frequencies, source->position(), wposition(1, 1), 1, targetIDs);
+    auto* ray = new eigenray_model();
+    ray->travel_time = travel_time;
+    ray->frequencies = frequencies;
+    ray->intensity = scalar_vector<double>(3, loss);
+    ray->phase = scalar_vector<double>(3, ray_phase);
+    collection->add_eigenray(0, 0, eigenray_model::csptr(ray));
+    collection->sum_eigenrays();
+
+    block_listener listener;
+    dpts_generator generator(source, receiver,
+                             eigenray_collection::csptr(collection), fsample,
+                             fband, 0);
+    generator.add_listener(&listener);
+    generator.run();
+    BOOST_REQUIRE(listener.collection != nullptr);
+    const auto& series = listener.collection->time_series();
+
+    // compare samples inside of each pulse to the analytic signal
+
+    const size_t edge = dpts_collection::delay_taps;
+    double start = 0.0;
+    double theta = 0.0;
+    size_t num_checked = 0;
+    for (size_t n = 0; n < 2; ++n) {
+        start += delay[n];
+        const double tau = start + travel_time;
+        const double amplitude = pow(10.0, (level[n] - loss) / 20.0);
+        const double omega = TWO_PI * (fcenter[n] - fband);
+        const size_t first = (size_t)std::ceil(tau * fsample) + edge;
+        const size_t last =
+            (size_t)std::floor((tau + duration[n]) * fsample) - edge;
+        for (size_t t = first; t < last; ++t) {
+            const double time = (double)t / fsample;
+            const complex expected =
+                complex(0.0, 1.0) *
+                std::polar(amplitude, TWO_PI * fband * tau - ray_phase -
+                                          omega * (time - tau) - theta);
+            BOOST_CHECK_SMALL(std::abs(series(0, t) - expected),
+                              1e-4 * amplitude);
+            ++num_checked;
+        }
+        theta = fmod(omega * duration[n] + theta, TWO_PI);
+        start += duration[n];
+    }
+    BOOST_CHECK_GT(num_checked, 100);
+}
+
+/// @}
+BOOST_AUTO_TEST_SUITE_END()
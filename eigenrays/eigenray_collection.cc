@@ -4,6 +4,9 @@
  */
 
 #include <usml/eigenrays/eigenray_collection.h>
+#include <usml/threads/parallel_for.h>
+#include <usml/types/archive.h>
+#include <usml/types/seq_data.h>
 #include <usml/types/wvector1.h>
 #include <usml/ublas/math_traits.h>
 
@@ -14,8 +17,207 @@
 #include <complex>
 #include <list>
 #include <netcdf>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 using namespace usml::eigenrays;
+using namespace usml::threads;
+
+/**
+ * Number of targets summed as a single unit of parallel work.
+ */
+size_t eigenray_collection::targets_per_task = 64;
+
+namespace {
+
+/**
+ * Scratch memory used to sum the eigenrays of one target. Each array is
+ * reused from one target to the next, so that memory is only allocated
+ * while the arrays grow to their working size.
+ */
+struct sum_scratch {
+    /// Time of arrival for each eigenray (sec).
+    std::vector<double> travel_time;
+
+    /// Propagation loss for each frequency and eigenray, frequency major (dB).
+    std::vector<double> intensity;
+
+    /// Phase for each frequency and eigenray, frequency major (radians).
+    std::vector<double> phase;
+
+    /// Pressure amplitude of each eigenray at the current frequency.
+    std::vector<double> amplitude;
+
+    /// Pressure squared of each eigenray, summed over frequency.
+    std::vector<double> weight;
+};
+
+/**
+ * Compute propagation loss summed over the eigenrays of a single target.
+ * The eigenrays are copied into frequency major arrays so that the loops
+ * over eigenrays, for each frequency, read contiguous memory with no
+ * branches, and can be vectorized by the compiler. The pressure squared of
+ * each eigenray is summed over frequency before computing the weighted
+ * averages of time and angle, so that the sine and cosine of each
+ * azimuth are only computed once per eigenray.
+ *
+ * @param rays      Eigenrays for this target.
+ * @param freq      Frequencies over which to compute loss (Hz).
+ * @param coherent  Compute coherent propagation totals if true.
+ * @param scratch   Scratch memory, reused from one target to the next.
+ * @param total     Propagation loss summed over all eigenrays (output).
+ */
+void sum_rays(const eigenray_view &rays, const seq_vector &freq,
+              bool coherent, sum_scratch *scratch, eigenray_model *total) {
+    const size_t N = rays.size();
+    const size_t num_freq = freq.size();
+    scratch->travel_time.resize(N);
+    scratch->intensity.resize(N * num_freq);
+    scratch->phase.resize(N * num_freq);
+    scratch->amplitude.resize(N);
+    scratch->weight.assign(N, 0.0);
+    double *travel_time = scratch->travel_time.data();
+    double *amplitude = scratch->amplitude.data();
+    double *weight = scratch->weight.data();
+
+    // copy eigenrays into frequency major arrays
+
+    size_t n = 0;
+    for (size_t index : rays) {
+        travel_time[n] = rays.travel_time(index);
+        const double *intensity = rays.intensity(index);
+        const double *phase = rays.phase(index);
+        for (size_t f = 0; f < num_freq; ++f) {
+            scratch->intensity[f * N + n] = intensity[f];
+            scratch->phase[f * N + n] = phase[f];
+        }
+        ++n;
+    }
+
+    // sum complex amplitudes over eigenrays at each frequency,
+    // and find the eigenray with the largest amplitude
+
+    const double db_scale = -log(10.0) / 20.0;
+    double max_a = 0.0;
+    size_t strongest = N;
+    for (size_t f = 0; f < num_freq; ++f) {
+        const double *intensity = &scratch->intensity[f * N];
+        for (n = 0; n < N; ++n) {
+            amplitude[n] = exp(db_scale * intensity[n]);  // pressure
+        }
+
+        double real = 0.0;
+        double imag = 0.0;
+        if (coherent) {
+            const double frequency = freq(f);
+            const double *phase = &scratch->phase[f * N];
+            for (n = 0; n < N; ++n) {
+                // remove whole cycles, large phases bad for cos,sin
+                double cycles = frequency * travel_time[n];
+                cycles -= floor(cycles);
+                const double p = TWO_PI * cycles + phase[n];
+                real += amplitude[n] * cos(p);
+                imag += amplitude[n] * sin(p);
+            }
+        } else {
+            for (n = 0; n < N; ++n) {
+                real += amplitude[n];
+            }
+        }
+
+        for (n = 0; n < N; ++n) {
+            amplitude[n] *= amplitude[n];  // scale by the pressure squared
+            weight[n] += amplitude[n];
+        }
+        for (n = 0; n < N; ++n) {
+            if (amplitude[n] > max_a) {
+                max_a = amplitude[n];
+                strongest = n;
+            }
+        }
+
+        // convert back into intensity (dB) and phase (radians) values
+
+        const std::complex<double> phasor(real, imag);
+        total->intensity(f) = -20.0 * log10(max(1e-15, abs(phasor)));
+        total->phase(f) = arg(phasor);
+    }
+
+    // weighted average of other eigenray terms
+
+    double wgt = 0.0;
+    double time = 0.0;
+    double source_de = 0.0;
+    double source_az_x = 0.0;  // east/west component
+    double source_az_y = 0.0;  // north/south component
+    double target_de = 0.0;
+    double target_az_x = 0.0;  // east/west component
+    double target_az_y = 0.0;  // north/south component
+    int surface = -1;
+    int bottom = -1;
+    int caustic = -1;
+    int upper = -1;
+    int lower = -1;
+    n = 0;
+    for (size_t index : rays) {
+        const double a = weight[n];
+        wgt += a;
+        time += a * travel_time[n];
+        source_de += a * rays.source_de(index);
+        source_az_x += a * sin(to_radians(rays.source_az(index)));
+        source_az_y += a * cos(to_radians(rays.source_az(index)));
+        target_de += a * rays.target_de(index);
+        target_az_x += a * sin(to_radians(rays.target_az(index)));
+        target_az_y += a * cos(to_radians(rays.target_az(index)));
+        if (n == strongest) {
+            const int *paths = rays.paths(index);
+            surface = paths[0];
+            bottom = paths[1];
+            caustic = paths[2];
+            upper = paths[3];
+            lower = paths[4];
+        }
+        ++n;
+    }
+    total->travel_time = time / wgt;
+    total->source_de = source_de / wgt;
+    total->source_az = 90.0 - to_degrees(atan2(source_az_y, source_az_x));
+    total->target_de = target_de / wgt;
+    total->target_az = 90.0 - to_degrees(atan2(target_az_y, target_az_x));
+    total->surface = surface;
+    total->bottom = bottom;
+    total->caustic = caustic;
+    total->upper = upper;
+    total->lower = lower;
+}
+
+/**
+ * Reads a whole netCDF variable with a single call.
+ */
+template <class T>
+std::vector<T> read_variable(const netCDF::NcFile &nc_file, const char *name,
+                             size_t size) {
+    std::vector<T> values(size);
+    if (size > 0) {
+        nc_file.getVar(name).getVar(values.data());
+    }
+    return values;
+}
+
+/**
+ * Copies a row major array from an archive into a matrix.
+ */
+matrix<double> read_grid(const archive_reader &archive, const char *name,
+                         size_t rows, size_t cols) {
+    const double *values = archive.column<double>(name, rows * cols);
+    matrix<double> grid(rows, cols);
+    std::copy_n(values, rows * cols, grid.data().begin());
+    return grid;
+}
+
+}  // namespace
 
 /**
  * Initialize the acoustic propagation effects associated
@@ -32,11 +234,11 @@ eigenray_collection::eigenray_collection(const seq_vector::csptr &frequencies,
       _source_pos(source_pos),
       _target_pos(target_pos),
       _frequencies(frequencies),
-      _eigenrays(target_pos.size1(), target_pos.size2()),
+      _eigenrays(target_pos.size1() * target_pos.size2()),
       _initial_time(target_pos.size1(), target_pos.size2()),
-      _num_eigenrays(0),
       _total(target_pos.size1(), target_pos.size2()),
       _coherent(coherent) {
+    _eigenrays.frequencies = frequencies;
     for (size_t t1 = 0; t1 < size1(); ++t1) {
         for (size_t t2 = 0; t2 < size2(); ++t2) {
             eigenray_model loss;
@@ -51,36 +253,70 @@ eigenray_collection::eigenray_collection(const seq_vector::csptr &frequencies,
             } else {
                 _targetIDs(t1, t2) = 0;
             }
+            _target_index.emplace(_targetIDs(t1, t2), std::make_pair(t1, t2));
         }
     }
 }
 
+/**
+ * Find the row and column of a single target in the grid.
+ */
+bool eigenray_collection::find_target(uint64_t targetID, size_t *t1,
+                                      size_t *t2) const {
+    if (targetID == 0) {
+        *t1 = 0;
+        *t2 = 0;
+        return size1() > 0 && size2() > 0;
+    }
+    auto iter = _target_index.find(targetID);
+    if (iter == _target_index.end()) {
+        return false;
+    }
+    *t1 = iter->second.first;
+    *t2 = iter->second.second;
+    return true;
+}
+
+/**
+ * Find a read only view of the results for a single target.
+ */
+eigenray_collection::target_view eigenray_collection::find_view(
+    uint64_t targetID, bool swapped) const {
+    target_view view;
+    view.targetID = targetID;
+    view.found = find_target(targetID, &view.t1, &view.t2);
+    if (view.found) {
+        view.eigenrays = this->view(view.t1, view.t2, swapped);
+        view.initial_time = initial_time(view.t1, view.t2);
+    }
+    return view;
+}
+
+/**
+ * Splits this collection into read only views for a list of targets.
+ */
+std::vector<eigenray_collection::target_view> eigenray_collection::find_views(
+    const std::vector<uint64_t> &targetIDs) const {
+    std::vector<target_view> views;
+    views.reserve(targetIDs.size());
+    for (uint64_t targetID : targetIDs) {
+        views.push_back(find_view(targetID));
+    }
+    return views;
+}
+
 /**
  * Find eigenrays for a single target in the grid.
  */
 eigenray_list eigenray_collection::find_eigenrays(uint64_t targetID) const {
-    for (size_t t1 = 0; t1 < size1(); ++t1) {
-        for (size_t t2 = 0; t2 < size2(); ++t2) {
-            if (_targetIDs(t1, t2) == targetID || targetID == 0) {
-                return eigenrays(t1, t2);
-            }
-        }
-    }
-    return {};
+    return find_view(targetID).eigenrays.list();
 }
 
 /**
  * Find fastest eigenray for a single target in the grid.
  */
 double eigenray_collection::find_initial_time(uint64_t targetID) const {
-    for (size_t t1 = 0; t1 < size1(); ++t1) {
-        for (size_t t2 = 0; t2 < size2(); ++t2) {
-            if (_targetIDs(t1, t2) == targetID || targetID == 0) {
-                return initial_time(t1, t2);
-            }
-        }
-    }
-    return 0.0;
+    return find_view(targetID).initial_time;
 }
 
 /**
@@ -90,104 +326,74 @@ double eigenray_collection::find_initial_time(uint64_t targetID) const {
 void eigenray_collection::add_eigenray(size_t t1, size_t t2,
                                        eigenray_model::csptr ray,
                                        size_t /*runID*/) {
-    _eigenrays(t1, t2).push_back(ray);
+    _eigenrays.push_back(t1 * size2() + t2, *ray);
     auto old_initial = _initial_time(t1, t2);
     auto new_initial = ray->travel_time;
     if (old_initial <= 0.0 || old_initial > new_initial) {
         _initial_time(t1, t2) = new_initial;
     }
-    ++_num_eigenrays;
 }
 
 /**
- * Compute propagation loss summed over all eigenrays.
+ * Copies the eigenrays in a view to a single target.
  */
-void eigenray_collection::sum_eigenrays() {
+void eigenray_collection::add_eigenrays(size_t t1, size_t t2,
+                                        const eigenray_view &rays,
+                                        double time_maximum) {
+    for (size_t index : rays) {
+        if (rays.travel_time(index) > time_maximum) {
+            continue;
+        }
+        _eigenrays.push_back(t1 * size2() + t2, *rays.columns(), index,
+                             rays.swapped());
+        auto old_initial = _initial_time(t1, t2);
+        auto new_initial = rays.travel_time(index);
+        if (old_initial <= 0.0 || old_initial > new_initial) {
+            _initial_time(t1, t2) = new_initial;
+        }
+    }
+}
+
+/**
+ * Creates a new collection with the eigenrays that arrive at or before
+ * a specific travel time.
+ */
+eigenray_collection::csptr eigenray_collection::snapshot(
+    double time_maximum) const {
+    auto *result = new eigenray_collection(_frequencies, _source_pos,
+                                           _target_pos, _sourceID,
+                                           _targetIDs, _coherent);
     for (size_t t1 = 0; t1 < size1(); ++t1) {
         for (size_t t2 = 0; t2 < size2(); ++t2) {
-            const eigenray_list &ray_list = eigenrays(t1, t2);
-            eigenray_model &total = _total(t1, t2);
-
-            double time = 0.0;
-            double source_de = 0.0;
-            double source_az_x = 0.0;  // east/west component
-            double source_az_y = 0.0;  // north/south component
-            double target_de = 0.0;
-            double target_az_x = 0.0;  // east/west component
-            double target_az_y = 0.0;  // north/south component
-            int surface = -1;
-            int bottom = -1;
-            int caustic = -1;
-            int upper = -1;
-            int lower = -1;
-            double wgt = 0.0;
-            double max_a = 0.0;
-
-            // compute at each frequency
-
-            for (size_t f = 0; f < _frequencies->size(); ++f) {
-                // sum complex amplitudes over eigenrays
-
-                std::complex<double> phasor(0.0, 0.0);
-                for (const auto &ray : ray_list) {
-                    // pressure amplitude
-
-                    double a =
-                        pow(10.0, ray->intensity(f) / -20.0);  // pressure
-                    if (_coherent) {
-                        double p =
-                            TWO_PI * (*_frequencies)(f)*ray->travel_time +
-                            ray->phase(f);
-                        p = fmod(p, TWO_PI);  // large phases bad for cos,sin
-                        std::complex<double> value(a * cos(p), a * sin(p));
-                        phasor += value;
-                    } else {
-                        phasor += a;
-                    }
+            result->add_eigenrays(t1, t2, view(t1, t2), time_maximum);
+        }
+    }
+    result->sum_eigenrays();
+    return csptr(result);
+}
 
-                    // other eigenray terms
-
-                    a *= a;  // scale by the pressure squared
-                    wgt += a;
-                    time += a * ray->travel_time;
-                    source_de += a * ray->source_de;
-                    source_az_x += a * sin(to_radians(ray->source_az));
-                    source_az_y += a * cos(to_radians(ray->source_az));
-                    target_de += a * ray->target_de;
-                    target_az_x += a * sin(to_radians(ray->target_az));
-                    target_az_y += a * cos(to_radians(ray->target_az));
-                    if (a > max_a) {
-                        max_a = a;
-                        surface = ray->surface;
-                        bottom = ray->bottom;
-                        caustic = ray->caustic;
-                        upper = ray->upper;
-                        lower = ray->lower;
-                    }
-                }  // end eigenray_list
-
-                // convert back into intensity (dB) and phase (radians) values
-
-                total.intensity(f) = -20.0 * log10(max(1e-15, abs(phasor)));
-                total.phase(f) = arg(phasor);
-            }  // end frequency
-
-            // weighted average of other eigenray terms
-
-            total.travel_time = time / wgt;
-            total.source_de = source_de / wgt;
-            total.source_az =
-                90.0 - to_degrees(atan2(source_az_y, source_az_x));
-            total.target_de = target_de / wgt;
-            total.target_az =
-                90.0 - to_degrees(atan2(target_az_y, target_az_x));
-            total.surface = surface;
-            total.bottom = bottom;
-            total.caustic = caustic;
-            total.upper = upper;
-            total.lower = lower;
-        }  // end target size2
-    }      // end target size1
+/**
+ * Compute propagation loss summed over all eigenrays.
+ */
+void eigenray_collection::sum_eigenrays() {
+    const size_t num_targets = size1() * size2();
+    const size_t block = std::max(targets_per_task, size_t(1));
+    const size_t num_blocks = (num_targets + block - 1) / block;
+    auto body = [&](size_t b) {
+        sum_scratch scratch;
+        const size_t last = std::min(num_targets, (b + 1) * block);
+        for (size_t t = b * block; t < last; ++t) {
+            const size_t t1 = t / size2();
+            const size_t t2 = t % size2();
+            sum_rays(view(t1, t2), *_frequencies, _coherent, &scratch,
+                     &_total(t1, t2));
+        }
+    };
+    if (num_blocks > 1) {
+        parallel_for::run(num_blocks, body);
+    } else if (num_blocks == 1) {
+        body(0);
+    }
 }
 
 /**
@@ -206,7 +412,7 @@ void eigenray_collection::write_netcdf(const char *filename,
     // clang-format off
     netCDF::NcDim row_dim = nc_file.addDim("rows", _target_pos.size1());
     netCDF::NcDim col_dim = nc_file.addDim("cols", _target_pos.size2());
-    netCDF::NcDim eigenray_dim = nc_file.addDim( "eigenrays", _num_eigenrays + _total.size1() * _total.size2());
+    netCDF::NcDim eigenray_dim = nc_file.addDim( "eigenrays", _eigenrays.size() + _total.size1() * _total.size2());
     netCDF::NcDim freq_dim = nc_file.addDim("frequencies", _frequencies->size());
     const std::vector< netCDF::NcDim > row_col_dims{ row_dim, col_dim };
     const std::vector< netCDF::NcDim > ray_freq_dims{ eigenray_dim, freq_dim };
@@ -317,23 +523,27 @@ void eigenray_collection::write_netcdf(const char *filename,
         row_col_index[0] = t1;
         for (size_t t2 = 0; t2 < _target_pos.size2(); ++t2) {
             row_col_index[1] = t2;
-            size_t num = _eigenrays(t1, t2).size();
+            const eigenray_view rays = view(t1, t2);
+            size_t num = rays.size();
             size_t next_rec = record + 1;
 
             proploss_index_var.putVar(row_col_index, &record);
             eigenray_index_var.putVar(row_col_index, &next_rec);
             eigenray_num_var.putVar(row_col_index, &num);
 
-            auto iter = _eigenrays(t1, t2).begin();
+            auto iter = rays.begin();
             for (int n = -1; n < (int)num; ++n) {
                 ray_index[0] = record++;
                 ray_freq_index[0] = ray_index[0];
                 ray_freq_index[1] = 0;
+                eigenray_model::csptr copy;
                 const eigenray_model *ray;
                 if (n < 0) {  // summed over all eigenrays
                     ray = &_total(t1, t2);
                 } else {  // individual eigenray
-                    ray = (*iter++).get();
+                    copy = rays.eigenray(*iter);
+                    ++iter;
+                    ray = copy.get();
                 }
                 intensity_var.putVar(ray_freq_index, ray_freq_count,
                                      ray->intensity.data().begin());
@@ -355,16 +565,412 @@ void eigenray_collection::write_netcdf(const char *filename,
     }          // loop over target# t1
 }
 
+/**
+ * Reads an eigenray_collection from a netCDF file created by write_netcdf().
+ */
+eigenray_collection::csptr eigenray_collection::read_netcdf(
+    const char *filename) {
+    netCDF::NcFile nc_file(filename, netCDF::NcFile::read);
+
+    // dimensions
+
+    const size_t rows = nc_file.getDim("rows").getSize();
+    const size_t cols = nc_file.getDim("cols").getSize();
+    const size_t num_rays = nc_file.getDim("eigenrays").getSize();
+    const size_t num_freq = nc_file.getDim("frequencies").getSize();
+    const size_t num_targets = rows * cols;
+
+    // source and target parameters
+
+    unsigned long long sourceID;
+    double latitude;
+    double longitude;
+    double altitude;
+    nc_file.getVar("sourceID").getVar(&sourceID);
+    nc_file.getVar("source_latitude").getVar(&latitude);
+    nc_file.getVar("source_longitude").getVar(&longitude);
+    nc_file.getVar("source_altitude").getVar(&altitude);
+    const wposition1 source_pos(latitude, longitude, altitude);
+
+    auto freq = read_variable<double>(nc_file, "frequencies", num_freq);
+    seq_vector::csptr frequencies(new seq_data(freq.data(), num_freq));
+
+    auto ids = read_variable<unsigned long long>(nc_file, "targetID",
+                                                 num_targets);
+    matrix<uint64_t> targetIDs(rows, cols);
+    std::copy(ids.begin(), ids.end(), targetIDs.data().begin());
+
+    wposition target_pos(rows, cols);
+    matrix<double> grid(rows, cols);
+    auto load_grid = [&](const char *name) -> const matrix<double> & {
+        auto values = read_variable<double>(nc_file, name, num_targets);
+        std::copy(values.begin(), values.end(), grid.data().begin());
+        return grid;
+    };
+    target_pos.latitude(load_grid("latitude"));
+    target_pos.longitude(load_grid("longitude"));
+    target_pos.altitude(load_grid("altitude"));
+
+    auto *collection = new eigenray_collection(frequencies, source_pos,
+                                               target_pos, sourceID, targetIDs);
+    csptr result(collection);
+    collection->_initial_time = load_grid("initial_time");
+
+    // eigenray components, including the totals
+
+    auto proploss_index =
+        read_variable<int>(nc_file, "proploss_index", num_targets);
+    auto eigenray_index =
+        read_variable<int>(nc_file, "eigenray_index", num_targets);
+    auto eigenray_num =
+        read_variable<int>(nc_file, "eigenray_num", num_targets);
+    const size_t num_values = num_rays * num_freq;
+    auto intensity = read_variable<double>(nc_file, "intensity", num_values);
+    auto phase = read_variable<double>(nc_file, "phase", num_values);
+    auto travel_time = read_variable<double>(nc_file, "travel_time", num_rays);
+    auto source_de = read_variable<double>(nc_file, "source_de", num_rays);
+    auto source_az = read_variable<double>(nc_file, "source_az", num_rays);
+    auto target_de = read_variable<double>(nc_file, "target_de", num_rays);
+    auto target_az = read_variable<double>(nc_file, "target_az", num_rays);
+    auto surface = read_variable<int>(nc_file, "surface", num_rays);
+    auto bottom = read_variable<int>(nc_file, "bottom", num_rays);
+    auto caustic = read_variable<int>(nc_file, "caustic", num_rays);
+    auto upper = read_variable<int>(nc_file, "upper", num_rays);
+    auto lower = read_variable<int>(nc_file, "lower", num_rays);
+
+    eigenray_model ray;
+    ray.frequencies = frequencies;
+    ray.intensity.resize(num_freq);
+    ray.phase.resize(num_freq);
+    auto load_ray = [&](size_t record) -> const eigenray_model & {
+        if (record >= num_rays) {
+            throw std::invalid_argument(std::string("eigenray netCDF ") +
+                                        filename + ": bad eigenray index");
+        }
+        std::copy_n(&intensity[record * num_freq], num_freq,
+                    ray.intensity.begin());
+        std::copy_n(&phase[record * num_freq], num_freq, ray.phase.begin());
+        ray.travel_time = travel_time[record];
+        ray.source_de = source_de[record];
+        ray.source_az = source_az[record];
+        ray.target_de = target_de[record];
+        ray.target_az = target_az[record];
+        ray.surface = surface[record];
+        ray.bottom = bottom[record];
+        ray.caustic = caustic[record];
+        ray.upper = upper[record];
+        ray.lower = lower[record];
+        return ray;
+    };
+
+    for (size_t t1 = 0; t1 < rows; ++t1) {
+        for (size_t t2 = 0; t2 < cols; ++t2) {
+            const size_t target = t1 * cols + t2;
+            collection->_total(t1, t2) = load_ray(proploss_index[target]);
+            const int first = eigenray_index[target];
+            for (int n = 0; n < eigenray_num[target]; ++n) {
+                collection->_eigenrays.push_back(target, load_ray(first + n));
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Writes this collection to a binary archive.
+ */
+void eigenray_collection::write_archive(const char *filename) const {
+    archive_writer archive(filename, "eigenrays");
+    const auto freq = _frequencies->data();
+    archive.write("frequencies", freq.begin(), freq.size());
+
+    // source and target parameters
+
+    archive.write_value("sourceID", _sourceID);
+    archive.write_value("source_latitude", _source_pos.latitude());
+    archive.write_value("source_longitude", _source_pos.longitude());
+    archive.write_value("source_altitude", _source_pos.altitude());
+    archive.write_value("coherent", (int)_coherent);
+    const uint64_t shape[] = {size1(), size2()};
+    archive.write("shape", shape, 2);
+    archive.write("targetID", _targetIDs.data().begin(),
+                  _targetIDs.data().size());
+    const matrix<double> latitude = _target_pos.latitude();
+    const matrix<double> longitude = _target_pos.longitude();
+    const matrix<double> altitude = _target_pos.altitude();
+    archive.write("latitude", latitude.data().begin(), latitude.data().size());
+    archive.write("longitude", longitude.data().begin(),
+                  longitude.data().size());
+    archive.write("altitude", altitude.data().begin(), altitude.data().size());
+    archive.write("initial_time", _initial_time.data().begin(),
+                  _initial_time.data().size());
+
+    // totals are stored as columns with one eigenray per target
+
+    eigenray_columns totals(size1() * size2());
+    totals.frequencies = _frequencies;
+    for (size_t t1 = 0; t1 < size1(); ++t1) {
+        for (size_t t2 = 0; t2 < size2(); ++t2) {
+            totals.push_back(t1 * size2() + t2, _total(t1, t2));
+        }
+    }
+    totals.write_archive(&archive, "total/");
+    _eigenrays.write_archive(&archive);
+    archive.close();
+}
+
+/**
+ * Reads an eigenray_collection from a binary archive.
+ */
+eigenray_collection::csptr eigenray_collection::read_archive(
+    const char *filename) {
+    archive_reader archive(filename, "eigenrays");
+    size_t num_freq;
+    const double *freq = archive.data<double>("frequencies", &num_freq);
+    seq_vector::csptr frequencies(new seq_data(freq, num_freq));
+
+    // source and target parameters
+
+    const wposition1 source_pos(archive.value<double>("source_latitude"),
+                                archive.value<double>("source_longitude"),
+                                archive.value<double>("source_altitude"));
+    const uint64_t *shape = archive.column<uint64_t>("shape", 2);
+    const size_t rows = shape[0];
+    const size_t cols = shape[1];
+    const uint64_t *ids = archive.column<uint64_t>("targetID", rows * cols);
+    matrix<uint64_t> targetIDs(rows, cols);
+    std::copy_n(ids, rows * cols, targetIDs.data().begin());
+    wposition target_pos(rows, cols);
+    target_pos.latitude(read_grid(archive, "latitude", rows, cols));
+    target_pos.longitude(read_grid(archive, "longitude", rows, cols));
+    target_pos.altitude(read_grid(archive, "altitude", rows, cols));
+
+    auto *collection = new eigenray_collection(
+        frequencies, source_pos, target_pos,
+        archive.value<uint64_t>("sourceID"), targetIDs,
+        archive.value<int>("coherent") != 0);
+    csptr result(collection);
+    collection->_initial_time = read_grid(archive, "initial_time", rows, cols);
+
+    // eigenrays and totals
+
+    collection->_eigenrays.read_archive(archive);
+    collection->_eigenrays.frequencies = frequencies;
+    eigenray_columns totals;
+    totals.read_archive(archive, "total/");
+    totals.frequencies = frequencies;
+    const size_t num_targets = rows * cols;
+    if (collection->_eigenrays.num_targets() != num_targets ||
+        collection->_eigenrays.intensity_data.size() !=
+            collection->_eigenrays.size() * num_freq ||
+        totals.size() != num_targets ||
+        totals.intensity_data.size() != num_targets * num_freq) {
+        throw std::invalid_argument(std::string("eigenray archive ") +
+                                    filename + ": bad eigenray columns");
+    }
+    for (size_t t1 = 0; t1 < rows; ++t1) {
+        for (size_t t2 = 0; t2 < cols; ++t2) {
+            collection->_total(t1, t2) = *totals.eigenray(t1 * cols + t2);
+        }
+    }
+    return result;
+}
+
 /**
  * Adjust eigenrays for small changes in source/target geometry.
  */
 eigenray_list eigenray_collection::dead_reckon(
     size_t t1, size_t t2, const wposition1 &source_new,
     const wposition1 &target_new, const profile_model::csptr &profile) const {
-    eigenray_list eigenrays =
-        dead_reckon_one(_eigenrays(t1, t2), _source_pos, source_new, profile);
+    eigenray_list eigenrays = dead_reckon_one(
+        view(t1, t2).list(), _source_pos, source_new, profile, false);
     return dead_reckon_one(eigenrays, wposition1(_target_pos, t1, t2),
-                           target_new, profile);
+                           target_new, profile, true);
+}
+
+/**
+ * Adjust the eigenrays of many collections for small changes in
+ * source/target geometry.
+ */
+std::vector<eigenray_collection::csptr> eigenray_collection::dead_reckon(
+    const std::vector<csptr> &collections,
+    const std::vector<wposition1> &sources_new,
+    const std::vector<wposition> &targets_new,
+    const profile_model::csptr &profile) {
+    // list the old and new location of every source and target,
+    // sources are followed by the targets for the same collection
+
+    const size_t num_collections = collections.size();
+    std::vector<size_t> first_sensor(num_collections + 1, 0);
+    size_t num_rays = 0;
+    for (size_t c = 0; c < num_collections; ++c) {
+        const eigenray_collection &old = *collections[c];
+        first_sensor[c + 1] =
+            first_sensor[c] + 1 + old.size1() * old.size2();
+        num_rays += old._eigenrays.size();
+    }
+    const size_t num_sensors = first_sensor[num_collections];
+    wposition old_pos(num_sensors, 1);
+    std::vector<wposition1> new_pos(num_sensors);
+    for (size_t c = 0; c < num_collections; ++c) {
+        const eigenray_collection &old = *collections[c];
+        size_t s = first_sensor[c];
+        old_pos.rho(s, 0, old._source_pos.rho());
+        old_pos.theta(s, 0, old._source_pos.theta());
+        old_pos.phi(s, 0, old._source_pos.phi());
+        new_pos[s] = sources_new[c];
+        for (size_t t1 = 0; t1 < old.size1(); ++t1) {
+            for (size_t t2 = 0; t2 < old.size2(); ++t2) {
+                ++s;
+                old_pos.rho(s, 0, old._target_pos.rho(t1, t2));
+                old_pos.theta(s, 0, old._target_pos.theta(t1, t2));
+                old_pos.phi(s, 0, old._target_pos.phi(t1, t2));
+                new_pos[s] = wposition1(targets_new[c], t1, t2);
+            }
+        }
+    }
+
+    // compute position change of each sensor in local tangent plane,
+    // and the sound speed at each original position
+
+    std::vector<double> dir(3 * num_sensors);
+    std::vector<bool> moved(num_sensors);
+    for (size_t s = 0; s < num_sensors; ++s) {
+        const double rho = old_pos.rho(s, 0);
+        const double theta = old_pos.theta(s, 0);
+        double *d = &dir[3 * s];
+        d[0] = new_pos[s].rho() - rho;
+        d[1] = (new_pos[s].theta() - theta) * rho;
+        d[2] = (new_pos[s].phi() - old_pos.phi(s, 0)) * rho * sin(theta);
+        moved[s] = d[0] * d[0] + d[1] * d[1] + d[2] * d[2] >= 1e-6;
+    }
+    matrix<double> speed(num_sensors, 1);
+    profile->sound_speed(old_pos, &speed);
+
+    // compute the change in range and travel time for each eigenray,
+    // for the source step followed by the target step,
+    // stores the location and range before/after each step for attenuation
+
+    std::vector<eigenray_collection *> results(num_collections);
+    wposition location(std::max(num_rays, size_t(1)), 4);
+    matrix<double> distance(std::max(num_rays, size_t(1)), 4, 1.0);
+    size_t r = 0;
+    for (size_t c = 0; c < num_collections; ++c) {
+        const eigenray_collection &old = *collections[c];
+        const eigenray_columns &rays = old._eigenrays;
+        auto *result = new eigenray_collection(
+            old._frequencies, sources_new[c], targets_new[c], old._sourceID,
+            old._targetIDs, old._coherent);
+        result->_eigenrays = rays;
+        results[c] = result;
+
+        const size_t src = first_sensor[c];
+        for (size_t t1 = 0; t1 < old.size1(); ++t1) {
+            for (size_t t2 = 0; t2 < old.size2(); ++t2) {
+                const size_t trg = src + 1 + t1 * old.size2() + t2;
+                for (size_t index : result->view(t1, t2)) {
+                    double time = rays.travel_time[index];
+                    size_t col = 0;
+                    for (size_t s : {src, trg}) {
+                        // source uses launch angles, and gets shorter
+                        // target uses arrival angles, and gets longer
+                        const bool target = (s == trg);
+                        const double de = to_radians(
+                            target ? rays.target_de[index]
+                                   : rays.source_de[index]);
+                        const double az = to_radians(
+                            target ? rays.target_az[index]
+                                   : rays.source_az[index]);
+                        const double cos_de = cos(de);
+                        const double raydir[3] = {sin(de), -cos_de * cos(az),
+                                                  cos_de * sin(az)};
+                        const double *d = &dir[3 * s];
+                        const double sign = target ? 1.0 : -1.0;
+                        const double dr =
+                            moved[s] ? sign * (d[0] * raydir[0] +
+                                               d[1] * raydir[1] +
+                                               d[2] * raydir[2])
+                                     : 0.0;
+                        const double r1 = time * speed(s, 0);
+                        for (size_t n = 0; n < 2; ++n) {
+                            location.rho(r, col + n, old_pos.rho(s, 0));
+                            location.theta(r, col + n, old_pos.theta(s, 0));
+                            location.phi(r, col + n, old_pos.phi(s, 0));
+                        }
+                        distance(r, col) = r1;
+                        distance(r, col + 1) = r1 + dr;
+                        time += dr / speed(s, 0);
+                        col += 2;
+                    }
+                    result->_eigenrays.travel_time[index] = time;
+                    ++r;
+                }
+            }
+        }
+    }
+
+    // compute change in intensity along each ray path
+    // approximating TL = 20*log10(r) + alpha * r + b
+
+    const size_t num_freq =
+        num_collections > 0 ? collections[0]->_frequencies->size() : 0;
+    matrix<vector<double> > atten(location.size1(), 4);
+    for (auto &value : atten.data()) {
+        value.resize(num_freq);
+    }
+    if (num_rays > 0) {
+        profile->attenuation(location, collections[0]->_frequencies,
+                             distance, &atten);
+    }
+    r = 0;
+    for (size_t c = 0; c < num_collections; ++c) {
+        eigenray_collection *result = results[c];
+        const size_t src = first_sensor[c];
+        for (size_t t1 = 0; t1 < result->size1(); ++t1) {
+            for (size_t t2 = 0; t2 < result->size2(); ++t2) {
+                const size_t trg = src + 1 + t1 * result->size2() + t2;
+                for (size_t index : result->view(t1, t2)) {
+                    double *intensity =
+                        &result->_eigenrays.intensity_data[index * num_freq];
+                    size_t col = 0;
+                    for (size_t s : {src, trg}) {
+                        if (moved[s]) {
+                            const double r1 = distance(r, col);
+                            const double r2 = distance(r, col + 1);
+                            for (size_t f = 0; f < num_freq; ++f) {
+                                const double offset = intensity[f] -
+                                                      20.0 * log10(r1) -
+                                                      atten(r, col)[f];
+                                intensity[f] = 20.0 * log10(r2) +
+                                               atten(r, col + 1)[f] + offset;
+                            }
+                        }
+                        col += 2;
+                    }
+                    ++r;
+                }
+
+                // update the time of arrival of the fastest eigenray
+
+                double initial = 0.0;
+                for (size_t index : result->view(t1, t2)) {
+                    const double time = result->_eigenrays.travel_time[index];
+                    if (initial <= 0.0 || initial > time) {
+                        initial = time;
+                    }
+                }
+                result->_initial_time(t1, t2) = initial;
+            }
+        }
+    }
+
+    std::vector<csptr> list;
+    list.reserve(num_collections);
+    for (eigenray_collection *result : results) {
+        result->sum_eigenrays();
+        list.push_back(csptr(result));
+    }
+    return list;
 }
 
 /**
@@ -372,7 +978,8 @@ eigenray_list eigenray_collection::dead_reckon(
  */
 eigenray_list eigenray_collection::dead_reckon_one(
     const eigenray_list &eigenrays, const wposition1 &oldpos,
-    const wposition1 &newpos, const profile_model::csptr &profile) {
+    const wposition1 &newpos, const profile_model::csptr &profile,
+    bool target) {
     // compute position change in local tangent plane
 
     double dir[3] = {newpos.rho() - oldpos.rho(),
@@ -403,10 +1010,11 @@ eigenray_list eigenray_collection::dead_reckon_one(
     for (const auto &ray : eigenrays) {
         auto *new_ray = new eigenray_model(*ray);
 
-        // compute ray direction in local tangent plane
+        // compute ray direction in local tangent plane,
+        // using the launch angles at the source or arrival angles at target
 
-        const double de = to_radians(ray->source_de);
-        const double az = to_radians(ray->source_az);
+        const double de = to_radians(target ? ray->target_de : ray->source_de);
+        const double az = to_radians(target ? ray->target_az : ray->source_az);
         const double cos_de = cos(de);
         const double sin_de = sin(de);
         const double cos_az = cos(az);
@@ -414,10 +1022,12 @@ eigenray_list eigenray_collection::dead_reckon_one(
         const double raydir[3] = {sin_de, -cos_de * cos_az, cos_de * sin_az};
 
         // change in range is proportional to the component of
-        // slant range along the direction of the ray
+        // slant range along the direction of the ray, moving the source
+        // along the ray shortens the path, moving the target lengthens it
 
-        const double dr =
-            (dir[0] * raydir[0] + dir[1] * raydir[1] + dir[2] * raydir[2]);
+        const double sign = target ? 1.0 : -1.0;
+        const double dr = sign * (dir[0] * raydir[0] + dir[1] * raydir[1] +
+                                  dir[2] * raydir[2]);
         new_ray->travel_time = ray->travel_time + dr / sound_speed;
 
         // compute change in intensity along ray path
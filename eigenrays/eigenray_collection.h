@@ -4,6 +4,7 @@
  */
 #pragma once
 
+#include <usml/eigenrays/eigenray_columns.h>
 #include <usml/eigenrays/eigenray_listener.h>
 #include <usml/eigenrays/eigenray_model.h>
 #include <usml/ocean/profile_model.h>
@@ -15,7 +16,11 @@
 
 #include <boost/numeric/ublas/matrix.hpp>
 #include <cstddef>
+#include <limits>
 #include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace usml {
 namespace eigenrays {
@@ -31,12 +36,54 @@ using namespace usml::ocean;
  * acoustic eigenrays at each target location.  After propagation is complete,
  * the sum_eigenrays() method is used to collect the results into a
  * phasor-summed propagation loss and phase at each target point.
+ *
+ * The constructor builds a hash index from each target ID to its row and
+ * column in the target grid, so that the results for a specific target can
+ * be found without searching the whole grid. If the same target ID appears
+ * more than once, the index refers to the first one, in row major order.
+ *
+ * Eigenrays are copied into an eigenray_columns object as they arrive,
+ * instead of keeping a shared pointer to each eigenray_model. Read only
+ * access to the eigenrays of a target uses an eigenray_view, which
+ * refers to the columns without copying them.
  */
 class USML_DECLSPEC eigenray_collection : public eigenray_listener {
    public:
     /// Alias for shared reference to eigenray collection.
     typedef std::shared_ptr<const eigenray_collection> csptr;
 
+    /**
+     * Number of targets summed as a single unit of parallel work by
+     * sum_eigenrays(). Small grids, like the single target used by a
+     * sensor_pair, are summed in the calling thread. Defaults to 64.
+     */
+    static size_t targets_per_task;
+
+    /**
+     * Read only view of the results for a single target in this collection.
+     * Refers to the eigenrays stored in the collection, instead of copying
+     * them, so it is only valid while the collection exists.
+     */
+    struct target_view {
+        /// Platform ID number for this target.
+        uint64_t targetID{0};
+
+        /// True if the target was found in this collection.
+        bool found{false};
+
+        /// Row number of target in the grid.
+        size_t t1{0};
+
+        /// Column number of target in the grid.
+        size_t t2{0};
+
+        /// Eigenrays for this target, empty view if not found.
+        eigenray_view eigenrays;
+
+        /// The time of arrival of the fastest eigenray, zero if not found.
+        double initial_time{0.0};
+    };
+
     /**
      * Initialize with references to wave front information.
      *
@@ -81,6 +128,9 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
         return wposition1(_target_pos, t1, t2);
     }
 
+    /// Location of the wavefront source.
+    const wposition1 &source_pos() const { return _source_pos; }
+
     /// Platform ID number for this source. Set to zero if unknown.
     uint64_t sourceID() const { return _sourceID; }
 
@@ -102,21 +152,70 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
     seq_vector::csptr frequencies() const { return _frequencies; }
 
     /**
-     * Return eigenray list for a single target.
+     * Return eigenray list for a single target. Creates a new eigenray_model
+     * for each eigenray, use view() to avoid this copy.
      *
      * @param   t1  			Row number of target.
      * @param   t2  			Column number of target.
      * @return  Eigenray list for this target.
      */
-    const eigenray_list &eigenrays(size_t t1 = 0, size_t t2 = 0) const {
-        return _eigenrays(t1, t2);
+    eigenray_list eigenrays(size_t t1 = 0, size_t t2 = 0) const {
+        return view(t1, t2).list();
+    }
+
+    /**
+     * Read only view of the eigenrays for a single target.
+     *
+     * @param   t1  			Row number of target.
+     * @param   t2  			Column number of target.
+     * @param   swapped  		Exchange source and target angles if true.
+     * @return  View of the eigenrays for this target.
+     */
+    eigenray_view view(size_t t1 = 0, size_t t2 = 0,
+                       bool swapped = false) const {
+        return eigenray_view(&_eigenrays, t1 * size2() + t2, swapped);
     }
 
+    /// Columnar storage for the eigenrays of all targets.
+    const eigenray_columns &columns() const { return _eigenrays; }
+
     /// The time of arrival of the fastest eigenray for each target.
     double initial_time(size_t t1 = 0, size_t t2 = 0) const {
         return _initial_time(t1, t2);
     }
 
+    /**
+     * Find the row and column of a single target in the grid, using the
+     * hash index built by the constructor. A targetID of zero matches the
+     * first target in the grid.
+     *
+     * @param   targetID	  Platform ID number for this target.
+     * @param   t1  		  Row number of target (output).
+     * @param   t2  		  Column number of target (output).
+     * @return  True if the target was found.
+     */
+    bool find_target(uint64_t targetID, size_t *t1, size_t *t2) const;
+
+    /**
+     * Find a read only view of the results for a single target.
+     *
+     * @param   targetID	  Platform ID number for this target.
+     * @param   swapped  	  Exchange source and target angles if true.
+     * @return  View of the results for this target.
+     */
+    target_view find_view(uint64_t targetID = 0, bool swapped = false) const;
+
+    /**
+     * Splits this collection into read only views of the results for a list
+     * of targets, such as the receivers of each sensor_pair that uses this
+     * source. Does not copy any eigenrays.
+     *
+     * @param   targetIDs	  Platform ID numbers for these targets.
+     * @return  View of the results for each target, in the same order.
+     */
+    std::vector<target_view> find_views(
+        const std::vector<uint64_t> &targetIDs) const;
+
     /**
      * Find eigenrays for a single target in the grid.
      *
@@ -160,8 +259,37 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
      */
     void add_eigenray(size_t t1, size_t t2, eigenray_model::csptr ray,
                       size_t runID = 0);
+
     /**
-     * Compute propagation loss summed over all eigenrays.
+     * Copies the eigenrays in a view, from this collection or another one,
+     * to a single target. Does not create any eigenray_model objects. The
+     * view must use the same frequencies as this collection.
+     *
+     * @param t1     	Row number of target.
+     * @param t2     	Column number of target.
+     * @param rays    	Eigenrays to be copied.
+     * @param time_maximum  Only copy eigenrays with travel times less than
+     *                      or equal to this value (sec).
+     */
+    void add_eigenrays(size_t t1, size_t t2, const eigenray_view &rays,
+                       double time_maximum =
+                           std::numeric_limits<double>::infinity());
+
+    /**
+     * Creates a new collection with the eigenrays that arrive at or before
+     * a specific travel time, and computes their totals. Used to publish
+     * partial results while a wavefront is still being computed. Uses the
+     * same targets, target IDs, and frequencies as this collection.
+     *
+     * @param time_maximum  Latest travel time to include (sec).
+     * @return              Summed collection of early eigenrays.
+     */
+    csptr snapshot(double time_maximum) const;
+
+    /**
+     * Compute propagation loss summed over all eigenrays. Targets are
+     * divided into blocks of targets_per_task, and the blocks are summed in
+     * parallel using the thread_controller pool.
      */
     void sum_eigenrays();
 
@@ -191,6 +319,45 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
     void write_netcdf(const char *filename,
                       const char *long_name = nullptr) const;
 
+    /**
+     * Reads an eigenray_collection from a netCDF file created by
+     * write_netcdf(). Each variable is read with a single call, and the
+     * eigenrays for each target are found using the proploss_index,
+     * eigenray_index, and eigenray_num variables. The netCDF file does not
+     * record whether the totals were computed coherently, so the collection
+     * is assumed to be coherent.
+     *
+     * @param filename      Name of the netCDF file.
+     * @return              New collection, with the totals and eigenrays
+     *                      from the file.
+     */
+    static csptr read_netcdf(const char *filename);
+
+    /**
+     * Writes this collection to a binary archive. Each column of the
+     * eigenrays, the totals, and the target grid is written as a single
+     * contiguous array, so that the file can be reloaded with one bulk copy
+     * per column. Archives are much faster to write and read than netCDF
+     * files, but they can only be read on hosts with the same byte order.
+     *
+     * The user is responsible for ensuring that sum_eigenrays() has been
+     * called prior to this routine.
+     *
+     * @param filename      Name of the archive file.
+     */
+    void write_archive(const char *filename) const;
+
+    /**
+     * Reads an eigenray_collection from a binary archive created by
+     * write_archive(). Includes the totals, so sum_eigenrays() does not
+     * need to be called again.
+     *
+     * @param filename          Name of the archive file.
+     * @return                  New collection, with the contents of the file.
+     * @throws invalid_argument If the file is not an eigenray archive.
+     */
+    static csptr read_archive(const char *filename);
+
     /**
      * Adjust eigenrays for small changes in source/target geometry. Adjusts the
      * travel time and intensity using the component of position change along
@@ -214,6 +381,29 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
                               const wposition1 &target_new,
                               const profile_model::csptr &profile) const;
 
+    /**
+     * Adjust the eigenrays of many collections for small changes in
+     * source/target geometry. Uses the same approximation as dead_reckon(),
+     * but processes all targets of all collections as a single batch. The
+     * sound speed at every original source and target location is found
+     * with a single query to the profile, and the attenuation for every
+     * eigenray is found with a single query to the attenuation model.
+     * Sensors that have not moved keep their eigenrays unchanged.
+     *
+     * @param collections   Eigenrays to be adjusted.
+     * @param sources_new   Updated source location for each collection.
+     * @param targets_new   Updated target locations for each collection,
+     *                      same size as the target grid of that collection.
+     * @param profile       Ocean profile model used to extract sound speed.
+     * @return              New collections, with the same target IDs, at
+     *                      the updated locations, and with summed totals.
+     */
+    static std::vector<csptr> dead_reckon(
+        const std::vector<csptr> &collections,
+        const std::vector<wposition1> &sources_new,
+        const std::vector<wposition> &targets_new,
+        const profile_model::csptr &profile);
+
    private:
     /// Value to find source in platform_manager. Set to zero if unknown.
     const uint64_t _sourceID;
@@ -221,6 +411,9 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
     /// Value to find targets in platform_manager. Set to zero if unknown.
     matrix<uint64_t> _targetIDs;
 
+    /// Row and column of each target ID in the grid.
+    std::unordered_map<uint64_t, std::pair<size_t, size_t>> _target_index;
+
     /**
      * Location of the wavefront source in spherical earth coordinates.
      * Linked from wavefront object so we can write it to a netCDF file.
@@ -237,15 +430,12 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
      */
     const seq_vector::csptr _frequencies;
 
-    /// List of eigenrays associated with each target.
-    matrix<eigenray_list> _eigenrays;
+    /// Eigenrays associated with each target, in row major target order.
+    eigenray_columns _eigenrays;
 
     /// The time of arrival of the fastest eigenray for each target.
     matrix<double> _initial_time;
 
-    /// Total number of eigenrays.  Used by write_netcdf().
-    int _num_eigenrays;
-
     /**
      * Propagation loss summed over all eigenrays.
      * Estimates of time and angle are averages weighted by
@@ -267,11 +457,16 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
      * other ray components small for small changes in position.
      *
      * Based on Equation 11 and Figure 1 in the E. K. Skarsoullis reference.
+     * Moving the source along the launch direction of a ray makes that path
+     * shorter, and moving the target along the arrival direction of a ray
+     * makes that path longer.
      *
      * @param eigenrays List of acoustic paths to update.
      * @param oldpos    Original sensor location.
      * @param newpos    Updated sensor location.
      * @param profile   Ocean profile model used to extract sound speed.
+     * @param target    Uses the arrival angles at the target if true, and
+     *                  the launch angles at the source if false.
      *
      * @xref E. K. Skarsoullis, "Multi-section matched-peak tomographic
      * inversion with a moving source", J. Acoust. Soc. Am.
@@ -280,7 +475,8 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
     static eigenray_list dead_reckon_one(const eigenray_list &eigenrays,
                                          const wposition1 &oldpos,
                                          const wposition1 &newpos,
-                                         const profile_model::csptr &profile);
+                                         const profile_model::csptr &profile,
+                                         bool target);
 };
 
 /// @}
@@ -0,0 +1,203 @@
+/**
+ * @file eigenray_columns.cc
+ * Columnar storage for the eigenrays of a grid of targets.
+ */
+
+#include <usml/eigenrays/eigenray_columns.h>
+
+#include <algorithm>
+#include <boost/numeric/ublas/vector.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace usml::eigenrays;
+
+/**
+ * Appends a single eigenray to the end of the list for a target.
+ */
+void eigenray_columns::push_back(size_t target, const eigenray_model& ray) {
+    if (frequencies == nullptr) {
+        frequencies = ray.frequencies;
+    }
+    travel_time.push_back(ray.travel_time);
+    const size_t num_freq = num_frequencies();
+    const size_t row = intensity_data.size();
+    intensity_data.resize(row + num_freq, 0.0);
+    std::copy_n(ray.intensity.begin(), std::min(num_freq, ray.intensity.size()),
+                intensity_data.begin() + row);
+    phase_data.resize(row + num_freq, 0.0);
+    std::copy_n(ray.phase.begin(), std::min(num_freq, ray.phase.size()),
+                phase_data.begin() + row);
+    source_de.push_back(ray.source_de);
+    source_az.push_back(ray.source_az);
+    target_de.push_back(ray.target_de);
+    target_az.push_back(ray.target_az);
+    paths.insert(paths.end(), {ray.surface, ray.bottom, ray.caustic,
+                               ray.upper, ray.lower});
+    link(target);
+}
+
+/**
+ * Appends a single eigenray from another list to the end of the list
+ * for a target.
+ */
+void eigenray_columns::push_back(size_t target, const eigenray_columns& other,
+                                 size_t index, bool swapped) {
+    if (frequencies == nullptr) {
+        frequencies = other.frequencies;
+    }
+    travel_time.push_back(other.travel_time[index]);
+    const size_t num_freq = other.num_frequencies();
+    intensity_data.insert(intensity_data.end(), other.intensity(index),
+                          other.intensity(index) + num_freq);
+    phase_data.insert(phase_data.end(), other.phase(index),
+                      other.phase(index) + num_freq);
+    if (swapped) {
+        source_de.push_back(other.target_de[index]);
+        source_az.push_back(other.target_az[index]);
+        target_de.push_back(other.source_de[index]);
+        target_az.push_back(other.source_az[index]);
+    } else {
+        source_de.push_back(other.source_de[index]);
+        source_az.push_back(other.source_az[index]);
+        target_de.push_back(other.target_de[index]);
+        target_az.push_back(other.target_az[index]);
+    }
+    auto src = other.paths.begin() + index * num_paths;
+    paths.insert(paths.end(), src, src + num_paths);
+    link(target);
+}
+
+/**
+ * Creates a new eigenray_model from a single element of this list.
+ */
+eigenray_model::csptr eigenray_columns::eigenray(size_t index,
+                                                 bool swapped) const {
+    auto* ray = new eigenray_model();
+    ray->travel_time = travel_time[index];
+    ray->frequencies = frequencies;
+    const size_t num_freq = num_frequencies();
+    ray->intensity.resize(num_freq);
+    std::copy(intensity(index), intensity(index) + num_freq,
+              ray->intensity.begin());
+    ray->phase.resize(num_freq);
+    std::copy(phase(index), phase(index) + num_freq, ray->phase.begin());
+    ray->source_de = source_de[index];
+    ray->source_az = source_az[index];
+    ray->target_de = target_de[index];
+    ray->target_az = target_az[index];
+    if (swapped) {
+        std::swap(ray->source_de, ray->target_de);
+        std::swap(ray->source_az, ray->target_az);
+    }
+
+    const int* counts = &paths[index * num_paths];
+    ray->surface = counts[0];
+    ray->bottom = counts[1];
+    ray->caustic = counts[2];
+    ray->upper = counts[3];
+    ray->lower = counts[4];
+    return eigenray_model::csptr(ray);
+}
+
+/**
+ * Writes every column to an archive.
+ */
+void eigenray_columns::write_archive(archive_writer* archive,
+                                     const std::string& prefix) const {
+    archive->write(prefix + "travel_time", travel_time);
+    archive->write(prefix + "intensity", intensity_data);
+    archive->write(prefix + "phase", phase_data);
+    archive->write(prefix + "source_de", source_de);
+    archive->write(prefix + "source_az", source_az);
+    archive->write(prefix + "target_de", target_de);
+    archive->write(prefix + "target_az", target_az);
+    archive->write(prefix + "paths", paths);
+    archive->write(prefix + "next", next);
+    archive->write(prefix + "first", _first);
+    archive->write(prefix + "last", _last);
+    archive->write(prefix + "count", _count);
+}
+
+/**
+ * Replaces every column with the ones read from an archive.
+ */
+void eigenray_columns::read_archive(const archive_reader& archive,
+                                    const std::string& prefix) {
+    archive.read(prefix + "travel_time", &travel_time);
+    archive.read(prefix + "intensity", &intensity_data);
+    archive.read(prefix + "phase", &phase_data);
+    archive.read(prefix + "source_de", &source_de);
+    archive.read(prefix + "source_az", &source_az);
+    archive.read(prefix + "target_de", &target_de);
+    archive.read(prefix + "target_az", &target_az);
+    archive.read(prefix + "paths", &paths);
+    archive.read(prefix + "next", &next);
+    archive.read(prefix + "first", &_first);
+    archive.read(prefix + "last", &_last);
+    archive.read(prefix + "count", &_count);
+
+    const size_t num_rays = travel_time.size();
+    const bool valid =
+        intensity_data.size() == phase_data.size() &&
+        source_de.size() == num_rays && source_az.size() == num_rays &&
+        target_de.size() == num_rays && target_az.size() == num_rays &&
+        paths.size() == num_rays * num_paths && next.size() == num_rays &&
+        _last.size() == _first.size() && _count.size() == _first.size() &&
+        (num_rays == 0 || intensity_data.size() % num_rays == 0);
+    auto in_range = [num_rays](size_t index) {
+        return index == npos || index < num_rays;
+    };
+    if (!valid || !std::all_of(next.begin(), next.end(), in_range) ||
+        !std::all_of(_first.begin(), _first.end(), in_range) ||
+        !std::all_of(_last.begin(), _last.end(), in_range)) {
+        throw std::invalid_argument("inconsistent eigenray columns");
+    }
+
+    // walk each list for at most _count steps, so that cycles in the next
+    // links, or eigenrays shared between targets, can not loop forever
+    std::vector<bool> visited(num_rays, false);
+    for (size_t target = 0; target < _first.size(); ++target) {
+        size_t index = _first[target];
+        size_t previous = npos;
+        size_t length = 0;
+        while (index != npos && length < _count[target] && !visited[index]) {
+            visited[index] = true;
+            previous = index;
+            index = next[index];
+            ++length;
+        }
+        if (index != npos || length != _count[target] ||
+            previous != _last[target]) {
+            throw std::invalid_argument("inconsistent eigenray columns");
+        }
+    }
+}
+
+/**
+ * Links a new eigenray to the end of the list for a target.
+ */
+void eigenray_columns::link(size_t target) {
+    const size_t index = next.size();
+    next.push_back(npos);
+    if (_last[target] == npos) {
+        _first[target] = index;
+    } else {
+        next[_last[target]] = index;
+    }
+    _last[target] = index;
+    ++_count[target];
+}
+
+/**
+ * Creates a list of new eigenray_model objects for all of the
+ * eigenrays in this view.
+ */
+eigenray_list eigenray_view::list() const {
+    eigenray_list result;
+    for (size_t index : *this) {
+        result.push_back(eigenray(index));
+    }
+    return result;
+}
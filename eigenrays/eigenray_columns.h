@@ -0,0 +1,367 @@
+/**
+ * @file eigenray_columns.h
+ * Columnar storage for the eigenrays of a grid of targets.
+ */
+#pragma once
+
+#include <usml/eigenrays/eigenray_model.h>
+#include <usml/types/archive.h>
+#include <usml/types/seq_vector.h>
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace usml {
+namespace eigenrays {
+
+using namespace usml::types;
+
+/// @ingroup eigenrays
+/// @{
+
+/**
+ * Columnar storage for the eigenrays of a grid of targets. Each attribute
+ * of eigenray_model is stored in its own contiguous array, and the intensity
+ * and phase of all eigenrays are stored in row major matrices, with one row
+ * per eigenray and one column per frequency. This avoids the heap allocation
+ * of an eigenray_model, a shared pointer control block, a list node, and
+ * two frequency vectors for each eigenray.
+ *
+ * Targets are identified by a single index number, which is the row major
+ * offset of the target in the grid. Eigenrays are stored in the order that
+ * they are added, because wavefronts find them in an arbitrary target
+ * order. Each target keeps the position of its first and last eigenray, and
+ * each eigenray keeps the position of the next eigenray for the same
+ * target, so that eigenrays can be appended without moving the ones
+ * already stored. All eigenrays must use the same frequencies.
+ */
+class USML_DECLSPEC eigenray_columns {
+   public:
+    /// Position used to mark the end of the eigenrays for a target.
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    /// Number of path counts stored for each eigenray.
+    static constexpr size_t num_paths = 5;
+
+    /**
+     * Creates storage for a fixed number of targets.
+     *
+     * @param num_targets   Number of targets in the grid.
+     */
+    explicit eigenray_columns(size_t num_targets = 0)
+        : _first(num_targets, npos),
+          _last(num_targets, npos),
+          _count(num_targets, 0) {}
+
+    /**
+     * Number of eigenrays for all targets.
+     */
+    size_t size() const { return travel_time.size(); }
+
+    /**
+     * Number of targets in the grid.
+     */
+    size_t num_targets() const { return _count.size(); }
+
+    /**
+     * Number of frequencies in each row of the intensity and phase matrices.
+     */
+    size_t num_frequencies() const {
+        return (frequencies == nullptr) ? 0 : frequencies->size();
+    }
+
+    /**
+     * Number of eigenrays for a single target.
+     *
+     * @param target    Index number of the target.
+     */
+    size_t count(size_t target) const { return _count[target]; }
+
+    /**
+     * Position of the first eigenray for a single target.
+     *
+     * @param target    Index number of the target.
+     * @return          Position of the eigenray, npos if there are none.
+     */
+    size_t first(size_t target) const { return _first[target]; }
+
+    /**
+     * Pointer to the intensity of a single eigenray, one value per frequency.
+     *
+     * @param index     Position of the eigenray in this list.
+     */
+    const double* intensity(size_t index) const {
+        return &intensity_data[index * num_frequencies()];
+    }
+
+    /**
+     * Pointer to the phase of a single eigenray, one value per frequency.
+     *
+     * @param index     Position of the eigenray in this list.
+     */
+    const double* phase(size_t index) const {
+        return &phase_data[index * num_frequencies()];
+    }
+
+    /**
+     * Appends a single eigenray to the end of the list for a target.
+     * Intensity and phase values missing from the eigenray are set to zero.
+     *
+     * @param target    Index number of the target.
+     * @param ray       Eigenray to be appended.
+     */
+    void push_back(size_t target, const eigenray_model& ray);
+
+    /**
+     * Appends a single eigenray from another list to the end of the list
+     * for a target. Exchanges the source and target angles if swapped is
+     * true.
+     *
+     * @param target    Index number of the target.
+     * @param other     List that contains the eigenray.
+     * @param index     Position of the eigenray in the other list.
+     * @param swapped   Exchange source and target angles if true.
+     */
+    void push_back(size_t target, const eigenray_columns& other, size_t index,
+                   bool swapped = false);
+
+    /**
+     * Creates a new eigenray_model from a single element of this list.
+     *
+     * @param index     Position of the eigenray in this list.
+     * @param swapped   Exchange source and target angles if true.
+     */
+    eigenray_model::csptr eigenray(size_t index, bool swapped = false) const;
+
+    /**
+     * Writes every column to an archive, including the links between the
+     * eigenrays of each target. Does not write the frequencies.
+     *
+     * @param archive   Archive that receives the columns.
+     * @param prefix    Prefix added to the name of each column.
+     */
+    void write_archive(archive_writer* archive,
+                       const std::string& prefix = "") const;
+
+    /**
+     * Replaces every column with the ones read from an archive, using one
+     * bulk copy per column. Does not read the frequencies, callers must
+     * set them before the intensity and phase are used.
+     *
+     * @param archive   Archive that contains the columns.
+     * @param prefix    Prefix added to the name of each column.
+     * @throws invalid_argument If the columns have inconsistent sizes, or
+     *                  if the list for any target does not end after
+     *                  exactly count() eigenrays.
+     */
+    void read_archive(const archive_reader& archive,
+                      const std::string& prefix = "");
+
+    /// Frequencies over which propagation was computed (Hz).
+    seq_vector::csptr frequencies;
+
+    /// Time of arrival for each eigenray (sec).
+    std::vector<double> travel_time;
+
+    /// Propagation loss for each eigenray and frequency, row major (dB).
+    std::vector<double> intensity_data;
+
+    /// Phase change for each eigenray and frequency, row major (radians).
+    std::vector<double> phase_data;
+
+    /// Initial DE at the source for each eigenray (degrees, positive is up).
+    std::vector<double> source_de;
+
+    /// Initial AZ at the source for each eigenray (degrees, true north).
+    std::vector<double> source_az;
+
+    /// Final DE at the target for each eigenray (degrees, positive is up).
+    std::vector<double> target_de;
+
+    /// Final AZ at the target for each eigenray (degrees, true north).
+    std::vector<double> target_az;
+
+    /// Number of surface, bottom, caustic, upper, and lower vertices along
+    /// each path, five values per eigenray.
+    std::vector<int> paths;
+
+    /// Position of the next eigenray for the same target, npos at the end.
+    std::vector<size_t> next;
+
+   private:
+    /// Position of the first eigenray for each target.
+    std::vector<size_t> _first;
+
+    /// Position of the last eigenray for each target.
+    std::vector<size_t> _last;
+
+    /// Number of eigenrays for each target.
+    std::vector<size_t> _count;
+
+    /// Links a new eigenray to the end of the list for a target.
+    void link(size_t target);
+};
+
+/**
+ * Read only view of the eigenrays for a single target. Refers to the
+ * eigenrays stored in an eigenray_columns object, instead of copying them,
+ * so it is only valid while that object exists. A swapped view exchanges
+ * the source and target angles as they are read, which lets a bistatic pair
+ * use the eigenrays computed from the receiver's location without copying
+ * them. Iterating over a view produces the position of each eigenray in
+ * the columns.
+ */
+class USML_DECLSPEC eigenray_view {
+   public:
+    /// Forward iterator over the position of each eigenray in the columns.
+    class iterator {
+       public:
+        /// Iterator traits.
+        typedef std::forward_iterator_tag iterator_category;
+        typedef size_t value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const size_t* pointer;
+        typedef const size_t& reference;
+
+        /// Creates iterator at a specific position.
+        iterator(const eigenray_columns* columns, size_t index)
+            : _columns(columns), _index(index) {}
+
+        /// Position of the current eigenray in the columns.
+        reference operator*() const { return _index; }
+
+        /// Advance to the next eigenray for this target.
+        iterator& operator++() {
+            _index = _columns->next[_index];
+            return *this;
+        }
+
+        /// True if both iterators refer to the same eigenray.
+        bool operator==(const iterator& other) const {
+            return _index == other._index;
+        }
+
+        /// True if the iterators refer to different eigenrays.
+        bool operator!=(const iterator& other) const {
+            return _index != other._index;
+        }
+
+       private:
+        const eigenray_columns* _columns;
+        size_t _index;
+    };
+
+    /**
+     * Creates an empty view.
+     */
+    eigenray_view() = default;
+
+    /**
+     * Creates a view of the eigenrays for a single target.
+     *
+     * @param columns   Storage for the eigenrays of all targets.
+     * @param target    Index number of the target.
+     * @param swapped   Exchange source and target angles if true.
+     */
+    eigenray_view(const eigenray_columns* columns, size_t target,
+                  bool swapped = false)
+        : _columns(columns), _target(target), _swapped(swapped) {}
+
+    /// Storage for the eigenrays of all targets, nullptr for empty view.
+    const eigenray_columns* columns() const { return _columns; }
+
+    /// True if the source and target angles are exchanged.
+    bool swapped() const { return _swapped; }
+
+    /// Number of eigenrays in this view.
+    size_t size() const {
+        return (_columns == nullptr) ? 0 : _columns->count(_target);
+    }
+
+    /// True if this view has no eigenrays.
+    bool empty() const { return size() == 0; }
+
+    /// Iterator to the first eigenray in this view.
+    iterator begin() const {
+        return iterator(_columns, empty() ? eigenray_columns::npos
+                                          : _columns->first(_target));
+    }
+
+    /// Iterator past the last eigenray in this view.
+    iterator end() const { return iterator(_columns, eigenray_columns::npos); }
+
+    /// Time of arrival for one eigenray (sec).
+    double travel_time(size_t index) const {
+        return _columns->travel_time[index];
+    }
+
+    /// Propagation loss for one eigenray, one value per frequency (dB).
+    const double* intensity(size_t index) const {
+        return _columns->intensity(index);
+    }
+
+    /// Phase change for one eigenray, one value per frequency (radians).
+    const double* phase(size_t index) const { return _columns->phase(index); }
+
+    /// Initial DE at the source for one eigenray (degrees).
+    double source_de(size_t index) const {
+        return _swapped ? _columns->target_de[index]
+                        : _columns->source_de[index];
+    }
+
+    /// Initial AZ at the source for one eigenray (degrees).
+    double source_az(size_t index) const {
+        return _swapped ? _columns->target_az[index]
+                        : _columns->source_az[index];
+    }
+
+    /// Final DE at the target for one eigenray (degrees).
+    double target_de(size_t index) const {
+        return _swapped ? _columns->source_de[index]
+                        : _columns->target_de[index];
+    }
+
+    /// Final AZ at the target for one eigenray (degrees).
+    double target_az(size_t index) const {
+        return _swapped ? _columns->source_az[index]
+                        : _columns->target_az[index];
+    }
+
+    /// Surface, bottom, caustic, upper, and lower counts for one eigenray.
+    const int* paths(size_t index) const {
+        return &_columns->paths[index * eigenray_columns::num_paths];
+    }
+
+    /**
+     * Creates a new eigenray_model from a single element of this view.
+     *
+     * @param index     Position of the eigenray in the columns.
+     */
+    eigenray_model::csptr eigenray(size_t index) const {
+        return _columns->eigenray(index, _swapped);
+    }
+
+    /**
+     * Creates a list of new eigenray_model objects for all of the
+     * eigenrays in this view, for code that needs the old interface.
+     */
+    eigenray_list list() const;
+
+   private:
+    /// Storage for the eigenrays of all targets.
+    const eigenray_columns* _columns{nullptr};
+
+    /// Index number of the target.
+    size_t _target{0};
+
+    /// Exchange source and target angles if true.
+    bool _swapped{false};
+};
+
+/// @}
+}  // namespace eigenrays
+}  // namespace usml
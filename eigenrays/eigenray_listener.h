@@ -51,6 +51,19 @@ class USML_DECLSPEC eigenray_listener {
      * @see wave_queue.runID()
      */
     virtual void check_eigenrays(double wave_time, size_t runID) {}
+
+    /**
+     * Notifies the observer that the wavefront has passed one of the
+     * travel time checkpoints requested from the eigenray_notifier. Allows
+     * the observer to publish a partial set of results, like the eigenrays
+     * with travel times less than the checkpoint, before the propagation
+     * model is complete. Does nothing by default.
+     *
+     * @param checkpoint 	Travel time checkpoint that has been passed (sec).
+     * @param runID 		Wavefront identification number.
+     * @see eigenray_notifier.eigenray_checkpoints()
+     */
+    virtual void checkpoint_eigenrays(double checkpoint, size_t runID) {}
 };
 
 /// @}
@@ -5,6 +5,8 @@
 
 #include <usml/eigenrays/eigenray_notifier.h>
 
+#include <algorithm>
+
 using namespace usml::eigenrays;
 
 /**
@@ -35,11 +37,29 @@ void eigenray_notifier::notify_eigenray_listeners(
 /**
  * For each eigenray_listener in the eigenray_listeners set,
  * call the check_eigenrays method to deliver all eigenrays after
- * a certain amount of time has passed.
+ * a certain amount of time has passed. Then report any checkpoints
+ * that the wavefront has passed during this time step.
  */
 void eigenray_notifier::check_eigenray_listeners(double wave_time,
                                                  size_t runID) const {
     for (eigenray_listener* listener : _listeners) {
         listener->check_eigenrays(wave_time, runID);
     }
+    while (_next_checkpoint < _checkpoints.size() &&
+           _checkpoints[_next_checkpoint] <= wave_time) {
+        const double checkpoint = _checkpoints[_next_checkpoint++];
+        for (eigenray_listener* listener : _listeners) {
+            listener->checkpoint_eigenrays(checkpoint, runID);
+        }
+    }
+}
+
+/**
+ * Defines the travel time checkpoints at which listeners are notified.
+ */
+void eigenray_notifier::eigenray_checkpoints(
+    const std::vector<double>& checkpoints) {
+    _checkpoints = checkpoints;
+    std::sort(_checkpoints.begin(), _checkpoints.end());
+    _next_checkpoint = 0;
 }
@@ -10,6 +10,7 @@
 
 #include <cstddef>
 #include <set>
+#include <vector>
 
 namespace usml {
 namespace eigenrays {
@@ -49,7 +50,9 @@ class USML_DECLSPEC eigenray_notifier {
     /**
      * Notifies all of the listeners that eigenray processing is complete for
      * a specific wavefront time step. This can be used to limit the time
-     * window for eigenrays to each specific target.
+     * window for eigenrays to each specific target. Also notifies the
+     * listeners of each travel time checkpoint that is less than or equal
+     * to the wave_time, but has not been reported yet.
      *
      * @param  wave_time    Elapsed time for this wavefront step.
      * @param runID 		Wavefront identification number.
@@ -63,11 +66,41 @@ class USML_DECLSPEC eigenray_notifier {
      */
     inline bool has_eigenray_listeners() const { return _listeners.size() > 0; }
 
+    /**
+     * Travel time checkpoints at which listeners are notified, using
+     * eigenray_listener::checkpoint_eigenrays(), that the wavefront has
+     * passed this time. Stored in increasing order.
+     */
+    const std::vector<double>& eigenray_checkpoints() const {
+        return _checkpoints;
+    }
+
+    /**
+     * Defines the travel time checkpoints at which listeners are notified
+     * that the wavefront has passed this time. Sorts the checkpoints into
+     * increasing order, and resets the notifier so that all of them will be
+     * reported. Use an empty list to turn checkpoints off.
+     *
+     * @param checkpoints   Travel times at which to notify listeners (sec).
+     */
+    void eigenray_checkpoints(const std::vector<double>& checkpoints);
+
    private:
     /**
      * List of active eigenray listeners.
      */
     std::set<eigenray_listener*> _listeners;
+
+    /**
+     * Travel time checkpoints, in increasing order (sec).
+     */
+    std::vector<double> _checkpoints;
+
+    /**
+     * Index of the next checkpoint to be reported. Mutable because the
+     * checkpoints are reported by check_eigenray_listeners().
+     */
+    mutable size_t _next_checkpoint{0};
 };
 
 /// @}
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <usml/eigenrays/eigenray_collection.h>
+#include <usml/eigenrays/eigenray_columns.h>
 #include <usml/eigenrays/eigenray_listener.h>
 #include <usml/eigenrays/eigenray_model.h>
 #include <usml/eigenrays/eigenray_notifier.h>
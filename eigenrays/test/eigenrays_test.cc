@@ -2,6 +2,7 @@
  * @example eigenrays/test/eigenrays_test.cc
  */
 #include <usml/eigenrays/eigenrays.h>
+#include <usml/ocean/profile_linear.h>
 #include <usml/types/types.h>
 
 #include <boost/test/unit_test.hpp>
@@ -90,6 +91,619 @@ BOOST_AUTO_TEST_CASE(create_eigenray) {
     collection.write_netcdf(ncname);
 }
 
+/**
+ * Tests the hash index from target ID to grid location. Builds a grid of
+ * targets with unique IDs, except for the last target, which repeats the
+ * ID of the first target. Adds a single eigenray to some of the targets.
+ *
+ * This test passes if:
+ *   - find_target() locates each target ID, with duplicates matching the
+ *     first target in row major order,
+ *   - find_views() returns views that refer to the eigenrays stored
+ *     in the collection, instead of copies, with the correct initial time,
+ *   - unknown target IDs produce views with an empty eigenray list, and
+ *   - find_eigenrays() and find_initial_time() agree with the views.
+ */
+BOOST_AUTO_TEST_CASE(target_index) {
+    cout << "=== eigenrays_test: target_index ===" << endl;
+    const size_t num_rows = 40;
+    const size_t num_cols = 50;
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    wposition1 source_pos(15.0, 35.0);
+    wposition targets(num_rows, num_cols, 12.0, 37.0);
+    matrix<uint64_t> targetIDs(num_rows, num_cols);
+    for (size_t t1 = 0; t1 < num_rows; ++t1) {
+        for (size_t t2 = 0; t2 < num_cols; ++t2) {
+            targetIDs(t1, t2) = 1000 + t1 * num_cols + t2;
+        }
+    }
+    targetIDs(num_rows - 1, num_cols - 1) = targetIDs(0, 0);
+    eigenray_collection collection(frequencies, source_pos, targets, 1,
+                                   targetIDs);
+    for (size_t t1 = 0; t1 < num_rows; t1 += 3) {
+        auto* ray = new eigenray_model();
+        ray->travel_time = 1.0 + (double)t1;
+        collection.add_eigenray(t1, 1, eigenray_model::csptr(ray));
+    }
+
+    // find each target in the grid
+
+    std::vector<uint64_t> search;
+    for (size_t t1 = 0; t1 < num_rows; ++t1) {
+        for (size_t t2 = 0; t2 < num_cols; ++t2) {
+            size_t r = 0;
+            size_t c = 0;
+            BOOST_REQUIRE(collection.find_target(targetIDs(t1, t2), &r, &c));
+            const bool duplicate = (t1 == num_rows - 1 && t2 == num_cols - 1);
+            BOOST_CHECK_EQUAL(r, duplicate ? 0 : t1);
+            BOOST_CHECK_EQUAL(c, duplicate ? 0 : t2);
+        }
+        search.push_back(targetIDs(t1, 1));
+    }
+    search.push_back(999);  // unknown target
+
+    // split collection into views for a list of targets
+
+    auto views = collection.find_views(search);
+    BOOST_REQUIRE_EQUAL(views.size(), search.size());
+    for (size_t t1 = 0; t1 < num_rows; ++t1) {
+        const auto& view = views[t1];
+        BOOST_CHECK(view.found);
+        BOOST_CHECK_EQUAL(view.targetID, search[t1]);
+        BOOST_CHECK_EQUAL(view.eigenrays.columns(), &collection.columns());
+        BOOST_CHECK_EQUAL(view.eigenrays.size(), (t1 % 3 == 0) ? 1 : 0);
+        BOOST_CHECK_EQUAL(view.initial_time, collection.initial_time(t1, 1));
+        BOOST_CHECK_EQUAL(collection.find_eigenrays(search[t1]).size(),
+                          view.eigenrays.size());
+        BOOST_CHECK_EQUAL(collection.find_initial_time(search[t1]),
+                          view.initial_time);
+    }
+    BOOST_CHECK(!views.back().found);
+    BOOST_CHECK(views.back().eigenrays.empty());
+    BOOST_CHECK_EQUAL(collection.find_initial_time(999), 0.0);
+}
+
+/**
+ * Tests the columnar storage of eigenrays. Adds eigenrays to two targets
+ * in an interleaved order, and then copies the eigenrays of the first
+ * target into a second collection, using a view that swaps the source
+ * and target angles.
+ *
+ * This test passes if:
+ *   - each target's view lists its eigenrays in the order they were added,
+ *   - eigenrays converted back into eigenray_model objects match the
+ *     originals, and
+ *   - the copy has its source and target angles exchanged, with all other
+ *     values unchanged, and the same summed intensity as the original.
+ */
+BOOST_AUTO_TEST_CASE(eigenray_columns_view) {
+    cout << "=== eigenrays_test: eigenray_columns_view ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1000.0, 3));
+    wposition1 source_pos(15.0, 35.0);
+    wposition targets(1, 2, 12.0, 37.0);
+    eigenray_collection collection(frequencies, source_pos, targets);
+
+    eigenray_factory factory;
+    factory.add_eigenray_listener(&collection);
+    std::vector<eigenray_model::csptr> originals;
+    for (size_t n = 0; n < 6; ++n) {
+        auto* ray = new eigenray_model();
+        ray->travel_time = 10.0 - (double)n;
+        ray->source_de = 20.0 + (double)n;
+        ray->source_az = 30.0 + (double)n;
+        ray->target_de = 40.0 + (double)n;
+        ray->target_az = 50.0 + (double)n;
+        ray->surface = (int)n;
+        ray->bottom = (int)n + 1;
+        ray->caustic = (int)n + 2;
+        ray->upper = (int)n + 3;
+        ray->lower = (int)n + 4;
+        ray->frequencies = frequencies;
+        ray->intensity = scalar_vector<double>(frequencies->size(), 60.0 + n);
+        ray->phase = scalar_vector<double>(frequencies->size(), -0.1 * n);
+        originals.push_back(eigenray_model::csptr(ray));
+        collection.add_eigenray(0, n % 2, originals.back());
+    }
+    BOOST_CHECK_EQUAL(collection.columns().size(), 6);
+    BOOST_CHECK_EQUAL(collection.initial_time(0, 0), 6.0);
+    BOOST_CHECK_EQUAL(collection.initial_time(0, 1), 5.0);
+
+    // check that views list eigenrays in the order they were added
+
+    for (size_t t2 = 0; t2 < 2; ++t2) {
+        const eigenray_list list = collection.eigenrays(0, t2);
+        BOOST_REQUIRE_EQUAL(list.size(), 3);
+        size_t n = t2;
+        for (const auto& ray : list) {
+            const auto& orig = *originals[n];
+            BOOST_CHECK_EQUAL(ray->travel_time, orig.travel_time);
+            BOOST_CHECK_EQUAL(ray->source_az, orig.source_az);
+            BOOST_CHECK_EQUAL(ray->target_de, orig.target_de);
+            BOOST_CHECK_EQUAL(ray->lower, orig.lower);
+            BOOST_CHECK_EQUAL(ray->intensity(2), orig.intensity(2));
+            BOOST_CHECK_EQUAL(ray->phase(1), orig.phase(1));
+            n += 2;
+        }
+    }
+
+    // copy first target using a swapped view
+
+    wposition source(1, 1, 12.0, 37.0);
+    eigenray_collection copy(frequencies, wposition1(targets, 0, 0), source);
+    copy.add_eigenrays(0, 0, collection.view(0, 0, true));
+    BOOST_CHECK_EQUAL(copy.initial_time(0, 0), 6.0);
+    const eigenray_view rays = copy.view(0, 0);
+    BOOST_REQUIRE_EQUAL(rays.size(), 3);
+    size_t n = 0;
+    for (size_t index : rays) {
+        const auto& orig = *originals[n];
+        BOOST_CHECK_EQUAL(rays.travel_time(index), orig.travel_time);
+        BOOST_CHECK_EQUAL(rays.source_de(index), orig.target_de);
+        BOOST_CHECK_EQUAL(rays.source_az(index), orig.target_az);
+        BOOST_CHECK_EQUAL(rays.target_de(index), orig.source_de);
+        BOOST_CHECK_EQUAL(rays.target_az(index), orig.source_az);
+        BOOST_CHECK_EQUAL(rays.paths(index)[1], orig.bottom);
+        BOOST_CHECK_EQUAL(rays.intensity(index)[0], orig.intensity(0));
+        BOOST_CHECK_EQUAL(rays.phase(index)[2], orig.phase(2));
+        n += 2;
+    }
+
+    collection.sum_eigenrays();
+    copy.sum_eigenrays();
+    for (size_t f = 0; f < frequencies->size(); ++f) {
+        BOOST_CHECK_EQUAL(copy.total(0, 0).intensity(f),
+                          collection.total(0, 0).intensity(f));
+    }
+    BOOST_CHECK_CLOSE(copy.total(0, 0).source_de,
+                      collection.total(0, 0).target_de, 1e-10);
+}
+
+/**
+ * Tests the coherent and incoherent sums of eigenrays over a grid of
+ * targets. Each target has a different number of eigenrays, with different
+ * travel times, angles, and losses at each frequency. Sums the grid once
+ * in a single thread, and again in parallel blocks of one target each.
+ *
+ * This test passes if:
+ *   - the parallel sum matches the single thread sum exactly, and
+ *   - the intensity, phase, travel time, and path counts match a phasor
+ *     sum computed directly from the eigenrays in this test.
+ */
+BOOST_AUTO_TEST_CASE(sum_eigenrays_grid) {
+    cout << "=== eigenrays_test: sum_eigenrays_grid ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(1000.0, 250.0, 5));
+    wposition1 source_pos(15.0, 35.0);
+    wposition targets(3, 4, 12.0, 37.0);
+    const size_t default_block = eigenray_collection::targets_per_task;
+
+    for (bool coherent : {true, false}) {
+        eigenray_collection serial(frequencies, source_pos, targets, 0,
+                                   matrix<uint64_t>(), coherent);
+        eigenray_collection parallel(frequencies, source_pos, targets, 0,
+                                     matrix<uint64_t>(), coherent);
+        for (size_t t1 = 0; t1 < targets.size1(); ++t1) {
+            for (size_t t2 = 0; t2 < targets.size2(); ++t2) {
+                for (size_t n = 0; n <= t1 + t2; ++n) {
+                    auto* ray = new eigenray_model();
+                    ray->travel_time = 1.0 + 0.37 * n + 0.01 * t2;
+                    ray->source_de = -10.0 + 3.0 * n;
+                    ray->source_az = 10.0 * t1 + 5.0 * n;
+                    ray->target_de = 10.0 - 2.0 * n;
+                    ray->target_az = 180.0 + 7.0 * n;
+                    ray->surface = (int)n;
+                    ray->bottom = (int)(t1 + t2);
+                    ray->frequencies = frequencies;
+                    ray->intensity.resize(frequencies->size());
+                    ray->phase.resize(frequencies->size());
+                    for (size_t f = 0; f < frequencies->size(); ++f) {
+                        ray->intensity(f) = 60.0 + 3.0 * n + (n % 2) * f;
+                        ray->phase(f) = -M_PI_2 * (n % 3);
+                    }
+                    eigenray_model::csptr csptr(ray);
+                    serial.add_eigenray(t1, t2, csptr);
+                    parallel.add_eigenray(t1, t2, csptr);
+                }
+            }
+        }
+        eigenray_collection::targets_per_task = 1000;
+        serial.sum_eigenrays();
+        eigenray_collection::targets_per_task = 1;
+        parallel.sum_eigenrays();
+        eigenray_collection::targets_per_task = default_block;
+
+        for (size_t t1 = 0; t1 < targets.size1(); ++t1) {
+            for (size_t t2 = 0; t2 < targets.size2(); ++t2) {
+                const eigenray_model& total = serial.total(t1, t2);
+                const eigenray_model& other = parallel.total(t1, t2);
+                BOOST_CHECK_EQUAL(total.travel_time, other.travel_time);
+                BOOST_CHECK_EQUAL(total.source_az, other.source_az);
+                BOOST_CHECK_EQUAL(total.surface, other.surface);
+
+                // compute phasor sum directly from eigenrays
+
+                const eigenray_list rays = serial.eigenrays(t1, t2);
+                double wgt = 0.0;
+                double time = 0.0;
+                double max_a = 0.0;
+                int surface = -1;
+                for (size_t f = 0; f < frequencies->size(); ++f) {
+                    std::complex<double> phasor(0.0, 0.0);
+                    for (const auto& ray : rays) {
+                        double a = pow(10.0, ray->intensity(f) / -20.0);
+                        if (coherent) {
+                            double p = TWO_PI * (*frequencies)(f) *
+                                           ray->travel_time +
+                                       ray->phase(f);
+                            phasor += std::polar(a, p);
+                        } else {
+                            phasor += a;
+                        }
+                        a *= a;
+                        wgt += a;
+                        time += a * ray->travel_time;
+                        if (a > max_a) {
+                            max_a = a;
+                            surface = ray->surface;
+                        }
+                    }
+                    BOOST_CHECK_EQUAL(total.intensity(f),
+                                      other.intensity(f));
+                    BOOST_CHECK_CLOSE(total.intensity(f),
+                                      -20.0 * log10(abs(phasor)), 1e-8);
+                    BOOST_CHECK_SMALL(
+                        std::arg(std::polar(1.0, total.phase(f)) /
+                                 std::polar(1.0, arg(phasor))),
+                        1e-8);
+                }
+                BOOST_CHECK_CLOSE(total.travel_time, time / wgt, 1e-10);
+                BOOST_CHECK_EQUAL(total.surface, surface);
+                BOOST_CHECK_EQUAL(total.bottom, (int)(t1 + t2));
+            }
+        }
+    }
+}
+
+/**
+ * Tests the batch version of dead reckoning against the version that
+ * processes a single target. Builds two collections, with different
+ * sources and a different number of targets, and moves the source and
+ * all but one of the targets.
+ *
+ * This test passes if:
+ *   - the travel time and intensity of each eigenray match the results of
+ *     the single target dead_reckon() method,
+ *   - eigenrays for a target that has not moved and a source that has not
+ *     moved are unchanged, and
+ *   - the new collections are at the updated locations, with the
+ *     same target IDs, and an initial time that matches the fastest ray.
+ */
+BOOST_AUTO_TEST_CASE(dead_reckon_batch) {
+    cout << "=== eigenrays_test: dead_reckon_batch ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(1000.0, 1000.0, 3));
+    profile_model::csptr profile(new profile_linear(1500.0, 0.017));
+
+    std::vector<eigenray_collection::csptr> collections;
+    std::vector<wposition1> sources;
+    std::vector<wposition> targets;
+    for (size_t c = 0; c < 2; ++c) {
+        wposition1 source_pos(45.0 + (double)c, -45.0, -100.0);
+        wposition target_pos(1, 2 + c, 45.02 + (double)c, -45.0, -200.0);
+        matrix<uint64_t> targetIDs(1, 2 + c);
+        for (size_t t2 = 0; t2 < target_pos.size2(); ++t2) {
+            targetIDs(0, t2) = 10 * (c + 1) + t2;
+        }
+        auto* collection = new eigenray_collection(
+            frequencies, source_pos, target_pos, c + 1, targetIDs);
+        for (size_t t2 = 0; t2 < target_pos.size2(); ++t2) {
+            for (size_t n = 0; n < 3; ++n) {
+                auto* ray = new eigenray_model();
+                ray->travel_time = 1.5 + 0.1 * n;
+                ray->source_de = -30.0 + 20.0 * n;
+                ray->source_az = 10.0 + 40.0 * t2;
+                ray->target_de = 30.0 - 20.0 * n;
+                ray->target_az = 190.0 + 40.0 * t2;
+                ray->frequencies = frequencies;
+                ray->intensity = scalar_vector<double>(3, 70.0 + n);
+                ray->phase = scalar_vector<double>(3, 0.0);
+                collection->add_eigenray(0, t2, eigenray_model::csptr(ray));
+            }
+        }
+        collection->sum_eigenrays();
+        collections.push_back(eigenray_collection::csptr(collection));
+
+        // move the source of the second collection, and all targets
+        // except the first target of the first collection
+
+        if (c == 1) {
+            source_pos.latitude(source_pos.latitude() + 0.005);
+        }
+        for (size_t t2 = (c == 0) ? 1 : 0; t2 < target_pos.size2(); ++t2) {
+            target_pos.longitude(0, t2, target_pos.longitude(0, t2) + 0.004);
+            target_pos.altitude(0, t2, target_pos.altitude(0, t2) - 10.0);
+        }
+        sources.push_back(source_pos);
+        targets.push_back(target_pos);
+    }
+
+    auto results = eigenray_collection::dead_reckon(collections, sources,
+                                                    targets, profile);
+    BOOST_REQUIRE_EQUAL(results.size(), 2);
+    for (size_t c = 0; c < 2; ++c) {
+        const eigenray_collection& old = *collections[c];
+        const eigenray_collection& result = *results[c];
+        BOOST_CHECK_EQUAL(result.sourceID(), old.sourceID());
+        BOOST_CHECK_EQUAL(result.source_pos().latitude(),
+                          sources[c].latitude());
+        for (size_t t2 = 0; t2 < old.size2(); ++t2) {
+            BOOST_CHECK_EQUAL(result.targetID(0, t2), old.targetID(0, t2));
+            BOOST_CHECK_EQUAL(result.position(0, t2).longitude(),
+                              targets[c].longitude(0, t2));
+            const eigenray_list expected = old.dead_reckon(
+                0, t2, sources[c], wposition1(targets[c], 0, t2), profile);
+            const eigenray_list actual = result.eigenrays(0, t2);
+            BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+            auto ray = actual.begin();
+            double fastest = 1e10;
+            for (const auto& theory : expected) {
+                BOOST_CHECK_CLOSE((*ray)->travel_time, theory->travel_time,
+                                  1e-10);
+                for (size_t f = 0; f < frequencies->size(); ++f) {
+                    BOOST_CHECK_CLOSE((*ray)->intensity(f),
+                                      theory->intensity(f), 1e-10);
+                }
+                fastest = std::min(fastest, theory->travel_time);
+                ++ray;
+            }
+            BOOST_CHECK_CLOSE(result.initial_time(0, t2), fastest, 1e-10);
+        }
+    }
+
+    // first target of first collection did not move
+
+    const eigenray_list before = collections[0]->eigenrays(0, 0);
+    const eigenray_list after = results[0]->eigenrays(0, 0);
+    auto ray = after.begin();
+    for (const auto& orig : before) {
+        BOOST_CHECK_EQUAL((*ray)->travel_time, orig->travel_time);
+        BOOST_CHECK_EQUAL((*ray)->intensity(1), orig->intensity(1));
+        ++ray;
+    }
+}
+
+/**
+ * Tests the ability to publish partial results at travel time checkpoints.
+ * Builds a collection with three eigenrays for each of two targets, and
+ * uses an eigenray_notifier to report checkpoints as a simulated wavefront
+ * advances in time.
+ *
+ * This test passes if:
+ *   - each checkpoint is reported exactly once, in increasing order, on the
+ *     first time step that reaches it,
+ *   - a snapshot only includes the eigenrays that arrive at or before its
+ *     checkpoint, and
+ *   - the totals of the snapshot match a collection built from just those
+ *     early eigenrays.
+ */
+BOOST_AUTO_TEST_CASE(eigenray_checkpoints) {
+    cout << "=== eigenrays_test: eigenray_checkpoints ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(1000.0, 1000.0, 3));
+    wposition1 source_pos(45.0, -45.0, -100.0);
+    wposition target_pos(1, 2, 45.02, -45.0, -200.0);
+    matrix<uint64_t> targetIDs(1, 2);
+    targetIDs(0, 0) = 1;
+    targetIDs(0, 1) = 2;
+    eigenray_collection collection(frequencies, source_pos, target_pos, 0,
+                                   targetIDs, false);
+    for (size_t t2 = 0; t2 < 2; ++t2) {
+        for (size_t n = 0; n < 3; ++n) {
+            auto* ray = new eigenray_model();
+            ray->travel_time = 1.0 + (double)n + 0.1 * (double)t2;
+            ray->frequencies = frequencies;
+            ray->intensity = scalar_vector<double>(3, 60.0 + 10.0 * n);
+            ray->phase = scalar_vector<double>(3, 0.0);
+            collection.add_eigenray(0, t2, eigenray_model::csptr(ray));
+        }
+    }
+    collection.sum_eigenrays();
+
+    // record each checkpoint reported by the notifier
+
+    struct checkpoint_listener : public eigenray_listener {
+        void add_eigenray(size_t, size_t, eigenray_model::csptr,
+                          size_t) override {}
+        void checkpoint_eigenrays(double checkpoint, size_t) override {
+            checkpoints.push_back(checkpoint);
+        }
+        std::vector<double> checkpoints;
+    } listener;
+
+    eigenray_notifier notifier;
+    notifier.add_eigenray_listener(&listener);
+    notifier.eigenray_checkpoints({2.5, 1.5});
+    BOOST_CHECK_EQUAL(notifier.eigenray_checkpoints().front(), 1.5);
+    for (double wave_time = 0.0; wave_time < 4.0; wave_time += 0.25) {
+        notifier.check_eigenray_listeners(wave_time, 0);
+    }
+    BOOST_REQUIRE_EQUAL(listener.checkpoints.size(), 2);
+    BOOST_CHECK_EQUAL(listener.checkpoints[0], 1.5);
+    BOOST_CHECK_EQUAL(listener.checkpoints[1], 2.5);
+
+    // compare snapshot at each checkpoint to eigenrays that arrive before it
+
+    for (double checkpoint : listener.checkpoints) {
+        auto snapshot = collection.snapshot(checkpoint);
+        eigenray_collection early(frequencies, source_pos, target_pos, 0,
+                                  targetIDs, false);
+        for (size_t t2 = 0; t2 < 2; ++t2) {
+            for (const auto& ray : collection.eigenrays(0, t2)) {
+                if (ray->travel_time <= checkpoint) {
+                    early.add_eigenray(0, t2, ray);
+                }
+            }
+        }
+        early.sum_eigenrays();
+        BOOST_CHECK_EQUAL(snapshot->targetID(0, 1), 2);
+        for (size_t t2 = 0; t2 < 2; ++t2) {
+            const eigenray_list rays = snapshot->eigenrays(0, t2);
+            BOOST_CHECK_EQUAL(rays.size(), early.eigenrays(0, t2).size());
+            for (const auto& ray : rays) {
+                BOOST_CHECK(ray->travel_time <= checkpoint);
+            }
+            BOOST_CHECK_EQUAL(snapshot->initial_time(0, t2),
+                              early.initial_time(0, t2));
+            BOOST_CHECK_CLOSE(snapshot->total(0, t2).intensity(0),
+                              early.total(0, t2).intensity(0), 1e-10);
+        }
+    }
+}
+
+/**
+ * Writes a grid of targets to a binary archive and reads it back. Some
+ * targets have several eigenrays, in an interleaved target order, and one
+ * target has none.
+ *
+ * This test passes if:
+ *   - the source, target grid, target IDs, and coherent flag are restored,
+ *   - the eigenrays, totals, and initial time of each target are identical
+ *     to the ones written to the archive,
+ *   - the target ID index is rebuilt, and
+ *   - readers reject the archive if they expect a different kind of data.
+ */
+BOOST_AUTO_TEST_CASE(eigenray_archive) {
+    cout << "=== eigenrays_test: eigenray_archive ===" << endl;
+    const char* filename =
+        USML_TEST_DIR "/eigenrays/test/eigenray_archive.arc";
+    seq_vector::csptr frequencies(new seq_linear(1000.0, 500.0, 4));
+    wposition1 source_pos(15.0, 35.0, -50.0);
+    wposition target_pos(2, 3, 15.1, 35.2, -75.0);
+    matrix<uint64_t> targetIDs(2, 3);
+    for (size_t t1 = 0; t1 < 2; ++t1) {
+        for (size_t t2 = 0; t2 < 3; ++t2) {
+            targetIDs(t1, t2) = 100 + 10 * t1 + t2;
+            target_pos.altitude(t1, t2, -10.0 * (double)(t1 + t2));
+        }
+    }
+    eigenray_collection collection(frequencies, source_pos, target_pos, 7,
+                                   targetIDs, false);
+    for (size_t n = 0; n < 3; ++n) {
+        for (size_t target = 0; target < 5; ++target) {
+            const size_t t1 = target / 3;
+            const size_t t2 = target % 3;
+            auto* ray = new eigenray_model();
+            ray->travel_time = 2.0 - 0.3 * (double)n + 0.01 * (double)target;
+            ray->source_de = -5.0 * (double)n;
+            ray->source_az = 10.0 * (double)target;
+            ray->target_de = 3.0 * (double)n;
+            ray->target_az = 180.0 + (double)target;
+            ray->surface = (int)n;
+            ray->bottom = (int)target;
+            ray->lower = 1;
+            ray->frequencies = frequencies;
+            ray->intensity.resize(frequencies->size());
+            ray->phase.resize(frequencies->size());
+            for (size_t f = 0; f < frequencies->size(); ++f) {
+                ray->intensity(f) = 70.0 + (double)(n + f + target);
+                ray->phase(f) = -M_PI_2 * (double)n;
+            }
+            collection.add_eigenray(t1, t2, eigenray_model::csptr(ray));
+        }
+    }
+    collection.sum_eigenrays();
+    collection.write_archive(filename);
+
+    auto copy = eigenray_collection::read_archive(filename);
+    BOOST_CHECK_EQUAL(copy->sourceID(), 7);
+    BOOST_CHECK_EQUAL(copy->coherent(), false);
+    BOOST_CHECK_CLOSE(copy->source_pos().latitude(), 15.0, 1e-10);
+    BOOST_CHECK_CLOSE(copy->source_pos().altitude(), -50.0, 1e-10);
+    BOOST_REQUIRE_EQUAL(copy->size1(), 2);
+    BOOST_REQUIRE_EQUAL(copy->size2(), 3);
+    BOOST_REQUIRE_EQUAL(copy->frequencies()->size(), frequencies->size());
+    BOOST_CHECK_EQUAL((*copy->frequencies())(3), (*frequencies)(3));
+    for (size_t t1 = 0; t1 < 2; ++t1) {
+        for (size_t t2 = 0; t2 < 3; ++t2) {
+            BOOST_CHECK_EQUAL(copy->targetID(t1, t2), targetIDs(t1, t2));
+            BOOST_CHECK_CLOSE(copy->position(t1, t2).longitude(), 35.2, 1e-10);
+            BOOST_CHECK_SMALL(copy->position(t1, t2).altitude() +
+                                  10.0 * (double)(t1 + t2),
+                              1e-6);
+            BOOST_CHECK_EQUAL(copy->initial_time(t1, t2),
+                              collection.initial_time(t1, t2));
+
+            const eigenray_list rays = copy->eigenrays(t1, t2);
+            const eigenray_list original = collection.eigenrays(t1, t2);
+            BOOST_REQUIRE_EQUAL(rays.size(), original.size());
+            if (!rays.empty()) {  // totals of empty targets are NaN
+                const eigenray_model& total = copy->total(t1, t2);
+                const eigenray_model& expected = collection.total(t1, t2);
+                BOOST_CHECK_EQUAL(total.travel_time, expected.travel_time);
+                BOOST_CHECK_EQUAL(total.surface, expected.surface);
+                for (size_t f = 0; f < frequencies->size(); ++f) {
+                    BOOST_CHECK_EQUAL(total.intensity(f),
+                                      expected.intensity(f));
+                    BOOST_CHECK_EQUAL(total.phase(f), expected.phase(f));
+                }
+            }
+            auto other = original.begin();
+            for (const auto& ray : rays) {
+                BOOST_CHECK_EQUAL(ray->travel_time, (*other)->travel_time);
+                BOOST_CHECK_EQUAL(ray->source_az, (*other)->source_az);
+                BOOST_CHECK_EQUAL(ray->target_de, (*other)->target_de);
+                BOOST_CHECK_EQUAL(ray->bottom, (*other)->bottom);
+                BOOST_CHECK_EQUAL(ray->lower, (*other)->lower);
+                BOOST_CHECK_EQUAL(ray->intensity(2), (*other)->intensity(2));
+                BOOST_CHECK_EQUAL(ray->phase(1), (*other)->phase(1));
+                ++other;
+            }
+        }
+    }
+    BOOST_CHECK(copy->eigenrays(1, 2).empty());
+    BOOST_CHECK_EQUAL(copy->find_view(111).t2, 1);
+    BOOST_CHECK_THROW(archive_reader(filename, "eigenverbs"),
+                      std::invalid_argument);
+}
+
+/**
+ * Writes eigenray columns with corrupted links to an archive and reads
+ * them back.
+ *
+ * This test passes if:
+ *   - the original columns are read back without errors, and
+ *   - readers reject columns where the next links form a cycle, or
+ *     where a list has more eigenrays than its count.
+ */
+BOOST_AUTO_TEST_CASE(eigenray_archive_cycle) {
+    cout << "=== eigenrays_test: eigenray_archive_cycle ===" << endl;
+    const char* filename =
+        USML_TEST_DIR "/eigenrays/test/eigenray_archive_cycle.arc";
+    eigenray_columns columns(2);
+    for (size_t n = 0; n < 4; ++n) {
+        eigenray_model ray;
+        ray.travel_time = 1.0 + 0.1 * (double)n;
+        columns.push_back(n % 2, ray);
+    }
+
+    auto round_trip = [&](const eigenray_columns& original) {
+        {
+            archive_writer writer(filename, "eigenrays");
+            original.write_archive(&writer);
+        }
+        archive_reader reader(filename, "eigenrays");
+        eigenray_columns copy;
+        copy.read_archive(reader);
+        return copy.size();
+    };
+    BOOST_CHECK_EQUAL(round_trip(columns), 4);
+
+    eigenray_columns cycle = columns;
+    cycle.next[2] = 0;  // target 0 loops back to its first eigenray
+    BOOST_CHECK_THROW(round_trip(cycle), std::invalid_argument);
+
+    eigenray_columns merged = columns;
+    merged.next[2] = 1;  // target 0 runs into the list for target 1
+    BOOST_CHECK_THROW(round_trip(merged), std::invalid_argument);
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
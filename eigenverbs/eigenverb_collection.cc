@@ -4,25 +4,33 @@
  */
 
 #include <usml/eigenverbs/eigenverb_collection.h>
+#include <usml/types/archive.h>
 #include <usml/types/seq_data.h>
 #include <usml/types/seq_vector.h>
+#include <usml/types/wposition.h>
 #include <usml/types/wposition1.h>
 #include <usml/ublas/math_traits.h>
 #include <usml/ublas/vector_math.h>
 
+#include <boost/iterator/function_output_iterator.hpp>
+#include <boost/geometry/geometries/box.hpp>
 #include <boost/geometry/geometries/polygon.hpp>
 #include <boost/geometry/index/detail/predicates.hpp>
 #include <boost/geometry/index/predicates.hpp>
 #include <boost/numeric/ublas/storage.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/vector_expression.hpp>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <iterator>
 #include <list>
 #include <netcdf>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace usml::eigenverbs;
 
@@ -31,63 +39,209 @@ using namespace usml::eigenverbs;
  */
 double eigenverb_collection::search_scale = 1.5;
 
+namespace {
+
+/// Point in longitude and latitude on the surface of a sphere.
+typedef bgm::point<double, 2, bg::cs::spherical_equatorial<bg::degree>>
+    geo_point;
+
+/// Polygon whose edges are great circle arcs.
+typedef bgm::polygon<geo_point> geo_polygon;
+
+/**
+ * Wraps longitude into the range [-180,180).
+ *
+ * @param longitude     Longitude in any range (degrees_east).
+ * @return              Equivalent longitude in the range [-180,180).
+ */
+double wrap_longitude(double longitude) {
+    longitude = std::fmod(longitude + 180.0, 360.0);
+    if (longitude < 0.0) {
+        longitude += 360.0;
+    }
+    return longitude - 180.0;
+}
+
+/**
+ * Diamond shaped search area around an eigenverb. Its corners are
+ * search_scale times the length of the eigenverb in front of, and
+ * behind, its center. The other corners are search_scale times the width
+ * of the eigenverb to each side. Edges are great circle arcs.
+ *
+ * @param verb          Eigenverb that defines the search area.
+ * @param scale         Scale factor for size of search area.
+ * @return              Closed polygon in clockwise order.
+ */
+geo_polygon search_area(const eigenverb_model& verb, double scale) {
+    const auto& pos = verb.position;
+    const auto direction = verb.direction;
+    wposition1 posA(pos, scale * verb.length, direction);
+    wposition1 posB(pos, scale * verb.width, direction + M_PI_2);
+    wposition1 posC(pos, scale * verb.length, direction + M_PI);
+    wposition1 posD(pos, scale * verb.width, direction + M_PI + M_PI_2);
+    geo_polygon area;
+    for (const wposition1* corner : {&posA, &posB, &posC, &posD, &posA}) {
+        area.outer().emplace_back(wrap_longitude(corner->longitude()),
+                                  corner->latitude());
+    }
+    return area;
+}
+
+}  // namespace
+
+/**
+ * Tests whether an eigenverb is inside the search area around another
+ * eigenverb.
+ */
+bool eigenverb_collection::in_search_area(
+    const eigenverb_model& bounding_verb, const eigenverb_model& verb) {
+    const geo_point center(wrap_longitude(verb.position.longitude()),
+                           verb.position.latitude());
+    return bg::within(center, search_area(bounding_verb, search_scale));
+}
+
 /**
  * Creates list of eigenverbs for a specific interface.
  */
 eigenverb_list eigenverb_collection::eigenverbs(size_t interface) const {
-    read_lock_guard guard(_mutex);
+    const eigenverb_columns& verbs = _collection[interface].verbs;
     eigenverb_list list;
-    for (const auto& pair : _collection[interface]) {
-        list.push_back(pair.second);
+    for (size_t n = 0; n < verbs.size(); ++n) {
+        list.push_back(verbs.eigenverb(n));
     }
     return list;
 }
 
+/**
+ * Upper limit on the duration of the biverbs that use these eigenverbs
+ * as receiver eigenverbs.
+ */
+double eigenverb_collection::duration_maximum() const {
+    double duration = 0.0;
+    for (const auto& entry : _collection) {
+        const eigenverb_columns& verbs = entry.verbs;
+        for (size_t n = 0; n < verbs.size(); ++n) {
+            duration = std::max(duration, 0.5 * verbs.length[n] *
+                                              cos(verbs.grazing[n]) /
+                                              verbs.sound_speed[n]);
+        }
+    }
+    return duration;
+}
+
 /**
  * Adds a new eigenverb to this collection.
  */
 void eigenverb_collection::add_eigenverb(eigenverb_model::csptr verb,
                                          size_t interface) {
+    _collection[interface].verbs.push_back(*verb);
+    _indexed = false;
+}
+
+/**
+ * Bulk loads the spatial index for each interface.
+ */
+void eigenverb_collection::build_index() const {
+    if (_indexed) {
+        return;
+    }
     write_lock_guard guard(_mutex);
-    eigenverb_collection::point center(verb->position.latitude(),
-                                       verb->position.longitude());
-    _collection[interface].insert(eigenverb_collection::pair(center, verb));
+    if (_indexed) {
+        return;  // another thread built index while we waited for lock
+    }
+    std::vector<eigenverb_collection::pair> values;
+    for (interface_verbs& store : _collection) {
+        const eigenverb_columns& verbs = store.verbs;
+        values.clear();
+        values.reserve(verbs.size());
+        for (size_t n = 0; n < verbs.size(); ++n) {
+            values.emplace_back(
+                point(verbs.latitude[n], wrap_longitude(verbs.longitude[n]),
+                      verbs.travel_time[n]),
+                n);
+        }
+        store.index = rtree(values.begin(), values.end());
+    }
+    _indexed = true;
 }
 
 /**
- * Finds all of the eigenverbs that intersect the requested area.
+ * Finds all of the eigenverbs inside the search area around another
+ * eigenverb, and inside a window of travel times.
  */
-eigenverb_list eigenverb_collection::find_eigenverbs(
-    const eigenverb_model::csptr& bounding_verb, size_t interface) const {
+void eigenverb_collection::find_eigenverbs(const eigenverb_model& bounding_verb,
+                                           size_t interface,
+                                           std::vector<size_t>* found,
+                                           double time_minimum,
+                                           double time_maximum) const {
+    found->clear();
+    build_index();
     read_lock_guard guard(_mutex);
 
-    // compute size of search area
-
-    auto& pos = bounding_verb->position;
-    auto direction = bounding_verb->direction;
-    wposition1 posA(pos, search_scale * bounding_verb->length, direction);
-    wposition1 posB(pos, search_scale * bounding_verb->width,
-                    direction + M_PI_2);
-    wposition1 posC(pos, search_scale * bounding_verb->length,
-                    direction + M_PI);
-    wposition1 posD(pos, search_scale * bounding_verb->width,
-                    direction + M_PI + M_PI_2);
-    bgm::polygon<point> search_area{{{posA.latitude(), posA.longitude()},
-                                     {posB.latitude(), posB.longitude()},
-                                     {posC.latitude(), posC.longitude()},
-                                     {posD.latitude(), posD.longitude()}}};
-
-    // find eigenverbs whose position is within this box
+    // compute size of search area, and the spherical cap around it
+
+    const geo_polygon area = search_area(bounding_verb, search_scale);
+    const auto& pos = bounding_verb.position;
+    const double angle =
+        search_scale * std::max(bounding_verb.length, bounding_verb.width) /
+        (wposition::earth_radius + pos.altitude());
+    const double latitude = pos.latitude();
+    const double longitude = wrap_longitude(pos.longitude());
+    const double dlat = to_degrees(angle) + 1e-9;
+    const double lat_minimum = std::max(-90.0, latitude - dlat);
+    const double lat_maximum = std::min(90.0, latitude + dlat);
+
+    // longitude range of the cap, split into two boxes if it crosses
+    // the anti-meridian, and all longitudes if it contains a pole
+
+    double dlng = 180.0;
+    if (lat_minimum > -90.0 && lat_maximum < 90.0) {
+        const double ratio = sin(angle) / cos(to_radians(latitude));
+        dlng = (ratio < 1.0) ? to_degrees(asin(ratio)) + 1e-9 : 180.0;
+    }
+    std::vector<std::pair<double, double>> lng_ranges;
+    if (dlng >= 180.0) {
+        lng_ranges.emplace_back(-180.0, 180.0);
+    } else if (longitude - dlng < -180.0) {
+        lng_ranges.emplace_back(longitude - dlng + 360.0, 180.0);
+        lng_ranges.emplace_back(-180.0, longitude + dlng);
+    } else if (longitude + dlng > 180.0) {
+        lng_ranges.emplace_back(longitude - dlng, 180.0);
+        lng_ranges.emplace_back(-180.0, longitude + dlng - 360.0);
+    } else {
+        lng_ranges.emplace_back(longitude - dlng, longitude + dlng);
+    }
 
-    std::list<eigenverb_collection::pair> pair_list;
-    _collection[interface].query(bgi::within(search_area),
-                                 std::back_inserter(pair_list));
+    // use the boxes as a coarse filter on position and travel time,
+    // then keep the eigenverbs that are inside the search area
 
-    // translate to output structure
+    auto keep = [&area, found](const eigenverb_collection::pair& value) {
+        const geo_point center(bg::get<1>(value.first),
+                               bg::get<0>(value.first));
+        if (bg::within(center, area)) {
+            found->push_back(value.second);
+        }
+    };
+    for (const auto& range : lng_ranges) {
+        const bgm::box<point> box(
+            point(lat_minimum, range.first, time_minimum),
+            point(lat_maximum, range.second, time_maximum));
+        _collection[interface].index.query(
+            bgi::intersects(box), boost::make_function_output_iterator(keep));
+    }
+}
 
+/**
+ * Finds all of the eigenverbs inside the search area around another
+ * eigenverb, and returns them as a new list.
+ */
+eigenverb_list eigenverb_collection::find_eigenverbs(
+    const eigenverb_model::csptr& bounding_verb, size_t interface) const {
+    std::vector<size_t> found;
+    find_eigenverbs(*bounding_verb, interface, &found);
     eigenverb_list list;
-    for (const auto& pair : pair_list) {
-        list.push_back(pair.second);
+    for (size_t index : found) {
+        list.push_back(eigenverb(interface, index));
     }
     return list;
 }
@@ -99,7 +253,8 @@ void eigenverb_collection::write_netcdf(const char* filename,
                                         size_t interface) const {
     netCDF::NcFile nc_file(filename, netCDF::NcFile::replace);
     eigenverb_list list = eigenverbs(interface);
-    size_t num_freq = list.begin()->get()->frequencies->size();
+    size_t num_freq =
+        list.empty() ? 0 : list.begin()->get()->frequencies->size();
 
     switch (interface) {
         case eigenverb_model::BOTTOM:
@@ -246,13 +401,13 @@ void eigenverb_collection::read_netcdf(const char* filename, size_t interface) {
 
     netCDF::NcDim eigenverb_dim = nc_file.getDim("eigenverbs");
     size_t num_eigenverbs = eigenverb_dim.getSize();
-    netCDF::NcDim freq_dim = nc_file.getDim("frequency");
+    netCDF::NcDim freq_dim = nc_file.getDim("frequencies");
     size_t num_freq = freq_dim.getSize();
 
     // variables
 
     netCDF::NcVar time_var = nc_file.getVar("travel_time");
-    netCDF::NcVar freq_var = nc_file.getVar("frequency");
+    netCDF::NcVar freq_var = nc_file.getVar("frequencies");
     netCDF::NcVar power_var = nc_file.getVar("power");
     netCDF::NcVar length_var = nc_file.getVar("length");
     netCDF::NcVar width_var = nc_file.getVar("width");
@@ -260,7 +415,7 @@ void eigenverb_collection::read_netcdf(const char* filename, size_t interface) {
     netCDF::NcVar lng_var = nc_file.getVar("longitude");
     netCDF::NcVar alt_var = nc_file.getVar("altitude");
     netCDF::NcVar direction_var = nc_file.getVar("direction");
-    netCDF::NcVar grazing_var = nc_file.getVar("grazing_angle");
+    netCDF::NcVar grazing_var = nc_file.getVar("grazing");
     netCDF::NcVar sound_speed_var = nc_file.getVar("sound_speed");
     netCDF::NcVar de_index_var = nc_file.getVar("de_index");
     netCDF::NcVar az_index_var = nc_file.getVar("az_index");
@@ -333,3 +488,32 @@ void eigenverb_collection::read_netcdf(const char* filename, size_t interface) {
     }
     delete[] power;
 }
+
+/**
+ * Writes the eigenverbs for all interfaces to a binary archive.
+ */
+void eigenverb_collection::write_archive(const char* filename) const {
+    archive_writer archive(filename, "eigenverbs");
+    archive.write_value("num_interfaces", (uint64_t)_collection.size());
+    for (size_t interface = 0; interface < _collection.size(); ++interface) {
+        _collection[interface].verbs.write_archive(
+            &archive, "interface" + std::to_string(interface) + "/");
+    }
+    archive.close();
+}
+
+/**
+ * Replaces the eigenverbs for all interfaces with the contents of a
+ * binary archive.
+ */
+void eigenverb_collection::read_archive(const char* filename) {
+    archive_reader archive(filename, "eigenverbs");
+    const auto num_interfaces = archive.value<uint64_t>("num_interfaces");
+    std::vector<interface_verbs> collection(num_interfaces);
+    for (size_t interface = 0; interface < num_interfaces; ++interface) {
+        collection[interface].verbs.read_archive(
+            archive, "interface" + std::to_string(interface) + "/");
+    }
+    _collection.swap(collection);
+    _indexed = false;
+}
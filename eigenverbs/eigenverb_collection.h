@@ -4,6 +4,7 @@
  */
 #pragma once
 
+#include <usml/eigenverbs/eigenverb_columns.h>
 #include <usml/eigenverbs/eigenverb_listener.h>
 #include <usml/eigenverbs/eigenverb_model.h>
 #include <usml/threads/read_write_lock.h>
@@ -20,7 +21,9 @@
 #include <boost/geometry/geometry.hpp>
 #pragma GCC diagnostic pop
 
+#include <atomic>
 #include <cstddef>
+#include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -51,6 +54,27 @@ namespace bgm = boost::geometry::model;
  *
  * In addition to structures for storing eigenverbs, it also includes the
  * algorithms for eigenverb searches and writing eigenverbs to disk.
+ *
+ * Eigenverbs for each interface are appended to an eigenverb_columns
+ * structure of arrays while the wavefront is propagated, instead of being
+ * stored as separate heap objects. This does not require locking, because
+ * each collection is only filled by the wave_queue that owns it. The
+ * geographic coordinates and travel time of each eigenverb are separate
+ * columns, so that the spatial index can be built without touching the
+ * rest of the eigenverbs.
+ *
+ * The spatial index for each interface is an rtree that is bulk loaded,
+ * using the sort-tile-recursive packing algorithm, when build_index() is
+ * called at the end of the propagation. Bulk loading is faster than
+ * inserting eigenverbs one at a time, and it creates a tree with fewer,
+ * fuller, nodes that is faster to search. Each node stores the position of
+ * an eigenverb in the flat arrays, instead of a reference to the eigenverb.
+ * The index has three dimensions: latitude, longitude, and travel time.
+ * This allows searches to reject eigenverbs outside of a window of travel
+ * times, without ever looking at them.
+ * If eigenverbs are added after the index is built, the index is rebuilt
+ * by the next call to find_eigenverbs(). Adding eigenverbs while other
+ * threads are searching the collection is not supported.
  */
 class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
    public:
@@ -59,7 +83,7 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
 
     /**
      * Scale factor for size of search area in find_eigenverbs(). Defaults to
-     * a 3.0 value.
+     * a 1.5 value.
      */
     static double search_scale;
 
@@ -84,7 +108,16 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
      * @param interface Interface number of the desired list of eigenverbs.
      */
     size_t size(size_t interface) const {
-        return _collection[interface].size();
+        return _collection[interface].verbs.size();
+    }
+
+    /**
+     * Columnar storage for the eigenverbs of a specific interface.
+     *
+     * @param interface Interface number of the desired list of eigenverbs.
+     */
+    const eigenverb_columns& columns(size_t interface) const {
+        return _collection[interface].verbs;
     }
 
     /**
@@ -95,20 +128,70 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
     eigenverb_list eigenverbs(size_t interface) const;
 
     /**
-     * Adds a new eigenverb to this collection.
+     * Upper limit on the duration of the biverbs that use these eigenverbs
+     * as receiver eigenverbs, over all interfaces. The overlap of two
+     * Gaussian eigenverbs is never longer, in the direction of the receiver
+     * eigenverb, than the receiver eigenverb itself. So the duration of each
+     * biverb is never larger than half the length of its receiver
+     * eigenverb, times the cosine of the grazing angle, divided by the
+     * sound speed.
+     *
+     * @return  Maximum biverb duration (sec), zero if there are no
+     *          eigenverbs.
+     */
+    double duration_maximum() const;
+
+    /**
+     * Adds a new eigenverb to this collection. Copies the eigenverb into the
+     * columns for this interface without locking. Marks the spatial index
+     * as out of date.
      *
      * @param verb      Eigenverb reference to add to the eigenverb_collection.
      * @param interface Interface number for this addition.
      */
-    void add_eigenverb(eigenverb_model::csptr verb, size_t interface);
+    void add_eigenverb(eigenverb_model::csptr verb, size_t interface) override;
+
+    /**
+     * Bulk loads the spatial index for each interface, if eigenverbs have
+     * been added since the last time the index was built. Called by the
+     * wavefront_generator when propagation is complete, so that the
+     * index is ready before the collection is shared with other threads.
+     */
+    void build_index() const;
 
     /**
-     * Finds all of the eigenverbs near another eigenverb. Computes a ploygonal
-     * search area that is roughly 3 times as big as the major and minor axes
-     * for the bounding_verb. Then uses an rtree search to find all the
-     * eigenverbs whose positions are inside that search area.
+     * Finds all of the eigenverbs near another eigenverb. The search area is
+     * a diamond around the bounding_verb, whose corners are search_scale
+     * times its length in front of and behind its center, and search_scale
+     * times its width to either side. The rtree search uses the latitude
+     * and longitude box around the spherical cap that contains this
+     * diamond, and the window of travel times, as a coarse filter. The box
+     * is split in two when it crosses the anti-meridian, and covers all
+     * longitudes when the cap contains a pole. Each eigenverb found by the
+     * rtree is then tested against the diamond itself, using great circle
+     * edges. Writes the position of each eigenverb found into a caller
+     * owned vector, which can be reused for many queries to avoid memory
+     * allocation. Callers use columns() or eigenverb() to retrieve the
+     * eigenverbs found.
      *
-     * @param bounding_verb		Eigenverb that defines bounding box.
+     * @param bounding_verb     Eigenverb that defines the search area.
+     * @param interface         Interface number for this query.
+     * @param found             Position of each eigenverb found in this
+     *                          interface. Cleared before the query.
+     * @param time_minimum      Earliest travel time of eigenverbs found (sec).
+     * @param time_maximum      Latest travel time of eigenverbs found (sec).
+     */
+    void find_eigenverbs(
+        const eigenverb_model& bounding_verb, size_t interface,
+        std::vector<size_t>* found,
+        double time_minimum = -std::numeric_limits<double>::max(),
+        double time_maximum = std::numeric_limits<double>::max()) const;
+
+    /**
+     * Finds all of the eigenverbs near another eigenverb, and returns them
+     * as a new list.
+     *
+     * @param bounding_verb		Eigenverb that defines the search area.
      * @param interface 		Interface number for this query.
      * @return          		List for eigenverbs that overlap this
      * area.
@@ -116,6 +199,29 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
     eigenverb_list find_eigenverbs(const eigenverb_model::csptr& bounding_verb,
                                    size_t interface) const;
 
+    /**
+     * Tests whether an eigenverb is inside the diamond shaped search area
+     * that find_eigenverbs() uses around another eigenverb.
+     *
+     * @param bounding_verb     Eigenverb that defines the search area.
+     * @param verb              Eigenverb to be tested.
+     * @return                  True if the center of verb is inside the
+     *                          search area.
+     */
+    static bool in_search_area(const eigenverb_model& bounding_verb,
+                               const eigenverb_model& verb);
+
+    /**
+     * Creates a new eigenverb_model from a single element of the collection.
+     *
+     * @param interface Interface number of the desired eigenverb.
+     * @param index     Position of the eigenverb in this interface, from
+     *                  0 to size(interface)-1, or from find_eigenverbs().
+     */
+    eigenverb_model::csptr eigenverb(size_t interface, size_t index) const {
+        return _collection[interface].verbs.eigenverb(index);
+    }
+
     /**
      * Writes the eigenverbs for an individual interface to a netcdf file. There
      * are separate variables for each eigenverb component, and each eigenverb
@@ -138,22 +244,61 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
      */
     void read_netcdf(const char* filename, size_t interface);
 
+    /**
+     * Writes the eigenverbs for all interfaces to a binary archive. Each
+     * column of the eigenverbs, for each interface, is written as a
+     * single contiguous array. This includes the latitude, longitude, and
+     * travel time columns that are used as the keys of the spatial index,
+     * so that the index can be bulk loaded from the archive without
+     * touching the rest of the eigenverbs. Archives are much faster to write and read
+     * than netCDF files, but they can only be read on hosts with the same
+     * byte order.
+     *
+     * @param filename      Name of the archive file.
+     */
+    void write_archive(const char* filename) const;
+
+    /**
+     * Replaces the eigenverbs for all interfaces with the contents of a
+     * binary archive created by write_archive(). Each column is copied
+     * with one bulk copy, without creating any eigenverb_model objects,
+     * and the index is bulk loaded from them by the next call to
+     * build_index() or find_eigenverbs().
+     *
+     * @param filename          Name of the archive file.
+     * @throws invalid_argument If the file is not an eigenverb archive,
+     *                          or if its columns have inconsistent sizes.
+     */
+    void read_archive(const char* filename);
+
    private:
-    /// Point in geographic coordinates, based on degrees.
-    typedef bgm::point<double, 2, bg::cs::spherical_equatorial<bg::degree>>
-        point;
+    /// Point in latitude, longitude, and travel time, treated as cartesian
+    /// coordinates. Longitudes are wrapped into the range [-180,180).
+    typedef bgm::point<double, 3, bg::cs::cartesian> point;
+
+    /// Position in the flat arrays paired with its geographic coordinate.
+    typedef std::pair<point, size_t> pair;
 
-    /// Eigenverb paired with its geographic coordinate.
-    typedef std::pair<point, eigenverb_model::csptr> pair;
+    /// Spatial index for eigenverbs in geographic coordinates and time.
+    typedef bgi::rtree<pair, bgi::rstar<16>> rtree;
 
-    /// Spatial index for eigenverbs in geographic coordinates.
-    typedef bgi::rtree<pair, bgi::rstar<8>> rtree;
+    /// Columns of eigenverbs, and spatial index, for one interface.
+    struct interface_verbs {
+        /// Eigenverbs in the order that they were added.
+        eigenverb_columns verbs;
 
-    /// Mutex to that locks object during changes.
+        /// Spatial index, bulk loaded by build_index().
+        rtree index;
+    };
+
+    /// Mutex to that locks object while the spatial index is built.
     mutable read_write_lock _mutex;
 
-    /// Spatial index for each interface.
-    std::vector<rtree> _collection;
+    /// True if spatial index is up to date with eigenverbs.
+    mutable std::atomic<bool> _indexed{true};
+
+    /// Eigenverbs and spatial index for each interface.
+    mutable std::vector<interface_verbs> _collection;
 };
 
 /// @}
@@ -0,0 +1,176 @@
+/**
+ * @file eigenverb_columns.cc
+ * Columnar storage for the eigenverbs of a single interface.
+ */
+
+#include <usml/eigenverbs/eigenverb_columns.h>
+#include <usml/types/seq_data.h>
+
+#include <algorithm>
+#include <boost/numeric/ublas/vector.hpp>
+#include <stdexcept>
+#include <string>
+
+using namespace usml::eigenverbs;
+
+/**
+ * Appends a single eigenverb to the end of this list.
+ */
+void eigenverb_columns::push_back(const eigenverb_model& verb) {
+    if (frequencies == nullptr) {
+        frequencies = verb.frequencies;
+    }
+    travel_time.push_back(verb.travel_time);
+    const size_t num_freq = num_frequencies();
+    const size_t row = power_data.size();
+    power_data.resize(row + num_freq, 0.0);
+    std::copy_n(verb.power.begin(), std::min(num_freq, verb.power.size()),
+                power_data.begin() + row);
+    length.push_back(verb.length);
+    width.push_back(verb.width);
+    latitude.push_back(verb.position.latitude());
+    longitude.push_back(verb.position.longitude());
+    altitude.push_back(verb.position.altitude());
+    direction.push_back(verb.direction);
+    grazing.push_back(verb.grazing);
+    sound_speed.push_back(verb.sound_speed);
+    de_index.push_back(verb.de_index);
+    az_index.push_back(verb.az_index);
+    source_de.push_back(verb.source_de);
+    source_az.push_back(verb.source_az);
+    paths.insert(paths.end(), {verb.surface, verb.bottom, verb.caustic,
+                               verb.upper, verb.lower});
+}
+
+/**
+ * Creates a new eigenverb_model from a single element of this list.
+ */
+eigenverb_model::csptr eigenverb_columns::eigenverb(size_t index) const {
+    auto* verb = new eigenverb_model();
+    eigenverb(index, verb);
+    return eigenverb_model::csptr(verb);
+}
+
+/**
+ * Copies a single element of this list into an existing eigenverb_model.
+ */
+void eigenverb_columns::eigenverb(size_t index, eigenverb_model* verb) const {
+    const size_t num_freq = num_frequencies();
+    verb->travel_time = travel_time[index];
+    verb->frequencies = frequencies;
+    if (verb->power.size() != num_freq) {
+        verb->power.resize(num_freq, false);
+    }
+    std::copy_n(power(index), num_freq, verb->power.begin());
+    verb->length = length[index];
+    verb->width = width[index];
+    verb->position.latitude(latitude[index]);
+    verb->position.longitude(longitude[index]);
+    verb->position.altitude(altitude[index]);
+    verb->direction = direction[index];
+    verb->grazing = grazing[index];
+    verb->sound_speed = sound_speed[index];
+    verb->de_index = de_index[index];
+    verb->az_index = az_index[index];
+    verb->source_de = source_de[index];
+    verb->source_az = source_az[index];
+    const int* counts = &paths[index * num_paths];
+    verb->surface = counts[0];
+    verb->bottom = counts[1];
+    verb->caustic = counts[2];
+    verb->upper = counts[3];
+    verb->lower = counts[4];
+}
+
+/**
+ * Removes all eigenverbs from this list.
+ */
+void eigenverb_columns::clear() {
+    frequencies = nullptr;
+    travel_time.clear();
+    power_data.clear();
+    length.clear();
+    width.clear();
+    latitude.clear();
+    longitude.clear();
+    altitude.clear();
+    direction.clear();
+    grazing.clear();
+    sound_speed.clear();
+    de_index.clear();
+    az_index.clear();
+    source_de.clear();
+    source_az.clear();
+    paths.clear();
+}
+
+/**
+ * Writes every column to an archive.
+ */
+void eigenverb_columns::write_archive(archive_writer* archive,
+                                      const std::string& prefix) const {
+    std::vector<double> freq;
+    if (frequencies != nullptr) {
+        const auto data = frequencies->data();
+        freq.assign(data.begin(), data.end());
+    }
+    archive->write(prefix + "frequencies", freq);
+    archive->write(prefix + "latitude", latitude);
+    archive->write(prefix + "longitude", longitude);
+    archive->write(prefix + "travel_time", travel_time);
+    archive->write(prefix + "power", power_data);
+    archive->write(prefix + "length", length);
+    archive->write(prefix + "width", width);
+    archive->write(prefix + "altitude", altitude);
+    archive->write(prefix + "direction", direction);
+    archive->write(prefix + "grazing", grazing);
+    archive->write(prefix + "sound_speed", sound_speed);
+    archive->write(prefix + "source_de", source_de);
+    archive->write(prefix + "source_az", source_az);
+    archive->write(prefix + "de_index", de_index);
+    archive->write(prefix + "az_index", az_index);
+    archive->write(prefix + "paths", paths);
+}
+
+/**
+ * Replaces every column with the ones read from an archive.
+ */
+void eigenverb_columns::read_archive(const archive_reader& archive,
+                                     const std::string& prefix) {
+    size_t num_freq;
+    const double* freq =
+        archive.data<double>(prefix + "frequencies", &num_freq);
+    frequencies = nullptr;
+    if (num_freq > 0) {
+        frequencies.reset(new seq_data(freq, num_freq));
+    }
+    archive.read(prefix + "latitude", &latitude);
+    archive.read(prefix + "longitude", &longitude);
+    archive.read(prefix + "travel_time", &travel_time);
+    archive.read(prefix + "power", &power_data);
+    archive.read(prefix + "length", &length);
+    archive.read(prefix + "width", &width);
+    archive.read(prefix + "altitude", &altitude);
+    archive.read(prefix + "direction", &direction);
+    archive.read(prefix + "grazing", &grazing);
+    archive.read(prefix + "sound_speed", &sound_speed);
+    archive.read(prefix + "source_de", &source_de);
+    archive.read(prefix + "source_az", &source_az);
+    archive.read(prefix + "de_index", &de_index);
+    archive.read(prefix + "az_index", &az_index);
+    archive.read(prefix + "paths", &paths);
+
+    const size_t num_verbs = travel_time.size();
+    const bool valid =
+        power_data.size() == num_verbs * num_freq &&
+        latitude.size() == num_verbs && longitude.size() == num_verbs &&
+        length.size() == num_verbs && width.size() == num_verbs &&
+        altitude.size() == num_verbs && direction.size() == num_verbs &&
+        grazing.size() == num_verbs && sound_speed.size() == num_verbs &&
+        source_de.size() == num_verbs && source_az.size() == num_verbs &&
+        de_index.size() == num_verbs && az_index.size() == num_verbs &&
+        paths.size() == num_verbs * num_paths;
+    if (!valid) {
+        throw std::invalid_argument("inconsistent eigenverb columns");
+    }
+}
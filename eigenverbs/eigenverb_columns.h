@@ -0,0 +1,173 @@
+/**
+ * @file eigenverb_columns.h
+ * Columnar storage for the eigenverbs of a single interface.
+ */
+#pragma once
+
+#include <usml/eigenverbs/eigenverb_model.h>
+#include <usml/types/archive.h>
+#include <usml/types/seq_vector.h>
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace usml {
+namespace eigenverbs {
+
+using namespace usml::types;
+
+/// @ingroup eigenverbs
+/// @{
+
+/**
+ * Columnar storage for the eigenverbs of a single interface. Each attribute
+ * of eigenverb_model is stored in its own contiguous array, and the power of
+ * all eigenverbs is stored in a single row major matrix, with one row per
+ * eigenverb and one column per frequency. This avoids the heap allocation of
+ * an eigenverb_model, a shared pointer control block, and a power vector for
+ * each eigenverb. It also lets the spatial index, and batched calculations
+ * like biverb_overlap, read the attributes they need without touching the
+ * rest of each eigenverb.
+ *
+ * Eigenverbs are stored in the order that they are added, and retrieved by
+ * their position in the list, from 0 to size()-1. All eigenverbs in a list
+ * must use the same frequencies. The eigenverb() methods convert a single
+ * element back into an eigenverb_model, for code that needs the old
+ * interface.
+ */
+class USML_DECLSPEC eigenverb_columns {
+   public:
+    /// Number of path counts stored for each eigenverb.
+    static constexpr size_t num_paths = 5;
+
+    /**
+     * Number of eigenverbs in this list.
+     */
+    size_t size() const { return travel_time.size(); }
+
+    /**
+     * True if this list has no eigenverbs.
+     */
+    bool empty() const { return travel_time.empty(); }
+
+    /**
+     * Number of frequencies in each row of the power matrix.
+     */
+    size_t num_frequencies() const {
+        return (frequencies == nullptr) ? 0 : frequencies->size();
+    }
+
+    /**
+     * Pointer to the power of a single eigenverb, one value per frequency.
+     *
+     * @param index     Position of the eigenverb in this list.
+     */
+    const double* power(size_t index) const {
+        return &power_data[index * num_frequencies()];
+    }
+
+    /**
+     * Appends a single eigenverb to the end of this list. Power values
+     * missing from the eigenverb are set to zero.
+     *
+     * @param verb      Eigenverb to be appended.
+     */
+    void push_back(const eigenverb_model& verb);
+
+    /**
+     * Creates a new eigenverb_model from a single element of this list.
+     *
+     * @param index     Position of the eigenverb in this list.
+     */
+    eigenverb_model::csptr eigenverb(size_t index) const;
+
+    /**
+     * Copies a single element of this list into an existing eigenverb_model.
+     * Reuses the power vector of the model when it is already the right
+     * size, so that loops over many eigenverbs do not allocate memory.
+     *
+     * @param index     Position of the eigenverb in this list.
+     * @param verb      Eigenverb that receives the copy (output).
+     */
+    void eigenverb(size_t index, eigenverb_model* verb) const;
+
+    /**
+     * Removes all eigenverbs from this list.
+     */
+    void clear();
+
+    /**
+     * Writes every column to an archive, including the frequencies.
+     *
+     * @param archive   Archive that receives the columns.
+     * @param prefix    Prefix added to the name of each column.
+     */
+    void write_archive(archive_writer* archive,
+                       const std::string& prefix = "") const;
+
+    /**
+     * Replaces every column with the ones read from an archive, using one
+     * bulk copy per column.
+     *
+     * @param archive   Archive that contains the columns.
+     * @param prefix    Prefix added to the name of each column.
+     * @throws invalid_argument If the columns have inconsistent sizes.
+     */
+    void read_archive(const archive_reader& archive,
+                      const std::string& prefix = "");
+
+    /// Frequencies of the wavefront (Hz), shared by all eigenverbs.
+    seq_vector::csptr frequencies;
+
+    /// One way travel time for each eigenverb (sec).
+    std::vector<double> travel_time;
+
+    /// Power for each eigenverb and frequency, row major (linear units).
+    std::vector<double> power_data;
+
+    /// Length of the D/E projection of each Gaussian beam (meters).
+    std::vector<double> length;
+
+    /// Width of the AZ projection of each Gaussian beam (meters).
+    std::vector<double> width;
+
+    /// Latitude of each impact with the interface (degrees_north).
+    std::vector<double> latitude;
+
+    /// Longitude of each impact with the interface (degrees_east).
+    std::vector<double> longitude;
+
+    /// Altitude of each impact with the interface (meters).
+    std::vector<double> altitude;
+
+    /// Compass heading of the length axis (radians, clockwise from north).
+    std::vector<double> direction;
+
+    /// Grazing angle at each impact (radians, positive is up).
+    std::vector<double> grazing;
+
+    /// Sound speed at each impact (m/s).
+    std::vector<double> sound_speed;
+
+    /// Index number of the source DE angle.
+    std::vector<size_t> de_index;
+
+    /// Index number of the source AZ angle.
+    std::vector<size_t> az_index;
+
+    /// Launch DE angle at the source (radians, positive is up).
+    std::vector<double> source_de;
+
+    /// Launch AZ angle at the source (radians, clockwise from true north).
+    std::vector<double> source_az;
+
+    /// Number of surface, bottom, caustic, upper, and lower vertices along
+    /// each path, five values per eigenverb.
+    std::vector<int> paths;
+};
+
+/// @}
+}  // end of namespace eigenverbs
+}  // end of namespace usml
@@ -6,8 +6,13 @@
 
 #include <boost/geometry/geometry.hpp>
 #include <boost/test/unit_test.hpp>
+#include <boost/timer/timer.hpp>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(eigenverbs_test)
 
@@ -119,6 +124,272 @@ BOOST_AUTO_TEST_CASE(create_eigenverbs) {
                    collection.size(eigenverb_model::BOTTOM));
 }
 
+/**
+ * Tests the bulk loaded spatial index in eigenverb_collection, using a
+ * dense fan of eigenverbs at 2 deg spacing in DE and AZ. Adds the same
+ * eigenverbs to two collections in opposite orders, and times the
+ * construction of the spatial index and a search around every eigenverb.
+ *
+ * This test passes if:
+ *   - both collections find the same eigenverbs, independent of the order
+ *     in which they were added,
+ *   - a search limited to a window of travel times finds the same eigenverbs
+ *     as a full search whose results are filtered by travel time, and
+ *   - an eigenverb added after the index is built is found by the next
+ *     search, because the index is rebuilt.
+ */
+BOOST_AUTO_TEST_CASE(eigenverb_index) {
+    cout << "=== eigenverbs_test: eigenverb_index ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    wposition1 source_pos(36.0, 16.0, 0.0);
+    double depth = 1000;
+
+    std::vector<eigenverb_model::csptr> verbs;
+    for (double az = 0.0; az < 360.0; az += 2.0) {
+        for (double de = -89.0; de <= -5.0; de += 2.0) {
+            verbs.push_back(
+                create_eigenverb(source_pos, depth, de, az, frequencies));
+        }
+    }
+    cout << "number of eigenverbs: " << verbs.size() << endl;
+
+    eigenverb_collection forward(0);
+    eigenverb_collection reverse(0);
+    {
+        boost::timer::auto_cpu_timer timer("add and index: %w secs\n");
+        for (const auto& verb : verbs) {
+            forward.add_eigenverb(verb, eigenverb_model::BOTTOM);
+        }
+        forward.build_index();
+    }
+    for (auto iter = verbs.rbegin(); iter != verbs.rend(); ++iter) {
+        reverse.add_eigenverb(*iter, eigenverb_model::BOTTOM);
+    }
+    BOOST_CHECK_EQUAL(forward.size(eigenverb_model::BOTTOM), verbs.size());
+
+    // search around every eigenverb in both collections
+
+    size_t total = 0;
+    size_t mismatch = 0;
+    {
+        boost::timer::auto_cpu_timer timer("find_eigenverbs: %w secs\n");
+        for (const auto& verb : verbs) {
+            eigenverb_list list1 =
+                forward.find_eigenverbs(verb, eigenverb_model::BOTTOM);
+            eigenverb_list list2 =
+                reverse.find_eigenverbs(verb, eigenverb_model::BOTTOM);
+            std::set<std::pair<double, double>> set1;
+            std::set<std::pair<double, double>> set2;
+            for (const auto& found : list1) {
+                set1.emplace(found->source_de, found->source_az);
+            }
+            for (const auto& found : list2) {
+                set2.emplace(found->source_de, found->source_az);
+            }
+            total += set1.size();
+            if (set1 != set2) {
+                ++mismatch;
+            }
+        }
+    }
+    cout << "average number found: " << (double)total / verbs.size() << endl;
+    BOOST_CHECK_GT(total, verbs.size());
+    BOOST_CHECK_EQUAL(mismatch, 0);
+
+    // search limited to a window of travel times
+
+    const double time_minimum = 0.8;
+    const double time_maximum = 1.2;
+    std::vector<size_t> windowed;
+    std::vector<size_t> filtered;
+    mismatch = 0;
+    for (const auto& verb : verbs) {
+        forward.find_eigenverbs(*verb, eigenverb_model::BOTTOM, &windowed,
+                                time_minimum, time_maximum);
+        forward.find_eigenverbs(*verb, eigenverb_model::BOTTOM, &filtered);
+        auto outside = [&](size_t index) {
+            double time =
+                forward.eigenverb(eigenverb_model::BOTTOM, index)->travel_time;
+            return time < time_minimum || time > time_maximum;
+        };
+        filtered.erase(
+            std::remove_if(filtered.begin(), filtered.end(), outside),
+            filtered.end());
+        std::sort(windowed.begin(), windowed.end());
+        std::sort(filtered.begin(), filtered.end());
+        if (windowed != filtered) {
+            ++mismatch;
+        }
+    }
+    BOOST_CHECK_EQUAL(mismatch, 0);
+
+    // eigenverbs added after the index is built are found
+
+    eigenverb_model::csptr extra =
+        create_eigenverb(source_pos, depth, -40.5, 30.5, frequencies);
+    eigenverb_list before =
+        forward.find_eigenverbs(extra, eigenverb_model::BOTTOM);
+    forward.add_eigenverb(extra, eigenverb_model::BOTTOM);
+    eigenverb_list after =
+        forward.find_eigenverbs(extra, eigenverb_model::BOTTOM);
+    BOOST_CHECK_EQUAL(after.size(), before.size() + 1);
+    BOOST_CHECK(std::find_if(after.begin(), after.end(),
+                             [&](const eigenverb_model::csptr& found) {
+                                 return found->source_de == extra->source_de &&
+                                        found->source_az == extra->source_az;
+                             }) != after.end());
+}
+
+/**
+ * Tests the search area used by find_eigenverbs() for fans of eigenverbs
+ * that cross the anti-meridian, and that surround the north pole. Compares
+ * the results of each search to a brute force test of every eigenverb in
+ * the collection against the same diamond shaped search area.
+ *
+ * This test passes if find_eigenverbs() finds exactly the eigenverbs that
+ * in_search_area() accepts, for every eigenverb in each fan.
+ */
+BOOST_AUTO_TEST_CASE(eigenverb_search_area) {
+    cout << "=== eigenverbs_test: eigenverb_search_area ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    const double depth = 1000;
+    const wposition1 centers[] = {wposition1(36.0, 16.0, 0.0),
+                                  wposition1(36.0, 179.99, 0.0),
+                                  wposition1(-36.0, -179.99, 0.0),
+                                  wposition1(89.99, 45.0, 0.0)};
+    for (const auto& source_pos : centers) {
+        eigenverb_collection collection(0);
+        std::vector<eigenverb_model::csptr> verbs;
+        for (double az = 0.0; az < 360.0; az += az_spacing) {
+            for (double de = -90.0 + de_spacing; de < 0.0; de += de_spacing) {
+                verbs.push_back(
+                    create_eigenverb(source_pos, depth, de, az, frequencies));
+                collection.add_eigenverb(verbs.back(),
+                                         eigenverb_model::BOTTOM);
+            }
+        }
+        size_t total = 0;
+        size_t mismatch = 0;
+        std::vector<size_t> found;
+        for (const auto& verb : verbs) {
+            collection.find_eigenverbs(*verb, eigenverb_model::BOTTOM, &found);
+            std::sort(found.begin(), found.end());
+            std::vector<size_t> expected;
+            for (size_t n = 0; n < verbs.size(); ++n) {
+                if (eigenverb_collection::in_search_area(*verb, *verbs[n])) {
+                    expected.push_back(n);
+                }
+            }
+            total += found.size();
+            if (found != expected) {
+                ++mismatch;
+            }
+        }
+        cout << "center=(" << source_pos.latitude() << ","
+             << source_pos.longitude() << ") found=" << total << endl;
+        BOOST_CHECK_GT(total, 0);
+        BOOST_CHECK_EQUAL(mismatch, 0);
+    }
+}
+
+/**
+ * Writes eigenverbs for the bottom and surface interfaces to a binary
+ * archive and reads them into a new collection. Times the archive and
+ * netCDF versions of the same bottom eigenverbs.
+ *
+ * This test passes if:
+ *   - each interface has the same number of eigenverbs after it is read,
+ *   - every column of every eigenverb is restored, without creating an
+ *     eigenverb_model for each one, and
+ *   - spatial searches around every bottom eigenverb find the same
+ *     eigenverbs in the original and restored collections.
+ */
+BOOST_AUTO_TEST_CASE(eigenverb_archive) {
+    cout << "=== eigenverbs_test: eigenverb_archive ===" << endl;
+    const char* filename =
+        USML_TEST_DIR "/eigenverbs/test/eigenverb_archive.arc";
+    const char* ncname = USML_TEST_DIR "/eigenverbs/test/eigenverb_archive.nc";
+    seq_vector::csptr frequencies(new seq_linear(1000.0, 1000.0, 3));
+    wposition1 source_pos(36.0, 16.0, 0.0);
+    double depth = 1000;
+
+    eigenverb_collection collection(0);
+    for (double az = 0.0; az < 360.0; az += 5.0) {
+        for (double de = -89.0; de <= -5.0; de += 4.0) {
+            collection.add_eigenverb(
+                create_eigenverb(source_pos, depth, de, az, frequencies),
+                eigenverb_model::BOTTOM);
+        }
+    }
+    for (double az = 0.0; az < 360.0; az += 30.0) {
+        collection.add_eigenverb(
+            create_eigenverb(source_pos, 10.0, -45.0, az, frequencies),
+            eigenverb_model::SURFACE);
+    }
+    {
+        boost::timer::auto_cpu_timer timer("write_archive: %w secs\n");
+        collection.write_archive(filename);
+    }
+    {
+        boost::timer::auto_cpu_timer timer("write_netcdf: %w secs\n");
+        collection.write_netcdf(ncname, eigenverb_model::BOTTOM);
+    }
+
+    eigenverb_collection copy(0);
+    {
+        boost::timer::auto_cpu_timer timer("read_archive: %w secs\n");
+        copy.read_archive(filename);
+    }
+    BOOST_REQUIRE_EQUAL(copy.num_interfaces(), collection.num_interfaces());
+    for (size_t interface = 0; interface < copy.num_interfaces();
+         ++interface) {
+        BOOST_REQUIRE_EQUAL(copy.size(interface), collection.size(interface));
+        const eigenverb_columns& columns = copy.columns(interface);
+        eigenverb_model verb;
+        for (size_t n = 0; n < copy.size(interface); ++n) {
+            columns.eigenverb(n, &verb);
+            const eigenverb_model::csptr orig =
+                collection.eigenverb(interface, n);
+            BOOST_CHECK_EQUAL(columns.power(n)[1], orig->power(1));
+            BOOST_CHECK_EQUAL(verb.travel_time, orig->travel_time);
+            BOOST_CHECK_EQUAL(verb.frequencies->size(), 3);
+            BOOST_CHECK_EQUAL(verb.power(2), orig->power(2));
+            BOOST_CHECK_EQUAL(verb.length, orig->length);
+            BOOST_CHECK_EQUAL(verb.width, orig->width);
+            BOOST_CHECK_CLOSE(verb.position.latitude(),
+                              orig->position.latitude(), 1e-10);
+            BOOST_CHECK_CLOSE(verb.position.longitude(),
+                              orig->position.longitude(), 1e-10);
+            BOOST_CHECK_CLOSE(verb.position.altitude(),
+                              orig->position.altitude(), 1e-6);
+            BOOST_CHECK_EQUAL(verb.direction, orig->direction);
+            BOOST_CHECK_EQUAL(verb.grazing, orig->grazing);
+            BOOST_CHECK_EQUAL(verb.de_index, orig->de_index);
+            BOOST_CHECK_EQUAL(verb.az_index, orig->az_index);
+            BOOST_CHECK_EQUAL(verb.source_az, orig->source_az);
+            BOOST_CHECK_EQUAL(verb.sound_speed, orig->sound_speed);
+            BOOST_CHECK_EQUAL(verb.bottom, orig->bottom);
+        }
+    }
+
+    // spatial index finds the same eigenverbs
+
+    size_t mismatch = 0;
+    std::vector<size_t> found1;
+    std::vector<size_t> found2;
+    for (size_t n = 0; n < copy.size(eigenverb_model::BOTTOM); ++n) {
+        const auto& verb = collection.eigenverb(eigenverb_model::BOTTOM, n);
+        collection.find_eigenverbs(*verb, eigenverb_model::BOTTOM, &found1);
+        copy.find_eigenverbs(*verb, eigenverb_model::BOTTOM, &found2);
+        std::sort(found1.begin(), found1.end());
+        std::sort(found2.begin(), found2.end());
+        if (found1 != found2) {
+            ++mismatch;
+        }
+    }
+    BOOST_CHECK_EQUAL(mismatch, 0);
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -207,6 +207,18 @@ class USML_DECLSPEC boundary_model : public reflect_loss_model,
                                 amplitude);
     }
 
+    /**
+     * Computes an upper limit on the scattering strength, at each frequency,
+     * over all locations and scattering angles.
+     *
+     * @param frequencies   Frequencies over which to compute the limit. (Hz)
+     * @param amplitude     Upper limit on scattering strength ratio (output).
+     */
+    void max_scattering(const seq_vector::csptr& frequencies,
+                        vector<double>* amplitude) const override {
+        _scattering->max_scattering(frequencies, amplitude);
+    }
+
    private:
     /// Reference to the reflection loss model.
     reflect_loss_model::csptr _reflect_loss;
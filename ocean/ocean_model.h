@@ -109,6 +109,30 @@ class USML_DECLSPEC ocean_model {
         }
     }
 
+    /**
+     * Computes an upper limit on the scattering strength for a specific
+     * interface, at each frequency, over all locations and scattering angles.
+     *
+     * @param interface 	Interface number of scattering ocean component
+     * @param frequencies   Frequencies over which to compute the limit. (Hz)
+     * @param amplitude     Upper limit on scattering strength ratio (output).
+     */
+    void max_scattering(size_t interface, const seq_vector::csptr& frequencies,
+                        vector<double>* amplitude) const {
+        switch (interface) {
+            case 0:  // bottom
+                _bottom->max_scattering(frequencies, amplitude);
+                break;
+            case 1:  // surface
+                _surface->max_scattering(frequencies, amplitude);
+                break;
+            default:  // volume
+                auto layer = (size_t)floor(((double)interface - 2.0) / 2.0);
+                _volume.at(layer)->max_scattering(frequencies, amplitude);
+                break;
+        }
+    }
+
    private:
     /** Model of the ocean surface. */
     boundary_model::csptr _surface;
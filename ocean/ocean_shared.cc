@@ -11,23 +11,38 @@ using namespace usml::ocean;
 /** Shared reference to the current ocean. */
 ocean_model::csptr ocean_shared::_current = nullptr;
 
+/** Version number of the current ocean. */
+uint64_t ocean_shared::_version = 0;
+
 /** Locks singleton while ocean is being changed. */
 read_write_lock ocean_shared::_mutex;
 
 /**
  * Pass a shared reference of current ocean back to client.
  */
-ocean_model::csptr ocean_shared::current() {
+ocean_model::csptr ocean_shared::current(uint64_t* version) {
     read_lock_guard guard(ocean_shared::_mutex);
+    if (version != nullptr) {
+        *version = _version;
+    }
     return _current;
 }
 
+/**
+ * Version number of the current ocean.
+ */
+uint64_t ocean_shared::version() {
+    read_lock_guard guard(ocean_shared::_mutex);
+    return _version;
+}
+
 /**
  * Update shared ocean with new data.
  */
 void ocean_shared::update(const ocean_model::csptr& ocean) {
     write_lock_guard guard(ocean_shared::_mutex);
     _current = ocean;
+    ++_version;
 }
 
 /**
@@ -36,4 +51,5 @@ void ocean_shared::update(const ocean_model::csptr& ocean) {
 void ocean_shared::reset() {
     write_lock_guard guard(ocean_shared::_mutex);
     _current.reset();
+    ++_version;
 }
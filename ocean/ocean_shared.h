@@ -7,6 +7,8 @@
 #include <usml/ocean/ocean_model.h>
 #include <usml/threads/threads.h>
 
+#include <cstdint>
+
 namespace usml {
 namespace ocean {
 
@@ -35,8 +37,18 @@ class USML_DECLSPEC ocean_shared {
      * Pass a shared reference of current ocean back to the client.
      * Returns a null reference if ocean has not yet been
      * defined using update().
+     *
+     * @param version   Version number of the ocean that is returned
+     *                  (output), not returned if this is nullptr.
+     */
+    static ocean_model::csptr current(uint64_t* version = nullptr);
+
+    /**
+     * Version number of the current ocean. Incremented each time that the
+     * ocean is changed by update() or reset(), so that clients can detect
+     * results that were computed with an earlier ocean.
      */
-    static ocean_model::csptr current();
+    static uint64_t version();
 
     /**
      * Update shared ocean singleton with new data.
@@ -57,6 +69,9 @@ class USML_DECLSPEC ocean_shared {
      */
     static ocean_model::csptr _current;
 
+    /** Version number of the current ocean, never decreases. */
+    static uint64_t _version;
+
     /** Locks singleton while ocean is being changed. */
     static read_write_lock _mutex;
 
@@ -110,6 +110,23 @@ class USML_DECLSPEC scattering_chapman : public scattering_model {
         }
     }
 
+    /**
+     * Computes an upper limit on the scattering strength. Scattering
+     * strength increases with grazing angle, because beta is positive, and
+     * the average of the incident and scattered grazing angles is never
+     * larger than 90 degrees. So the limit is the scattering strength at
+     * normal incidence.
+     *
+     * @param frequencies   Frequencies over which to compute the limit. (Hz)
+     * @param amplitude     Upper limit on scattering strength ratio (output).
+     */
+    void max_scattering(const seq_vector::csptr& frequencies,
+                        vector<double>* amplitude) const override {
+        const double normal = M_PI_2;
+        scattering(wposition1(), frequencies, normal, normal, 0.0, 0.0,
+                   amplitude);
+    }
+
    private:
     /// Wind speed (m/s).
     const double _wind_speed;
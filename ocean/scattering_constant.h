@@ -79,6 +79,19 @@ class USML_DECLSPEC scattering_constant : public scattering_model {
         // fast assignment of scalar to matrix of vectors
     }
 
+    /**
+     * Computes an upper limit on the scattering strength, which is the
+     * same constant as the scattering strength.
+     *
+     * @param frequencies   Frequencies over which to compute the limit. (Hz)
+     * @param amplitude     Upper limit on scattering strength ratio (output).
+     */
+    void max_scattering(const seq_vector::csptr& frequencies,
+                        vector<double>* amplitude) const override {
+        noalias(*amplitude) =
+            scalar_vector<double>(frequencies->size(), _amplitude);
+    }
+
    private:
     /** Holds the reverberation scattering strength ratio. */
     double _amplitude;
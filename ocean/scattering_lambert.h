@@ -102,6 +102,20 @@ class USML_DECLSPEC scattering_lambert : public scattering_model {
         }
     }
 
+    /**
+     * Computes an upper limit on the scattering strength. The product of
+     * the sines of the incident and scattered angles is never larger than
+     * one, so the limit is the magnitude of the Mackenzie coefficient.
+     *
+     * @param frequencies   Frequencies over which to compute the limit. (Hz)
+     * @param amplitude     Upper limit on scattering strength ratio (output).
+     */
+    void max_scattering(const seq_vector::csptr& frequencies,
+                        vector<double>* amplitude) const override {
+        noalias(*amplitude) =
+            scalar_vector<double>(frequencies->size(), abs(_coeff));
+    }
+
    private:
     /**
      * Bottom scattering strength coefficient in linear units.
@@ -7,6 +7,8 @@
 #include <usml/types/types.h>
 #include <usml/ublas/ublas.h>
 
+#include <limits>
+
 namespace usml {
 namespace ocean {
 
@@ -98,6 +100,22 @@ class USML_DECLSPEC scattering_model {
                             double az_incident, matrix<double> az_scattered,
                             matrix<vector<double> >* amplitude) const = 0;
 
+    /**
+     * Computes an upper limit on the scattering strength, at each frequency,
+     * over all locations and scattering angles. Used to reject pairs of
+     * eigenverbs that can not create a biverb above the power threshold,
+     * before the scattering strength is computed. The default
+     * implementation returns infinity, which never rejects any pairs.
+     *
+     * @param frequencies   Frequencies over which to compute the limit. (Hz)
+     * @param amplitude     Upper limit on scattering strength ratio (output).
+     */
+    virtual void max_scattering(const seq_vector::csptr& frequencies,
+                                vector<double>* amplitude) const {
+        noalias(*amplitude) = scalar_vector<double>(
+            frequencies->size(), std::numeric_limits<double>::infinity());
+    }
+
     /**
      * Virtual destructor
      */
@@ -470,6 +470,52 @@ BOOST_AUTO_TEST_CASE(scattering_chapman_test) {
     }
 }
 
+/**
+ * Tests the upper limits on scattering strength used to reject pairs of
+ * eigenverbs. Computes the Lambert and Chapman/Harris scattering strengths
+ * for every combination of incident and scattered grazing angle, at 1 deg
+ * spacing, and the constant scattering strength of a volume layer in an
+ * ocean_model. Generates errors if any scattering strength is larger than
+ * the result of max_scattering(), or if the limit is more than 1e-6
+ * percent larger than the scattering strength at normal incidence.
+ */
+BOOST_AUTO_TEST_CASE(max_scattering_test) {
+    cout << "=== boundary_test: max_scattering_test ===" << endl;
+    const wposition1 pos;
+    seq_vector::csptr freq(new seq_log(600.0, 2.0, 4));
+    vector<double> amplitude(freq->size());
+    vector<double> limit(freq->size());
+
+    const scattering_lambert lambert;
+    const scattering_chapman chapman(10.0);
+    for (const scattering_model* model :
+         {(const scattering_model*)&lambert,
+          (const scattering_model*)&chapman}) {
+        model->max_scattering(freq, &limit);
+        for (int i = 1; i <= 90; ++i) {
+            for (int s = 1; s <= 90; ++s) {
+                model->scattering(pos, freq, to_radians(i), to_radians(s),
+                                  0.0, 0.0, &amplitude);
+                for (size_t f = 0; f < freq->size(); ++f) {
+                    BOOST_CHECK_LE(amplitude(f), limit(f));
+                }
+            }
+        }
+        for (size_t f = 0; f < freq->size(); ++f) {
+            BOOST_CHECK_CLOSE(amplitude(f), limit(f), 1e-6);
+        }
+    }
+
+    boundary_model::csptr surface(new boundary_flat());
+    boundary_model::csptr bottom(new boundary_flat(2000.0));
+    profile_model::csptr profile(new profile_linear());
+    ocean_model ocean1(surface, bottom, profile);
+    volume_model::csptr volume(new volume_flat(1000.0, 10.0, -30.0));
+    ocean1.add_volume(volume);
+    ocean1.max_scattering(2, freq, &limit);
+    BOOST_CHECK_CLOSE(limit(0), 1e-3, 1e-6);
+}
+
 /**
  * Test the basics of creating an ocean volume layer,
  */
@@ -130,6 +130,18 @@ class USML_DECLSPEC volume_model : public scattering_model {
                                 amplitude);
     }
 
+    /**
+     * Computes an upper limit on the scattering strength, at each frequency,
+     * over all locations and scattering angles.
+     *
+     * @param frequencies   Frequencies over which to compute the limit. (Hz)
+     * @param amplitude     Upper limit on scattering strength ratio (output).
+     */
+    void max_scattering(const seq_vector::csptr& frequencies,
+                        vector<double>* amplitude) const override {
+        _scattering->max_scattering(frequencies, amplitude);
+    }
+
    private:
     /** Reference to the scattering strength model **/
     scattering_model::csptr _scattering;
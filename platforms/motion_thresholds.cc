@@ -13,3 +13,7 @@ const double motion_thresholds::alt_threshold = 5.0;    // meters
 const double motion_thresholds::yaw_threshold = 5.0;    // degrees
 const double motion_thresholds::pitch_threshold = 5.0;  // degrees
 const double motion_thresholds::roll_threshold = 5.0;   // degrees
+
+double motion_thresholds::dead_reckon_lat = 0.0;  // degrees
+double motion_thresholds::dead_reckon_lon = 0.0;  // degrees
+double motion_thresholds::dead_reckon_alt = 0.0;  // meters
@@ -32,6 +32,28 @@ class motion_thresholds {
 
     /** Maximum change in roll  (degrees). */
     static const double roll_threshold;
+
+    /**
+     * Maximum change in latitude, since the last wavefront calculation,
+     * for which direct path eigenrays are dead reckoned instead of being
+     * recomputed (degrees). Dead reckoning is disabled if this, or any of
+     * the other dead reckoning limits, is zero. Defaults to zero.
+     */
+    static double dead_reckon_lat;
+
+    /**
+     * Maximum change in longitude, since the last wavefront calculation,
+     * for which direct path eigenrays are dead reckoned (degrees).
+     * Defaults to zero.
+     */
+    static double dead_reckon_lon;
+
+    /**
+     * Maximum change in altitude, since the last wavefront calculation,
+     * for which direct path eigenrays are dead reckoned (meters).
+     * Defaults to zero.
+     */
+    static double dead_reckon_alt;
 };
 
 /// @}
@@ -5,6 +5,7 @@
  */
 
 #include <usml/beampatterns/bp_model.h>
+#include <usml/ocean/ocean_shared.h>
 #include <usml/rvbts/rvbts_collection.h>
 #include <usml/types/bvector.h>
 #include <usml/types/seq_linear.h>
@@ -16,10 +17,12 @@
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/vector_expression.hpp>
 #include <boost/numeric/ublas/vector_proxy.hpp>
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <list>
 #include <netcdf>
+#include <vector>
 
 using namespace usml::rvbts;
 
@@ -28,6 +31,41 @@ using namespace usml::rvbts;
  */
 double rvbts_collection::power_threshold = 1e-20;
 
+/**
+ * Use bp_table lookups when the table meets beam_table_tolerance.
+ */
+bool rvbts_collection::use_beam_tables = true;
+
+/**
+ * Maximum interpolation error for beam tables (linear units).
+ */
+double rvbts_collection::beam_table_tolerance = 1e-3;
+
+namespace {
+
+/**
+ * Speed of sound in the current ocean at a single location. Uses 1500 m/s
+ * if the ocean has not been defined yet.
+ *
+ * @param location  Location at which sound speed is computed.
+ * @return          Speed of sound (m/s).
+ */
+double sound_speed_at(const wposition1 &location) {
+    auto ocean = ocean_shared::current();
+    if (ocean == nullptr) {
+        return 1500.0;
+    }
+    wposition position(1, 1);
+    position.rho(0, 0, location.rho());
+    position.theta(0, 0, location.theta());
+    position.phi(0, 0, location.phi());
+    matrix<double> speed(1, 1);
+    ocean->profile()->sound_speed(position, &speed);
+    return speed(0, 0);
+}
+
+}  // namespace
+
 /**
  * Initialize model parameters with state of sensor_pair at the time that
  * reverberation generator was created.
@@ -46,8 +84,83 @@ rvbts_collection::rvbts_collection(
       _receiver_pos(receiver_pos),
       _receiver_orient(receiver_orient),
       _receiver_speed(receiver_speed),
+      _source_sound_speed(sound_speed_at(source_pos)),
+      _receiver_sound_speed(sound_speed_at(receiver_pos)),
       _travel_times(travel_times),
-      _time_series(receiver->rcv_num_keys(), travel_times->size()) {}
+      _time_series(receiver->rcv_num_keys(), travel_times->size()) {
+    _time_series.clear();
+    for (int key : source->src_keys()) {
+        _src_beams[key] = source->src_beam(key);
+    }
+    for (int key : receiver->rcv_keys()) {
+        _rcv_keys.push_back(key);
+        _rcv_beams.push_back(receiver->rcv_beam(key));
+        _rcv_steering.push_back(receiver->rcv_steering(key));
+    }
+}
+
+/**
+ * Single frequency axis for a transmit frequency.
+ */
+const seq_vector::csptr &rvbts_collection::workspace::frequency(
+    double fcenter) {
+    for (const auto &entry : frequencies) {
+        if (entry.first == fcenter) {
+            return entry.second;
+        }
+    }
+    frequencies.emplace_back(fcenter,
+                             seq_vector::csptr(new seq_linear(fcenter, 1.0, 1)));
+    return frequencies.back().second;
+}
+
+/**
+ * Source beam table for a transmission.
+ */
+const bp_table *rvbts_collection::workspace::src_table(
+    const bp_model::csptr &pattern, double fcenter, const bvector &steering,
+    double sound_speed) {
+    const auto key = std::make_tuple(pattern.get(), fcenter, steering.front(),
+                                     steering.right(), steering.up(),
+                                     sound_speed);
+    for (const auto &entry : src_tables) {
+        if (entry.first == key) {
+            return entry.second.get();
+        }
+    }
+    auto table = bp_table::find(pattern, fcenter, steering, sound_speed,
+                                beam_table_tolerance);
+    src_tables.emplace_back(key, table);
+    return table.get();
+}
+
+/**
+ * Receiver beam table for a channel.
+ */
+const bp_table *rvbts_collection::workspace::rcv_table(
+    size_t channel, size_t num_channels, const bp_model::csptr &pattern,
+    double fcenter, const bvector &steering, double sound_speed) {
+    std::vector<std::pair<bool, bp_table::csptr> > *tables = nullptr;
+    for (auto &entry : rcv_tables) {
+        if (entry.first == fcenter) {
+            tables = &entry.second;
+            break;
+        }
+    }
+    if (tables == nullptr) {
+        rcv_tables.emplace_back(
+            fcenter,
+            std::vector<std::pair<bool, bp_table::csptr> >(num_channels));
+        tables = &rcv_tables.back().second;
+    }
+    auto &table = (*tables)[channel];
+    if (!table.first) {
+        table.first = true;
+        table.second = bp_table::find(pattern, fcenter, steering, sound_speed,
+                                      beam_table_tolerance);
+    }
+    return table.second.get();
+}
 
 /**
  * Adds the intensity contribution for a single bistatic eigenverb.
@@ -55,61 +168,115 @@ rvbts_collection::rvbts_collection(
 void rvbts_collection::add_biverb(const biverb_model::csptr &verb,
                                   const transmit_model::csptr &transmit,
                                   const bvector &steering) {
-    static const double SQRT_TWO_PI = sqrt(TWO_PI);
-
-    // find range of time indices to update
-
-    const auto duration = verb->duration + transmit->duration;
-    const auto delay = transmit->delay + verb->travel_time + duration;
-    size_t first = _travel_times->find_index(delay - 5.0 * duration);
-    size_t last = _travel_times->find_index(delay + 5.0 * duration);
-    range window(first, last);
+    workspace scratch;
+    biverb_columns verbs;
+    verbs.push_back(*verb);
+    const double src_level =
+        source_level(verbs, 0, transmit, steering, &scratch);
+    add_biverb(verbs, 0, transmit, transmit->delay, src_level, 0,
+               _rcv_keys.size(), &scratch);
+}
 
-    // update Gaussian time series in this window
+/**
+ * Computes the source level of a single bistatic eigenverb for one
+ * transmission.
+ */
+double rvbts_collection::source_level(const biverb_columns &verbs,
+                                      size_t index,
+                                      const transmit_model::csptr &transmit,
+                                      const bvector &steering,
+                                      workspace *scratch) const {
+    auto beam = _src_beams.find(transmit->transmit_mode);
+    if (beam == _src_beams.end() || beam->second == nullptr) {
+        return 0.0;
+    }
+    vector<double> &level = scratch->level;
+    bvector src_arrival(verbs.source_de[index], verbs.source_az[index]);
+    src_arrival.rotate(_source_orient, src_arrival);
+    const bp_table *src_table =
+        use_beam_tables
+            ? scratch->src_table(beam->second, transmit->fcenter, steering,
+                                 _source_sound_speed)
+            : nullptr;
+    if (src_table != nullptr) {
+        level[0] = src_table->level(src_arrival);
+    } else {
+        beam->second->beam_level(src_arrival,
+                                 scratch->frequency(transmit->fcenter),
+                                 &level, steering, _source_sound_speed);
+    }
+    return transmit->source_level + level[0];
+}
 
-    vector<double> times = _travel_times->data();
-    vector_range<vector<double> > tau(times, window);
-    vector<double> gaussian =
-        exp(-0.5 * abs2((tau - delay) / duration)) / (duration * SQRT_TWO_PI);
+/**
+ * Adds the intensity contribution for a single bistatic eigenverb to a
+ * range of receiver channels.
+ */
+void rvbts_collection::add_biverb(const biverb_columns &verbs, size_t index,
+                                  const transmit_model::csptr &transmit,
+                                  double start, double src_level, size_t first,
+                                  size_t last, workspace *scratch) {
+    static const double SQRT_TWO_PI = sqrt(TWO_PI);
+    if (src_level < power_threshold) {
+        return;
+    }
+    const seq_vector::csptr &frequencies = scratch->frequency(transmit->fcenter);
+    vector<double> &level = scratch->level;
 
     // interpolate eigenverb power
 
-    double verb_level = verb->power[0] * transmit->duration;
-    if (verb->frequencies->size() > 1) {
+    const double *power = verbs.power(index);
+    double verb_level = power[0] * transmit->duration;
+    if (verbs.num_frequencies() > 1) {
         double freq = transmit->fcenter;
-        const seq_vector &axis = *(verb->frequencies);
-        size_t index = axis.find_nearest(freq);
-        if (index >= axis.size()) {
-            --index;
+        const seq_vector &axis = *(verbs.frequencies);
+        size_t f = axis.find_nearest(freq);
+        if (f >= axis.size()) {
+            --f;
         }
-        double u = (freq - axis[index]) / axis.increment(index);
-        verb_level = u * verb->power[index + 1] + (1 - u) * verb->power[index];
+        double u = (freq - axis[f]) / axis.increment(f);
+        verb_level = u * power[f + 1] + (1 - u) * power[f];
     }
 
-    // compute source level for this transmission
-
-    bp_model::csptr src_beam = _source->src_beam(transmit->transmit_mode);
-    const seq_vector::csptr frequencies(
-        new seq_linear(transmit->fcenter, 1.0, 1));
-    vector<double> level(1);
-    bvector src_arrival(verb->source_de, verb->source_az);
-    src_arrival.rotate(_source_orient, src_arrival);
-    src_beam->beam_level(src_arrival, frequencies, &level, steering);
-    double src_level = transmit->source_level + level[0];
-    if (src_level < power_threshold) {
-        return;
+    // evaluate Gaussian time series over the window of time indices,
+    // directly from the travel time axis
+
+    const auto duration = verbs.duration[index] + transmit->duration;
+    const auto delay = start + verbs.travel_time[index] + duration;
+    const size_t tfirst = _travel_times->find_index(delay - 5.0 * duration);
+    const size_t tlast = _travel_times->find_index(delay + 5.0 * duration);
+    const size_t num_times = tlast - tfirst;
+    const seq_vector &times = *_travel_times;
+    const double norm = duration * SQRT_TWO_PI;
+    std::vector<double> &gaussian = scratch->gaussian;
+    gaussian.resize(num_times);
+    for (size_t n = 0; n < num_times; ++n) {
+        const double u = (times[tfirst + n] - delay) / duration;
+        gaussian[n] = exp(-0.5 * u * u) / norm;
     }
 
     // add Gaussian to each receiver channel
 
-    for (int rcv : this->_receiver->rcv_keys()) {
+    bvector rcv_arrival(verbs.receiver_de[index], verbs.receiver_az[index]);
+    rcv_arrival.rotate(_receiver_orient, rcv_arrival);
+    last = std::min(last, _rcv_keys.size());
+    for (size_t channel = first; channel < last; ++channel) {
         // compute received level for this transmission
 
-        bp_model::csptr rcv_beam = _receiver->rcv_beam(rcv);
-        bvector rcv_arrival(verb->receiver_de, verb->receiver_az);
-        rcv_arrival.rotate(_receiver_orient, rcv_arrival);
-        bvector rcv_steering = _receiver->rcv_steering(rcv);
-        rcv_beam->beam_level(rcv_arrival, frequencies, &level, rcv_steering);
+        const bp_table *rcv_table =
+            use_beam_tables
+                ? scratch->rcv_table(channel, _rcv_keys.size(),
+                                     _rcv_beams[channel], transmit->fcenter,
+                                     _rcv_steering[channel],
+                                     _receiver_sound_speed)
+                : nullptr;
+        if (rcv_table != nullptr) {
+            level[0] = rcv_table->level(rcv_arrival);
+        } else {
+            _rcv_beams[channel]->beam_level(rcv_arrival, frequencies, &level,
+                                            _rcv_steering[channel],
+                                            _receiver_sound_speed);
+        }
         double rcv_level = src_level + verb_level + level[0];
         if (rcv_level < power_threshold) {
             continue;
@@ -117,9 +284,9 @@ void rvbts_collection::add_biverb(const biverb_model::csptr &verb,
 
         // add scaled Gaussian to each result in time window
 
-        for (size_t n = 0; n < gaussian.size(); ++n) {
-            auto t = n + first;
-            _time_series(rcv, t) += rcv_level * gaussian[n];
+        double *row = &_time_series(_rcv_keys[channel], tfirst);
+        for (size_t n = 0; n < num_times; ++n) {
+            row[n] += rcv_level * gaussian[n];
         }
     }
 }
@@ -4,20 +4,29 @@
  */
 #pragma once
 
+#include <usml/beampatterns/bp_model.h>
+#include <usml/beampatterns/bp_table.h>
+#include <usml/biverbs/biverb_columns.h>
 #include <usml/biverbs/biverb_model.h>
 #include <usml/sensors/sensor_model.h>
 #include <usml/transmit/transmit_model.h>
+#include <usml/types/bvector.h>
 #include <usml/types/orientation.h>
 #include <usml/types/seq_vector.h>
 #include <usml/types/wposition1.h>
 #include <usml/usml_config.h>
 
 #include <boost/numeric/ublas/matrix.hpp>
+#include <map>
 #include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace usml {
 namespace rvbts {
 
+using namespace usml::beampatterns;
 using namespace usml::biverbs;
 using namespace usml::sensors;
 using namespace usml::threads;
@@ -46,9 +55,96 @@ class USML_DECLSPEC rvbts_collection {
      */
     static double power_threshold;
 
+    /**
+     * Use bp_table lookups, instead of exact beam pattern evaluation, when
+     * the table meets beam_table_tolerance. Defaults to true.
+     */
+    static bool use_beam_tables;
+
+    /**
+     * Maximum interpolation error for beam tables (linear units).
+     * Patterns whose tables can not meet this tolerance are evaluated
+     * exactly. Defaults to 1e-3.
+     */
+    static double beam_table_tolerance;
+
+    /**
+     * Scratch memory used by add_biverb(). Each thread that adds biverbs
+     * to a collection needs its own workspace. Reusing the same workspace
+     * for every biverb avoids memory allocation in the inner loop once the
+     * buffers have grown to their working size.
+     */
+    struct workspace {
+        /// Gaussian pulse over the time window of the current biverb.
+        std::vector<double> gaussian;
+
+        /// Beam level at a single frequency.
+        vector<double> level{vector<double>(1)};
+
+        /// Single frequency axis for each transmit frequency seen so far.
+        std::vector<std::pair<double, seq_vector::csptr> > frequencies;
+
+        /**
+         * Single frequency axis for a transmit frequency. Only allocated the
+         * first time that each transmit frequency is used.
+         *
+         * @param fcenter   Transmit frequency (Hz).
+         */
+        const seq_vector::csptr& frequency(double fcenter);
+
+        /// Source beam tables, by pattern, frequency, steering, and sound
+        /// speed.
+        std::vector<std::pair<std::tuple<const bp_model*, double, double,
+                                         double, double, double>,
+                              bp_table::csptr> >
+            src_tables;
+
+        /// Receiver beam tables, for each channel, by frequency. Each
+        /// table is paired with a flag that is true once it has been found,
+        /// because tables that do not meet tolerance are nullptr.
+        std::vector<std::pair<
+            double, std::vector<std::pair<bool, bp_table::csptr> > > >
+            rcv_tables;
+
+        /**
+         * Source beam table for a transmission. Tables are found in the
+         * bp_table cache the first time they are used by this workspace.
+         *
+         * @param pattern       Source beam pattern.
+         * @param fcenter       Transmit frequency (Hz).
+         * @param steering      Transmit steering relative to source array.
+         * @param sound_speed   Speed of sound at the source (m/s).
+         * @return              Table, nullptr if it does not meet tolerance.
+         */
+        const bp_table* src_table(const bp_model::csptr& pattern,
+                                  double fcenter, const bvector& steering,
+                                  double sound_speed);
+
+        /**
+         * Receiver beam table for a channel. Tables are found in the
+         * bp_table cache the first time they are used by this workspace.
+         * The workspace must only be used with receivers of a single
+         * collection, because the tables are stored by channel number.
+         *
+         * @param channel       Channel number, index into rcv_keys().
+         * @param num_channels  Number of receiver channels.
+         * @param pattern       Receiver beam pattern for this channel.
+         * @param fcenter       Transmit frequency (Hz).
+         * @param steering      Receiver steering for this channel.
+         * @param sound_speed   Speed of sound at the receiver (m/s).
+         * @return              Table, nullptr if it does not meet tolerance.
+         */
+        const bp_table* rcv_table(size_t channel, size_t num_channels,
+                                  const bp_model::csptr& pattern,
+                                  double fcenter, const bvector& steering,
+                                  double sound_speed);
+    };
+
     /**
      * Initialize model parameters with state of sensor_pair at the time that
-     * reverberation generator was created.
+     * reverberation generator was created. Beam patterns are evaluated
+     * using the speed of sound in the current ocean at the source and
+     * receiver positions.
      *
      * @param source      	  Reference to source sensor
      * @param source_pos      Source position at this time.
@@ -115,6 +211,8 @@ class USML_DECLSPEC rvbts_collection {
      * Loops over receiver beams and adds the Gaussian contribution to each
      * channel. Interpolates eigenverb power to the transmit frequency. Applies
      * the source and receiver beam patterns to each eigenverb contribution.
+     * The transmission is treated as the first pulse of a schedule, so it
+     * starts at its delay.
      *
      * @param verb	   	Bistatic eigenverb for time series contribution.
      * @param transmit	Single waveform in a transmission schedule.
@@ -124,6 +222,56 @@ class USML_DECLSPEC rvbts_collection {
                     const transmit_model::csptr& transmit,
                     const bvector& steering);
 
+    /**
+     * Computes the source level of a single bistatic eigenverb for one
+     * transmission. This is the transmit source level plus the source beam
+     * level in the direction that the biverb leaves the source. It is the
+     * same for every receiver channel, so callers that split the channels
+     * across threads compute it once and pass it to each channel group.
+     *
+     * @param verbs	   	List of bistatic eigenverbs.
+     * @param index	   	Position of the biverb in the list.
+     * @param transmit	Single waveform in a transmission schedule.
+     * @param steering 	Transmit steering relative to source array.
+     * @param scratch 	Scratch memory for this thread.
+     * @return          Source level, zero if the source has no beam pattern
+     *                  for this transmit mode.
+     */
+    double source_level(const biverb_columns& verbs, size_t index,
+                        const transmit_model::csptr& transmit,
+                        const bvector& steering, workspace* scratch) const;
+
+    /**
+     * Adds the intensity contribution for a single bistatic eigenverb to a
+     * range of receiver channels. Calls for disjoint ranges of channels
+     * only write to their own rows of the time series, so they can be made
+     * from different threads without locking, as long as each thread uses
+     * its own workspace.
+     *
+     * Receiver beams and steerings are taken from the snapshot made when
+     * this collection was constructed, so that this method does not need to
+     * lock the receiver. Channel numbers are indices into rcv_keys().
+     * Reads the biverb directly from the columnar storage of the
+     * biverb_collection, so that no biverb_model needs to be created.
+     *
+     * @param verbs	   	List of bistatic eigenverbs.
+     * @param index	   	Position of the biverb for time series contribution.
+     * @param transmit	Single waveform in a transmission schedule.
+     * @param start	    Time at which transmission starts (sec),
+     *                  from usml::transmit::start_times().
+     * @param src_level Source level computed by source_level().
+     * @param first 	First channel number to be updated.
+     * @param last 	    One past the last channel number to be updated.
+     * @param scratch 	Scratch memory for this thread.
+     */
+    void add_biverb(const biverb_columns& verbs, size_t index,
+                    const transmit_model::csptr& transmit, double start,
+                    double src_level, size_t first, size_t last,
+                    workspace* scratch);
+
+    /// Receiver channel keys at time that class constructed.
+    const std::vector<int>& rcv_keys() const { return _rcv_keys; }
+
     /**
      * Writes reverberation time series data to disk.
      *
@@ -220,9 +368,27 @@ class USML_DECLSPEC rvbts_collection {
     /// Receiver speed at time that class constructed (m/s).
     const double _receiver_speed;
 
+    /// Speed of sound at the source position (m/s).
+    const double _source_sound_speed;
+
+    /// Speed of sound at the receiver position (m/s).
+    const double _receiver_sound_speed;
+
     /// Receiver times at which reverberation is computed (sec).
     const seq_vector::csptr _travel_times;
 
+    /// Source beam patterns, by transmit mode, at time that class constructed.
+    std::map<int, bp_model::csptr> _src_beams;
+
+    /// Receiver channel keys at time that class constructed.
+    std::vector<int> _rcv_keys;
+
+    /// Receiver beam pattern for each channel in _rcv_keys.
+    std::vector<bp_model::csptr> _rcv_beams;
+
+    /// Receiver steering for each channel in _rcv_keys.
+    std::vector<bvector> _rcv_steering;
+
     /// Reverberation time series for each receiver channel.
     matrix<double> _time_series;
 };
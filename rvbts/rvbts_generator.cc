@@ -6,6 +6,9 @@
 #include <usml/managed/managed_obj.h>
 #include <usml/platforms/platform_model.h>
 #include <usml/rvbts/rvbts_generator.h>
+#include <usml/threads/parallel_for.h>
+#include <usml/threads/thread_controller.h>
+#include <usml/threads/thread_pool.h>
 #include <usml/types/bvector.h>
 #include <usml/types/seq_linear.h>
 
@@ -13,11 +16,19 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/matrix_expression.hpp>
 #include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <list>
+#include <vector>
 
 using namespace usml::rvbts;
 
+/**
+ * Number of biverbs in each block of source level calculations.
+ */
+size_t rvbts_generator::source_block_size = 256;
+
 /**
  * Initialize model parameters with state of sensor_pair at this time.
  */
@@ -47,36 +58,7 @@ rvbts_generator::rvbts_generator(const sensor_pair::sptr& pair,
  * Compute source steerings for each transmit waveform.
  */
 matrix<double> rvbts_generator::compute_src_steering() const {
-    // compute matrix of ordered steerings relative to host
-
-    matrix<double> steering(3, _transmit_schedule.size());
-    int n = 0;
-    for (const auto& transmit : _transmit_schedule) {
-        bvector ordered(transmit->orderedDE, transmit->orderedAZ);
-        steering(0, n) = ordered.front();
-        steering(1, n) = ordered.right();
-        steering(2, n) = ordered.up();
-        ++n;
-    }
-
-    // use these steerings if sensor has no host
-
-    const platform_model* host = _source->host();
-    if (host == nullptr) {
-        return steering;
-    }
-
-    // convert steerings to world coordinates using orientation of host
-
-    while (host->host() != nullptr) {
-        host = host->host();
-    }
-    steering = prod(host->orient().rotation(), steering);
-
-    // convert steerings from world to array coordinates
-
-    steering = prod(trans(_source_orient.rotation()), steering);
-    return steering;
+    return _source->src_steering(_transmit_schedule, _source_orient);
 }
 
 /**
@@ -96,26 +78,98 @@ void rvbts_generator::run() {
 
     cout << "task #" << id() << " rvbts_generator: " << _description << endl;
 
-    // loop through eigenverbs for each interface
+    // split receiver channels into contiguous groups, one per thread,
+    // so that each thread updates its own rows of the time series
 
-    auto num_interfaces = _biverbs->num_interfaces();
+    const size_t num_channels = collection->rcv_keys().size();
+    const size_t num_groups = std::max(
+        (size_t)1,
+        std::min(num_channels, thread_controller::instance()->num_threads()));
+
+    // extract source steering and start times before starting threads
+
+    const std::vector<double> starts = start_times(_transmit_schedule);
+    std::vector<bvector> steerings;
+    for (size_t n = 0; n < _transmit_schedule.size(); ++n) {
+        steerings.emplace_back(
+            matrix_column<matrix<double> >(_source_steering, n));
+    }
+
+    // compute the source level of each biverb and transmission once,
+    // because it is the same for all channels. Blocks of biverbs are claimed
+    // from a shared counter by one worker per thread, so that each worker
+    // reuses its own workspace, and the beam tables in it, for every block.
+
+    const size_t num_interfaces = _biverbs->num_interfaces();
+    const size_t num_transmits = _transmit_schedule.size();
+    const size_t block_size = std::max((size_t)1, source_block_size);
+    std::vector<std::vector<double> > src_levels(num_interfaces);
+    std::vector<std::pair<size_t, size_t> > blocks;  // interface, first
     for (size_t interface = 0; interface < num_interfaces; ++interface) {
-        auto verb_list = _biverbs->biverbs(interface);
-        for (const auto& verb : verb_list) {
-            int n = 0;
-            for (const auto& transmit : _transmit_schedule) {
-                bvector steering(
-                    matrix_column<matrix<double> >(_source_steering, n));
-                collection->add_biverb(verb, transmit, steering);
+        const size_t num_verbs = _biverbs->columns(interface).size();
+        src_levels[interface].resize(num_verbs * num_transmits);
+        for (size_t first = 0; first < num_verbs; first += block_size) {
+            blocks.emplace_back(interface, first);
+        }
+    }
+    const size_t num_workers = std::max(
+        (size_t)1,
+        std::min(blocks.size(), thread_controller::instance()->num_threads()));
+    std::atomic<size_t> next_block(0);
+    auto source_body = [&](size_t /* worker */) {
+        rvbts_collection::workspace scratch;
+        for (size_t block = next_block++; block < blocks.size() && !_abort;
+             block = next_block++) {
+            const size_t interface = blocks[block].first;
+            const biverb_columns& verbs = _biverbs->columns(interface);
+            auto& levels = src_levels[interface];
+            const size_t first = blocks[block].second;
+            const size_t last = std::min(first + block_size, verbs.size());
+            for (size_t index = first; index < last; ++index) {
+                size_t n = 0;
+                for (const auto& transmit : _transmit_schedule) {
+                    levels[index * num_transmits + n] =
+                        collection->source_level(verbs, index, transmit,
+                                                 steerings[n], &scratch);
+                    ++n;
+                }
+            }
+        }
+    };
+    if (!parallel_for::run(num_workers, source_body, &_abort, priority()) ||
+        _abort) {
+        cout << "task #" << id()
+             << " rvbts_generator *** aborted during execution ***" << endl;
+        return;
+    }
+
+    // loop through eigenverbs for each group of channels in parallel
+
+    auto body = [&](size_t group) {
+        const size_t first = group * num_channels / num_groups;
+        const size_t last = (group + 1) * num_channels / num_groups;
+        rvbts_collection::workspace scratch;
+        for (size_t interface = 0; interface < num_interfaces; ++interface) {
+            const biverb_columns& verbs = _biverbs->columns(interface);
+            const double* levels = src_levels[interface].data();
+            for (size_t index = 0; index < verbs.size(); ++index) {
+                size_t n = 0;
+                for (const auto& transmit : _transmit_schedule) {
+                    collection->add_biverb(verbs, index, transmit, starts[n],
+                                           levels[index * num_transmits + n],
+                                           first, last, &scratch);
+                    ++n;
+                }
                 if (_abort) {
-                    cout << "task #" << id()
-                         << " rvbts_generator *** aborted during execution ***"
-                         << endl;
                     return;
                 }
-                ++n;
             }
         }
+    };
+    if (!parallel_for::run(num_groups, body, &_abort, priority()) || _abort) {
+        cout << "task #" << id()
+             << " rvbts_generator *** aborted during execution ***" << endl;
+        return;
     }
 
     // notify listeners of results
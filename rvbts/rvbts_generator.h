@@ -36,11 +36,25 @@ using namespace usml::types;
  * pair.
  * Notifies update listeners when the computation is
  * complete.
+ *
+ * The receiver channels are split into contiguous groups, one for each
+ * thread in the thread_controller pool, and the groups are processed in
+ * parallel using parallel_for. Each group only writes to its own rows of the
+ * rvbts_collection time series, so no locking is needed, and the results are
+ * identical to a serial calculation. The source level of each biverb does not
+ * depend on the receiver channel, so it is computed once for each biverb and
+ * transmission, before the channel groups start, and shared by every group.
  */
 class USML_DECLSPEC rvbts_generator
     : public thread_task,
       public update_notifier<rvbts_collection::csptr> {
    public:
+    /**
+     * Number of biverbs processed as a single unit of parallel work when
+     * computing source levels. Defaults to 256.
+     */
+    static size_t source_block_size;
+
     /**
      * Initialize generator with state of sensor_pair at this time. Makes copies
      * of the position, orientation, speed, transmit pulses, and bistatic
@@ -67,12 +81,8 @@ class USML_DECLSPEC rvbts_generator
 
    private:
     /**
-     * Compute source steerings for each transmit waveform. Steerings in the
-     * transmission schedule are defined relative to the orientation of the host
-     * platform. But, the beam patterns need them to be specified in array
-     * coordinates. This implementation uses the orientation of the host to
-     * convert the ordered heading into world coordinates. Then it uses the
-     * orientation of the array to covert from world to array coordinates.
+     * Compute source steerings for each transmit waveform, relative to the
+     * source array, using sensor_model::src_steering().
      *
      * Receiver beam patterns are less work because their steering directions
      * are defined relative to the array and not the array's host platform.
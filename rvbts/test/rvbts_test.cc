@@ -5,6 +5,7 @@
 #include <usml/beampatterns/bp_model.h>
 #include <usml/beampatterns/bp_omni.h>
 #include <usml/biverbs/biverb_collection.h>
+#include <usml/biverbs/biverb_generator.h>
 #include <usml/eigenrays/eigenray_collection.h>
 #include <usml/eigenverbs/eigenverb_collection.h>
 #include <usml/managed/managed_obj.h>
@@ -18,6 +19,8 @@
 #include <usml/sensors/sensor_manager.h>
 #include <usml/sensors/sensor_model.h>
 #include <usml/sensors/sensor_pair.h>
+#include <usml/threads/thread_controller.h>
+#include <usml/threads/thread_pool.h>
 #include <usml/threads/thread_task.h>
 #include <usml/transmit/transmit_cw.h>
 #include <usml/transmit/transmit_model.h>
@@ -27,6 +30,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <iostream>
+#include <limits>
 #include <list>
 #include <memory>
 #include <sstream>
@@ -177,5 +181,174 @@ BOOST_AUTO_TEST_CASE(update_envelope) {
     sensor_manager::reset();
 }
 
+/**
+ * Tests the parallel computation of reverberation for a receiver with
+ * multiple channels. Uses the same geometry as update_envelope, but gives
+ * the receiver 8 identical omni-directional beams, and computes the
+ * reverberation in a 4 thread pool. Test fails if the time series for any
+ * channel is different from the time series for the first channel, which
+ * would indicate that a channel was skipped or processed more than once.
+ */
+BOOST_AUTO_TEST_CASE(parallel_channels) {
+    cout << "=== rvbts_test: parallel_channels ===" << endl;
+    thread_controller::reset(4);
+    ocean_utils::make_iso(2000.0);
+    auto* platform_mgr = platform_manager::instance();
+    auto* sensor_mgr = sensor_manager::instance();
+    seq_vector::csptr freq(new seq_linear(900.0, 100.0, 1100.0));
+    sensor_mgr->frequencies(freq);
+    const int num_channels = 8;
+    auto beam = bp_model::csptr(new bp_omni());
+
+    auto* source = new sensor_model(1, "source", 0.0,
+                                    wposition1(36.0, 16.0, -100.0));
+    source->compute_reverb(true);
+    source->multistatic(1);
+    source->time_maximum(8.0);
+    source->src_beam(0, beam);
+    transmit_list transmits;
+    transmits.push_back(transmit_model::csptr(
+        new transmit_cw("CW", 0.1, 1005.0, 0.0, 200.0)));
+    source->transmit_schedule(transmits);
+    sensor_mgr->add_sensor(sensor_model::sptr(source), &test_listener);
+
+    auto* receiver = new sensor_model(2, "receiver", 0.0,
+                                      wposition1(36.0, 16.0, -500.0));
+    receiver->compute_reverb(true);
+    receiver->multistatic(1);
+    receiver->time_maximum(8.0);
+    for (int channel = 0; channel < num_channels; ++channel) {
+        receiver->rcv_beam(channel, beam);
+    }
+    sensor_mgr->add_sensor(sensor_model::sptr(receiver), &test_listener);
+
+    for (auto& platform : platform_mgr->list()) {
+        platform->update(0.0, platform_model::FORCE_UPDATE);
+    }
+    thread_task::wait();
+
+    // compare the time series for each channel to the first channel
+
+    for (const auto& pair : sensor_mgr->list()) {
+        if (pair->receiver()->keyID() != 2 || pair->source()->keyID() != 1) {
+            continue;
+        }
+        BOOST_REQUIRE(pair->rvbts() != nullptr);
+        const auto& series = pair->rvbts()->time_series();
+        BOOST_REQUIRE_EQUAL(series.size1(), num_channels);
+        double total = 0.0;
+        for (size_t t = 0; t < series.size2(); ++t) {
+            total += series(0, t);
+            for (size_t channel = 1; channel < series.size1(); ++channel) {
+                BOOST_CHECK_EQUAL(series(channel, t), series(0, t));
+            }
+        }
+        BOOST_CHECK_GT(total, 0.0);
+    }
+
+    sensor_manager::reset();
+    thread_controller::reset();
+}
+
+/**
+ * Tests the travel time window used to limit biverb generation. Uses the
+ * same geometry as update_envelope, with a 4 sec time series, so that
+ * some biverbs arrive after the end of the padded window, and a 10 msec
+ * pulse, so that the padding is dominated by the biverb durations. Runs
+ * biverb_generator for the pair twice, once without a window, and once
+ * with the window that sensor_pair uses, and computes the reverberation
+ * time series for each.
+ *
+ * This test passes if the window removes some of the biverbs, and if the
+ * time series are identical at every time in the reverberation time
+ * series. This fails if the padding only depends on the pulse length,
+ * because biverbs that spread into the end of the time series are lost.
+ */
+BOOST_AUTO_TEST_CASE(windowed_biverbs) {
+    cout << "=== rvbts_test: windowed_biverbs ===" << endl;
+    ocean_utils::make_iso(2000.0);
+    auto* platform_mgr = platform_manager::instance();
+    auto* sensor_mgr = sensor_manager::instance();
+    seq_vector::csptr freq(new seq_linear(900.0, 100.0, 1100.0));
+    sensor_mgr->frequencies(freq);
+    auto beam = bp_model::csptr(new bp_omni());
+    const double max_time = 4.0;
+
+    auto* source = new sensor_model(1, "source", 0.0,
+                                    wposition1(36.0, 16.0, -100.0));
+    source->compute_reverb(true);
+    source->multistatic(1);
+    source->time_maximum(max_time);
+    source->src_beam(0, beam);
+    transmit_list transmits;
+    transmits.push_back(transmit_model::csptr(
+        new transmit_cw("CW", 0.01, 1005.0, 0.0, 200.0)));
+    source->transmit_schedule(transmits);
+    sensor_mgr->add_sensor(sensor_model::sptr(source), &test_listener);
+
+    auto* receiver = new sensor_model(2, "receiver", 0.0,
+                                      wposition1(36.0, 16.0, -500.0));
+    receiver->compute_reverb(true);
+    receiver->multistatic(1);
+    receiver->time_maximum(max_time);
+    receiver->rcv_beam(0, beam);
+    sensor_mgr->add_sensor(sensor_model::sptr(receiver), &test_listener);
+
+    for (auto& platform : platform_mgr->list()) {
+        platform->update(0.0, platform_model::FORCE_UPDATE);
+    }
+    thread_task::wait();
+
+    sensor_pair::sptr pair;
+    for (const auto& entry : sensor_mgr->list()) {
+        if (entry->source()->keyID() == 1 && entry->receiver()->keyID() == 2) {
+            pair = entry;
+        }
+    }
+    BOOST_REQUIRE(pair != nullptr);
+    BOOST_REQUIRE(pair->src_eigenverbs() != nullptr);
+    BOOST_REQUIRE(pair->rcv_eigenverbs() != nullptr);
+
+    // compute biverbs and time series without, and then with, the window
+
+    const double padding = biverb_generator::time_padding(
+        transmits, pair->rcv_eigenverbs()->duration_maximum());
+    const double windows[2] = {std::numeric_limits<double>::max(),
+                               max_time + padding};
+    size_t num_biverbs[2];
+    matrix<double> series[2];
+    for (size_t n = 0; n < 2; ++n) {
+        auto task = std::make_shared<biverb_generator>(
+            pair, pair->src_eigenverbs(), pair->rcv_eigenverbs(), 0.0,
+            windows[n]);
+        thread_controller::instance()->run(task);
+        task.reset();
+        thread_task::wait();
+        BOOST_REQUIRE(pair->biverbs() != nullptr);
+        BOOST_REQUIRE(pair->rvbts() != nullptr);
+        num_biverbs[n] = pair->biverbs()->size(eigenverb_model::BOTTOM);
+        series[n] = pair->rvbts()->time_series();
+    }
+    cout << "window=" << windows[1] << " biverbs: unlimited=" << num_biverbs[0]
+         << " windowed=" << num_biverbs[1] << endl;
+    BOOST_CHECK_LT(num_biverbs[1], num_biverbs[0]);
+
+    // compare the time series inside the window
+
+    BOOST_REQUIRE_EQUAL(series[0].size2(), series[1].size2());
+    const seq_vector& times = *pair->rvbts()->travel_times();
+    double total = 0.0;
+    for (size_t t = 0; t < series[0].size2(); ++t) {
+        if (times[t] > max_time) {
+            break;
+        }
+        total += series[0](0, t);
+        BOOST_CHECK_EQUAL(series[1](0, t), series[0](0, t));
+    }
+    BOOST_CHECK_GT(total, 0.0);
+
+    sensor_manager::reset();
+}
+
 /// @}
 BOOST_AUTO_TEST_SUITE_END()
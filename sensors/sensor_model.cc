@@ -4,7 +4,9 @@
  */
 
 #include <usml/biverbs/biverb_collection.h>
+#include <usml/eigenrays/eigenray_collection.h>
 #include <usml/managed/manager_template.h>
+#include <usml/ocean/ocean_shared.h>
 #include <usml/platforms/motion_thresholds.h>
 #include <usml/platforms/platform_manager.h>
 #include <usml/sensors/sensor_manager.h>
@@ -19,6 +21,7 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include <cfloat>
 #include <cmath>
+#include <vector>
 
 using namespace usml::sensors;
 
@@ -107,6 +110,43 @@ void sensor_model::rcv_steering(int keyID, const bvector& steering) {
     _rcv_steering[keyID] = steering;
 }
 
+/**
+ * Compute source steerings for each pulse in a transmission schedule.
+ */
+matrix<double> sensor_model::src_steering(const transmit_list& schedule,
+                                          const orientation& orient) const {
+    // compute matrix of ordered steerings relative to host
+
+    matrix<double> steering(3, schedule.size());
+    int n = 0;
+    for (const auto& transmit : schedule) {
+        bvector ordered(transmit->orderedDE, transmit->orderedAZ);
+        steering(0, n) = ordered.front();
+        steering(1, n) = ordered.right();
+        steering(2, n) = ordered.up();
+        ++n;
+    }
+
+    // use these steerings if sensor has no host
+
+    const platform_model* platform = host();
+    if (platform == nullptr) {
+        return steering;
+    }
+
+    // convert steerings to world coordinates using orientation of host
+
+    while (platform->host() != nullptr) {
+        platform = platform->host();
+    }
+    steering = prod(platform->orient().rotation(), steering);
+
+    // convert steerings from world to array coordinates
+
+    steering = prod(trans(orient.rotation()), steering);
+    return steering;
+}
+
 /**
  * Return a list of all receiver beam keys.
  */
@@ -173,11 +213,16 @@ void sensor_model::update_internals(time_t time, const wposition1& pos,
     // start wavefront_generator background task to update acoustics
 
     if (update_acoustics) {
+        const bool needs_wavefront = update_type == FORCE_UPDATE ||
+                                     _needs_update;
         _needs_update = false;
         _update_position = pos;
         _update_orient = orient;
 
         auto targets = find_targets();
+        if (!needs_wavefront && dead_reckon_pairs(pos, targets)) {
+            return;
+        }
 
         if (!targets.empty() || _compute_reverb) {
             // abort previous wavefront generator if it exists
@@ -190,6 +235,8 @@ void sensor_model::update_internals(time_t time, const wposition1& pos,
 
             wposition tpos(targets.size(), 1);
             matrix<uint64_t> targetIDs(targets.size(), 1);
+            _wavefront_position = pos;
+            _wavefront_targets.clear();
 
             // count the number of targets
             size_t count = 0;
@@ -198,6 +245,7 @@ void sensor_model::update_internals(time_t time, const wposition1& pos,
                 tpos.longitude(count, 0, target->position().longitude());
                 tpos.altitude(count, 0, target->position().altitude());
                 targetIDs(count, 0) = target->keyID();
+                _wavefront_targets.push_back(target->keyID());
                 ++count;
             }
             auto frequencies = sensor_manager::instance()->frequencies();
@@ -205,8 +253,9 @@ void sensor_model::update_internals(time_t time, const wposition1& pos,
             _wavefront_task = std::make_shared<wavefront_generator>(
                 this, tpos, targetIDs, frequencies, _de_fan, _az_fan,
                 _time_step, _time_maximum, _intensity_threshold, _max_bottom,
-                _max_surface, _wavefront_file);
-            thread_controller::instance()->run(_wavefront_task);
+                _max_surface, _wavefront_file, _eigenray_checkpoints);
+            thread_controller::instance()->run(_wavefront_task,
+                                               _task_priority);
         }
     }
 }
@@ -237,3 +286,78 @@ std::list<platform_model::sptr> sensor_model::find_targets() {
     }
     return targets;
 }
+
+/**
+ * Dead reckons the direct paths of all sensor pairs that use this sensor.
+ */
+bool sensor_model::dead_reckon_pairs(
+    const wposition1& pos, const std::list<platform_model::sptr>& targets) {
+    if (_compute_reverb || _wavefront_task == nullptr ||
+        !_wavefront_task->done()) {
+        return false;
+    }
+
+    // check validity region relative to last wavefront calculation
+
+    if (abs(pos.latitude() - _wavefront_position.latitude()) >=
+            motion_thresholds::dead_reckon_lat ||
+        abs(pos.longitude() - _wavefront_position.longitude()) >=
+            motion_thresholds::dead_reckon_lon ||
+        abs(pos.altitude() - _wavefront_position.altitude()) >=
+            motion_thresholds::dead_reckon_alt) {
+        return false;
+    }
+    if (targets.size() != _wavefront_targets.size()) {
+        return false;
+    }
+    auto targetID = _wavefront_targets.begin();
+    for (const auto& target : targets) {
+        if (target->keyID() != *targetID++) {
+            return false;
+        }
+    }
+
+    // collect direct paths for the pairs that use this sensor
+
+    auto* sensor_mgr = sensor_manager::instance();
+    pair_list pairs = sensor_mgr->find_source(keyID());
+    for (const auto& pair : sensor_mgr->find_receiver(keyID())) {
+        if (pair->source() != pair->receiver()) {  // skip monostatic
+            pairs.push_back(pair);
+        }
+    }
+    if (pairs.empty()) {
+        return false;
+    }
+    // this sensor is locked by update(), use its new position directly
+
+    auto location = [&](const sensor_model::sptr& sensor) {
+        return (sensor.get() == this) ? pos : sensor->position();
+    };
+    std::vector<eigenray_collection::csptr> dirpaths;
+    std::vector<wposition1> sources;
+    std::vector<wposition> receivers;
+    for (const auto& pair : pairs) {
+        if (pair->compute_reverb()) {
+            return false;
+        }
+        auto collection = pair->dirpaths();
+        if (collection == nullptr) {
+            return false;
+        }
+        dirpaths.push_back(collection);
+        sources.push_back(location(pair->source()));
+        receivers.emplace_back(location(pair->receiver()));
+    }
+
+    // dead reckon all pairs as a single batch
+
+    auto profile = ocean_shared::current()->profile();
+    auto results =
+        eigenray_collection::dead_reckon(dirpaths, sources, receivers, profile);
+    auto result = results.begin();
+    for (const auto& pair : pairs) {
+        pair->update_dirpaths(*result++);
+    }
+    return true;
+}
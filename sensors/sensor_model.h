@@ -9,6 +9,7 @@
 #include <usml/managed/managed_obj.h>
 #include <usml/platforms/platform_model.h>
 #include <usml/threads/read_write_lock.h>
+#include <usml/threads/thread_task.h>
 #include <usml/transmit/transmit_model.h>
 #include <usml/types/bvector.h>
 #include <usml/types/orientation.h>
@@ -19,11 +20,13 @@
 #include <usml/usml_config.h>
 #include <usml/wavegen/wavefront_notifier.h>
 
+#include <boost/numeric/ublas/matrix.hpp>
 #include <cstddef>
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace usml {
 namespace wavegen {
@@ -144,6 +147,21 @@ class USML_DECLSPEC sensor_model : public platform_model,
     /// Maximum time to propagate wavefront (sec).
     void time_maximum(double value) { _time_maximum = value; }
 
+    /**
+     * Travel times at which partial eigenray results are published to
+     * wavefront listeners, while the wavefront is still being computed.
+     * Allows listeners to use early arrivals, like the direct path, without
+     * waiting for the wavefront to reach time_maximum. Empty by default.
+     */
+    const std::vector<double>& eigenray_checkpoints() const {
+        return _eigenray_checkpoints;
+    }
+
+    /// Travel times at which partial eigenray results are published (sec).
+    void eigenray_checkpoints(const std::vector<double>& value) {
+        _eigenray_checkpoints = value;
+    }
+
     /**
      * The value of the intensity threshold in dB. Any eigenray or eigenverb
      * with an intensity value that are weaker than this threshold is not sent
@@ -190,6 +208,19 @@ class USML_DECLSPEC sensor_model : public platform_model,
     /// Multi-static group for this sensor (0=none).
     void multistatic(uint64_t value) { _multistatic = value; }
 
+    /**
+     * Priority class for background tasks launched for this sensor. Sensor
+     * pairs use the highest priority of their source and receiver. Used to
+     * make sure that the sensors an operator is watching are updated before
+     * distant, low value sensors. Defaults to NORMAL.
+     */
+    thread_task::priority_type task_priority() const { return _task_priority; }
+
+    /// Priority class for background tasks launched for this sensor.
+    void task_priority(thread_task::priority_type value) {
+        _task_priority = value;
+    }
+
     /// Reset source beams.
     void reset_src_beams();
 
@@ -261,6 +292,24 @@ class USML_DECLSPEC sensor_model : public platform_model,
     void transmit_schedule(const transmit_list& schedule,
                            update_type_enum update_type = NO_UPDATE);
 
+    /**
+     * Compute source steerings for each pulse in a transmission schedule.
+     * Steerings in the transmission schedule are defined relative to the
+     * orientation of the host platform. But, the beam patterns need them to
+     * be specified in array coordinates. This implementation uses the
+     * orientation of the host to convert the ordered heading into world
+     * coordinates. Then it uses the orientation of the array to covert from
+     * world to array coordinates.
+     *
+     * @param schedule  List of transmit pulses for this source.
+     * @param orient    Orientation of the source array.
+     * @return          Steerings relative to the source array. The rows
+     *                  represent front, right, and up coordinates. There is
+     *                  a column for each pulse in the transmit schedule.
+     */
+    matrix<double> src_steering(const transmit_list& schedule,
+                                const orientation& orient) const;
+
     /// Reference to currently executing wavefront generator.
     std::shared_ptr<wavefront_generator>& wavefront_task() {
         return _wavefront_task;
@@ -288,6 +337,11 @@ class USML_DECLSPEC sensor_model : public platform_model,
      * Acoustics not computed if there are no eigenrays or eigenverbs to be
      * computed.
      *
+     * If the sensor is still within the dead reckoning limits defined in
+     * the motion_thresholds class, relative to the location of the last
+     * wavefront calculation, the direct paths of its sensor pairs are dead
+     * reckoned instead. See dead_reckon_pairs() for the conditions.
+     *
      * @param time          Time at which platform was updated.
      * @param pos           New location for this platform.
      * @param orient        New orientation for this platform.
@@ -304,6 +358,21 @@ class USML_DECLSPEC sensor_model : public platform_model,
      */
     std::list<platform_model::sptr> find_targets();
 
+    /**
+     * Dead reckons the direct paths of all sensor pairs that use this
+     * sensor, as either a source or a receiver, as a single batch. Pairs
+     * are updated with eigenrays adjusted for the current location of
+     * their source and receiver. Not used if this sensor computes
+     * reverberation, because eigenverbs can not be dead reckoned, or if
+     * the last wavefront calculation has not completed.
+     *
+     * @param pos       New location for this sensor.
+     * @param targets   List of acoustic targets near this sensor.
+     * @return          False if a new wavefront calculation is needed.
+     */
+    bool dead_reckon_pairs(const wposition1& pos,
+                           const std::list<platform_model::sptr>& targets);
+
    private:
     /// Type used to store list of objects.
     typedef std::map<int, bp_model::csptr> beam_map_type;
@@ -333,6 +402,9 @@ class USML_DECLSPEC sensor_model : public platform_model,
     /// Maximum time to propagate wavefront (sec).
     double _time_maximum{0.0};
 
+    /// Travel times at which partial eigenray results are published (sec).
+    std::vector<double> _eigenray_checkpoints;
+
     /**
      * The value of the intensity threshold in dB.
      * Any eigenray or eigenverb with an intensity value that are weaker
@@ -360,6 +432,9 @@ class USML_DECLSPEC sensor_model : public platform_model,
     /// Multi-static group for this sensor (0=none).
     uint64_t _multistatic{0};
 
+    /// Priority class for background tasks launched for this sensor.
+    thread_task::priority_type _task_priority{thread_task::NORMAL};
+
     /// Source beam patterns.
     beam_map_type _src_beams;
 
@@ -386,6 +461,12 @@ class USML_DECLSPEC sensor_model : public platform_model,
 
     /// Orientation of the platform at last acoustic update.
     orientation _update_orient;
+
+    /// Location of the platform at last wavefront calculation.
+    wposition1 _wavefront_position;
+
+    /// Acoustic targets used by the last wavefront calculation.
+    std::vector<uint64_t> _wavefront_targets;
 };
 
 /// @}
@@ -20,9 +20,32 @@
 
 #include <boost/numeric/ublas/matrix.hpp>
 #include <sstream>
+#include <utility>
 
 using namespace usml::sensors;
 
+namespace {
+
+/**
+ * Background task that notifies the listeners of a sensor_pair. Used when
+ * the pair is updated while the caller holds the lock of one of its
+ * sensors, so that listeners are not invoked inside that lock.
+ */
+class pair_notifier : public thread_task {
+   public:
+    /// Pair whose listeners are notified.
+    explicit pair_notifier(sensor_pair::sptr pair) : _pair(std::move(pair)) {}
+
+    /// Notifies the listeners of the pair.
+    void run() override { _pair->notify_update(_pair.get()); }
+
+   private:
+    /// Pair whose listeners are notified.
+    const sensor_pair::sptr _pair;
+};
+
+}  // namespace
+
 /**
  * Construct link between source and receiver.
  */
@@ -79,47 +102,8 @@ void sensor_pair::update_wavefront_data(
     bool notify_early{true};
     {
         write_lock_guard guard(_mutex);
-
-        // eigenray collection has eigenray list for all targets near this
-        // sensor find the eigenray list specific to this pair
-
-        auto sourceID = _source->keyID();
-        auto targetID = _receiver->keyID();
-        wposition1 source_pos(_source->position());
-        wposition1 receiver_pos(_receiver->position());
-        eigenray_list raylist = eigenrays->find_eigenrays(targetID);
-
-        // swap source/receiver sense of direct path eigenrays, if needed
-
-        if (_source != _receiver && sensor->keyID() == _receiver->keyID()) {
-            sourceID = _receiver->keyID();
-            targetID = _source->keyID();
-            source_pos = _receiver->position();
-            receiver_pos = _source->position();
-            eigenray_list new_list;
-            for (const auto& ray : eigenrays->find_eigenrays(targetID)) {
-                auto* copy = new eigenray_model(*ray);
-                std::swap(copy->source_de, copy->target_de);
-                std::swap(copy->source_az, copy->target_az);
-                new_list.push_back(eigenray_model::csptr(copy));
-            }
-            raylist = new_list;  // replace original list
-        }
-
-        // create new direct path collection with just rays for a single target
-
-        matrix<uint64_t> receiverID(1, 1);
-        receiverID(0, 0) = targetID;
-
-        auto* collection = new eigenray_collection(
-            eigenrays->frequencies(), _source->position(),
-            wposition(receiver_pos), sourceID, receiverID,
-            eigenrays->coherent());
-        for (const auto& ray : raylist) {
-            collection->add_eigenray(0, 0, ray);
-        }
-        collection->sum_eigenrays();
-        _dirpaths = eigenray_collection::csptr(collection);
+        _dirpaths = make_dirpaths(sensor, eigenrays);
+        _dirpaths_final = true;
 
         // update eigenverb contributions
 
@@ -144,9 +128,19 @@ void sensor_pair::update_wavefront_data(
                     sensor_manager::instance()->find(keyID());
                 eigenverb_collection::csptr src_verbs = _src_eigenverbs;
                 eigenverb_collection::csptr rcv_verbs = _rcv_eigenverbs;
+
+                // skip biverbs that arrive after the end of the
+                // reverberation time series
+
+                const double time_maximum =
+                    _receiver->time_maximum() +
+                    biverb_generator::time_padding(
+                        _source->transmit_schedule(),
+                        rcv_verbs->duration_maximum());
                 _biverb_task = std::make_shared<biverb_generator>(
-                    reference, src_verbs, rcv_verbs);
-                thread_controller::instance()->run(_biverb_task);
+                    reference, src_verbs, rcv_verbs, 0.0, time_maximum);
+                thread_controller::instance()->run(_biverb_task,
+                                                   task_priority());
                 _biverb_task.reset();  // destroy background task shared pointer
             }
         }
@@ -156,6 +150,45 @@ void sensor_pair::update_wavefront_data(
     }
 }
 
+/**
+ * Update direct path eigenrays using the partial results published
+ * at one of the sensor's eigenray checkpoints.
+ */
+void sensor_pair::update_eigenray_snapshot(
+    const sensor_model* sensor, eigenray_collection::csptr eigenrays) {
+    {
+        write_lock_guard guard(_mutex);
+        auto dirpaths = make_dirpaths(sensor, eigenrays);
+        if (dirpaths->view().empty()) {
+            return;
+        }
+        _dirpaths = dirpaths;
+        _dirpaths_final = false;
+    }
+    if (!_compute_reverb) {
+        notify_update(this);
+    }
+}
+
+/**
+ * Update direct path eigenrays using results that were dead reckoned
+ * from the previous direct paths.
+ */
+void sensor_pair::update_dirpaths(eigenray_collection::csptr dirpaths) {
+    {
+        write_lock_guard guard(_mutex);
+        _dirpaths = dirpaths;
+        _dirpaths_final = true;
+    }
+    if (!_compute_reverb) {
+        sensor_pair::sptr reference = sensor_manager::instance()->find(keyID());
+        if (reference != nullptr) {
+            thread_controller::instance()->run(
+                std::make_shared<pair_notifier>(reference), task_priority());
+        }
+    }
+}
+
 /**
  * Update bistatic eigenverbs using results of the biverb_generator
  * background task.
@@ -191,7 +224,7 @@ void sensor_pair::notify_update(const biverb_collection::csptr* object) {
         sensor_pair::sptr reference = sensor_manager::instance()->find(keyID());
         _rvbts_task = std::make_shared<rvbts_generator>(
             reference, _source, _receiver, treverb, _biverbs);
-        thread_controller::instance()->run(_rvbts_task);
+        thread_controller::instance()->run(_rvbts_task, task_priority());
         _rvbts_task.reset();  // destroy background task shared pointer
     }
     if (notify_early) {
@@ -217,3 +250,42 @@ void sensor_pair::notify_update(const rvbts_collection::csptr* object) {
 void sensor_pair::notify_update(const sensor_pair* object) const {
     this->update_notifier<sensor_pair>::notify_update(object);
 }
+
+/**
+ * Creates a direct path collection with just the rays for this pair.
+ */
+eigenray_collection::csptr sensor_pair::make_dirpaths(
+    const sensor_model* sensor,
+    const eigenray_collection::csptr& eigenrays) const {
+    // eigenray collection has eigenray list for all targets near this
+    // sensor find the eigenray list specific to this pair, and
+    // swap source/receiver sense of direct path eigenrays, if needed
+
+    const bool swapped =
+        _source != _receiver && sensor->keyID() == _receiver->keyID();
+    const auto targetID = swapped ? _source->keyID() : _receiver->keyID();
+    const auto view = eigenrays->find_view(targetID, swapped);
+
+    // create new direct path collection with just rays for a single
+    // target, from the source to the receiver of this pair, at the
+    // locations used to compute those rays
+
+    wposition1 source_pos(_source->position());
+    wposition1 receiver_pos(_receiver->position());
+    if (view.found) {
+        source_pos = eigenrays->source_pos();
+        receiver_pos = eigenrays->position(view.t1, view.t2);
+        if (swapped) {
+            std::swap(source_pos, receiver_pos);
+        }
+    }
+    matrix<uint64_t> receiverID(1, 1);
+    receiverID(0, 0) = _receiver->keyID();
+
+    auto* collection = new eigenray_collection(
+        eigenrays->frequencies(), source_pos, wposition(receiver_pos),
+        _source->keyID(), receiverID, eigenrays->coherent());
+    collection->add_eigenrays(0, 0, view.eigenrays);
+    collection->sum_eigenrays();
+    return eigenray_collection::csptr(collection);
+}
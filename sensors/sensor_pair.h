@@ -16,6 +16,7 @@
 #include <usml/usml_config.h>
 #include <usml/wavegen/wavefront_listener.h>
 
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <string>
@@ -95,12 +96,30 @@ class USML_DECLSPEC sensor_pair
     /// True if eigenverbs can be computed for this sensor pair.
     bool compute_reverb() const { return _compute_reverb; }
 
+    /**
+     * Priority class for background tasks launched for this pair.
+     * Uses the highest priority of the source and receiver.
+     */
+    thread_task::priority_type task_priority() const {
+        return std::max(_source->task_priority(), _receiver->task_priority());
+    }
+
     /// Direct paths that connect source and receiver locations.
     eigenray_collection::csptr dirpaths() const {
         read_lock_guard guard(_mutex);
         return _dirpaths;
     }
 
+    /**
+     * False if the direct paths are an early result, that only includes
+     * the eigenrays that arrived before one of the sensor's eigenray
+     * checkpoints. True after the wavefront calculation is complete.
+     */
+    bool dirpaths_final() const {
+        read_lock_guard guard(_mutex);
+        return _dirpaths_final;
+    }
+
     /// Interface collisions for wavefront emanating from the source.
     eigenverb_collection::csptr rcv_eigenverbs() const {
         read_lock_guard guard(_mutex);
@@ -172,6 +191,40 @@ class USML_DECLSPEC sensor_pair
         const sensor_model* sensor, eigenray_collection::csptr eigenrays,
         eigenverb_collection::csptr eigenverbs) override;
 
+    /**
+     * Update direct path eigenrays using the partial results published by
+     * the wavefront_generator at one of the sensor's eigenray checkpoints.
+     * Stores an early version of the direct paths, and marks them as not
+     * final, if the snapshot has eigenrays for this pair. Ignores snapshots
+     * that do not include this pair. Notifies sensor_pair listeners if this
+     * pair does not compute reverberation. The final direct paths are
+     * computed by update_wavefront_data().
+     *
+     * Locks the object while this update is taking place. Then unlocks the
+     * object before notifying sensor_pair listeners of the change.
+     *
+     * @param sensor		Pointer to updated sensor.
+     * @param eigenrays		Eigenrays found so far for this sensor.
+     */
+    virtual void update_eigenray_snapshot(
+        const sensor_model* sensor,
+        eigenray_collection::csptr eigenrays) override;
+
+    /**
+     * Update direct path eigenrays using results that were dead reckoned
+     * from the previous direct paths, instead of a new wavefront
+     * calculation. Notifies sensor_pair listeners if this pair does not
+     * compute reverberation.
+     *
+     * Locks the object while this update is taking place. Then queues a
+     * background task to notify sensor_pair listeners of the change,
+     * because this update is made while the sensor that moved is locked
+     * by platform_model::update().
+     *
+     * @param dirpaths  Dead reckoned direct paths for this pair.
+     */
+    void update_dirpaths(eigenray_collection::csptr dirpaths);
+
     /**
      * Update bistatic eigenverbs using results of the biverb_generator
      * background task. Stores a reference to the bistatic eigenverbs then
@@ -229,6 +282,9 @@ class USML_DECLSPEC sensor_pair
     /// Direct paths that connect source and receiver locations.
     eigenray_collection::csptr _dirpaths;
 
+    /// False if the direct paths are an early result from a checkpoint.
+    bool _dirpaths_final{true};
+
     /// Interface collisions for wavefront emanating from the source.
     eigenverb_collection::csptr _src_eigenverbs;
 
@@ -246,6 +302,20 @@ class USML_DECLSPEC sensor_pair
 
     /// Background task used to generate reverberation time series objects.
     std::shared_ptr<rvbts_generator> _rvbts_task;
+
+    /**
+     * Creates a direct path collection with just the rays for this pair,
+     * from the source to the receiver, at the locations used to compute
+     * those rays. Swaps the source/receiver sense of the eigenrays if the
+     * sensor is the receiver of a bistatic pair.
+     *
+     * @param sensor		Sensor that computed the eigenrays.
+     * @param eigenrays		Eigenrays for all targets near this sensor.
+     * @return              Summed direct paths for this pair.
+     */
+    eigenray_collection::csptr make_dirpaths(
+        const sensor_model* sensor,
+        const eigenray_collection::csptr& eigenrays) const;
 };
 
 typedef std::list<sensor_pair::sptr> pair_list;
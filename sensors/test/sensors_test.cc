@@ -11,6 +11,7 @@
 #include <usml/managed/manager_template.h>
 #include <usml/managed/update_listener.h>
 #include <usml/ocean/ocean_utils.h>
+#include <usml/platforms/motion_thresholds.h>
 #include <usml/platforms/platform_manager.h>
 #include <usml/platforms/platform_model.h>
 #include <usml/sensors/sensor_manager.h>
@@ -23,6 +24,7 @@
 #include <usml/types/seq_vector.h>
 #include <usml/types/wposition1.h>
 
+#include <atomic>
 #include <boost/test/unit_test.hpp>
 #include <iostream>
 #include <list>
@@ -41,14 +43,22 @@ BOOST_AUTO_TEST_SUITE(sensors_test)
  */
 class pair_listener : public update_listener<sensor_pair> {
    public:
+    /// Number of updates received.
+    std::atomic<size_t> count{0};
+
     /**
-     * Notify listeners of updates to sensor_pair.
+     * Notify listeners of updates to sensor_pair. Reads the position of
+     * the source, which locks it, to show that listeners are not invoked
+     * while the sensor is locked.
      *
      * @param pair  Reference to updated sensor_pair.
      */
     void notify_update(const sensor_pair* pair) override {
+        const wposition1 position = pair->source()->position();
         cout << "sensors_test::notify_update " << pair->source()->description()
-             << " -> " << pair->receiver()->description() << endl;
+             << " -> " << pair->receiver()->description()
+             << " lat=" << position.latitude() << endl;
+        ++count;
     }
 };
 pair_listener test_listener;
@@ -211,6 +221,91 @@ BOOST_AUTO_TEST_CASE(update_wavefront_data) {
     sensor_manager::reset();
 }
 
+/**
+ * Tests the ability to dead reckon direct paths for small sensor motions.
+ * Uses a simple isovelocity ocean with a 2000m depth, and two sensors that
+ * do not compute reverberation. Computes acoustics for both sensors, then
+ * moves the first sensor by more than the motion thresholds, but less than
+ * the dead reckoning limits. Then moves it again, outside of the dead
+ * reckoning limits.
+ *
+ * Test automatically fails if a new wavefront calculation is launched for
+ * the first move, if the dead reckoned direct paths do not start at the
+ * new location of the sensor, if their travel times are not updated, or
+ * if the pair listener is not notified. Also fails if a new wavefront
+ * calculation is not launched for the second move. Dead reckoning is
+ * disabled by default, so this test sets the dead reckoning limits, and
+ * then restores them.
+ */
+BOOST_AUTO_TEST_CASE(dead_reckon_pairs) {
+    cout << "=== sensors_test: dead_reckon_pairs ===" << endl;
+    motion_thresholds::dead_reckon_lat = 0.03;
+    motion_thresholds::dead_reckon_lon = 0.03;
+    motion_thresholds::dead_reckon_alt = 15.0;
+    ocean_utils::make_iso(2000.0);
+    auto* sensor_mgr = sensor_manager::instance();
+    seq_vector::csptr freq(new seq_linear(900.0, 10.0, 1000.0));
+    sensor_mgr->frequencies(freq);
+
+    auto beam = bp_model::csptr(new bp_omni());
+    sensor_model* sensors[2];
+    for (platform_model::key_type site = 1; site <= 2; ++site) {
+        std::ostringstream name;
+        name << "site" << site;
+        wposition1 position(36.0, 16.0 + 0.05 * (double)site, -100.0);
+        auto* sensor = new sensor_model(site, name.str(), 0.0, position);
+        sensor->time_maximum(10.0);
+        sensor->multistatic(1);
+        sensor->src_beam(0, beam);
+        sensor->rcv_beam(0, beam);
+        sensor_mgr->add_sensor(sensor_model::sptr(sensor), &test_listener);
+        sensors[site - 1] = sensor;
+    }
+    for (auto* sensor : sensors) {
+        sensor->update(0.0, platform_model::FORCE_UPDATE);
+    }
+    thread_task::wait();
+
+    auto pair = sensor_mgr->find_source(1).front();
+    auto old_paths = pair->dirpaths();
+    auto old_task = sensors[0]->wavefront_task();
+    BOOST_REQUIRE(old_paths != nullptr);
+    BOOST_REQUIRE(!old_paths->eigenrays().empty());
+
+    // move inside of the dead reckoning limits
+
+    wposition1 position = sensors[0]->position();
+    position.latitude(position.latitude() +
+                      0.5 * (motion_thresholds::lat_threshold +
+                             motion_thresholds::dead_reckon_lat));
+    const size_t old_count = test_listener.count;
+    sensors[0]->update(1.0, position, orientation(), 0.0);
+    thread_task::wait();
+    BOOST_CHECK_GT(test_listener.count, old_count);
+
+    auto new_paths = pair->dirpaths();
+    BOOST_CHECK(sensors[0]->wavefront_task() == old_task);
+    BOOST_CHECK(new_paths != old_paths);
+    BOOST_CHECK_CLOSE(new_paths->source_pos().latitude(),
+                      position.latitude(), 1e-10);
+    BOOST_CHECK_EQUAL(new_paths->eigenrays().size(),
+                      old_paths->eigenrays().size());
+    BOOST_CHECK_NE(new_paths->initial_time(), old_paths->initial_time());
+
+    // move outside of the dead reckoning limits
+
+    position.latitude(position.latitude() +
+                      2.0 * motion_thresholds::dead_reckon_lat);
+    sensors[0]->update(2.0, position, orientation(), 0.0);
+    thread_task::wait();
+    BOOST_CHECK(sensors[0]->wavefront_task() != old_task);
+
+    motion_thresholds::dead_reckon_lat = 0.0;
+    motion_thresholds::dead_reckon_lon = 0.0;
+    motion_thresholds::dead_reckon_alt = 0.0;
+    sensor_manager::reset();
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+/**
+ * @example studies/archive_convert/archive_convert.cc
+ */
+
+#include <usml/biverbs/biverb_collection.h>
+#include <usml/eigenrays/eigenray_collection.h>
+#include <usml/eigenverbs/eigenverb_collection.h>
+
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace usml::biverbs;
+using namespace usml::eigenrays;
+using namespace usml::eigenverbs;
+
+namespace {
+
+/**
+ * True if the filename ends with the netCDF extension.
+ */
+bool is_netcdf(const std::string& filename) {
+    return filename.size() > 3 &&
+           filename.compare(filename.size() - 3, 3, ".nc") == 0;
+}
+
+/**
+ * Name of the netCDF file for one interface of an eigenverb or biverb
+ * archive.
+ */
+std::string interface_file(const std::string& prefix, size_t interface) {
+    return prefix + std::to_string(interface) + ".nc";
+}
+
+/**
+ * Number of volume layers needed to hold a number of interfaces.
+ */
+size_t num_volumes(size_t num_interfaces) {
+    return (num_interfaces <= 2) ? 0 : (num_interfaces - 1) / 2;
+}
+
+}  // namespace
+
+/**
+ * Converts eigenrays, eigenverbs, and biverbs between netCDF files and
+ * binary archives. The direction of the conversion is determined by the
+ * extension of the first input file: files that end in ".nc" are converted
+ * to an archive, and all other files are treated as archives that are
+ * converted to netCDF.
+ *
+ * <pre>
+ * archive_convert eigenrays  input.nc output.arc
+ * archive_convert eigenrays  input.arc output.nc
+ * archive_convert eigenverbs bottom.nc surface.nc ... output.arc
+ * archive_convert eigenverbs input.arc prefix
+ * archive_convert biverbs    bottom.nc surface.nc ... output.arc
+ * archive_convert biverbs    input.arc prefix
+ * </pre>
+ *
+ * Eigenverbs and biverbs are stored in a separate netCDF file for each
+ * interface, in interface number order. When converting from an archive,
+ * the netCDF file for each interface is named by appending the interface
+ * number and ".nc" to the prefix.
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        std::cerr << "usage: " << argv[0]
+                  << " eigenrays|eigenverbs|biverbs input... output"
+                  << std::endl;
+        return 1;
+    }
+    const std::string kind = argv[1];
+    const std::vector<std::string> inputs(argv + 2, argv + argc - 1);
+    const std::string output = argv[argc - 1];
+    const bool to_archive = is_netcdf(inputs.front());
+
+    try {
+        if (kind == "eigenrays") {
+            if (to_archive) {
+                eigenray_collection::read_netcdf(inputs.front().c_str())
+                    ->write_archive(output.c_str());
+            } else {
+                eigenray_collection::read_archive(inputs.front().c_str())
+                    ->write_netcdf(output.c_str());
+            }
+        } else if (kind == "eigenverbs") {
+            eigenverb_collection collection(num_volumes(inputs.size()));
+            if (to_archive) {
+                for (size_t n = 0; n < inputs.size(); ++n) {
+                    collection.read_netcdf(inputs[n].c_str(), n);
+                }
+                collection.write_archive(output.c_str());
+            } else {
+                collection.read_archive(inputs.front().c_str());
+                for (size_t n = 0; n < collection.num_interfaces(); ++n) {
+                    collection.write_netcdf(interface_file(output, n).c_str(),
+                                            n);
+                }
+            }
+        } else if (kind == "biverbs") {
+            biverb_collection collection(num_volumes(inputs.size()));
+            if (to_archive) {
+                for (size_t n = 0; n < inputs.size(); ++n) {
+                    collection.read_netcdf(inputs[n].c_str(), n);
+                }
+                collection.write_archive(output.c_str());
+            } else {
+                collection.read_archive(inputs.front().c_str());
+                for (size_t n = 0; n < collection.num_interfaces(); ++n) {
+                    collection.write_netcdf(interface_file(output, n).c_str(),
+                                            n);
+                }
+            }
+        } else {
+            std::cerr << argv[0] << ": unknown kind " << kind << std::endl;
+            return 1;
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << argv[0] << ": " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file parallel_for.cc
+ * Splits a loop across the calling thread and the thread_controller pool.
+ */
+
+#include <usml/threads/parallel_for.h>
+#include <usml/threads/read_write_lock.h>
+#include <usml/threads/thread_controller.h>
+#include <usml/threads/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+using namespace usml::threads;
+
+namespace {
+
+/**
+ * Loop state shared between the caller and its helper tasks. Helpers only
+ * touch the loop body while they are counted in num_busy, and they can only
+ * join while the loop is open.
+ */
+struct parallel_state {
+    /// Number of indices to process.
+    std::size_t count{0};
+
+    /// Loop body, only valid while the loop is open or helpers are busy.
+    const parallel_for::body_type* body{nullptr};
+
+    /// Stops the claiming of new indices when true, ignored if null.
+    const bool* abort{nullptr};
+
+    /// Index of the next loop iteration to be claimed.
+    std::atomic<std::size_t> next{0};
+
+    /// Number of indices that have been completed.
+    std::atomic<std::size_t> completed{0};
+
+    /// Number of helpers currently executing the loop body.
+    std::size_t num_busy{0};
+
+    /// False once the caller has stopped accepting new helpers.
+    bool open{true};
+
+    /// Mutex used to lock updates to num_busy and open.
+    read_write_lock mutex;
+
+    /**
+     * Executes the loop body until there are no indices left,
+     * or the loop is aborted.
+     */
+    void work() {
+        while (abort == nullptr || !(*abort)) {
+            const std::size_t n = next++;
+            if (n >= count) {
+                break;
+            }
+            (*body)(n);
+            ++completed;
+        }
+    }
+};
+
+/**
+ * Background task that helps the caller execute a loop.
+ */
+class parallel_helper : public thread_task {
+   public:
+    /**
+     * Stores reference to the shared loop state.
+     *
+     * @param state     Loop state shared with the caller.
+     */
+    parallel_helper(std::shared_ptr<parallel_state> state)
+        : _state(std::move(state)) {}
+
+    /**
+     * Joins the loop if it is still open.
+     */
+    void run() override {
+        {
+            write_lock_guard guard(_state->mutex);
+            if (!_state->open) {
+                _done = true;
+                return;
+            }
+            ++_state->num_busy;
+        }
+        _state->work();
+        {
+            write_lock_guard guard(_state->mutex);
+            --_state->num_busy;
+        }
+        _done = true;
+    }
+
+   private:
+    /// Loop state shared with the caller.
+    std::shared_ptr<parallel_state> _state;
+};
+
+}  // namespace
+
+/**
+ * Executes a loop body for each index from 0 to count-1.
+ */
+bool parallel_for::run(std::size_t count, const body_type& body,
+                       const bool* abort, thread_task::priority_type priority,
+                       std::size_t max_threads) {
+    auto state = std::make_shared<parallel_state>();
+    state->count = count;
+    state->body = &body;
+    state->abort = abort;
+
+    // launch helpers, one less than the number of threads used
+
+    auto* pool = thread_controller::instance();
+    std::size_t num_threads = std::min(pool->num_threads(), max_threads);
+    num_threads = std::min(num_threads, count);
+    for (std::size_t n = 1; n < num_threads; ++n) {
+        pool->run(std::make_shared<parallel_helper>(state), priority);
+    }
+
+    // work on the loop in this thread, then wait for busy helpers
+
+    state->work();
+    {
+        write_lock_guard guard(state->mutex);
+        state->open = false;
+    }
+    while (true) {
+        {
+            read_lock_guard guard(state->mutex);
+            if (state->num_busy == 0) {
+                break;
+            }
+        }
+        thread_task::sleep();
+    }
+    return state->completed == count;
+}
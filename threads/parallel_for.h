@@ -0,0 +1,66 @@
+/**
+ * @file parallel_for.h
+ * Splits a loop across the calling thread and the thread_controller pool.
+ */
+#pragma once
+
+#include <usml/threads/thread_task.h>
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+
+namespace usml {
+namespace threads {
+
+/// @ingroup threads
+/// @{
+
+/**
+ * Splits a loop across the calling thread and the thread_controller pool.
+ * Used by background tasks, like biverb_generator and rvbts_generator, to
+ * split their own work into independent pieces. Each index in the loop is
+ * claimed using an atomic counter, so it is executed exactly once, by
+ * whichever thread gets to it first.
+ *
+ * The calling thread always participates in the loop. Helper tasks that
+ * have not started by the time the loop is finished exit without doing
+ * any work. This prevents deadlock when the caller is itself running in
+ * the pool, even if the pool only has a single thread.
+ *
+ * The loop body is executed by multiple threads at the same time.
+ * Each index must only write to its own section of the output.
+ */
+class USML_DECLSPEC parallel_for {
+   public:
+    /// Loop body, invoked once for each index.
+    typedef std::function<void(std::size_t)> body_type;
+
+    /**
+     * Executes a loop body for each index from 0 to count-1. Returns after
+     * all of the helper tasks have stopped using the loop body, so the body
+     * can safely refer to variables on the caller's stack.
+     *
+     * @param count         Number of indices to process.
+     * @param body          Loop body, invoked once for each index.
+     * @param abort         Stops the claiming of new indices when true,
+     *                      ignored if null. Checked before each index.
+     * @param priority      Priority class for the helper tasks.
+     * @param max_threads   Maximum number of threads, including the caller,
+     *                      used to execute the loop.
+     * @return              False if the loop was aborted before completion.
+     */
+    static bool run(
+        std::size_t count, const body_type& body, const bool* abort = nullptr,
+        thread_task::priority_type priority = thread_task::NORMAL,
+        std::size_t max_threads = std::numeric_limits<std::size_t>::max());
+
+   private:
+    /// Hide default constructor, all members are static.
+    parallel_for() {}
+};
+
+/// @}
+}  // end of namespace threads
+}  // end of namespace usml
@@ -4,17 +4,26 @@
 
 #include <bits/stdint-intn.h>
 #include <cstddef>
+#include <usml/threads/parallel_for.h>
 #include <usml/threads/read_write_lock.h>
+#include <usml/threads/thread_affinity.h>
 #include <usml/threads/thread_controller.h>
 #include <usml/threads/thread_pool.h>
 #include <usml/threads/thread_task.h>
+#include <usml/threads/thread_telemetry.h>
 #include <usml/ublas/randgen.h>
 
 #include <boost/test/unit_test.hpp>
 #include <boost/timer/timer.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(threads_test)
 
@@ -253,11 +262,168 @@ class sqrt_task_tester {
     }
 };
 
+/**
+ * Task that records the order in which tasks are executed. Optionally blocks
+ * until a gate is opened, which allows the test to fill up the queue of a
+ * thread_pool before any of the queued tasks are executed.
+ */
+class order_task : public thread_task {
+   private:
+    /** List of task IDs in the order that they were executed. */
+    std::vector<size_t>* _order;
+
+    /** Mutex used to lock updates to order list. */
+    read_write_lock* _lock;
+
+    /** Task blocks until this flag is true, ignored if null. */
+    std::atomic<bool>* _gate;
+
+   public:
+    /**
+     * Stores references to shared test data.
+     *
+     * @param order     List of task IDs in the order that they were executed.
+     * @param lock      Mutex used to lock updates to order list.
+     * @param gate      Task blocks until this flag is true, ignored if null.
+     */
+    order_task(std::vector<size_t>* order, read_write_lock* lock,
+               std::atomic<bool>* gate = nullptr)
+        : _order(order), _lock(lock), _gate(gate) {}
+
+    /**
+     * Waits for gate to open, then adds this task to the order list.
+     */
+    void run() override {
+        while (_gate != nullptr && !(*_gate)) {
+            thread_task::sleep();
+        }
+        write_lock_guard guard(*_lock);
+        _order->push_back(id());
+        _done = true;
+    }
+};
+
+/**
+ * Results shared by all of the stream_task objects in a test. Tasks update
+ * these atomics on the worker threads, and the test checks them on the main
+ * thread, because Boost.Test assertions are not thread safe.
+ */
+struct stream_stats {
+    /** Number of tasks completed. */
+    std::atomic<size_t> count{0};
+
+    /** Number of tasks that computed a positive sum. */
+    std::atomic<size_t> valid{0};
+
+    /** Largest number of CPUs that any worker was allowed to run on. */
+    std::atomic<size_t> max_cpus{0};
+};
+
+/**
+ * Task that streams repeatedly through a block of memory. Used to measure
+ * the effect of thread affinity and memory placement on throughput.
+ * In the "local" mode, the block is allocated and first touched in run(),
+ * on the worker thread. Otherwise, it is allocated and first touched in the
+ * constructor, on the thread that submits the task.
+ */
+class stream_task : public thread_task {
+   private:
+    /** Number of elements in the memory block. */
+    const size_t _size;
+
+    /** Number of passes through the memory block. */
+    const size_t _passes;
+
+    /** Memory block allocated by the submitting thread, if not local. */
+    std::vector<double> _remote;
+
+    /** Results shared by all tasks in a test. */
+    stream_stats* _stats;
+
+   public:
+    /**
+     * Allocates memory block on the submitting thread, if not local.
+     *
+     * @param size      Number of elements in the memory block.
+     * @param passes    Number of passes through the memory block.
+     * @param local     Allocate memory block on the worker thread.
+     * @param stats     Results shared by all tasks in a test.
+     */
+    stream_task(size_t size, size_t passes, bool local, stream_stats* stats)
+        : _size(size), _passes(passes), _stats(stats) {
+        if (!local) {
+            _remote.assign(_size, 1.0);
+        }
+    }
+
+    /**
+     * Sums the memory block multiple times, then records the results.
+     */
+    void run() override {
+        std::vector<double> local;
+        std::vector<double>* block = &_remote;
+        if (_remote.empty()) {
+            local.assign(_size, 1.0);
+            block = &local;
+        }
+        double sum = 0.0;
+        for (size_t pass = 0; pass < _passes && !_abort; ++pass) {
+            for (double& value : *block) {
+                value += 1e-9;
+                sum += value;
+            }
+        }
+        if (sum > 0.0) {
+            ++_stats->valid;
+        }
+        const size_t cpus = thread_affinity::allowed_cpus();
+        size_t max_cpus = _stats->max_cpus;
+        while (cpus > max_cpus &&
+               !_stats->max_cpus.compare_exchange_weak(max_cpus, cpus)) {
+        }
+        ++_stats->count;
+        _done = true;
+    }
+};
+
 /**
  * @ingroup threads_test
  * @{
  */
 
+/**
+ * Task that runs a parallel_for loop from inside the thread pool. Used to
+ * test that nested loops complete when all of the pool threads are busy.
+ */
+class nested_task : public thread_task {
+   public:
+    /**
+     * Defines the counters incremented by each index of the loop.
+     *
+     * @param counts    Number of times each index was executed.
+     */
+    nested_task(std::vector<std::atomic<size_t> >* counts) : _counts(counts) {}
+
+    /**
+     * Runs the loop and records whether it completed.
+     */
+    void run() override {
+        _complete = parallel_for::run(_counts->size(),
+                                      [this](size_t n) { ++(*_counts)[n]; });
+        _done = true;
+    }
+
+    /// True if the nested loop reported completion.
+    bool complete() const { return _complete; }
+
+   private:
+    /// Number of times each index was executed.
+    std::vector<std::atomic<size_t> >* _counts;
+
+    /// True if the nested loop reported completion.
+    bool _complete{false};
+};
+
 /**
  * Test the ability of thread_controller to schedule computationally intense
  * tasks across cores on the computer.  Does not include any automated
@@ -291,6 +457,324 @@ BOOST_AUTO_TEST_CASE(thread_controller_test) {
     #endif
 }
 
+/**
+ * Test the ability of thread_pool to execute tasks in priority order.
+ * Uses a single thread that is blocked by a gate task, while one task from
+ * each priority class is added to the queue, in order of increasing
+ * priority. Starvation protection is disabled for this test.
+ *
+ * This test passes if:
+ *   - tasks are executed in order of decreasing priority
+ *   - queue wait statistics count the number of tasks in each class
+ */
+BOOST_AUTO_TEST_CASE(thread_priority_test) {
+    cout << "=== threads_test: thread_priority_test ===" << endl;
+    std::vector<size_t> order;
+    read_write_lock lock;
+    std::atomic<bool> gate(false);
+
+    thread_pool pool(1);
+    pool.aging_time(0.0);
+    auto blocker = std::make_shared<order_task>(&order, &lock, &gate);
+    pool.run(blocker);
+    while (pool.num_queued(thread_task::NORMAL) > 0) {
+        thread_task::sleep();
+    }
+
+    std::vector<std::shared_ptr<order_task> > tasks;
+    for (size_t p = 0; p < thread_task::num_priorities; ++p) {
+        auto task = std::make_shared<order_task>(&order, &lock);
+        pool.run(task, (thread_task::priority_type)p);
+        tasks.push_back(task);
+    }
+    gate = true;
+    while (!tasks.front()->done()) {
+        thread_task::sleep();
+    }
+
+    read_lock_guard guard(lock);
+    BOOST_REQUIRE_EQUAL(order.size(), thread_task::num_priorities + 1);
+    BOOST_CHECK_EQUAL(order[0], blocker->id());
+    for (size_t n = 1; n < order.size(); ++n) {
+        BOOST_CHECK_EQUAL(order[n], tasks[order.size() - 1 - n]->id());
+    }
+    BOOST_CHECK_EQUAL(pool.statistics(thread_task::LOW).num_tasks, 1);
+    BOOST_CHECK_EQUAL(pool.statistics(thread_task::NORMAL).num_tasks, 2);
+    BOOST_CHECK_EQUAL(pool.statistics(thread_task::CRITICAL).num_tasks, 1);
+    BOOST_CHECK_GT(pool.statistics(thread_task::LOW).max_wait,
+                   pool.statistics(thread_task::CRITICAL).max_wait);
+}
+
+/**
+ * Test the ability of thread_pool to protect low priority tasks from
+ * starvation. A low priority task that has been waiting for many aging
+ * intervals must execute before a critical task that was just queued.
+ */
+BOOST_AUTO_TEST_CASE(thread_starvation_test) {
+    cout << "=== threads_test: thread_starvation_test ===" << endl;
+    std::vector<size_t> order;
+    read_write_lock lock;
+    std::atomic<bool> gate(false);
+
+    thread_pool pool(1);
+    pool.aging_time(0.01);
+    pool.run(std::make_shared<order_task>(&order, &lock, &gate));
+    while (pool.num_queued(thread_task::NORMAL) > 0) {
+        thread_task::sleep();
+    }
+
+    auto low = std::make_shared<order_task>(&order, &lock);
+    pool.run(low, thread_task::LOW);
+    thread_task::sleep(100);
+    auto critical = std::make_shared<order_task>(&order, &lock);
+    pool.run(critical, thread_task::CRITICAL);
+    gate = true;
+    while (!critical->done()) {
+        thread_task::sleep();
+    }
+
+    read_lock_guard guard(lock);
+    BOOST_REQUIRE_EQUAL(order.size(), 3);
+    BOOST_CHECK_EQUAL(order[1], low->id());
+    BOOST_CHECK_EQUAL(order[2], critical->id());
+}
+
+/**
+ * Measure the scaling of thread_pool throughput with number of threads,
+ * for each thread affinity policy, and for memory allocated on the submitting
+ * thread (remote) or on the worker thread (local). Prints the elapsed time
+ * and throughput for each configuration, so that the benefit of pinning and
+ * first touch memory placement can be evaluated on multi-socket hosts.
+ *
+ * The amount of work is the same for every thread count. Throughput is
+ * printed for information only, because wall clock rates are unreliable on
+ * loaded or shared hosts. Affinity is only checked if a probe thread is
+ * allowed to pin itself to the same CPUs or nodes as the workers, because
+ * containers often restrict the CPUs that can be used.
+ *
+ * This test passes if:
+ *   - all tasks complete and compute a valid sum for every configuration
+ *   - the NUMA topology contains at least one node and one CPU
+ *   - workers are limited to one CPU by the CORE policy, and to the CPUs
+ *     of one node by the NODE policy, if pinning is allowed
+ */
+BOOST_AUTO_TEST_CASE(thread_scaling_test) {
+    cout << "=== threads_test: thread_scaling_test ===" << endl;
+    const size_t num_tasks = 16;
+    const size_t size = 1 << 18;  // 2 MB per task
+    const size_t passes = 4;
+    const char* names[] = {"NONE", "CORE", "NODE"};
+
+    BOOST_CHECK_GE(thread_affinity::num_nodes(), 1);
+    BOOST_CHECK_GE(thread_affinity::num_cpus(), 1);
+    cout << "nodes=" << thread_affinity::num_nodes()
+         << " cpus=" << thread_affinity::num_cpus() << endl;
+
+    size_t max_node_cpus = 0;
+    for (size_t node = 0; node < thread_affinity::num_nodes(); ++node) {
+        max_node_cpus =
+            std::max(max_node_cpus, thread_affinity::node_cpus(node).size());
+    }
+
+    const unsigned max_threads =
+        std::max(1U, std::thread::hardware_concurrency());
+    for (int policy = thread_affinity::NONE; policy <= thread_affinity::NODE;
+         ++policy) {
+        const auto type = (thread_affinity::affinity_type)policy;
+        for (unsigned num_threads = 1; num_threads <= max_threads;
+             num_threads *= 2) {
+            // find out if workers can be pinned on this host
+
+            bool pinned = type != thread_affinity::NONE;
+            std::thread probe([&pinned, type, num_threads]() {
+                for (size_t n = 0; n < num_threads && pinned; ++n) {
+                    pinned = thread_affinity::pin_worker(type, n);
+                }
+            });
+            probe.join();
+
+            for (int local = 0; local < 2; ++local) {
+                stream_stats stats;
+                std::vector<thread_task::ref> tasks;
+                for (size_t n = 0; n < num_tasks; ++n) {
+                    tasks.push_back(std::make_shared<stream_task>(
+                        size, passes, local != 0, &stats));
+                }
+                const auto start = std::chrono::steady_clock::now();
+                {
+                    thread_pool pool(num_threads, type);
+                    for (const auto& task : tasks) {
+                        pool.run(task);
+                    }
+                    while (stats.count < num_tasks) {
+                        thread_task::sleep();
+                    }
+                }
+                const std::chrono::duration<double> elapsed =
+                    std::chrono::steady_clock::now() - start;
+                const double bytes =
+                    double(num_tasks * size * passes * sizeof(double));
+                const double rate = bytes / elapsed.count() / 1e9;
+                cout << "affinity=" << names[policy]
+                     << " threads=" << num_threads
+                     << " memory=" << (local ? "local " : "remote")
+                     << " time=" << elapsed.count() << " s"
+                     << " rate=" << rate << " GB/s"
+                     << " cpus=" << stats.max_cpus << endl;
+                BOOST_CHECK_EQUAL(stats.count, num_tasks);
+                BOOST_CHECK_EQUAL(stats.valid, num_tasks);
+                if (pinned && type == thread_affinity::CORE) {
+                    BOOST_CHECK_EQUAL(stats.max_cpus, 1);
+                } else if (pinned && type == thread_affinity::NODE) {
+                    BOOST_CHECK_LE(stats.max_cpus, max_node_cpus);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Test the ability of thread_pool to record the execution history of its
+ * tasks. Runs a mix of order_task and stream_task objects, with one task
+ * aborted before execution, and then exports the trace and histograms.
+ *
+ * This test passes if:
+ *   - each task type has the correct number of tasks and aborts
+ *   - each record has a consistent submit, start, and end time
+ *   - the trace is written in Chrome trace-event JSON format
+ *   - histogram bins are one decade wide
+ */
+BOOST_AUTO_TEST_CASE(thread_telemetry_test) {
+    cout << "=== threads_test: thread_telemetry_test ===" << endl;
+    BOOST_CHECK_EQUAL(thread_telemetry::bin(1e-7), 0);
+    BOOST_CHECK_EQUAL(thread_telemetry::bin(5e-6), 1);
+    BOOST_CHECK_EQUAL(thread_telemetry::bin(1.0), 7);
+    BOOST_CHECK_EQUAL(thread_telemetry::bin(1e3), 9);
+
+    std::vector<size_t> order;
+    read_write_lock lock;
+    stream_stats stats;
+
+    thread_pool pool(2);
+    pool.telemetry().enabled(true);
+    std::vector<thread_task::ref> tasks;
+    for (int n = 0; n < 4; ++n) {
+        tasks.push_back(std::make_shared<order_task>(&order, &lock));
+        tasks.push_back(std::make_shared<stream_task>(1000, 1, true, &stats));
+    }
+    tasks[0]->abort();
+    for (const auto& task : tasks) {
+        pool.run(task);
+    }
+    for (const auto& task : tasks) {
+        while (!task->done()) {
+            thread_task::sleep();
+        }
+    }
+    while (pool.telemetry().records().size() < tasks.size()) {
+        thread_task::sleep();
+    }
+
+    // check aggregate statistics
+
+    const auto hist = pool.telemetry().histograms();
+    BOOST_REQUIRE_EQUAL(hist.size(), 2);
+    const auto& order_hist = hist.at(tasks[0]->type_name());
+    const auto& stream_hist = hist.at(tasks[1]->type_name());
+    BOOST_CHECK_EQUAL(order_hist.num_tasks, 4);
+    BOOST_CHECK_EQUAL(order_hist.num_aborted, 1);
+    BOOST_CHECK_CLOSE(order_hist.abort_rate(), 0.25, 1e-6);
+    BOOST_CHECK_EQUAL(stream_hist.num_tasks, 4);
+    BOOST_CHECK_EQUAL(stream_hist.num_aborted, 0);
+    BOOST_CHECK_EQUAL(stats.valid, 4);
+    size_t total = 0;
+    for (size_t n : stream_hist.run_counts) {
+        total += n;
+    }
+    BOOST_CHECK_EQUAL(total, 4);
+
+    // check individual records
+
+    for (const auto& record : pool.telemetry().records()) {
+        BOOST_CHECK_LE(record.submit, record.start);
+        BOOST_CHECK_LE(record.start, record.end);
+        BOOST_CHECK_LT(record.worker, pool.num_threads());
+    }
+
+    // export trace and histograms
+
+    std::ostringstream trace;
+    pool.telemetry().write_trace(trace);
+    BOOST_CHECK(trace.str().find("\"traceEvents\"") != std::string::npos);
+    BOOST_CHECK(trace.str().find("\"ph\":\"X\"") != std::string::npos);
+    BOOST_CHECK(trace.str().find("stream_task") != std::string::npos);
+    std::ostringstream csv;
+    pool.telemetry().write_histograms(csv);
+    cout << csv.str();
+
+    pool.telemetry().clear();
+    BOOST_CHECK(pool.telemetry().records().empty());
+    BOOST_CHECK(pool.telemetry().histograms().empty());
+}
+
+/**
+ * Test the ability of parallel_for to split a loop across the calling
+ * thread and the thread_controller pool.
+ *
+ * This test passes if:
+ *   - every index is executed exactly once
+ *   - setting the abort flag stops the loop and reports failure
+ *   - a loop started from inside a single thread pool completes,
+ *     instead of waiting forever for helpers that can never start
+ */
+BOOST_AUTO_TEST_CASE(parallel_for_test) {
+    cout << "=== threads_test: parallel_for_test ===" << endl;
+    const size_t count = 1000;
+
+    // every index executed exactly once
+
+    std::vector<std::atomic<size_t> > counts(count);
+    BOOST_CHECK(parallel_for::run(count, [&](size_t n) { ++counts[n]; }));
+    size_t num_once = 0;
+    for (const auto& c : counts) {
+        num_once += (c == 1) ? 1 : 0;
+    }
+    BOOST_CHECK_EQUAL(num_once, count);
+
+    // abort stops the claiming of new indices
+
+    bool abort = false;
+    std::atomic<size_t> num_run(0);
+    const bool complete = parallel_for::run(
+        count,
+        [&](size_t n) {
+            ++num_run;
+            if (n == 10) {
+                abort = true;
+            }
+        },
+        &abort, thread_task::NORMAL, 1);
+    BOOST_CHECK(!complete);
+    BOOST_CHECK_EQUAL(num_run, 11);
+
+    // nested loop inside a single thread pool
+
+    thread_controller::reset(1);
+    std::vector<std::atomic<size_t> > nested(count);
+    auto task = std::make_shared<nested_task>(&nested);
+    thread_controller::instance()->run(task);
+    while (!task->done()) {
+        thread_task::sleep();
+    }
+    BOOST_CHECK(task->complete());
+    num_once = 0;
+    for (const auto& c : nested) {
+        num_once += (c == 1) ? 1 : 0;
+    }
+    BOOST_CHECK_EQUAL(num_once, count);
+    thread_controller::reset();
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
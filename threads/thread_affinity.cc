@@ -0,0 +1,230 @@
+/**
+ * @file thread_affinity.cc
+ * Processor and NUMA node placement for threads in the thread_pool.
+ */
+
+#include <usml/threads/thread_affinity.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace usml::threads;
+
+/// List of CPUs for each NUMA node.
+std::vector<std::vector<unsigned> > thread_affinity::_nodes;
+
+/// Ensures that the topology is only loaded once.
+std::once_flag thread_affinity::_loaded;
+
+/**
+ * Number of logical CPUs found in the topology.
+ */
+std::size_t thread_affinity::num_cpus() {
+    std::call_once(_loaded, load_topology);
+    std::size_t count = 0;
+    for (const auto& cpus : _nodes) {
+        count += cpus.size();
+    }
+    return count;
+}
+
+/**
+ * Number of NUMA nodes found in the topology.
+ */
+std::size_t thread_affinity::num_nodes() {
+    std::call_once(_loaded, load_topology);
+    return _nodes.size();
+}
+
+/**
+ * List of logical CPUs that belong to a NUMA node.
+ */
+std::vector<unsigned> thread_affinity::node_cpus(std::size_t node) {
+    std::call_once(_loaded, load_topology);
+    if (node >= _nodes.size()) {
+        return {};
+    }
+    return _nodes[node];
+}
+
+/**
+ * NUMA node that contains a logical CPU.
+ */
+std::size_t thread_affinity::cpu_node(unsigned cpu) {
+    std::call_once(_loaded, load_topology);
+    for (std::size_t node = 0; node < _nodes.size(); ++node) {
+        const auto& cpus = _nodes[node];
+        if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) {
+            return node;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Logical CPU assigned to a worker by the CORE policy.
+ */
+unsigned thread_affinity::worker_cpu(std::size_t worker) {
+    std::call_once(_loaded, load_topology);
+    worker %= num_cpus();
+
+    // deal workers to nodes like cards, skipping nodes that run out of CPUs
+
+    std::vector<std::size_t> used(_nodes.size(), 0);
+    std::size_t node = 0;
+    while (true) {
+        if (used[node] < _nodes[node].size()) {
+            if (worker == 0) {
+                return _nodes[node][used[node]];
+            }
+            ++used[node];
+            --worker;
+        }
+        node = (node + 1) % _nodes.size();
+    }
+}
+
+/**
+ * Pins the calling thread using a placement policy.
+ */
+bool thread_affinity::pin_worker(affinity_type policy, std::size_t worker) {
+    switch (policy) {
+        case CORE:
+            return pin_cpu(worker_cpu(worker));
+        case NODE:
+            return pin_node(worker_node(worker));
+        default:
+            return true;
+    }
+}
+
+/**
+ * Pins the calling thread to a single logical CPU.
+ */
+bool thread_affinity::pin_cpu(unsigned cpu) {
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Pins the calling thread to all of the CPUs on a NUMA node.
+ */
+bool thread_affinity::pin_node(std::size_t node) {
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (unsigned cpu : node_cpus(node)) {
+        CPU_SET(cpu, &mask);
+    }
+    if (CPU_COUNT(&mask) == 0) {
+        return false;
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * NUMA node of the CPU that is currently executing the calling thread.
+ */
+std::size_t thread_affinity::current_node() {
+#ifdef __linux__
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return cpu_node((unsigned)cpu);
+    }
+#endif
+    return 0;
+}
+
+/**
+ * Number of logical CPUs that the calling thread is allowed to run on.
+ */
+std::size_t thread_affinity::allowed_cpus() {
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask) == 0) {
+        return (std::size_t)CPU_COUNT(&mask);
+    }
+#endif
+    return 0;
+}
+
+/**
+ * Reads the CPU to node mapping from the operating system.
+ */
+void thread_affinity::load_topology() {
+    _nodes.clear();
+
+    // read the CPU list for each node until a node is missing
+
+    for (std::size_t node = 0;; ++node) {
+        std::ostringstream filename;
+        filename << "/sys/devices/system/node/node" << node << "/cpulist";
+        std::ifstream file(filename.str());
+        if (!file) {
+            break;
+        }
+        std::string text;
+        std::getline(file, text);
+        _nodes.push_back(parse_cpulist(text));
+    }
+
+    // remove nodes without CPUs, like memory only nodes
+
+    _nodes.erase(std::remove_if(_nodes.begin(), _nodes.end(),
+                                [](const std::vector<unsigned>& cpus) {
+                                    return cpus.empty();
+                                }),
+                 _nodes.end());
+
+    // fall back to a single node with every CPU
+
+    if (_nodes.empty()) {
+        unsigned count = std::max(1U, std::thread::hardware_concurrency());
+        std::vector<unsigned> cpus(count);
+        for (unsigned cpu = 0; cpu < count; ++cpu) {
+            cpus[cpu] = cpu;
+        }
+        _nodes.push_back(cpus);
+    }
+}
+
+/**
+ * Parses a Linux CPU list string into CPU numbers.
+ */
+std::vector<unsigned> thread_affinity::parse_cpulist(const std::string& text) {
+    std::vector<unsigned> cpus;
+    std::istringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range[0] < '0' || range[0] > '9') {
+            continue;
+        }
+        const std::size_t dash = range.find('-');
+        const auto first = (unsigned)std::stoul(range.substr(0, dash));
+        const auto last = (dash == std::string::npos)
+                              ? first
+                              : (unsigned)std::stoul(range.substr(dash + 1));
+        for (unsigned cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
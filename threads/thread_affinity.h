@@ -0,0 +1,158 @@
+/**
+ * @file thread_affinity.h
+ * Processor and NUMA node placement for threads in the thread_pool.
+ */
+#pragma once
+
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace usml {
+namespace threads {
+
+/// @ingroup threads
+/// @{
+
+/**
+ * Processor and NUMA node placement for threads in the thread_pool.
+ * Discovers the mapping of logical CPUs to Non-Uniform Memory Access (NUMA)
+ * nodes and pins the calling thread to a specific CPU or node. On multi-socket
+ * hosts, this keeps the memory that a task allocates close to the processor
+ * that uses it.
+ *
+ * Memory placement relies on the "first touch" policy of the operating system:
+ * physical pages are allocated on the node of the thread that first writes to
+ * them. Tasks that allocate and initialize their working memory, like the
+ * wave_queue buffers in wavefront_generator, inside their run() method will
+ * automatically have that memory placed on the executing worker's node when
+ * the thread_pool pins its workers. Memory allocated in the constructor of the
+ * task is placed on the node of the thread that submitted it.
+ *
+ * The topology is read from /sys/devices/system/node on Linux. Other
+ * platforms, and Linux hosts without this information, are treated as a
+ * single node that contains all of the CPUs. Pinning is a no-op on platforms
+ * that do not support it.
+ */
+class USML_DECLSPEC thread_affinity {
+   public:
+    /**
+     * Placement policies for the workers in a thread_pool.
+     *
+     *  - NONE lets the operating system schedule workers on any CPU.
+     *  - CORE pins each worker to a single CPU.
+     *  - NODE pins each worker to all of the CPUs on a single NUMA node.
+     *
+     * In the CORE and NODE policies, workers are distributed round-robin
+     * across NUMA nodes, so that small pools still use the memory bandwidth
+     * of every socket.
+     */
+    typedef enum { NONE = 0, CORE = 1, NODE = 2 } affinity_type;
+
+    /// Number of logical CPUs found in the topology.
+    static std::size_t num_cpus();
+
+    /// Number of NUMA nodes found in the topology, at least one.
+    static std::size_t num_nodes();
+
+    /**
+     * List of logical CPUs that belong to a NUMA node.
+     *
+     * @param node      NUMA node number.
+     * @return          CPU numbers for this node, empty if node not found.
+     */
+    static std::vector<unsigned> node_cpus(std::size_t node);
+
+    /**
+     * NUMA node that contains a logical CPU.
+     *
+     * @param cpu       Logical CPU number.
+     * @return          Node number, zero if cpu not found.
+     */
+    static std::size_t cpu_node(unsigned cpu);
+
+    /**
+     * Logical CPU assigned to a worker by the CORE policy. Walks across the
+     * nodes round-robin, and then through the CPUs within each node.
+     *
+     * @param worker    Index of the worker in the thread_pool.
+     */
+    static unsigned worker_cpu(std::size_t worker);
+
+    /**
+     * NUMA node assigned to a worker by the CORE and NODE policies.
+     *
+     * @param worker    Index of the worker in the thread_pool.
+     */
+    static std::size_t worker_node(std::size_t worker) {
+        return worker % num_nodes();
+    }
+
+    /**
+     * Pins the calling thread using a placement policy.
+     *
+     * @param policy    Placement policy to apply.
+     * @param worker    Index of the worker in the thread_pool.
+     * @return          True if the operating system accepted the request.
+     */
+    static bool pin_worker(affinity_type policy, std::size_t worker);
+
+    /**
+     * Pins the calling thread to a single logical CPU.
+     *
+     * @param cpu       Logical CPU number.
+     * @return          True if the operating system accepted the request.
+     */
+    static bool pin_cpu(unsigned cpu);
+
+    /**
+     * Pins the calling thread to all of the CPUs on a NUMA node.
+     *
+     * @param node      NUMA node number.
+     * @return          True if the operating system accepted the request.
+     */
+    static bool pin_node(std::size_t node);
+
+    /**
+     * NUMA node of the CPU that is currently executing the calling thread.
+     * Returns zero if this information is not available.
+     */
+    static std::size_t current_node();
+
+    /**
+     * Number of logical CPUs that the calling thread is allowed to run on.
+     * Returns zero if this information is not available.
+     */
+    static std::size_t allowed_cpus();
+
+   private:
+    /**
+     * Reads the CPU to node mapping from the operating system.
+     * Invoked once, on first use of the topology.
+     */
+    static void load_topology();
+
+    /**
+     * Parses a Linux CPU list string, like "0-3,8-11", into CPU numbers.
+     *
+     * @param text      CPU list to be parsed.
+     * @return          List of CPU numbers.
+     */
+    static std::vector<unsigned> parse_cpulist(const std::string& text);
+
+    /// List of CPUs for each NUMA node.
+    static std::vector<std::vector<unsigned> > _nodes;
+
+    /// Ensures that the topology is only loaded once.
+    static std::once_flag _loaded;
+
+    /// Hide default constructor, all members are static.
+    thread_affinity() {}
+};
+
+/// @}
+}  // end of namespace threads
+}  // end of namespace usml
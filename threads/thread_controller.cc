@@ -14,6 +14,13 @@ using namespace usml::threads;
  */
 unsigned thread_controller::_num_threads = std::thread::hardware_concurrency();
 
+/**
+ * Placement policy for worker threads in thread_pool.
+ * Defaults to no affinity.
+ */
+thread_affinity::affinity_type thread_controller::_affinity =
+    thread_affinity::NONE;
+
 /// Reference to the thread_pool owned by this singleton.
 std::unique_ptr<thread_pool> thread_controller::_instance;
 
@@ -30,7 +37,7 @@ thread_pool* thread_controller::instance() {
         write_lock_guard guard(_instance_mutex);
         pool = _instance.get();
         if (pool == nullptr) {
-            pool = new thread_pool(_num_threads);
+            pool = new thread_pool(_num_threads, _affinity);
             _instance.reset(pool);
         }
     }
@@ -40,9 +47,11 @@ thread_pool* thread_controller::instance() {
 /**
  * Reset the thread_controller to empty.
  */
-void thread_controller::reset(unsigned num_threads) {
+void thread_controller::reset(unsigned num_threads,
+                              thread_affinity::affinity_type affinity) {
     write_lock_guard guard(_instance_mutex);
     _num_threads = num_threads;
-    auto* pool = new thread_pool(_num_threads);
+    _affinity = affinity;
+    auto* pool = new thread_pool(_num_threads, _affinity);
     _instance.reset(pool);
 }
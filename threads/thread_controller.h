@@ -5,6 +5,7 @@
 #pragma once
 
 #include <usml/threads/read_write_lock.h>
+#include <usml/threads/thread_affinity.h>
 #include <usml/usml_config.h>
 
 #include <memory>
@@ -42,9 +43,11 @@ class USML_DECLSPEC thread_controller {
      *
      * @param num_threads Number of threads used next time controller is
      * initialized.
+     * @param affinity    Placement policy for worker threads.
      */
     static void reset(
-        unsigned num_threads = std::thread::hardware_concurrency());
+        unsigned num_threads = std::thread::hardware_concurrency(),
+        thread_affinity::affinity_type affinity = thread_affinity::NONE);
 
    private:
     /**
@@ -53,6 +56,12 @@ class USML_DECLSPEC thread_controller {
      */
     static unsigned _num_threads;
 
+    /**
+     * Placement policy for worker threads in thread_pool.
+     * Defaults to no affinity.
+     */
+    static thread_affinity::affinity_type _affinity;
+
     /// Reference to the thread_pool owned by this singleton.
     static std::unique_ptr<thread_pool> _instance;
 
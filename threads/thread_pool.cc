@@ -5,8 +5,10 @@
 
 #include <usml/threads/thread_pool.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -18,30 +20,34 @@ using namespace std::chrono_literals;
  * Creates a new thread pool with a specific number of threads.
  *
  */
-thread_pool::thread_pool(unsigned num_threads) {
+thread_pool::thread_pool(unsigned num_threads,
+                         thread_affinity::affinity_type affinity)
+    : _affinity(affinity) {
     assert(num_threads != 0);
 
     // Use a lambda expression to create an infinite loop that
     // checks for (and then executes) new entries in the _task_queue
-    // until _running is false.
+    // until _running is false. Each worker pins itself before taking
+    // any tasks, so that the memory it touches is allocated locally.
 
-    auto worker = [this] {
+    auto worker = [this](unsigned index) {
+        thread_affinity::pin_worker(_affinity, index);
         while (this->_running) {
             // find the next task in the queue
 
             thread_task::ref task;
             {
                 write_lock_guard guard(_task_mutex);
-                if (!_task_queue.empty()) {
-                    task = _task_queue.front();
-                    _task_queue.pop();
-                }
+                task = next_task();
             }
 
             // run this task or wait for a short time
 
             if (task != nullptr) {
-                task->start();
+                task->start(index);
+                if (_telemetry.enabled()) {
+                    record(task);
+                }
             } else {
                 thread_task::sleep();
             }
@@ -51,15 +57,16 @@ thread_pool::thread_pool(unsigned num_threads) {
     // create a list of threads using this worker
 
     for (unsigned n = 0; n < num_threads; ++n) {
-        _thread_list.emplace_back(worker);
+        _thread_list.emplace_back(worker, n);
     }
 }
 
 /**
  * Stop the scheduler and terminate the threads used to execute tasks.
+ * The queue is not locked while joining, because workers need to lock it
+ * before they can observe that _running is false.
  */
 thread_pool::~thread_pool() {
-    write_lock_guard guard(_task_mutex);
     this->_running = false;
     for (auto& thread : _thread_list) {
         thread.join();
@@ -67,9 +74,104 @@ thread_pool::~thread_pool() {
 }
 
 /**
- * Adds a task to the scheduler.
+ * Adds a task to the scheduler using the task's own priority class.
  */
 void thread_pool::run(const thread_task::ref& task) {
     write_lock_guard guard(_task_mutex);
-    _task_queue.push(task);
+    task->_submit_time = std::chrono::steady_clock::now();
+    _task_queue[task->priority()].push(task);
+}
+
+/**
+ * Assigns a new priority class to a task, and then adds it to the scheduler.
+ */
+void thread_pool::run(const thread_task::ref& task,
+                      thread_task::priority_type priority) {
+    task->priority(priority);
+    run(task);
+}
+
+/**
+ * Number of tasks waiting for execution in a specific priority class.
+ */
+std::size_t thread_pool::num_queued(
+    thread_task::priority_type priority) const {
+    read_lock_guard guard(_task_mutex);
+    return _task_queue[priority].size();
+}
+
+/**
+ * Queue wait statistics for a specific priority class.
+ */
+thread_pool::queue_stats thread_pool::statistics(
+    thread_task::priority_type priority) const {
+    read_lock_guard guard(_task_mutex);
+    return _stats[priority];
+}
+
+/**
+ * Reset queue wait statistics for all priority classes.
+ */
+void thread_pool::reset_statistics() {
+    write_lock_guard guard(_task_mutex);
+    _stats.fill(queue_stats());
+}
+
+/**
+ * Removes the next task to execute from the priority lanes.
+ */
+thread_task::ref thread_pool::next_task() {
+    const auto now = std::chrono::steady_clock::now();
+
+    // search for the lane with the highest effective priority
+    // only the front of each lane needs to be tested, because it has
+    // been waiting the longest
+
+    std::size_t lane = thread_task::num_priorities;
+    double best = -1.0;
+    for (std::size_t p = 0; p < thread_task::num_priorities; ++p) {
+        if (_task_queue[p].empty()) {
+            continue;
+        }
+        double score = (double)p;
+        if (_aging_time > 0.0) {
+            const std::chrono::duration<double> wait =
+                now - _task_queue[p].front()->_submit_time;
+            score += wait.count() / _aging_time;
+        }
+        if (score >= best) {
+            best = score;
+            lane = p;
+        }
+    }
+    if (lane >= thread_task::num_priorities) {
+        return nullptr;
+    }
+
+    // remove task from its lane and update wait statistics
+
+    thread_task::ref task = _task_queue[lane].front();
+    _task_queue[lane].pop();
+    const std::chrono::duration<double> wait = now - task->_submit_time;
+    queue_stats& stats = _stats[lane];
+    ++stats.num_tasks;
+    stats.total_wait += wait.count();
+    stats.max_wait = std::max(stats.max_wait, wait.count());
+    return task;
+}
+
+/**
+ * Adds the execution history of a completed task to the telemetry.
+ */
+void thread_pool::record(const thread_task::ref& task) {
+    thread_telemetry::task_record record;
+    record.type = task->type_name();
+    record.id = task->id();
+    record.priority = (int)task->priority();
+    record.worker = task->worker();
+    record.submit = _telemetry.elapsed(task->submit_time());
+    record.start = _telemetry.elapsed(task->start_time());
+    record.end = _telemetry.elapsed(task->end_time());
+    record.aborted = task->_abort;
+    _telemetry.add(record);
 }
@@ -5,10 +5,14 @@
 #pragma once
 
 #include <usml/threads/read_write_lock.h>
+#include <usml/threads/thread_affinity.h>
 #include <usml/threads/thread_task.h>
+#include <usml/threads/thread_telemetry.h>
 #include <usml/usml_config.h>
 
+#include <array>
 #include <atomic>
+#include <cstddef>
 #include <queue>
 #include <thread>
 #include <vector>
@@ -25,18 +29,59 @@ namespace threads {
  * simultaneously on a specific computer. It also avoids the overhead
  * associated with starting each task on its own thread.
  *
+ * Tasks are queued in a separate first-in/first-out lane for each
+ * thread_task::priority_type. Idle threads take the next task from the
+ * highest priority lane that is not empty. To prevent starvation, the
+ * effective priority of the task at the front of each lane increases by one
+ * class for each aging_time() interval that it has been waiting. This allows
+ * low priority tasks to eventually run, even when the pool is saturated with
+ * high priority work. The pool also accumulates queue wait statistics for
+ * each priority class.
+ *
+ * Workers can optionally be pinned to individual cores or NUMA nodes using
+ * a thread_affinity::affinity_type policy. Combined with the operating
+ * system's first touch memory policy, this keeps the working memory that a
+ * task allocates in its run() method on the same node as the worker that
+ * executes it.
+ *
+ * When telemetry() is enabled, the pool records the execution history of
+ * every task, which can be exported as a Chrome trace or as per-type
+ * histograms of queue wait and run time.
+ *
  * @xref Vorbrodt's C++ Blog: Advanced thread pool
  *       Posted on February 27, 2019 by Martin Vorbrodt
  *       https://vorbrodt.blog/2019/02/27/advanced-thread-pool/
  */
 class USML_DECLSPEC thread_pool {
    public:
+    /**
+     * Queue wait statistics for a single priority class.
+     */
+    struct queue_stats {
+        /// Number of tasks removed from the queue for execution.
+        std::size_t num_tasks{0};
+
+        /// Sum of the time that these tasks spent in the queue (sec).
+        double total_wait{0.0};
+
+        /// Longest time that any of these tasks spent in the queue (sec).
+        double max_wait{0.0};
+
+        /// Average time that these tasks spent in the queue (sec).
+        double mean_wait() const {
+            return (num_tasks == 0) ? 0.0 : total_wait / (double)num_tasks;
+        }
+    };
+
     /**
      * Creates a new thread pool with a specific number of threads.
      *
      * @param num_threads   Number of threads used to execute tasks.
+     * @param affinity      Placement policy for worker threads.
      */
-    thread_pool(unsigned num_threads = std::thread::hardware_concurrency());
+    thread_pool(
+        unsigned num_threads = std::thread::hardware_concurrency(),
+        thread_affinity::affinity_type affinity = thread_affinity::NONE);
 
     /**
      * Stop the scheduler and terminate the threads used to execute tasks.
@@ -44,7 +89,7 @@ class USML_DECLSPEC thread_pool {
     ~thread_pool();
 
     /**
-     * Adds a task to the scheduler.
+     * Adds a task to the scheduler using the task's own priority class.
      * This allows the calling program to invoke the abort() method,
      * on the shared reference, without fear that the scheduler has already
      * disposed of the task object. The task object is deleted when both the
@@ -54,15 +99,109 @@ class USML_DECLSPEC thread_pool {
      */
     void run(const thread_task::ref& task);
 
+    /**
+     * Assigns a new priority class to a task, and then adds it to
+     * the scheduler.
+     *
+     * @param task      Shared pointer to the task to be executed
+     * @param priority  Priority class for this task.
+     */
+    void run(const thread_task::ref& task,
+             thread_task::priority_type priority);
+
+    /// Number of threads used to execute tasks.
+    std::size_t num_threads() const { return _thread_list.size(); }
+
+    /// Placement policy for worker threads.
+    thread_affinity::affinity_type affinity() const { return _affinity; }
+
+    /**
+     * Number of tasks waiting for execution in a specific priority class.
+     *
+     * @param priority  Priority class to query.
+     */
+    std::size_t num_queued(thread_task::priority_type priority) const;
+
+    /**
+     * Time interval after which a waiting task is promoted by one priority
+     * class (sec). Set to zero to disable starvation protection.
+     * Defaults to 1.0 seconds.
+     */
+    double aging_time() const {
+        read_lock_guard guard(_task_mutex);
+        return _aging_time;
+    }
+
+    /**
+     * Time interval after which a waiting task is promoted by one priority
+     * class (sec).
+     *
+     * @param value     New aging interval (sec), zero disables aging.
+     */
+    void aging_time(double value) {
+        write_lock_guard guard(_task_mutex);
+        _aging_time = value;
+    }
+
+    /**
+     * Queue wait statistics for a specific priority class.
+     *
+     * @param priority  Priority class to query.
+     */
+    queue_stats statistics(thread_task::priority_type priority) const;
+
+    /**
+     * Reset queue wait statistics for all priority classes.
+     */
+    void reset_statistics();
+
+    /// Execution history of tasks in this pool, disabled by default.
+    thread_telemetry& telemetry() { return _telemetry; }
+
+    /// Execution history of tasks in this pool, disabled by default.
+    const thread_telemetry& telemetry() const { return _telemetry; }
+
    private:
+    /**
+     * Removes the next task to execute from the priority lanes. Selects the
+     * lane whose front task has the highest effective priority, where
+     * effective priority is the priority class plus the number of
+     * aging_time() intervals that the task has been waiting.  Ties go to the
+     * higher priority class. Updates queue wait statistics for the lane.
+     * Caller must hold a write lock on _task_mutex.
+     *
+     * @return  Next task to execute, nullptr if all lanes are empty.
+     */
+    thread_task::ref next_task();
+
+    /**
+     * Adds the execution history of a completed task to the telemetry.
+     *
+     * @param task      Task that has just finished executing.
+     */
+    void record(const thread_task::ref& task);
+
     /// List of threads that execute the tasks.
     std::vector<std::thread> _thread_list;
 
-    /// Queue of the tasks to execute.
-    std::queue<thread_task::ref> _task_queue;
+    /// Placement policy for worker threads.
+    const thread_affinity::affinity_type _affinity;
+
+    /// Queue of the tasks to execute for each priority class.
+    std::array<std::queue<thread_task::ref>, thread_task::num_priorities>
+        _task_queue;
+
+    /// Queue wait statistics for each priority class.
+    std::array<queue_stats, thread_task::num_priorities> _stats;
+
+    /// Interval after which waiting tasks are promoted (sec).
+    double _aging_time{1.0};
+
+    /// Execution history of tasks in this pool.
+    thread_telemetry _telemetry;
 
     /// Mutex used to lock updates to the the task queue.
-    read_write_lock _task_mutex;
+    mutable read_write_lock _task_mutex;
 
     /// Flag that controls execution of thread loop.
     std::atomic<bool> _running = true;
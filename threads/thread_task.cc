@@ -6,8 +6,14 @@
 #include <bits/exception.h>
 #include <usml/threads/thread_task.h>
 
+#include <cstdlib>
 #include <iostream>
 #include <limits>
+#include <typeinfo>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
 
 using namespace usml::threads;
 using namespace std;
@@ -32,10 +38,29 @@ thread_task::thread_task() {
     ++_num_active;
 }
 
+/**
+ * Human readable name for the type of this task.
+ */
+std::string thread_task::type_name() const {
+    const char* name = typeid(*this).name();
+#ifdef __GNUG__
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr) {
+        std::string result(demangled);
+        std::free(demangled);
+        return result;
+    }
+#endif
+    return name;
+}
+
 /**
  * Initiates a task in the thread pool.
  */
-void thread_task::start() {
+void thread_task::start(std::size_t worker) {
+    _worker = worker;
+    _start_time = std::chrono::steady_clock::now();
     try {
         run();  // invoke the user's version of this task
     } catch (std::exception& ex) {
@@ -43,6 +68,7 @@ void thread_task::start() {
     } catch (...) {
         cerr << "Uncaught exception in thread_task" << endl;
     }
+    _end_time = std::chrono::steady_clock::now();
     // After run is completed decrement number of active tasks counter.
     --_num_active;
 }
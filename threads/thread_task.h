@@ -12,6 +12,7 @@
 #include <cstddef>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <thread>
 
 namespace usml {
@@ -42,6 +43,16 @@ class thread_pool;
  * created. Sub-classes are responsible for catching their own exceptions.
  * Exceptions that are not caught by the sub-class are ignored.
  * This prevents uncaught exceptions from crashing the thread_pool.
+ *
+ * Each task is assigned to one of the priority classes in #priority_type
+ * before it is submitted to the thread_pool. Tasks in higher priority classes
+ * are executed before tasks in lower classes. The submitter is responsible for
+ * choosing the priority, based on things like the task type or the range of a
+ * sensor from the area of interest.
+ *
+ * The thread_pool stamps each task with the time that it was submitted,
+ * started, and ended, along with the index of the worker that executed it.
+ * These are used by thread_telemetry to trace the execution of the pool.
  */
 class USML_DECLSPEC thread_task {
     friend class thread_pool;
@@ -50,6 +61,15 @@ class USML_DECLSPEC thread_task {
     /// Shared reference to this task.
     typedef std::shared_ptr<thread_task> ref;
 
+    /**
+     * Priority classes used by the thread_pool to order the execution of
+     * tasks. Each class is serviced as a separate first-in/first-out lane.
+     */
+    typedef enum { LOW = 0, NORMAL = 1, HIGH = 2, CRITICAL = 3 } priority_type;
+
+    /// Number of priority classes in priority_type.
+    static constexpr std::size_t num_priorities = 4;
+
     /**
      * Default constructor, assigns a new id to this task.
      * Creates a sequential task ID number for each new task as it is created.
@@ -70,6 +90,44 @@ class USML_DECLSPEC thread_task {
      */
     std::size_t id() const { return _id; }
 
+    /**
+     * Priority class used to schedule this task in the thread_pool.
+     * Defaults to NORMAL.
+     */
+    priority_type priority() const { return _priority; }
+
+    /**
+     * Priority class used to schedule this task in the thread_pool.
+     * Has no effect once the task has been submitted to the thread_pool.
+     *
+     * @param value     New priority class for this task.
+     */
+    void priority(priority_type value) { _priority = value; }
+
+    /**
+     * Human readable name for the type of this task. Used to group tasks
+     * in thread_telemetry. Defaults to the demangled name of the sub-class.
+     */
+    virtual std::string type_name() const;
+
+    /// Time at which this task was added to the thread_pool queue.
+    std::chrono::steady_clock::time_point submit_time() const {
+        return _submit_time;
+    }
+
+    /// Time at which this task started to execute.
+    std::chrono::steady_clock::time_point start_time() const {
+        return _start_time;
+    }
+
+    /// Time at which this task finished executing.
+    std::chrono::steady_clock::time_point end_time() const {
+        return _end_time;
+    }
+
+    /// Index of the thread_pool worker that executed this task.
+    std::size_t worker() const { return _worker; }
+
     /**
      * Sub-classes overload this operator with the task to be executed.
      * Tasks should terminate, as soon as possible, when #_abort is true.
@@ -130,9 +188,12 @@ class USML_DECLSPEC thread_task {
     /**
      * Safely initiates a task in the thread pool.
      * Traps uncaught exceptions to prevent thread_pool from crashing.
+     * Records the start and end times of the task.
      * Decrements the number of active tasks when the task is finished.
+     *
+     * @param worker    Index of the worker that executes this task.
      */
-    void start();
+    void start(std::size_t worker = 0);
 
     /// Next identification number to be assigned to a task.
     static std::atomic<std::size_t> _id_next;
@@ -142,6 +203,21 @@ class USML_DECLSPEC thread_task {
 
     /// Automatically assigned identification number for this task.
     std::size_t _id;
+
+    /// Priority class used to schedule this task in the thread_pool.
+    priority_type _priority{NORMAL};
+
+    /// Time at which this task was added to the thread_pool queue.
+    std::chrono::steady_clock::time_point _submit_time;
+
+    /// Time at which this task started to execute.
+    std::chrono::steady_clock::time_point _start_time;
+
+    /// Time at which this task finished executing.
+    std::chrono::steady_clock::time_point _end_time;
+
+    /// Index of the thread_pool worker that executed this task.
+    std::size_t _worker{0};
 };
 
 /// @}
@@ -0,0 +1,187 @@
+/**
+ * @file thread_telemetry.cc
+ * Records the execution history of tasks in the thread_pool.
+ */
+
+#include <usml/threads/thread_telemetry.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+using namespace usml::threads;
+
+namespace {
+
+/**
+ * Writes a string as a JSON string literal, escaping special characters.
+ */
+void write_json_string(std::ostream& stream, const std::string& text) {
+    stream << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"':
+                stream << "\\\"";
+                break;
+            case '\\':
+                stream << "\\\\";
+                break;
+            case '\n':
+                stream << "\\n";
+                break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    stream << ' ';
+                } else {
+                    stream << c;
+                }
+        }
+    }
+    stream << '"';
+}
+
+}  // namespace
+
+/**
+ * Creates an empty, disabled, telemetry recorder.
+ */
+thread_telemetry::thread_telemetry(std::size_t max_records)
+    : _epoch(std::chrono::steady_clock::now()), _max_records(max_records) {}
+
+/**
+ * Maximum number of task records kept for the trace.
+ */
+void thread_telemetry::max_records(std::size_t value) {
+    write_lock_guard guard(_mutex);
+    _max_records = value;
+    while (_records.size() > _max_records) {
+        _records.pop_front();
+    }
+}
+
+/**
+ * Adds the execution history for a task to the trace and histograms.
+ */
+void thread_telemetry::add(const task_record& record) {
+    const double wait = std::max(0.0, record.wait_time());
+    const double run = std::max(0.0, record.run_time());
+
+    write_lock_guard guard(_mutex);
+    if (_max_records > 0) {
+        if (_records.size() >= _max_records) {
+            _records.pop_front();
+        }
+        _records.push_back(record);
+    }
+
+    task_histogram& hist = _histograms[record.type];
+    ++hist.num_tasks;
+    if (record.aborted) {
+        ++hist.num_aborted;
+    }
+    hist.total_wait += wait;
+    hist.max_wait = std::max(hist.max_wait, wait);
+    hist.total_run += run;
+    hist.max_run = std::max(hist.max_run, run);
+    ++hist.wait_counts[bin(wait)];
+    ++hist.run_counts[bin(run)];
+}
+
+/**
+ * Removes all task records and aggregate statistics.
+ */
+void thread_telemetry::clear() {
+    write_lock_guard guard(_mutex);
+    _records.clear();
+    _histograms.clear();
+}
+
+/**
+ * Histogram bin for a time interval.
+ */
+std::size_t thread_telemetry::bin(double seconds) {
+    if (!(seconds >= 1e-6)) {
+        return 0;
+    }
+    const auto n = (long)std::floor(std::log10(seconds)) + 7;
+    return (std::size_t)std::min(n, (long)num_bins - 1);
+}
+
+/**
+ * Writes the trace in Chrome trace-event JSON format. Times are written in
+ * microseconds, as required by the format. The queue wait time and other
+ * task attributes are stored in the "args" of each event.
+ */
+void thread_telemetry::write_trace(std::ostream& stream) const {
+    read_lock_guard guard(_mutex);
+    stream << std::fixed << std::setprecision(3);
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& record : _records) {
+        stream << (first ? "\n" : ",\n");
+        first = false;
+        stream << "{\"name\":";
+        write_json_string(stream, record.type);
+        stream << ",\"cat\":\"task\",\"ph\":\"X\",\"pid\":0"
+               << ",\"tid\":" << record.worker
+               << ",\"ts\":" << record.start * 1e6
+               << ",\"dur\":" << record.run_time() * 1e6
+               << ",\"args\":{\"id\":" << record.id
+               << ",\"priority\":" << record.priority
+               << ",\"submit_us\":" << record.submit * 1e6
+               << ",\"wait_us\":" << record.wait_time() * 1e6
+               << ",\"aborted\":" << (record.aborted ? "true" : "false")
+               << "}}";
+    }
+    stream << "\n]}\n";
+}
+
+/**
+ * Writes the trace in Chrome trace-event JSON format.
+ */
+void thread_telemetry::write_trace(const char* filename) const {
+    std::ofstream stream(filename);
+    write_trace(stream);
+}
+
+/**
+ * Writes the aggregate statistics as comma separated values.
+ */
+void thread_telemetry::write_histograms(std::ostream& stream) const {
+    read_lock_guard guard(_mutex);
+    stream << "type,num_tasks,num_aborted,abort_rate,"
+           << "mean_wait,max_wait,mean_run,max_run";
+    for (std::size_t n = 0; n < num_bins; ++n) {
+        stream << ",wait_" << n;
+    }
+    for (std::size_t n = 0; n < num_bins; ++n) {
+        stream << ",run_" << n;
+    }
+    stream << std::endl;
+
+    for (const auto& entry : _histograms) {
+        const task_histogram& hist = entry.second;
+        write_json_string(stream, entry.first);
+        stream << ',' << hist.num_tasks << ',' << hist.num_aborted << ','
+               << hist.abort_rate() << ',' << hist.mean_wait() << ','
+               << hist.max_wait << ',' << hist.mean_run() << ','
+               << hist.max_run;
+        for (std::size_t count : hist.wait_counts) {
+            stream << ',' << count;
+        }
+        for (std::size_t count : hist.run_counts) {
+            stream << ',' << count;
+        }
+        stream << std::endl;
+    }
+}
+
+/**
+ * Writes the aggregate statistics as comma separated values.
+ */
+void thread_telemetry::write_histograms(const char* filename) const {
+    std::ofstream stream(filename);
+    write_histograms(stream);
+}
@@ -0,0 +1,261 @@
+/**
+ * @file thread_telemetry.h
+ * Records the execution history of tasks in the thread_pool.
+ */
+#pragma once
+
+#include <usml/threads/read_write_lock.h>
+#include <usml/usml_config.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <iosfwd>
+#include <map>
+#include <string>
+
+namespace usml {
+namespace threads {
+
+/// @ingroup threads
+/// @{
+
+/**
+ * Records the execution history of tasks in the thread_pool. Each task
+ * executed while telemetry is enabled produces a task_record with its type
+ * name, submit/start/end times, worker index, and whether it was aborted.
+ * Used to size thread pools and to find which stage of a processing chain
+ * is stalling the update loop.
+ *
+ * Two products are available:
+ *
+ * - A trace of the most recent max_records() tasks, which can be written in
+ *   the Chrome trace-event JSON format and viewed in chrome://tracing or
+ *   https://ui.perfetto.dev. Each task is a complete ("X") event on the
+ *   thread row of the worker that executed it.
+ * - Aggregate statistics for each task type, including histograms of queue
+ *   wait and run time with one bin per decade, and the abort rate. These
+ *   statistics include every task recorded, even those that have been
+ *   dropped from the trace.
+ *
+ * Telemetry is disabled by default. When disabled, the thread_pool does not
+ * acquire the telemetry lock, so the overhead is a single atomic load per
+ * task.
+ */
+class USML_DECLSPEC thread_telemetry {
+   public:
+    /// Number of histogram bins, see bin() for limits.
+    static constexpr std::size_t num_bins = 10;
+
+    /**
+     * Execution history for a single task. Times are in seconds relative
+     * to the creation of the telemetry object.
+     */
+    struct task_record {
+        /// Type name of the task, see thread_task::type_name().
+        std::string type;
+
+        /// Identification number of the task.
+        std::size_t id{0};
+
+        /// Priority class used to schedule the task.
+        int priority{0};
+
+        /// Index of the worker thread that executed the task.
+        std::size_t worker{0};
+
+        /// Time at which the task was added to the queue (sec).
+        double submit{0.0};
+
+        /// Time at which the task started to execute (sec).
+        double start{0.0};
+
+        /// Time at which the task finished executing (sec).
+        double end{0.0};
+
+        /// True if the task was aborted.
+        bool aborted{false};
+
+        /// Time that the task spent in the queue (sec).
+        double wait_time() const { return start - submit; }
+
+        /// Time that the task spent executing (sec).
+        double run_time() const { return end - start; }
+    };
+
+    /**
+     * Aggregate statistics for all of the tasks of a single type.
+     */
+    struct task_histogram {
+        /// Number of tasks executed.
+        std::size_t num_tasks{0};
+
+        /// Number of tasks that were aborted.
+        std::size_t num_aborted{0};
+
+        /// Sum of queue wait times (sec).
+        double total_wait{0.0};
+
+        /// Longest queue wait time (sec).
+        double max_wait{0.0};
+
+        /// Sum of run times (sec).
+        double total_run{0.0};
+
+        /// Longest run time (sec).
+        double max_run{0.0};
+
+        /// Number of tasks in each queue wait time bin.
+        std::array<std::size_t, num_bins> wait_counts{};
+
+        /// Number of tasks in each run time bin.
+        std::array<std::size_t, num_bins> run_counts{};
+
+        /// Fraction of tasks that were aborted.
+        double abort_rate() const {
+            return (num_tasks == 0) ? 0.0 : (double)num_aborted / num_tasks;
+        }
+
+        /// Average queue wait time (sec).
+        double mean_wait() const {
+            return (num_tasks == 0) ? 0.0 : total_wait / (double)num_tasks;
+        }
+
+        /// Average run time (sec).
+        double mean_run() const {
+            return (num_tasks == 0) ? 0.0 : total_run / (double)num_tasks;
+        }
+    };
+
+    /// Map of task type name to aggregate statistics.
+    typedef std::map<std::string, task_histogram> histogram_map;
+
+    /**
+     * Creates an empty, disabled, telemetry recorder.
+     *
+     * @param max_records   Maximum number of task records kept for the trace.
+     */
+    thread_telemetry(std::size_t max_records = 100000);
+
+    /// True if task execution is being recorded.
+    bool enabled() const { return _enabled; }
+
+    /**
+     * Starts or stops the recording of task execution.
+     *
+     * @param value     True to record task execution.
+     */
+    void enabled(bool value) { _enabled = value; }
+
+    /// Maximum number of task records kept for the trace.
+    std::size_t max_records() const {
+        read_lock_guard guard(_mutex);
+        return _max_records;
+    }
+
+    /**
+     * Maximum number of task records kept for the trace. The oldest
+     * records are dropped when this limit is exceeded.
+     *
+     * @param value     New maximum number of task records.
+     */
+    void max_records(std::size_t value);
+
+    /**
+     * Converts a time point into seconds since the creation of
+     * this telemetry object.
+     *
+     * @param time      Time point to convert.
+     * @return          Seconds since creation of telemetry object.
+     */
+    double elapsed(std::chrono::steady_clock::time_point time) const {
+        const std::chrono::duration<double> delta = time - _epoch;
+        return delta.count();
+    }
+
+    /**
+     * Adds the execution history for a task to the trace and histograms.
+     *
+     * @param record    Execution history for a single task.
+     */
+    void add(const task_record& record);
+
+    /// Copy of the task records currently kept for the trace.
+    std::deque<task_record> records() const {
+        read_lock_guard guard(_mutex);
+        return _records;
+    }
+
+    /// Copy of the aggregate statistics for each task type.
+    histogram_map histograms() const {
+        read_lock_guard guard(_mutex);
+        return _histograms;
+    }
+
+    /// Removes all task records and aggregate statistics.
+    void clear();
+
+    /**
+     * Histogram bin for a time interval. Bin 0 holds intervals less than
+     * 1 usec, bin 9 holds intervals of 100 sec or more, and each bin in
+     * between spans one decade. Bin n starts at 10^(n-7) sec.
+     *
+     * @param seconds   Time interval (sec).
+     * @return          Histogram bin number.
+     */
+    static std::size_t bin(double seconds);
+
+    /**
+     * Writes the trace in Chrome trace-event JSON format.
+     *
+     * @param stream    Output stream for JSON text.
+     */
+    void write_trace(std::ostream& stream) const;
+
+    /**
+     * Writes the trace in Chrome trace-event JSON format.
+     *
+     * @param filename  Name of the file to write.
+     */
+    void write_trace(const char* filename) const;
+
+    /**
+     * Writes the aggregate statistics as comma separated values, with one
+     * row per task type, and one column for each histogram bin.
+     *
+     * @param stream    Output stream for CSV text.
+     */
+    void write_histograms(std::ostream& stream) const;
+
+    /**
+     * Writes the aggregate statistics as comma separated values.
+     *
+     * @param filename  Name of the file to write.
+     */
+    void write_histograms(const char* filename) const;
+
+   private:
+    /// Time at which this telemetry object was created.
+    const std::chrono::steady_clock::time_point _epoch;
+
+    /// True if task execution is being recorded.
+    std::atomic<bool> _enabled{false};
+
+    /// Maximum number of task records kept for the trace.
+    std::size_t _max_records;
+
+    /// Most recent task records, in order of completion.
+    std::deque<task_record> _records;
+
+    /// Aggregate statistics for each task type.
+    histogram_map _histograms;
+
+    /// Mutex used to lock updates to records and histograms.
+    mutable read_write_lock _mutex;
+};
+
+/// @}
+}  // end of namespace threads
+}  // end of namespace usml
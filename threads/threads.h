@@ -11,7 +11,10 @@
  */
 #pragma once
 
+#include <usml/threads/parallel_for.h>
 #include <usml/threads/read_write_lock.h>
+#include <usml/threads/thread_affinity.h>
 #include <usml/threads/thread_controller.h>
 #include <usml/threads/thread_pool.h>
 #include <usml/threads/thread_task.h>
+#include <usml/threads/thread_telemetry.h>
@@ -29,7 +29,7 @@ transmit_cw::transmit_cw(const std::string& type, double duration,
  * Creates a complex analytic signal for this waveform.
  */
 cdvector transmit_cw::asignal(double fsample, double fband, double inphase,
-                              double* outphase) {
+                              double* outphase) const {
     const int N = int(round(duration * fsample));
     const double T = N / fsample;
     const double omega = TWO_PI * (fcenter - fband);
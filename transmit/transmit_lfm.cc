@@ -31,7 +31,7 @@ transmit_lfm::transmit_lfm(const std::string& type, double duration,
  * Creates a complex analytic signal for this waveform.
  */
 cdvector transmit_lfm::asignal(double fsample, double fband, double inphase,
-                               double* outphase) {
+                               double* outphase) const {
     const int N = int(round(duration * fsample));
     const double T = N / fsample;
     const double omega = TWO_PI * (fcenter - 0.5 * bandwidth - fband);
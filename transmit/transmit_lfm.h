@@ -64,7 +64,7 @@ class USML_DECLSPEC transmit_lfm : public transmit_model {
      * @param outphase  Phase at which the next signal should start.
      */
     cdvector asignal(double fsample, double fband, double inphase = 0.0,
-                     double* outphase = nullptr) override;
+                     double* outphase = nullptr) const override;
 };
 
 /// @}
@@ -36,3 +36,18 @@ transmit_model::transmit_model(const std::string& type, double duration,
 void transmit_model::add_window(cdvector& signal) const {
     signal = signal * window::any(window_type, signal.size(), window_param);
 }
+
+/**
+ * Computes the time at which each pulse in a transmission schedule starts.
+ */
+std::vector<double> usml::transmit::start_times(const transmit_list& schedule) {
+    std::vector<double> starts;
+    starts.reserve(schedule.size());
+    double start = 0.0;
+    for (const auto& transmit : schedule) {
+        start += transmit->delay;
+        starts.push_back(start);
+        start += transmit->duration;
+    }
+    return starts;
+}
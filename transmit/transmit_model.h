@@ -12,6 +12,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace usml {
 namespace transmit {
@@ -82,7 +83,7 @@ class USML_DECLSPEC transmit_model {
      * @param outphase  Phase at which the next signal should start.
      */
     virtual cdvector asignal(double fsample, double fband, double inphase,
-                             double* outphase) = 0;
+                             double* outphase) const = 0;
 
    protected:
     /**
@@ -117,6 +118,17 @@ class USML_DECLSPEC transmit_model {
  */
 typedef std::list<transmit_model::csptr> transmit_list;
 
+/**
+ * Computes the time at which each pulse in a transmission schedule starts,
+ * relative to the start of the schedule. Each pulse starts at its delay
+ * after the completion of the previous pulse. Used by every time series
+ * generator, so that they all agree on the timing of the schedule.
+ *
+ * @param schedule  List of transmit pulses.
+ * @return          Start time of each pulse (sec).
+ */
+USML_DECLSPEC std::vector<double> start_times(const transmit_list& schedule);
+
 /// @}
 }  // namespace transmit
 }  // namespace usml
@@ -0,0 +1,305 @@
+/**
+ * @file archive.cc
+ * Versioned, columnar, binary archive of named arrays.
+ */
+
+#include <usml/types/archive.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define USML_ARCHIVE_MMAP
+#endif
+
+using namespace usml::types;
+
+namespace {
+
+/// Identifies the file as an archive.
+const char MAGIC[8] = {'U', 'S', 'M', 'L', 'A', 'R', 'C', '\0'};
+
+/// Written in host byte order, reads differently on other hosts.
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * Fixed size header at the start of every archive.
+ */
+struct archive_header {
+    /// Identifies the file as an archive.
+    char magic[8];
+
+    /// Version number of the file format.
+    uint32_t version;
+
+    /// Byte order mark, in the byte order of the host that wrote it.
+    uint32_t byte_order;
+
+    /// Null terminated kind of data in the archive.
+    char kind[32];
+
+    /// Offset of the table of contents from the start of the file (bytes).
+    uint64_t toc_offset;
+
+    /// Number of sections in the table of contents.
+    uint64_t num_sections;
+};
+
+static_assert(sizeof(archive_header) == 64, "archive header must be packed");
+static_assert(sizeof(archive_section) == 72, "archive section must be packed");
+
+/**
+ * Writes zeros to pad a stream to a multiple of the alignment.
+ */
+void pad(std::ofstream* stream, size_t alignment) {
+    static const char zeros[archive_writer::align] = {0};
+    const auto position = (size_t)stream->tellp();
+    stream->write(zeros, (alignment - position % alignment) % alignment);
+}
+
+}  // namespace
+
+/**
+ * Creates a new archive file, replacing any existing file.
+ */
+archive_writer::archive_writer(const char* filename, const char* kind)
+    : _stream(filename, std::ios::binary | std::ios::trunc),
+      _filename(filename),
+      _kind(kind) {
+    if (!_stream) {
+        throw std::invalid_argument("archive " + _filename +
+                                    ": can not be created");
+    }
+    if (_kind.size() >= sizeof(archive_header::kind)) {
+        throw std::invalid_argument("archive " + _filename +
+                                    ": kind is too long");
+    }
+    archive_header header{};
+    _stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+/**
+ * Writes the table of contents, if close() has not already been called.
+ */
+archive_writer::~archive_writer() {
+    try {
+        close();
+    } catch (...) {
+        // destructors must not throw, use close() to detect errors
+    }
+}
+
+/**
+ * Pads the file to the next section boundary, and writes the section.
+ */
+void archive_writer::write_section(const std::string& name, uint32_t type,
+                                   const void* data, size_t bytes,
+                                   size_t count) {
+    if (!_stream.is_open()) {
+        throw std::invalid_argument("archive " + _filename + ": closed");
+    }
+    if (name.size() >= archive_section::name_size) {
+        throw std::invalid_argument("archive " + _filename + ": " + name +
+                                    " name is too long");
+    }
+    for (const auto& section : _sections) {
+        if (name == section.name) {
+            throw std::invalid_argument("archive " + _filename + ": " + name +
+                                        " already written");
+        }
+    }
+    pad(&_stream, align);
+    archive_section section{};
+    std::strncpy(section.name, name.c_str(), archive_section::name_size - 1);
+    section.offset = (uint64_t)_stream.tellp();
+    section.count = count;
+    section.type = type;
+    _sections.push_back(section);
+    if (bytes > 0) {
+        _stream.write(static_cast<const char*>(data), (std::streamsize)bytes);
+    }
+}
+
+/**
+ * Writes the table of contents and header, and closes the file.
+ */
+void archive_writer::close() {
+    if (!_stream.is_open()) {
+        return;
+    }
+    pad(&_stream, align);
+    archive_header header{};
+    std::copy_n(MAGIC, sizeof(MAGIC), header.magic);
+    header.version = version;
+    header.byte_order = BYTE_ORDER_MARK;
+    std::strncpy(header.kind, _kind.c_str(), sizeof(header.kind) - 1);
+    header.toc_offset = (uint64_t)_stream.tellp();
+    header.num_sections = _sections.size();
+    const size_t bytes = _sections.size() * sizeof(archive_section);
+    _stream.write(reinterpret_cast<const char*>(_sections.data()),
+                  (std::streamsize)bytes);
+    _stream.seekp(0);
+    _stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const bool failed = !_stream;
+    _stream.close();
+    if (failed) {
+        throw std::invalid_argument("archive " + _filename +
+                                    ": write failed");
+    }
+}
+
+/**
+ * Opens an archive file and maps it into memory.
+ */
+archive_reader::archive_reader(const char* filename, const char* kind)
+    : _filename(filename) {
+    load();
+    try {
+        validate(kind);
+    } catch (...) {
+#ifdef USML_ARCHIVE_MMAP
+        if (_mapped) {
+            munmap(const_cast<char*>(_base), _size);
+        }
+#endif
+        throw;
+    }
+}
+
+/**
+ * Releases the memory mapped file.
+ */
+archive_reader::~archive_reader() {
+#ifdef USML_ARCHIVE_MMAP
+    if (_mapped) {
+        munmap(const_cast<char*>(_base), _size);
+    }
+#endif
+}
+
+/**
+ * Maps file into memory, or reads it if mapping is not supported.
+ */
+void archive_reader::load() {
+#ifdef USML_ARCHIVE_MMAP
+    const int fd = ::open(_filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::invalid_argument("archive " + _filename +
+                                    ": can not be opened");
+    }
+    struct stat status {};
+    if (fstat(fd, &status) == 0 && status.st_size > 0) {
+        _size = (size_t)status.st_size;
+        void* address = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            _base = static_cast<const char*>(address);
+            _mapped = true;
+        }
+    }
+    ::close(fd);
+    if (_mapped) {
+        return;
+    }
+#endif
+    std::ifstream stream(_filename, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        throw std::invalid_argument("archive " + _filename +
+                                    ": can not be opened");
+    }
+    _size = (size_t)stream.tellg();
+    stream.seekg(0);
+    _buffer.resize((_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    stream.read(reinterpret_cast<char*>(_buffer.data()),
+                (std::streamsize)_size);
+    if (!stream) {
+        throw std::invalid_argument("archive " + _filename + ": read failed");
+    }
+    _base = reinterpret_cast<const char*>(_buffer.data());
+}
+
+/**
+ * Checks the header and table of contents.
+ */
+void archive_reader::validate(const char* kind) {
+    const std::string prefix = "archive " + _filename + ": ";
+    archive_header header{};
+    if (_size < sizeof(header)) {
+        throw std::invalid_argument(prefix + "not an archive");
+    }
+    std::memcpy(&header, _base, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::invalid_argument(prefix + "not an archive");
+    }
+    if (header.byte_order != BYTE_ORDER_MARK) {
+        throw std::invalid_argument(prefix + "written with other byte order");
+    }
+    if (header.version == 0 || header.version > archive_writer::version) {
+        throw std::invalid_argument(prefix + "unsupported version " +
+                                    std::to_string(header.version));
+    }
+    _version = header.version;
+    header.kind[sizeof(header.kind) - 1] = '\0';
+    _kind = header.kind;
+    if (kind != nullptr && _kind != kind) {
+        throw std::invalid_argument(prefix + "contains " + _kind +
+                                    " instead of " + kind);
+    }
+
+    // copy table of contents and check that each section is inside the file
+
+    if (header.toc_offset > _size ||
+        header.num_sections >
+            (_size - header.toc_offset) / sizeof(archive_section)) {
+        throw std::invalid_argument(prefix + "corrupt table of contents");
+    }
+    _sections.resize(header.num_sections);
+    std::memcpy(_sections.data(), _base + header.toc_offset,
+                _sections.size() * sizeof(archive_section));
+    for (auto& section : _sections) {
+        section.name[archive_section::name_size - 1] = '\0';
+        const uint64_t bytes = section.count * (section.type % 256U);
+        if (section.offset % archive_writer::align != 0 ||
+            section.offset > _size || section.count > _size ||
+            bytes > _size - section.offset) {
+            throw std::invalid_argument(prefix + "corrupt section " +
+                                        section.name);
+        }
+    }
+}
+
+/**
+ * Finds a section by name, nullptr if not found.
+ */
+const archive_section* archive_reader::find(const std::string& name) const {
+    for (const auto& section : _sections) {
+        if (name == section.name) {
+            return &section;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Finds a section by name and type, throws if not found.
+ */
+const archive_section& archive_reader::get(const std::string& name,
+                                           uint32_t type) const {
+    const archive_section* section = find(name);
+    if (section == nullptr) {
+        throw std::invalid_argument("archive " + _filename + ": " + name +
+                                    " not found");
+    }
+    if (type != 0 && section->type != type) {
+        throw std::invalid_argument("archive " + _filename + ": " + name +
+                                    " has wrong element type");
+    }
+    return *section;
+}
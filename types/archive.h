@@ -0,0 +1,347 @@
+/**
+ * @file archive.h
+ * Versioned, columnar, binary archive of named arrays.
+ */
+#pragma once
+
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace usml {
+namespace types {
+
+/// @ingroup archive
+/// @{
+
+/**
+ * Description of a single named array in an archive. Stored in the table
+ * of contents at the end of the file.
+ */
+struct archive_section {
+    /// Maximum length of a section name, including the terminating null.
+    static constexpr size_t name_size = 48;
+
+    /// Null terminated name of this array.
+    char name[name_size];
+
+    /// Offset of the first element from the start of the file (bytes).
+    uint64_t offset;
+
+    /// Number of elements in this array.
+    uint64_t count;
+
+    /// Element type code, see archive_type().
+    uint32_t type;
+
+    /// Reserved for future use, always zero.
+    uint32_t reserved;
+};
+
+/**
+ * Element type code for an arithmetic type. Combines a character for the
+ * category ('f' for floating point, 'i' for signed, and 'u' for unsigned
+ * integers) with the size of the type in bytes, so that readers reject
+ * arrays that were written with a different element type.
+ */
+template <class T>
+constexpr uint32_t archive_type() {
+    static_assert(std::is_arithmetic<T>::value,
+                  "archive only stores arrays of arithmetic types");
+    return (std::is_floating_point<T>::value ? 'f'
+            : std::is_signed<T>::value       ? 'i'
+                                             : 'u') *
+               256U +
+           (uint32_t)sizeof(T);
+}
+
+/**
+ * Writes named arrays of numbers to a binary archive file. Each array is
+ * written in a single operation, as a contiguous section of the file, with
+ * the native byte order of the host. Sections start on archive_writer::align
+ * byte boundaries, so that an archive_reader can use them in place, after
+ * mapping the file into memory, without copying them or worrying about
+ * alignment.
+ *
+ * The file starts with a fixed size header that identifies the file
+ * format, its version number, the byte order of the host that wrote it,
+ * and the kind of data stored in it. The table of contents is written to
+ * the end of the file by close(), after the size and position of every
+ * section are known.
+ */
+class USML_DECLSPEC archive_writer {
+   public:
+    /// Alignment of each section in the file (bytes).
+    static constexpr size_t align = 64;
+
+    /// Version number of the archive file format.
+    static constexpr uint32_t version = 1;
+
+    /**
+     * Creates a new archive file, replacing any existing file.
+     *
+     * @param filename          Name of the archive file.
+     * @param kind              Kind of data in the archive, like "eigenrays".
+     *                          Readers use this to reject the wrong files.
+     * @throws invalid_argument If file can not be created.
+     */
+    archive_writer(const char* filename, const char* kind);
+
+    /**
+     * Writes the table of contents, if close() has not already been called.
+     */
+    ~archive_writer();
+
+    /// Archives can not be copied.
+    archive_writer(const archive_writer&) = delete;
+
+    /// Archives can not be copied.
+    archive_writer& operator=(const archive_writer&) = delete;
+
+    /**
+     * Writes a named array as a single section of the file.
+     *
+     * @param name      Name of the array, must be unique in this archive.
+     * @param data      Pointer to the first element of the array.
+     * @param count     Number of elements in the array.
+     * @throws invalid_argument If name is too long or has already been used.
+     */
+    template <class T>
+    void write(const std::string& name, const T* data, size_t count) {
+        write_section(name, archive_type<T>(), data, count * sizeof(T), count);
+    }
+
+    /**
+     * Writes the contents of a std::vector as a named array.
+     *
+     * @param name      Name of the array, must be unique in this archive.
+     * @param data      Array to write.
+     */
+    template <class T>
+    void write(const std::string& name, const std::vector<T>& data) {
+        write(name, data.data(), data.size());
+    }
+
+    /**
+     * Writes a single value as a named array with one element.
+     *
+     * @param name      Name of the array, must be unique in this archive.
+     * @param value     Value to write.
+     */
+    template <class T>
+    void write_value(const std::string& name, T value) {
+        write(name, &value, 1);
+    }
+
+    /**
+     * Writes the table of contents and header, and closes the file.
+     * No more sections can be written after this call.
+     *
+     * @throws invalid_argument If file can not be written.
+     */
+    void close();
+
+   private:
+    /// Output stream for the archive file.
+    std::ofstream _stream;
+
+    /// Name of the archive file, used in error messages.
+    std::string _filename;
+
+    /// Kind of data in the archive.
+    std::string _kind;
+
+    /// Table of contents, one entry per section written so far.
+    std::vector<archive_section> _sections;
+
+    /// Pads the file to the next section boundary, and writes the section.
+    void write_section(const std::string& name, uint32_t type,
+                       const void* data, size_t bytes, size_t count);
+};
+
+/**
+ * Reads named arrays of numbers from a binary archive file. The whole file
+ * is mapped into memory when the reader is constructed, and the data()
+ * method returns pointers directly into that memory. This makes loading an
+ * archive nearly instant, because no data is copied or converted until the
+ * caller uses it. On systems that don't support memory mapped files, the
+ * file is read into memory with a single read operation instead.
+ *
+ * The pointers returned by data() are only valid while the reader exists.
+ * Readers reject files with the wrong kind of data, files from a newer
+ * version of the file format, files written on a host with a different
+ * byte order, and corrupt tables of contents.
+ */
+class USML_DECLSPEC archive_reader {
+   public:
+    /**
+     * Opens an archive file and maps it into memory.
+     *
+     * @param filename          Name of the archive file.
+     * @param kind              Expected kind of data in the archive.
+     *                          Kind is not checked if this is nullptr.
+     * @throws invalid_argument If file can not be opened, or is not an
+     *                          archive of the expected kind.
+     */
+    explicit archive_reader(const char* filename, const char* kind = nullptr);
+
+    /**
+     * Releases the memory mapped file.
+     */
+    ~archive_reader();
+
+    /// Archives can not be copied.
+    archive_reader(const archive_reader&) = delete;
+
+    /// Archives can not be copied.
+    archive_reader& operator=(const archive_reader&) = delete;
+
+    /// Kind of data in the archive.
+    const std::string& kind() const { return _kind; }
+
+    /// Version of the file format used to write this archive.
+    uint32_t version() const { return _version; }
+
+    /// True if the file was mapped into memory instead of being read.
+    bool mapped() const { return _mapped; }
+
+    /// Table of contents for the archive.
+    const std::vector<archive_section>& sections() const { return _sections; }
+
+    /**
+     * True if the archive has an array with this name.
+     *
+     * @param name      Name of the array.
+     */
+    bool contains(const std::string& name) const {
+        return find(name) != nullptr;
+    }
+
+    /**
+     * Number of elements in a named array.
+     *
+     * @param name      Name of the array.
+     * @throws invalid_argument If array is not in the archive.
+     */
+    size_t count(const std::string& name) const { return get(name).count; }
+
+    /**
+     * Pointer to the elements of a named array, without copying them.
+     * Only valid while this reader exists.
+     *
+     * @param name      Name of the array.
+     * @param count     Number of elements in the array (output), not
+     *                  returned if this is nullptr.
+     * @throws invalid_argument If array is not in the archive, or if it
+     *                          was written with a different element type.
+     */
+    template <class T>
+    const T* data(const std::string& name, size_t* count = nullptr) const {
+        const archive_section& section = get(name, archive_type<T>());
+        if (count != nullptr) {
+            *count = section.count;
+        }
+        return reinterpret_cast<const T*>(_base + section.offset);
+    }
+
+    /**
+     * Pointer to the elements of a named array, without copying them,
+     * after checking that the array has the expected number of elements.
+     * Only valid while this reader exists.
+     *
+     * @param name      Name of the array.
+     * @param size      Expected number of elements in the array.
+     * @throws invalid_argument If array is not in the archive, if it
+     *                          was written with a different element type,
+     *                          or if it has the wrong number of elements.
+     */
+    template <class T>
+    const T* column(const std::string& name, size_t size) const {
+        size_t count;
+        const T* values = data<T>(name, &count);
+        if (count != size) {
+            throw std::invalid_argument("archive " + _filename + ": " + name +
+                                        " has wrong size");
+        }
+        return values;
+    }
+
+    /**
+     * Copies a named array into a std::vector, with a single bulk copy.
+     *
+     * @param name      Name of the array.
+     * @param column    Vector that receives the array (output).
+     */
+    template <class T>
+    void read(const std::string& name, std::vector<T>* column) const {
+        size_t count;
+        const T* values = data<T>(name, &count);
+        column->assign(values, values + count);
+    }
+
+    /**
+     * Retrieves the first element of a named array, used for arrays
+     * written by archive_writer::write_value().
+     *
+     * @param name      Name of the array.
+     * @throws invalid_argument If array is not in the archive, or is empty.
+     */
+    template <class T>
+    T value(const std::string& name) const {
+        size_t count;
+        const T* values = data<T>(name, &count);
+        if (count == 0) {
+            throw std::invalid_argument("archive " + _filename + ": " + name +
+                                        " is empty");
+        }
+        return *values;
+    }
+
+   private:
+    /// Name of the archive file, used in error messages.
+    const std::string _filename;
+
+    /// Kind of data in the archive.
+    std::string _kind;
+
+    /// Version of the file format used to write this archive.
+    uint32_t _version{0};
+
+    /// Start of the file contents in memory.
+    const char* _base{nullptr};
+
+    /// Size of the file (bytes).
+    size_t _size{0};
+
+    /// True if the file was mapped into memory instead of being read.
+    bool _mapped{false};
+
+    /// File contents, if they could not be mapped into memory.
+    std::vector<uint64_t> _buffer;
+
+    /// Table of contents for the archive.
+    std::vector<archive_section> _sections;
+
+    /// Finds a section by name, nullptr if not found.
+    const archive_section* find(const std::string& name) const;
+
+    /// Finds a section by name and type, throws if not found.
+    const archive_section& get(const std::string& name,
+                               uint32_t type = 0) const;
+
+    /// Maps file into memory, or reads it if mapping is not supported.
+    void load();
+
+    /// Checks the header and table of contents.
+    void validate(const char* kind);
+};
+
+/// @}
+}  // end of namespace types
+}  // end of namespace usml
@@ -28,6 +28,15 @@
  * Vector relative to body along the aircraft principal axes and
  * body orientation.
  *
+ * @defgroup archive Archives
+ * @ingroup types
+ *
+ * Versioned, columnar, binary files that store named arrays of numbers.
+ * Used to save and reload large collections of model results, like
+ * eigenrays and eigenverbs, much faster than netCDF. Archives are
+ * mapped into memory when they are read, so that arrays can be used
+ * in place without copying them.
+ *
  * @defgroup types_test Type Tests
  * @ingroup types
  *
@@ -35,6 +44,7 @@
  */
 #pragma once
 
+#include <usml/types/archive.h>
 #include <usml/types/bvector.h>
 #include <usml/types/data_grid.h>
 #include <usml/types/data_grid_bathy.h>
@@ -0,0 +1,104 @@
+/**
+ * @file matrix_prod.h
+ *
+ * Cache blocked matrix product for dense, row major, uBLAS matrices.
+ * Used to replace ublas::prod() in tight loops, where the expression
+ * template version of prod() is too slow for large matrices. Does
+ * not require an external BLAS library.
+ */
+#pragma once
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+
+namespace usml {
+namespace ublas {
+
+using namespace boost::numeric::ublas;
+
+/// @ingroup vecmath
+/// @{
+
+/**
+ * Accumulates the product of two scalars into a result, c += a * b.
+ *
+ * @param c     Accumulated result.
+ * @param a     First scalar in product.
+ * @param b     Second scalar in product.
+ */
+template <class T>
+inline void multiply_add(T &c, const T &a, const T &b) {
+    c += a * b;
+}
+
+/**
+ * Accumulates the product of two complex numbers into a result, c += a * b.
+ * Avoids the NaN and infinity checks that compilers insert into the
+ * std::complex multiply operator, which prevents the compiler from
+ * vectorizing the inner loop of blocked_prod().
+ *
+ * @param c     Accumulated result.
+ * @param a     First scalar in product.
+ * @param b     Second scalar in product.
+ */
+template <class T>
+inline void multiply_add(std::complex<T> &c, const std::complex<T> &a,
+                         const std::complex<T> &b) {
+    const T ar = a.real();
+    const T ai = a.imag();
+    const T br = b.real();
+    const T bi = b.imag();
+    c = std::complex<T>(c.real() + ar * br - ai * bi,
+                        c.imag() + ar * bi + ai * br);
+}
+
+/**
+ * Computes the matrix product c = a * b, using blocks of rows and columns
+ * that fit in the processor cache. The inner loop runs along a row of b
+ * and a row of c, which are contiguous in memory for row major matrices.
+ * Terms are accumulated in the order of the inner dimension.
+ *
+ * @param a         Left matrix in product, size MxK.
+ * @param b         Right matrix in product, size KxN.
+ * @param c         Result matrix, resized to MxN.
+ * @param block     Number of rows and columns in each block.
+ */
+template <class T>
+void blocked_prod(const matrix<T> &a, const matrix<T> &b, matrix<T> *c,
+                  std::size_t block = 64) {
+    const std::size_t M = a.size1();
+    const std::size_t K = a.size2();
+    const std::size_t N = b.size2();
+    c->resize(M, N, false);
+    std::fill(c->data().begin(), c->data().end(), T(0));
+    if (M == 0 || K == 0 || N == 0) {
+        return;
+    }
+    const T *A = &a.data()[0];
+    const T *B = &b.data()[0];
+    T *C = &c->data()[0];
+
+    for (std::size_t k0 = 0; k0 < K; k0 += block) {
+        const std::size_t k1 = std::min(k0 + block, K);
+        for (std::size_t j0 = 0; j0 < N; j0 += block) {
+            const std::size_t j1 = std::min(j0 + block, N);
+            for (std::size_t i = 0; i < M; ++i) {
+                T *c_row = C + i * N;
+                const T *a_row = A + i * K;
+                for (std::size_t k = k0; k < k1; ++k) {
+                    const T aik = a_row[k];
+                    const T *b_row = B + k * N;
+                    for (std::size_t j = j0; j < j1; ++j) {
+                        multiply_add(c_row[j], aik, b_row[j]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// @}
+}  // end of namespace ublas
+}  // end of namespace usml
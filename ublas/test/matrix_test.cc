@@ -2,6 +2,7 @@
  * @example ublas/test/matrix_test.cc
  */
 #include <usml/ublas/matrix_math.h>
+#include <usml/ublas/matrix_prod.h>
 #include <usml/ublas/test/matrix_test_support.h>
 #include <usml/ublas/vector_math.h>
 
@@ -331,6 +332,72 @@ BOOST_AUTO_TEST_CASE(ublas_proxy_test) {
   BOOST_CHECK_CLOSE(m(2, 2), 133, 1e-10);
 }
 
+/**
+ * Compare the blocked matrix product to the uBLAS prod() function for
+ * real and complex matrices. Matrix sizes are chosen so that they are
+ * not multiples of the block size. Also checks that the result does not
+ * depend on the block size, to within round-off error.
+ */
+BOOST_AUTO_TEST_CASE(blocked_prod_test) {
+  cout << "=== matrix_test: blocked_prod_test ===" << endl;
+  const size_t M = 37;
+  const size_t K = 71;
+  const size_t N = 23;
+
+  matrix<complex<double> > a(M, K);
+  matrix<complex<double> > b(K, N);
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t k = 0; k < K; ++k) {
+      a(i, k) = complex<double>(cos(0.1 * i * k), sin(0.3 * i + k));
+    }
+  }
+  for (size_t k = 0; k < K; ++k) {
+    for (size_t j = 0; j < N; ++j) {
+      b(k, j) = complex<double>(sin(0.2 * k * j), cos(0.7 * k - j));
+    }
+  }
+
+  // complex product
+
+  const matrix<complex<double> > expected = prod(a, b);
+  matrix<complex<double> > c;
+  blocked_prod(a, b, &c, 8);
+  BOOST_REQUIRE_EQUAL(c.size1(), M);
+  BOOST_REQUIRE_EQUAL(c.size2(), N);
+  double max_diff = 0.0;
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      max_diff = max(max_diff, abs(c(i, j) - expected(i, j)));
+    }
+  }
+  BOOST_CHECK_SMALL(max_diff, 1e-10);
+
+  matrix<complex<double> > c64;
+  blocked_prod(a, b, &c64);
+  max_diff = 0.0;
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      max_diff = max(max_diff, abs(c(i, j) - c64(i, j)));
+    }
+  }
+  BOOST_CHECK_SMALL(max_diff, 1e-12);
+
+  // real product
+
+  const matrix<double> ar = real(a);
+  const matrix<double> br = imag(b);
+  const matrix<double> expected_real = prod(ar, br);
+  matrix<double> cr;
+  blocked_prod(ar, br, &cr, 16);
+  max_diff = 0.0;
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t j = 0; j < N; ++j) {
+      max_diff = max(max_diff, abs(cr(i, j) - expected_real(i, j)));
+    }
+  }
+  BOOST_CHECK_SMALL(max_diff, 1e-10);
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -2,12 +2,17 @@
  * @example wavegen/test/wavegen_test.cc
  */
 
+#include <usml/beampatterns/bp_omni.h>
+#include <usml/ocean/ocean_shared.h>
 #include <usml/ocean/ocean_utils.h>
+#include <usml/platforms/motion_thresholds.h>
 #include <usml/platforms/platform_manager.h>
 #include <usml/platforms/platform_model.h>
 #include <usml/sensors/sensor_manager.h>
 #include <usml/sensors/sensor_model.h>
+#include <usml/sensors/sensor_pair.h>
 #include <usml/threads/thread_task.h>
+#include <usml/wavegen/wavefront_cache.h>
 #include <usml/wavegen/wavefront_listener.h>
 
 #include <boost/test/unit_test.hpp>
@@ -117,5 +122,109 @@ BOOST_AUTO_TEST_CASE(propagate_wavefront) {
     platform_manager::reset();
 }
 
+/**
+ * Moves a sensor away from its original position, and back again, to test
+ * the wavefront cache. Dead reckoning is disabled by default, and each move
+ * is larger than the motion thresholds, so that each move launches a new
+ * wavefront_generator.
+ *
+ * This test fails if:
+ *   - the first visit to each position is not a cache miss,
+ *   - the return to the original position is not a cache hit,
+ *   - the direct paths found from the cache differ from the original
+ *     direct paths,
+ *   - a change to the ocean does not cause a cache miss, or
+ *   - a reset cache is not empty, or stores a wavefront that is larger
+ *     than its capacity.
+ */
+BOOST_AUTO_TEST_CASE(wavefront_cache_hits) {
+    cout << "=== wavegen_test: wavefront_cache_hits ===" << endl;
+    ocean_utils::make_iso(2000.0);
+    wavefront_cache::reset(64 << 20);
+    const auto* cache = wavefront_cache::instance();
+    sensor_manager* smgr = sensor_manager::instance();
+    seq_vector::csptr freq(new seq_linear(900.0, 10.0, 1000.0));
+    smgr->frequencies(freq);
+
+    auto beam = bp_model::csptr(new bp_omni());
+    sensor_model* sensors[2];
+    for (platform_model::key_type site = 1; site <= 2; ++site) {
+        std::ostringstream name;
+        name << "site" << site;
+        wposition1 position(36.0, 16.0 + 0.05 * (double)site, -100.0);
+        auto* sensor = new sensor_model(site, name.str(), 0.0, position);
+        sensor->time_maximum(10.0);
+        sensor->multistatic(1);
+        sensor->src_beam(0, beam);
+        sensor->rcv_beam(0, beam);
+        smgr->add_sensor(sensor_model::sptr(sensor));
+        sensors[site - 1] = sensor;
+    }
+    for (auto* sensor : sensors) {
+        sensor->update(0.0, platform_model::FORCE_UPDATE);
+    }
+    thread_task::wait();
+    BOOST_CHECK_EQUAL(cache->hits(), 0);
+    BOOST_CHECK_EQUAL(cache->misses(), 2);
+    BOOST_CHECK_EQUAL(cache->size(), 2);
+    BOOST_CHECK_GT(cache->bytes(), 0);
+    BOOST_CHECK_LE(cache->bytes(), cache->capacity());
+
+    auto pair = smgr->find_source(1).front();
+    auto old_paths = pair->dirpaths();
+    BOOST_REQUIRE(old_paths != nullptr);
+    BOOST_REQUIRE(!old_paths->eigenrays().empty());
+
+    // move away from original position
+
+    const wposition1 original = sensors[0]->position();
+    wposition1 position = original;
+    position.latitude(position.latitude() +
+                      2.0 * motion_thresholds::lat_threshold);
+    sensors[0]->update(1.0, position, orientation(), 0.0);
+    thread_task::wait();
+    BOOST_CHECK_EQUAL(cache->hits(), 0);
+    BOOST_CHECK_EQUAL(cache->misses(), 3);
+    BOOST_CHECK(pair->dirpaths() != old_paths);
+
+    // return to original position
+
+    sensors[0]->update(2.0, original, orientation(), 0.0);
+    thread_task::wait();
+    BOOST_CHECK_EQUAL(cache->hits(), 1);
+    BOOST_CHECK_EQUAL(cache->misses(), 3);
+    auto new_paths = pair->dirpaths();
+    BOOST_REQUIRE(new_paths != nullptr);
+    BOOST_CHECK_CLOSE(new_paths->source_pos().latitude(), original.latitude(),
+                      1e-10);
+    BOOST_CHECK_EQUAL(new_paths->eigenrays().size(),
+                      old_paths->eigenrays().size());
+    BOOST_CHECK_CLOSE(new_paths->initial_time(),
+                      old_paths->initial_time(), 1e-10);
+
+    // change the ocean, and force an update at the original position
+
+    const auto version = ocean_shared::version();
+    ocean_utils::make_iso(2000.0);
+    BOOST_CHECK_GT(ocean_shared::version(), version);
+    sensors[0]->update(3.0, platform_model::FORCE_UPDATE);
+    thread_task::wait();
+    BOOST_CHECK_EQUAL(cache->hits(), 1);
+    BOOST_CHECK_EQUAL(cache->misses(), 4);
+
+    // a cache too small for any wavefront stores nothing
+
+    wavefront_cache::reset(1);
+    BOOST_CHECK_EQUAL(wavefront_cache::instance(), cache);
+    sensors[0]->update(4.0, platform_model::FORCE_UPDATE);
+    thread_task::wait();
+    BOOST_CHECK_EQUAL(cache->misses(), 1);
+    BOOST_CHECK_EQUAL(cache->size(), 0);
+    BOOST_CHECK_EQUAL(cache->bytes(), 0);
+
+    sensor_manager::reset();
+    wavefront_cache::reset();
+}
+
 /// @}
 BOOST_AUTO_TEST_SUITE_END()
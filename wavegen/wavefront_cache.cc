@@ -0,0 +1,242 @@
+/**
+ * @file wavefront_cache.cc
+ * Bounded cache of eigenrays and eigenverbs from earlier wavefronts.
+ */
+
+#include <usml/wavegen/wavefront_cache.h>
+
+#include <functional>
+#include <vector>
+
+using namespace usml::wavegen;
+
+namespace {
+
+/**
+ * Mixes the hash of a value into a combined hash value.
+ */
+template <class T>
+void hash_combine(size_t* seed, const T& value) {
+    *seed ^= std::hash<T>()(value) + 0x9e3779b9 + (*seed << 6) + (*seed >> 2);
+}
+
+/**
+ * Memory allocated by a vector of numbers.
+ */
+template <class T>
+size_t vector_bytes(const std::vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+
+/**
+ * Estimates the memory used by the results of a single wavefront. Includes
+ * the eigenray columns, the eigenray totals for each target, and the
+ * eigenverb columns and spatial index for each interface. Ignores the small
+ * fixed size parts of each object.
+ */
+size_t estimate_bytes(const eigenray_collection::csptr& eigenrays,
+                      const eigenverb_collection::csptr& eigenverbs) {
+    size_t bytes = 0;
+    if (eigenrays != nullptr) {
+        const eigenray_columns& columns = eigenrays->columns();
+        bytes += vector_bytes(columns.travel_time) +
+                 vector_bytes(columns.intensity_data) +
+                 vector_bytes(columns.phase_data) +
+                 vector_bytes(columns.source_de) +
+                 vector_bytes(columns.source_az) +
+                 vector_bytes(columns.target_de) +
+                 vector_bytes(columns.target_az) +
+                 vector_bytes(columns.paths) + vector_bytes(columns.next);
+        const size_t num_targets = eigenrays->size1() * eigenrays->size2();
+        bytes += num_targets *
+                 (sizeof(eigenray_model) + 3 * sizeof(size_t) +
+                  sizeof(double) +
+                  2 * sizeof(double) * columns.num_frequencies());
+    }
+    if (eigenverbs != nullptr) {
+        for (size_t n = 0; n < eigenverbs->num_interfaces(); ++n) {
+            const eigenverb_columns& columns = eigenverbs->columns(n);
+            bytes += vector_bytes(columns.travel_time) +
+                     vector_bytes(columns.power_data) +
+                     vector_bytes(columns.length) +
+                     vector_bytes(columns.width) +
+                     vector_bytes(columns.latitude) +
+                     vector_bytes(columns.longitude) +
+                     vector_bytes(columns.altitude) +
+                     vector_bytes(columns.direction) +
+                     vector_bytes(columns.grazing) +
+                     vector_bytes(columns.sound_speed) +
+                     vector_bytes(columns.de_index) +
+                     vector_bytes(columns.az_index) +
+                     vector_bytes(columns.source_de) +
+                     vector_bytes(columns.source_az) +
+                     vector_bytes(columns.paths);
+            bytes += columns.size() * (3 * sizeof(double) + sizeof(size_t));
+        }
+    }
+    return bytes;
+}
+
+}  // namespace
+
+/** Reference to the cache owned by this singleton. */
+std::unique_ptr<wavefront_cache> wavefront_cache::_instance;
+
+/** Mutex to lock creation of instance. */
+read_write_lock wavefront_cache::_instance_mutex;
+
+/**
+ * Hash value used to find keys in an unordered map.
+ */
+size_t wavefront_key::hash() const {
+    size_t seed = 0;
+    hash_combine(&seed, sourceID);
+    hash_combine(&seed, ocean_version);
+    hash_combine(&seed, compute_reverb);
+    for (auto cell : cells) {
+        hash_combine(&seed, cell);
+    }
+    for (auto targetID : targetIDs) {
+        hash_combine(&seed, targetID);
+    }
+    for (auto parameter : parameters) {
+        hash_combine(&seed, parameter);
+    }
+    return seed;
+}
+
+/**
+ * Provides a reference to the cache singleton.
+ */
+wavefront_cache* wavefront_cache::instance() {
+    read_lock_guard guard(_instance_mutex);
+    wavefront_cache* cache = _instance.get();
+    if (cache == nullptr) {
+        guard.unlock();
+        write_lock_guard write_guard(_instance_mutex);
+        cache = _instance.get();
+        if (cache == nullptr) {
+            cache = new wavefront_cache(0);
+            _instance.reset(cache);
+        }
+    }
+    return cache;
+}
+
+/**
+ * Empties the cache singleton and changes its capacity.
+ */
+void wavefront_cache::reset(size_t capacity) {
+    wavefront_cache* cache = instance();
+    write_lock_guard guard(cache->_mutex);
+    cache->_capacity = capacity;
+    cache->_index.clear();
+    cache->_entries.clear();
+    cache->_bytes = 0;
+    cache->_hits = 0;
+    cache->_misses = 0;
+}
+
+/**
+ * Maximum number of bytes to store.
+ */
+size_t wavefront_cache::capacity() const {
+    read_lock_guard guard(_mutex);
+    return _capacity;
+}
+
+/**
+ * Number of wavefronts currently stored.
+ */
+size_t wavefront_cache::size() const {
+    read_lock_guard guard(_mutex);
+    return _entries.size();
+}
+
+/**
+ * Estimated number of bytes currently stored.
+ */
+size_t wavefront_cache::bytes() const {
+    read_lock_guard guard(_mutex);
+    return _bytes;
+}
+
+/**
+ * Number of searches that found a stored wavefront.
+ */
+size_t wavefront_cache::hits() const {
+    read_lock_guard guard(_mutex);
+    return _hits;
+}
+
+/**
+ * Number of searches that did not find a stored wavefront.
+ */
+size_t wavefront_cache::misses() const {
+    read_lock_guard guard(_mutex);
+    return _misses;
+}
+
+/**
+ * Searches for the results of an earlier wavefront.
+ */
+bool wavefront_cache::find(const wavefront_key& key,
+                           eigenray_collection::csptr* eigenrays,
+                           eigenverb_collection::csptr* eigenverbs) {
+    write_lock_guard guard(_mutex);
+    if (_capacity == 0) {
+        return false;
+    }
+    auto iter = _index.find(key);
+    if (iter == _index.end()) {
+        ++_misses;
+        return false;
+    }
+    ++_hits;
+    _entries.splice(_entries.begin(), _entries, iter->second);
+    *eigenrays = iter->second->eigenrays;
+    *eigenverbs = iter->second->eigenverbs;
+    return true;
+}
+
+/**
+ * Stores the results of a wavefront, as the most recently used entry.
+ */
+void wavefront_cache::insert(const wavefront_key& key,
+                             const eigenray_collection::csptr& eigenrays,
+                             const eigenverb_collection::csptr& eigenverbs) {
+    const size_t bytes = estimate_bytes(eigenrays, eigenverbs);
+    write_lock_guard guard(_mutex);
+    if (_capacity == 0) {
+        return;
+    }
+    auto iter = _index.find(key);
+    if (iter != _index.end()) {
+        _bytes -= iter->second->bytes;
+        _entries.erase(iter->second);
+        _index.erase(iter);
+    }
+    if (bytes > _capacity) {
+        return;
+    }
+    while (!_entries.empty() && _bytes + bytes > _capacity) {
+        _bytes -= _entries.back().bytes;
+        _index.erase(_entries.back().key);
+        _entries.pop_back();
+    }
+    _entries.push_front(entry{key, eigenrays, eigenverbs, bytes});
+    _index[key] = _entries.begin();
+    _bytes += bytes;
+}
+
+/**
+ * Removes all entries, and resets statistics.
+ */
+void wavefront_cache::clear() {
+    write_lock_guard guard(_mutex);
+    _index.clear();
+    _entries.clear();
+    _bytes = 0;
+    _hits = 0;
+    _misses = 0;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file wavefront_cache.h
+ * Bounded cache of eigenrays and eigenverbs from earlier wavefronts.
+ */
+#pragma once
+
+#include <usml/eigenrays/eigenray_collection.h>
+#include <usml/eigenverbs/eigenverb_collection.h>
+#include <usml/threads/read_write_lock.h>
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace usml {
+namespace wavegen {
+
+using namespace usml::eigenrays;
+using namespace usml::eigenverbs;
+using namespace usml::threads;
+
+/// @ingroup wavegen
+/// @{
+
+/**
+ * Inputs that determine the results of a wavefront calculation. Positions
+ * are quantized into cells, so that sensors which return to nearly the same
+ * geometry share the same key.
+ */
+struct USML_DECLSPEC wavefront_key {
+    /// Platform ID of the wavefront source.
+    uint64_t sourceID{0};
+
+    /// Version of the shared ocean used to compute the wavefront.
+    uint64_t ocean_version{0};
+
+    /// True if eigenverbs were computed for reverberation.
+    bool compute_reverb{false};
+
+    /// Cell indices for the source position, followed by each target.
+    std::vector<int64_t> cells;
+
+    /// Platform ID of each target, in target grid order.
+    std::vector<uint64_t> targetIDs;
+
+    /// Ray fans, frequencies, and propagation limits.
+    std::vector<double> parameters;
+
+    /// True if all of the inputs are the same.
+    bool operator==(const wavefront_key& other) const {
+        return sourceID == other.sourceID &&
+               ocean_version == other.ocean_version &&
+               compute_reverb == other.compute_reverb &&
+               cells == other.cells && targetIDs == other.targetIDs &&
+               parameters == other.parameters;
+    }
+
+    /// Hash value used to find keys in an unordered map.
+    size_t hash() const;
+};
+
+/**
+ * Bounded cache of eigenrays and eigenverbs from earlier wavefronts.
+ * Platforms that fly racetrack patterns, or buoys that drift around their
+ * anchors, revisit nearly the same geometry many times. The
+ * wavefront_generator uses this cache to skip the propagation when the
+ * inputs for a new wavefront match one that was computed before, and
+ * stores new results in the cache after each propagation.
+ *
+ * The capacity of the cache is measured in bytes, using an estimate of the
+ * memory used by the eigenrays and eigenverbs in each entry, because the
+ * size of a wavefront varies widely with the number of targets and the
+ * number of interfaces. The least recently used entries are discarded when
+ * the cache is full. The cache is disabled, and stores nothing, when its
+ * capacity is zero.
+ * This is the default, because results from the cache are only as accurate
+ * as the quantization of the positions in their keys. Multiple threads can
+ * use the cache simultaneously.
+ */
+class USML_DECLSPEC wavefront_cache {
+   public:
+    /**
+     * Provides a reference to the cache singleton. Constructs a disabled
+     * cache the first time that this method is called.
+     *
+     * @return  Reference to the wavefront_cache singleton.
+     */
+    static wavefront_cache* instance();
+
+    /**
+     * Removes all entries from the cache singleton, resets its statistics,
+     * and changes its capacity. The singleton itself is not replaced, so
+     * pointers from instance() remain valid in other threads.
+     *
+     * @param capacity  Maximum number of bytes to store.
+     *                  Disables the cache if this is zero.
+     */
+    static void reset(size_t capacity = 0);
+
+    /**
+     * Creates an empty cache.
+     *
+     * @param capacity  Maximum number of bytes to store.
+     */
+    explicit wavefront_cache(size_t capacity) : _capacity(capacity) {}
+
+    /// Maximum number of bytes to store.
+    size_t capacity() const;
+
+    /// Number of wavefronts currently stored.
+    size_t size() const;
+
+    /// Estimated number of bytes currently stored.
+    size_t bytes() const;
+
+    /// Number of searches that found a stored wavefront.
+    size_t hits() const;
+
+    /// Number of searches that did not find a stored wavefront.
+    size_t misses() const;
+
+    /**
+     * Searches for the results of an earlier wavefront. Marks the entry
+     * as the most recently used if it is found. Searches are not counted
+     * as hits or misses if the cache is disabled.
+     *
+     * @param key           Inputs for the new wavefront.
+     * @param eigenrays     Stored eigenrays (output), if found.
+     * @param eigenverbs    Stored eigenverbs (output), if found.
+     * @return              True if the key was found.
+     */
+    bool find(const wavefront_key& key, eigenray_collection::csptr* eigenrays,
+              eigenverb_collection::csptr* eigenverbs);
+
+    /**
+     * Stores the results of a wavefront, as the most recently used entry.
+     * Discards the least recently used entries until the new entry fits.
+     * Results larger than the whole cache are not stored.
+     *
+     * @param key           Inputs for this wavefront.
+     * @param eigenrays     Eigenrays computed by this wavefront.
+     * @param eigenverbs    Eigenverbs computed by this wavefront.
+     */
+    void insert(const wavefront_key& key,
+                const eigenray_collection::csptr& eigenrays,
+                const eigenverb_collection::csptr& eigenverbs);
+
+    /// Removes all entries, and resets statistics.
+    void clear();
+
+   private:
+    /// Adapts wavefront_key::hash() for use in an unordered map.
+    struct key_hash {
+        size_t operator()(const wavefront_key& key) const {
+            return key.hash();
+        }
+    };
+
+    /// Key and results for a single wavefront.
+    struct entry {
+        wavefront_key key;
+        eigenray_collection::csptr eigenrays;
+        eigenverb_collection::csptr eigenverbs;
+        size_t bytes;
+    };
+
+    /// List of entries, from most to least recently used.
+    typedef std::list<entry> entry_list;
+
+    /// Maximum number of bytes to store.
+    size_t _capacity;
+
+    /// Estimated number of bytes currently stored.
+    size_t _bytes{0};
+
+    /// Entries, from most to least recently used.
+    entry_list _entries;
+
+    /// Location of each entry in the list of entries.
+    std::unordered_map<wavefront_key, entry_list::iterator, key_hash> _index;
+
+    /// Number of searches that found a stored wavefront.
+    size_t _hits{0};
+
+    /// Number of searches that did not find a stored wavefront.
+    size_t _misses{0};
+
+    /// Locks cache while entries and statistics are being changed.
+    mutable read_write_lock _mutex;
+
+    /// Reference to the cache owned by this singleton.
+    static std::unique_ptr<wavefront_cache> _instance;
+
+    /// Mutex to lock creation of instance.
+    static read_write_lock _instance_mutex;
+};
+
+/// @}
+}  // namespace wavegen
+}  // namespace usml
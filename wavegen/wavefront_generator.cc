@@ -7,20 +7,109 @@
 #include <usml/eigenverbs/eigenverb_collection.h>
 #include <usml/managed/managed_obj.h>
 #include <usml/ocean/ocean_shared.h>
+#include <usml/platforms/motion_thresholds.h>
 #include <usml/platforms/platform_model.h>
 #include <usml/sensors/sensor_model.h>
+#include <usml/wavegen/wavefront_cache.h>
 #include <usml/wavegen/wavefront_generator.h>
 #include <usml/waveq3d/wave_queue.h>
 #include <usml/waveq3d/wave_thresholds.h>
 
+#include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+using namespace usml::platforms;
 using namespace usml::wavegen;
 using namespace usml::waveq3d;
 
+namespace {
+
+/**
+ * Publishes the eigenrays found so far as the wavefront passes each
+ * checkpoint. Eigenrays are found near the time of the current wavefront,
+ * but an eigenray that arrives within one time step of it may not be
+ * detected until the next step. The generator delays each checkpoint by one
+ * time step, and this listener removes that delay from the snapshot, so
+ * that each snapshot includes all of the eigenrays that arrive before its
+ * checkpoint.
+ */
+class snapshot_listener : public eigenray_listener {
+   public:
+    /**
+     * Creates listener for a specific wavefront.
+     *
+     * @param source        Sensor whose listeners receive the snapshots.
+     * @param eigenrays     Collection that stores the eigenrays found so far.
+     * @param delay         Delay added to each checkpoint (sec).
+     */
+    snapshot_listener(sensor_model* source,
+                      const eigenray_collection* eigenrays, double delay)
+        : _source(source), _eigenrays(eigenrays), _delay(delay) {}
+
+    /// Eigenrays are stored by the collection, not by this listener.
+    void add_eigenray(size_t /*t1*/, size_t /*t2*/,
+                      eigenray_model::csptr /*ray*/,
+                      size_t /*runID*/) override {}
+
+    /// Publishes the eigenrays that arrive before this checkpoint.
+    void checkpoint_eigenrays(double checkpoint,
+                              size_t /*runID*/) override {
+        _source->notify_eigenray_snapshot(
+            _source, _eigenrays->snapshot(checkpoint - _delay));
+    }
+
+   private:
+    sensor_model* _source;
+    const eigenray_collection* _eigenrays;
+    const double _delay;
+};
+
+/**
+ * True if eigenrays from the cache can be dead reckoned to new positions.
+ * Eigenverbs can not be dead reckoned, and dead reckoning is disabled when
+ * any of its limits are zero.
+ */
+bool can_dead_reckon(bool compute_reverb) {
+    return !compute_reverb && motion_thresholds::dead_reckon_lat > 0.0 &&
+           motion_thresholds::dead_reckon_lon > 0.0 &&
+           motion_thresholds::dead_reckon_alt > 0.0;
+}
+
+/**
+ * Appends the cell that contains a position to a cache key. Cells are the
+ * size of the dead reckoning limits when eigenrays can be dead reckoned, and
+ * the size of the motion thresholds otherwise, so that all positions in the
+ * same cell are close enough to share results.
+ */
+void add_cell(wavefront_key* key, const wposition1& pos, bool dead_reckon) {
+    const double lat = dead_reckon ? motion_thresholds::dead_reckon_lat
+                                   : motion_thresholds::lat_threshold;
+    const double lon = dead_reckon ? motion_thresholds::dead_reckon_lon
+                                   : motion_thresholds::lon_threshold;
+    const double alt = dead_reckon ? motion_thresholds::dead_reckon_alt
+                                   : motion_thresholds::alt_threshold;
+    key->cells.push_back((int64_t)std::floor(pos.latitude() / lat));
+    key->cells.push_back((int64_t)std::floor(pos.longitude() / lon));
+    key->cells.push_back((int64_t)std::floor(pos.altitude() / alt));
+}
+
+/**
+ * Appends the values of a sequence to a cache key, preceded by its size.
+ */
+void add_values(wavefront_key* key, const seq_vector::csptr& values) {
+    key->parameters.push_back((double)values->size());
+    for (size_t n = 0; n < values->size(); ++n) {
+        key->parameters.push_back((*values)[n]);
+    }
+}
+
+}  // namespace
+
 /**
  * Automatically recomputes acoustic data when platform motion exceeds position
  * or orientation thresholds.
@@ -30,9 +119,9 @@ wavefront_generator::wavefront_generator(
     const matrix<uint64_t>& targetIDs, const seq_vector::csptr& frequencies,
     const seq_vector::csptr& de_fan, const seq_vector::csptr& az_fan,
     double time_step, double time_maximum, double intensity_threshold,
-    int max_bottom, int max_surface, const std::string& wavefront_file)
-    : _ocean(ocean_shared::current()),
-      _source(source),
+    int max_bottom, int max_surface, const std::string& wavefront_file,
+    const std::vector<double>& checkpoints)
+    : _source(source),
       _source_position(source->position()),
       _target_positions(target_positions),
       _targetIDs(targetIDs),
@@ -44,7 +133,32 @@ wavefront_generator::wavefront_generator(
       _intensity_threshold(intensity_threshold),
       _max_bottom(max_bottom),
       _max_surface(max_surface),
-      _wavefront_file(wavefront_file) {}
+      _wavefront_file(wavefront_file),
+      _checkpoints(checkpoints) {
+    // identify the inputs for this wavefront in the cache
+
+    _ocean = ocean_shared::current(&_cache_key.ocean_version);
+    _cache_key.sourceID = source->keyID();
+    _cache_key.compute_reverb = source->compute_reverb();
+    const bool dead_reckon = can_dead_reckon(_cache_key.compute_reverb);
+    add_cell(&_cache_key, _source_position, dead_reckon);
+    for (size_t n = 0; n < targetIDs.size1(); ++n) {
+        for (size_t m = 0; m < targetIDs.size2(); ++m) {
+            _cache_key.targetIDs.push_back(targetIDs(n, m));
+            add_cell(&_cache_key,
+                     wposition1(target_positions, n, m), dead_reckon);
+        }
+    }
+    _cache_key.parameters.push_back((double)targetIDs.size2());
+    add_values(&_cache_key, frequencies);
+    add_values(&_cache_key, de_fan);
+    add_values(&_cache_key, az_fan);
+    _cache_key.parameters.push_back(time_step);
+    _cache_key.parameters.push_back(time_maximum);
+    _cache_key.parameters.push_back(intensity_threshold);
+    _cache_key.parameters.push_back(max_bottom);
+    _cache_key.parameters.push_back(max_surface);
+}
 
 /**
  * Executes the WaveQ3D propagation model.
@@ -58,7 +172,33 @@ void wavefront_generator::run() {
         return;
     }
 
+    // distribute results of an earlier wavefront with the same inputs,
+    // dead reckoned to the current positions when possible
+
+    wavefront_cache* cache = wavefront_cache::instance();
+    eigenray_collection::csptr cached_rays;
+    eigenverb_collection::csptr cached_verbs;
+    if (_wavefront_file.empty() &&
+        cache->find(_cache_key, &cached_rays, &cached_verbs)) {
+        cout << "task #" << id()
+             << " wavefront_generator: " << _source->description()
+             << " from cache" << endl;
+        if (can_dead_reckon(_cache_key.compute_reverb) &&
+            _targetIDs.size1() > 0 && _targetIDs.size2() > 0) {
+            cached_rays = eigenray_collection::dead_reckon(
+                              {cached_rays}, {_source_position},
+                              {_target_positions}, _ocean->profile())
+                              .front();
+        }
+        _done = true;
+        _source->notify_wavefront_listeners(_source, cached_rays,
+                                            cached_verbs);
+        return;
+    }
+
     // create a new wavefront
+    // allocated here, rather than in the constructor, so that the operating
+    // system places its memory on the NUMA node of the worker thread
 
     cout << "task #" << id()
          << " wavefront_generator: " << _source->description() << " for "
@@ -78,6 +218,19 @@ void wavefront_generator::run() {
         wave.add_eigenray_listener(eigenrays);
     }
 
+    // create listener to publish partial eigenrays at each checkpoint
+
+    snapshot_listener snapshots(_source, eigenrays, _time_step);
+    if (!_checkpoints.empty() && _targetIDs.size1() > 0 &&
+        _targetIDs.size2() > 0) {
+        std::vector<double> delayed(_checkpoints);
+        for (double& time : delayed) {
+            time += _time_step;
+        }
+        wave.eigenray_checkpoints(delayed);
+        wave.add_eigenray_listener(&snapshots);
+    }
+
     // create listener to store eigenverbs
 
     auto* eigenverbs = new eigenverb_collection(_ocean->num_volume());
@@ -116,12 +269,14 @@ void wavefront_generator::run() {
     if (eigenrays != nullptr) {
         eigenrays->sum_eigenrays();
     }
+    eigenverbs->build_index();
 
     // distribute eigenrays and eigenverbs to listeners
 
+    eigenray_collection::csptr rays(eigenrays);
+    eigenverb_collection::csptr verbs(eigenverbs);
+    cache->insert(_cache_key, rays, verbs);
     _done = true;
-    _source->notify_wavefront_listeners(
-        _source, eigenray_collection::csptr(eigenrays),
-        eigenverb_collection::csptr(eigenverbs));
+    _source->notify_wavefront_listeners(_source, rays, verbs);
     cout << "task #" << id() << " wavefront_generator: done" << endl;
 }
@@ -6,12 +6,15 @@
 
 #include <usml/ocean/ocean_model.h>
 #include <usml/threads/thread_task.h>
+#include <usml/wavegen/wavefront_cache.h>
 #include <usml/types/seq_vector.h>
 #include <usml/types/wposition.h>
 #include <usml/types/wposition1.h>
 #include <usml/usml_config.h>
 
 #include <boost/numeric/ublas/matrix.hpp>
+#include <string>
+#include <vector>
 
 namespace usml {
 namespace sensors {
@@ -55,7 +58,8 @@ class USML_DECLSPEC wavefront_generator : public thread_task {
      * @param max_bottom    	The maximum number of bottom bounces.
      * @param max_surface   	The maximum number of surface bounces.
      * @param wavefront_file   	NetCDF file to store wavefront data for debug.
-     *
+     * @param checkpoints   	Travel times at which to publish partial
+     *                          eigenray results (sec).
      */
     wavefront_generator(sensor_model* source, const wposition& target_positions,
                         const matrix<uint64_t>& targetIDs,
@@ -63,12 +67,23 @@ class USML_DECLSPEC wavefront_generator : public thread_task {
                         const seq_vector::csptr& de_fan,
                         const seq_vector::csptr& az_fan, double time_step,
                         double time_maximum, double intensity_threshold,
-                        int max_bottom, int max_surface, const std::string& wavefront_file=std::string());
+                        int max_bottom, int max_surface, const std::string& wavefront_file=std::string(),
+                        const std::vector<double>& checkpoints =
+                            std::vector<double>());
 
     /**
      * Executes the WaveQ3D propagation model to generate eigenrays and
      * eigenverbs. Updates the eigenrays and eigenverbs of this source using
-     * the source's update_wavefront_data() function when complete.
+     * the source's update_wavefront_data() function when complete. Also
+     * publishes the eigenrays found so far, using the source's
+     * notify_eigenray_snapshot() function, as the wavefront passes each
+     * checkpoint.
+     *
+     * Skips the propagation if the wavefront_cache has results for the same
+     * inputs, and distributes those results instead. Eigenrays from the
+     * cache are dead reckoned to the current source and target positions,
+     * if the source does not compute reverberation. New results are stored
+     * in the cache after each propagation.
      */
     virtual void run();
 
@@ -134,6 +149,12 @@ class USML_DECLSPEC wavefront_generator : public thread_task {
 
     /// NetCDF file in which to store wavefront data for debugging.
     std::string _wavefront_file;
+
+    /// Travel times at which to publish partial eigenray results (sec).
+    const std::vector<double> _checkpoints;
+
+    /// Inputs that identify the results of this wavefront in the cache.
+    wavefront_key _cache_key;
 };
 
 /// @}
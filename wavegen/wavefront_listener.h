@@ -44,6 +44,19 @@ class USML_DECLSPEC wavefront_listener {
     virtual void update_wavefront_data(
         const sensor_model* sensor, eigenray_collection::csptr eigenrays,
         eigenverb_collection::csptr eigenverbs) = 0;
+
+    /**
+     * Notify listener that a partial set of eigenrays is available for a
+     * sensor, while its wavefront is still being computed. Each snapshot
+     * includes all of the eigenrays that arrive before one of the sensor's
+     * eigenray checkpoints. The complete results are still delivered by
+     * update_wavefront_data(). Does nothing by default.
+     *
+     * @param sensor 		Sensor model that generated this wavefront data.
+     * @param eigenrays 	Shared pointer to the eigenrays found so far.
+     */
+    virtual void update_eigenray_snapshot(
+        const sensor_model* sensor, eigenray_collection::csptr eigenrays) {}
 };
 
 /// @}
@@ -34,3 +34,13 @@ void wavefront_notifier::notify_wavefront_listeners(
         listener->update_wavefront_data(sensor, eigenrays, eigenverbs);
     }
 }
+
+/**
+ * Distribute partial eigenray results to all listeners.
+ */
+void wavefront_notifier::notify_eigenray_snapshot(
+    const sensor_model* sensor, const eigenray_collection::csptr& eigenrays) {
+    for (wavefront_listener* listener : _listeners) {
+        listener->update_eigenray_snapshot(sensor, eigenrays);
+    }
+}
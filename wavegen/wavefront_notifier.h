@@ -41,6 +41,12 @@ class USML_DECLSPEC wavefront_notifier {
         const sensor_model* sensor, const eigenray_collection::csptr& eigenrays,
         const eigenverb_collection::csptr& eigenverbs);
 
+    /**
+     * Distribute partial eigenray results to all listeners.
+     */
+    void notify_eigenray_snapshot(const sensor_model* sensor,
+                                  const eigenray_collection::csptr& eigenrays);
+
    private:
     /**
      * List of active wavefront listeners.
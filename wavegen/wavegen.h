@@ -11,5 +11,6 @@
  */
 #pragma once
 
+#include <usml/wavegen/wavefront_cache.h>
 #include <usml/wavegen/wavefront_generator.h>
 #include <usml/wavegen/wavefront_listener.h>
@@ -0,0 +1,142 @@
+/**
+ * @file target_grid.cc
+ * Structured lattice of acoustic targets around a wavefront source.
+ */
+
+#include <usml/ublas/math_traits.h>
+#include <usml/waveq3d/target_grid.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace usml::waveq3d;
+
+namespace {
+
+/**
+ * Throws an exception if an axis is empty or is not increasing.
+ */
+void check_axis(const seq_vector::csptr& axis, const char* name) {
+    if (axis == nullptr || axis->size() == 0 ||
+        (axis->size() > 1 && (*axis)(1) <= (*axis)(0))) {
+        throw std::invalid_argument(std::string("target_grid: ") + name +
+                                    " must be increasing");
+    }
+}
+
+/**
+ * Finds the first and last index of an increasing axis, inside of the
+ * closed interval [lo,hi].
+ *
+ * @return  False if no values are inside of the interval.
+ */
+bool index_range(const seq_vector& axis, double lo, double hi,
+                 size_t index[2]) {
+    const size_t last = axis.size() - 1;
+    if (hi < axis(0) || lo > axis(last)) {
+        return false;
+    }
+    size_t first = (lo <= axis(0)) ? 0 : axis.find_index(lo);
+    while (first <= last && axis(first) < lo) {
+        ++first;
+    }
+    size_t final = (hi >= axis(last)) ? last : axis.find_index(hi);
+    while (final < last && axis(final + 1) <= hi) {
+        ++final;
+    }
+    index[0] = first;
+    index[1] = final;
+    return first <= final;
+}
+
+}  // namespace
+
+/**
+ * Constructs the nodes of the lattice.
+ */
+target_grid::target_grid(const wposition1& origin,
+                         const seq_vector::csptr& ranges,
+                         const seq_vector::csptr& depths,
+                         const seq_vector::csptr& bearings)
+    : _origin(origin.latitude(), origin.longitude(), 0.0),
+      _ranges(ranges),
+      _depths(depths),
+      _bearings(bearings) {
+    check_axis(ranges, "ranges");
+    check_axis(depths, "depths");
+    check_axis(bearings, "bearings");
+    _positions = wposition(size1(), size2());
+    for (size_t b = 0; b < _bearings->size(); ++b) {
+        const double bearing = to_radians((*_bearings)(b));
+        for (size_t r = 0; r < _ranges->size(); ++r) {
+            const wposition1 node(_origin, (*_ranges)(r), bearing);
+            const size_t t1 = row(b, r);
+            for (size_t d = 0; d < _depths->size(); ++d) {
+                _positions.latitude(t1, d, node.latitude());
+                _positions.longitude(t1, d, node.longitude());
+                _positions.altitude(t1, d, -(*_depths)(d));
+            }
+        }
+    }
+}
+
+/**
+ * Converts locations into lattice coordinates.
+ */
+void target_grid::coordinates(const wposition& points, matrix<double>* range,
+                              matrix<double>* bearing,
+                              matrix<double>* depth) const {
+    const double lat0 = to_radians(_origin.latitude());
+    const double lng0 = to_radians(_origin.longitude());
+    const double sin_lat0 = sin(lat0);
+    const double cos_lat0 = cos(lat0);
+    for (size_t n1 = 0; n1 < points.size1(); ++n1) {
+        for (size_t n2 = 0; n2 < points.size2(); ++n2) {
+            const double lat = M_PI_2 - points.theta(n1, n2);
+            const double dlng = points.phi(n1, n2) - lng0;
+            const double cos_lat = cos(lat);
+            const double sin_dlat = sin(0.5 * (lat - lat0));
+            const double sin_dlng = sin(0.5 * dlng);
+            const double a =
+                sin_dlat * sin_dlat + cos_lat0 * cos_lat * sin_dlng * sin_dlng;
+            (*range)(n1, n2) =
+                2.0 * asin(std::min(1.0, sqrt(a))) * wposition::earth_radius;
+            double heading = to_degrees(
+                atan2(sin(dlng) * cos_lat,
+                      cos_lat0 * sin(lat) - sin_lat0 * cos_lat * cos(dlng)));
+            if (heading < 0.0) {
+                heading += 360.0;
+            }
+            (*bearing)(n1, n2) = heading;
+            (*depth)(n1, n2) = -points.altitude(n1, n2);
+        }
+    }
+}
+
+/**
+ * Finds the nodes inside of a box in lattice coordinates.
+ */
+bool target_grid::find_nodes(const double range[2], const double depth[2],
+                             const double bearing[2], size_t range_index[2],
+                             size_t depth_index[2],
+                             std::vector<size_t>* bearings) const {
+    if (!index_range(*_ranges, range[0], range[1], range_index) ||
+        !index_range(*_depths, depth[0], depth[1], depth_index)) {
+        return false;
+    }
+    bearings->clear();
+    const double span = bearing[1] - bearing[0];
+    const bool all = range[0] < 1.0 || span > 180.0;
+    for (size_t b = 0; b < _bearings->size(); ++b) {
+        double offset = fmod((*_bearings)(b) - bearing[0], 360.0);
+        if (offset < 0.0) {
+            offset += 360.0;
+        }
+        if (all || offset <= span) {
+            bearings->push_back(b);
+        }
+    }
+    return !bearings->empty();
+}
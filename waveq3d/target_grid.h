@@ -0,0 +1,145 @@
+/**
+ * @file target_grid.h
+ * Structured lattice of acoustic targets around a wavefront source.
+ */
+#pragma once
+
+#include <usml/types/seq_vector.h>
+#include <usml/types/wposition.h>
+#include <usml/types/wposition1.h>
+#include <usml/usml_config.h>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace usml {
+namespace waveq3d {
+
+using namespace usml::types;
+
+using boost::numeric::ublas::matrix;
+
+/// @ingroup waveq3d
+/// @{
+
+/**
+ * Structured lattice of acoustic targets for transmission loss maps.
+ * Nodes are placed at every combination of range, depth, and bearing from
+ * an origin on the ocean surface. Ranges are great circle distances along
+ * the surface of the earth.
+ *
+ * The wave_queue uses this structure to search for eigenrays without
+ * computing the distance from every target to every point on the
+ * wavefront. Instead, each wave_front converts its own points into lattice
+ * coordinates, and the wave_queue only tests the nodes inside of a box
+ * around the neighborhood of each ray. This keeps the memory
+ * needed by the propagation proportional to the number of rays,
+ * independent of the number of nodes.
+ *
+ * Nodes are stored in a target matrix whose rows are the combinations of
+ * bearing and range, in bearing major order, and whose columns are depths.
+ * This allows eigenray_collection and other eigenray listeners to use
+ * the lattice like any other target matrix.
+ */
+class USML_DECLSPEC target_grid {
+   public:
+    /**
+     * Constructs the nodes of the lattice.
+     *
+     * @param origin    Location of the origin. Only latitude and longitude
+     *                  are used, ranges are measured along the surface.
+     * @param ranges    Great circle range of each node (meters).
+     * @param depths    Depth of each node (meters, positive is down).
+     * @param bearings  True bearing of each node (degrees, clockwise from
+     *                  true north).
+     * @throws invalid_argument If any axis is empty or is not increasing.
+     */
+    target_grid(const wposition1& origin, const seq_vector::csptr& ranges,
+                const seq_vector::csptr& depths,
+                const seq_vector::csptr& bearings);
+
+    /// Location of the origin on the ocean surface.
+    const wposition1& origin() const { return _origin; }
+
+    /// Great circle range of each node (meters).
+    seq_vector::csptr ranges() const { return _ranges; }
+
+    /// Depth of each node (meters, positive is down).
+    seq_vector::csptr depths() const { return _depths; }
+
+    /// True bearing of each node (degrees).
+    seq_vector::csptr bearings() const { return _bearings; }
+
+    /// Number of rows in the target matrix.
+    size_t size1() const { return _bearings->size() * _ranges->size(); }
+
+    /// Number of columns in the target matrix.
+    size_t size2() const { return _depths->size(); }
+
+    /**
+     * Row of the target matrix for a combination of bearing and range.
+     *
+     * @param bearing   Index of the bearing.
+     * @param range     Index of the range.
+     */
+    size_t row(size_t bearing, size_t range) const {
+        return bearing * _ranges->size() + range;
+    }
+
+    /// Location of each node, as a target matrix.
+    const wposition& positions() const { return _positions; }
+
+    /**
+     * Converts locations into lattice coordinates. Uses the haversine
+     * formula for range and the initial great circle heading for bearing.
+     *
+     * @param points    Locations to convert.
+     * @param range     Great circle range from origin (meters, output).
+     * @param bearing   True bearing from origin (degrees in the range
+     *                  [0,360), output).
+     * @param depth     Depth below the surface (meters, output).
+     */
+    void coordinates(const wposition& points, matrix<double>* range,
+                     matrix<double>* bearing, matrix<double>* depth) const;
+
+    /**
+     * Finds the nodes inside of a box in lattice coordinates. Boxes that
+     * come within 1 meter of the origin, or that span more than 180 degrees,
+     * include all bearings, because bearing is not well defined near the
+     * origin.
+     *
+     * @param range     Minimum and maximum range of the box (meters).
+     * @param depth     Minimum and maximum depth of the box (meters).
+     * @param bearing   Minimum and maximum bearing of the box (degrees).
+     *                  The maximum may be larger than 360, and the minimum
+     *                  may be negative, for boxes that cross true north.
+     * @param range_index   First and last range index in the box (output).
+     * @param depth_index   First and last depth index in the box (output).
+     * @param bearings  Index of each bearing in the box (output).
+     * @return          False if there are no nodes in the box.
+     */
+    bool find_nodes(const double range[2], const double depth[2],
+                    const double bearing[2], size_t range_index[2],
+                    size_t depth_index[2], std::vector<size_t>* bearings) const;
+
+   private:
+    /// Location of the origin on the ocean surface.
+    wposition1 _origin;
+
+    /// Great circle range of each node (meters).
+    const seq_vector::csptr _ranges;
+
+    /// Depth of each node (meters, positive is down).
+    const seq_vector::csptr _depths;
+
+    /// True bearing of each node (degrees).
+    const seq_vector::csptr _bearings;
+
+    /// Location of each node, as a target matrix.
+    wposition _positions;
+};
+
+/// @}
+}  // end of namespace waveq3d
+}  // end of namespace usml
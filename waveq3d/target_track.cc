@@ -0,0 +1,68 @@
+/**
+ * @file target_track.cc
+ * Piecewise linear trajectories for a matrix of acoustic targets.
+ */
+
+#include <usml/waveq3d/target_track.h>
+
+#include <usml/ublas/math_traits.h>
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace usml::waveq3d;
+
+/**
+ * Defines the location of every target at each knot.
+ */
+target_track::target_track(const seq_vector::csptr& times,
+                           const std::vector<wposition>& positions)
+    : _times(times), _positions(positions) {
+    if (_times == nullptr || _times->size() == 0 ||
+        _times->size() != _positions.size()) {
+        throw std::invalid_argument(
+            "target_track: number of times and positions must match");
+    }
+    if (_times->size() > 1 && (*_times)(1) <= (*_times)(0)) {
+        throw std::invalid_argument("target_track: times must be increasing");
+    }
+    for (const auto& knot : _positions) {
+        if (knot.size1() != size1() || knot.size2() != size2()) {
+            throw std::invalid_argument(
+                "target_track: positions must be the same size");
+        }
+    }
+}
+
+/**
+ * Interpolates the location of every target at a specific time.
+ * Longitude follows the shortest path between knots, so that tracks which
+ * cross the antimeridian do not sweep around the rest of the earth.
+ */
+void target_track::position(double time, wposition* result) const {
+    const size_t last = _times->size() - 1;
+    if (last == 0 || time <= (*_times)(0)) {
+        *result = _positions.front();
+        return;
+    }
+    if (time >= (*_times)(last)) {
+        *result = _positions.back();
+        return;
+    }
+    const size_t n = _times->find_index(time);
+    const double u = (time - (*_times)(n)) / _times->increment(n);
+    const wposition& p0 = _positions[n];
+    const wposition& p1 = _positions[n + 1];
+    for (size_t n1 = 0; n1 < size1(); ++n1) {
+        for (size_t n2 = 0; n2 < size2(); ++n2) {
+            result->rho(n1, n2,
+                        p0.rho(n1, n2) + u * (p1.rho(n1, n2) - p0.rho(n1, n2)));
+            result->theta(n1, n2, p0.theta(n1, n2) +
+                                      u * (p1.theta(n1, n2) -
+                                           p0.theta(n1, n2)));
+            const double dphi =
+                std::remainder(p1.phi(n1, n2) - p0.phi(n1, n2), TWO_PI);
+            result->phi(n1, n2, p0.phi(n1, n2) + u * dphi);
+        }
+    }
+}
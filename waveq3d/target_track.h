@@ -0,0 +1,85 @@
+/**
+ * @file target_track.h
+ * Piecewise linear trajectories for a matrix of acoustic targets.
+ */
+#pragma once
+
+#include <usml/types/seq_vector.h>
+#include <usml/types/wposition.h>
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace usml {
+namespace waveq3d {
+
+using namespace usml::types;
+
+/// @ingroup waveq3d
+/// @{
+
+/**
+ * Piecewise linear trajectories for a matrix of acoustic targets.
+ * The location of every target is defined at a common list of knot times,
+ * measured from the time that the wavefront leaves the source. Locations
+ * between knots are linearly interpolated in spherical earth coordinates,
+ * using the shortest difference in longitude between knots, so that tracks
+ * can cross the antimeridian.
+ * Targets hold their first location before the first knot, and their last
+ * location after the last knot.
+ *
+ * The wave_queue uses this structure to detect eigenrays for receivers
+ * that move while the wavefront is propagating, like the elements of a
+ * towed array. The distance from each target to each wavefront is
+ * computed using the location of the target at the travel time of that
+ * wavefront. A single propagation then covers a whole segment of the
+ * receiver track.
+ */
+class USML_DECLSPEC target_track {
+   public:
+    /**
+     * Defines the location of every target at each knot.
+     *
+     * @param times     Travel time of each knot (seconds).
+     * @param positions Location of every target at each knot.
+     *                  All of these matrices must be the same size.
+     * @throws invalid_argument If the number of knots and locations differ,
+     *                  if the times are not increasing, or if the
+     *                  locations are not all the same size.
+     */
+    target_track(const seq_vector::csptr& times,
+                 const std::vector<wposition>& positions);
+
+    /// Travel time of each knot (seconds).
+    seq_vector::csptr times() const { return _times; }
+
+    /// Location of every target at a specific knot.
+    const wposition& knot(size_t n) const { return _positions[n]; }
+
+    /// Number of rows in the target matrix.
+    size_t size1() const { return _positions.front().size1(); }
+
+    /// Number of columns in the target matrix.
+    size_t size2() const { return _positions.front().size2(); }
+
+    /**
+     * Interpolates the location of every target at a specific time.
+     *
+     * @param time      Travel time from the source (seconds).
+     * @param result    Location of every target (output). Must already
+     *                  be sized to match the target matrix.
+     */
+    void position(double time, wposition* result) const;
+
+   private:
+    /// Travel time of each knot (seconds).
+    const seq_vector::csptr _times;
+
+    /// Location of every target at each knot.
+    const std::vector<wposition> _positions;
+};
+
+/// @}
+}  // end of namespace waveq3d
+}  // end of namespace usml
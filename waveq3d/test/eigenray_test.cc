@@ -533,6 +533,112 @@ BOOST_AUTO_TEST_CASE(eigenray_branch_pt) {
     }
 }
 
+/**
+ * Tests the model's ability to detect eigenrays for targets that move
+ * while the wavefront is propagating. Uses the eigenray_basic scenario,
+ * with one stationary target and one target that starts at the same
+ * location but moves north, away from the source, at 100 m/s. This speed
+ * is much faster than any real receiver, so that the effect of target
+ * motion on travel time is much larger than the interpolation errors.
+ * The target track has knots at 0 and 4 seconds.
+ *
+ * - Scenario parameters
+ *   - Profile: constant 1500 m/s sound speed, no absorption
+ *   - Bottom: 3000 meters
+ *   - Source: 45N, 45W, -1000 meters, 10 kHz
+ *   - Targets: 45.02N, 45W, -1000 meters at the start of propagation
+ *   - Time Step: 100 msec
+ *   - Launch D/E: 5 degree linear spacing from -60 to 60 degrees
+ *
+ * The analytic travel time of the direct path to the moving target is
+ * the time at which the wavefront radius equals the distance to the
+ * target at that same time. This test fails if either direct path is not
+ * within 2 msec of its analytic value, which is the same accuracy that
+ * eigenray_basic expects for the stationary target.
+ */
+BOOST_AUTO_TEST_CASE(eigenray_track) {
+    cout << "=== eigenray_test: eigenray_track ===" << endl;
+    const double src_alt = -1000.0;
+    const double trg_lat = 45.02;
+    const double speed = 100.0;
+    const double time_max = 3.5;
+
+    // initialize propagation model
+
+    wposition::compute_earth_radius(src_lat);
+    boundary_model::csptr bottom(new boundary_flat(3000.0));
+    boundary_model::csptr surface(new boundary_flat());
+    attenuation_model::csptr attn(new attenuation_constant(0.0));
+    profile_model::csptr profile(new profile_linear(c0, attn));
+    ocean_model::csptr ocean(new ocean_model(surface, bottom, profile));
+
+    seq_vector::csptr freq(new seq_log(10e3, 2.0, 3));
+    wposition1 pos(src_lat, src_lng, src_alt);
+    seq_vector::csptr de(new seq_linear(-60.0, 5.0, 60.0));
+    seq_vector::csptr az(new seq_linear(-4.0, 1.0, 4.0));
+
+    // build a stationary target and a target moving north
+
+    const double knot_time = 4.0;
+    const double dlat = to_degrees(speed * knot_time / wposition::earth_radius);
+    seq_vector::csptr times(new seq_linear(0.0, knot_time, 2));
+    std::vector<wposition> knots(2, wposition(1, 2, trg_lat, src_lng, src_alt));
+    knots[1].latitude(0, 1, trg_lat + dlat);
+    const target_track track(times, knots);
+
+    eigenray_collection collection(freq, pos, track.knot(0), 1);
+    wave_queue wave(ocean, freq, pos, de, az, time_step, track);
+    wave.add_eigenray_listener(&collection);
+
+    cout << "propagate wavefronts for " << time_max << " seconds" << endl;
+    while (wave.time() < time_max) {
+        wave.step();
+    }
+
+    // compare direct path travel times to analytic results
+
+    for (size_t t2 = 0; t2 < 2; ++t2) {
+        double analytic = 0.0;
+        for (int n = 0; n < 10; ++n) {
+            const double lat = trg_lat + (t2 == 0 ? 0.0 : dlat) *
+                                             std::min(analytic / knot_time, 1.0);
+            analytic = wposition1(lat, src_lng, src_alt).distance(pos) / c0;
+        }
+        const eigenray_list raylist = collection.eigenrays(0, t2);
+        size_t num_direct = 0;
+        for (const eigenray_model::csptr& ray : raylist) {
+            if (ray->surface == 0 && ray->bottom == 0) {
+                cout << "target #" << t2 << " t=" << ray->travel_time
+                     << " error: t=" << (ray->travel_time - analytic) << endl;
+                BOOST_CHECK_SMALL(ray->travel_time - analytic, 0.002);
+                ++num_direct;
+            }
+        }
+        BOOST_REQUIRE_GT(num_direct, 0);
+    }
+}
+
+/**
+ * Interpolates a target track that crosses the antimeridian, from 179.9E
+ * to 179.9W. This test fails if the midpoint of the track is not at 180
+ * degrees longitude, which happens if the interpolation sweeps the long
+ * way around the earth.
+ */
+BOOST_AUTO_TEST_CASE(target_track_antimeridian) {
+    cout << "=== eigenray_test: target_track_antimeridian ===" << endl;
+    seq_vector::csptr times(new seq_linear(0.0, 2.0, 2));
+    std::vector<wposition> knots(2, wposition(1, 1, 10.0, 179.9, -100.0));
+    knots[1].longitude(0, 0, -179.9);
+    const target_track track(times, knots);
+
+    wposition result(1, 1);
+    track.position(1.0, &result);
+    const double lng = result.longitude(0, 0);
+    cout << "midpoint longitude=" << lng << endl;
+    BOOST_CHECK_SMALL(std::remainder(lng - 180.0, 360.0), 1e-6);
+    BOOST_CHECK_CLOSE(result.latitude(0, 0), 10.0, 1e-6);
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
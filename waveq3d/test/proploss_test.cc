@@ -1013,6 +1013,111 @@ BOOST_AUTO_TEST_CASE(proploss_lloyds_spherical) {
     analytic.write_netcdf(analytic_name);
 }
 
+/**
+ * Compares the eigenrays computed for a structured lattice of targets
+ * to the eigenrays computed for the same nodes, when they
+ * are passed to the wave_queue as a general matrix of targets. The lattice
+ * covers every 500 meters in range, every 100 meters in depth, and every
+ * 45 degrees in bearing, in an isovelocity ocean with surface and bottom
+ * reflections.
+ *
+ * - Scenario parameters
+ *   - Profile: constant 1500 m/s sound speed, no absorption
+ *   - Bottom: 1000 meters
+ *   - Source: 45N, 45W, -100 meters
+ *   - Targets: 500-5000 m range, 100-900 m depth, 0-315 deg bearing
+ *   - Frequency: 1000 Hz
+ *   - Time Step: 100 msec
+ *   - Source D/E: -60 to 60 degrees in 2 deg increments
+ *   - Source AZ: 0 to 360 degrees in 15 deg increments
+ *
+ * This test fails if the lattice search stores target distances in the
+ * wavefront, if any lattice eigenray does not match a general eigenray
+ * with the same surface and bottom bounces, within 1 usec of travel time
+ * and 0.01 dB of intensity, or if any general eigenray launched inside of
+ * the D/E fan is missing from the lattice. Eigenrays that the general
+ * search extrapolates from the edges of the fan are not compared, because
+ * the lattice search only finds nodes inside the box around each ray.
+ */
+BOOST_AUTO_TEST_CASE(proploss_grid) {
+    cout << "=== proploss_test: proploss_grid ===" << endl;
+    const double src_lat = 45.0;
+    const double src_lng = -45.0;
+    const double time_max = 4.0;
+
+    // initialize propagation model
+
+    wposition::compute_earth_radius(src_lat);
+    attenuation_model::csptr attn(new attenuation_constant(0.0));
+    profile_model::csptr profile(new profile_linear(1500.0, attn));
+    boundary_model::csptr surface(new boundary_flat());
+    boundary_model::csptr bottom(new boundary_flat(1000.0));
+    ocean_model::csptr ocean(new ocean_model(surface, bottom, profile));
+
+    seq_vector::csptr freq(new seq_linear(1000.0, 1.0, 1));
+    wposition1 pos(src_lat, src_lng, -100.0);
+    seq_vector::csptr de(new seq_linear(-60.0, 2.0, 60.0));
+    seq_vector::csptr az(new seq_linear(0.0, 15.0, 360.0));
+
+    // propagate the same wavefront with both kinds of target search
+
+    seq_vector::csptr ranges(new seq_linear(500.0, 500.0, 10));
+    seq_vector::csptr depths(new seq_linear(100.0, 100.0, 9));
+    seq_vector::csptr bearings(new seq_linear(0.0, 45.0, 8));
+    const target_grid grid(pos, ranges, depths, bearings);
+    eigenray_collection lattice(freq, pos, grid.positions(), 1);
+    wave_queue wave(ocean, freq, pos, de, az, time_step, grid);
+    wave.add_eigenray_listener(&lattice);
+    BOOST_CHECK_EQUAL(wave.curr()->distance2.size1(), 0);
+
+    const wposition& targets = grid.positions();
+    eigenray_collection general(freq, pos, targets, 1);
+    wave_queue wave_general(ocean, freq, pos, de, az, time_step, &targets);
+    wave_general.add_eigenray_listener(&general);
+
+    cout << "propagate wavefronts for " << targets.size1() * targets.size2()
+         << " targets" << endl;
+    while (wave.time() < time_max) {
+        wave.step();
+        wave_general.step();
+    }
+
+    // compare eigenrays at each node
+
+    const auto matches = [](const eigenray_model::csptr& ray,
+                            const eigenray_list& list) {
+        for (const auto& other : list) {
+            if (other->surface == ray->surface &&
+                other->bottom == ray->bottom &&
+                abs(other->travel_time - ray->travel_time) < 1e-6 &&
+                abs(other->intensity(0) - ray->intensity(0)) < 0.01) {
+                return true;
+            }
+        }
+        return false;
+    };
+    const double de_edge = (*de)(de->size() - 1) - 1.0;
+    size_t count = 0;
+    for (size_t t1 = 0; t1 < targets.size1(); ++t1) {
+        for (size_t t2 = 0; t2 < targets.size2(); ++t2) {
+            const eigenray_list lattice_rays = lattice.eigenrays(t1, t2);
+            const eigenray_list general_rays = general.eigenrays(t1, t2);
+            for (const auto& ray : lattice_rays) {
+                BOOST_CHECK(matches(ray, general_rays));
+            }
+            for (const auto& ray : general_rays) {
+                if (abs(ray->source_de) < de_edge) {
+                    BOOST_CHECK(matches(ray, lattice_rays));
+                }
+            }
+            if (!lattice_rays.empty()) {
+                ++count;
+            }
+        }
+    }
+    BOOST_CHECK_EQUAL(count, targets.size1() * targets.size2());
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -133,7 +133,8 @@ BOOST_AUTO_TEST_CASE(dead_reckon) {
 
     // compare dead reckoned result to modeled result
 
-    auto theory = eigenrays.eigenrays(0, 1).begin();
+    const eigenray_list modeled = eigenrays.eigenrays(0, 1);
+    auto theory = modeled.begin();
     for (const auto &ray : eigen_reckon) {
         BOOST_CHECK_SMALL(ray->travel_time - (*theory)->travel_time, 0.01);
         BOOST_CHECK_SMALL(ray->source_de - (*theory)->source_de, 1.0);
@@ -146,12 +147,77 @@ BOOST_AUTO_TEST_CASE(dead_reckon) {
         BOOST_CHECK_EQUAL(ray->upper, (*theory)->upper);
         BOOST_CHECK_EQUAL(ray->lower, (*theory)->lower);
         ++theory;
-        if (theory == eigenrays.eigenrays(0, 1).end()) {
+        if (theory == modeled.end()) {
             break;
         }
     }
 }
 
+/**
+ * Tests the signs of the source and target steps in eigenray dead reckoning,
+ * for both the single target and batch versions. Uses the same deep sound
+ * channel as the dead_reckon test. Propagates eigenrays from a source at
+ * 45N 45E to a receiver 1 deg east of that position. Then it moves the
+ * source 0.01 deg east, and the receiver 0.01 deg west, and propagates the
+ * eigenrays again. Each move makes every path about 0.5 sec shorter.
+ *
+ * This test fails if the travel times of the dead reckoned eigenrays differ
+ * from those of the second propagation by more than 0.01 sec, which would
+ * happen if either step moved the travel time in the wrong direction.
+ */
+BOOST_AUTO_TEST_CASE(dead_reckon_signs) {
+    cout << "=== waveq3d_test: dead_reckon_signs ===" << endl;
+    boundary_model::csptr bottom(new boundary_flat(4000.0));
+    boundary_model::csptr surface(new boundary_flat());
+    profile_model::csptr profile(new profile_munk());
+    ocean_model::csptr ocean(new ocean_model(surface, bottom, profile));
+
+    const double time_max = 90.0;
+    const double time_step = 0.1;
+    seq_vector::csptr freq(new seq_log(10.0, 2.0, 1280.0));
+    seq_vector::csptr de(new seq_rayfan(-10.0, 10.0));
+    seq_vector::csptr az(new seq_linear(89.0, 0.5, 91.0));
+    auto propagate = [&](const wposition1 &source, wposition &targets) {
+        auto *eigenrays = new eigenray_collection(freq, source, targets);
+        wave_queue wave(ocean, freq, source, de, az, time_step, &targets);
+        wave.add_eigenray_listener(eigenrays);
+        while (wave.time() < time_max) {
+            wave.step();
+        }
+        eigenrays->sum_eigenrays();
+        return eigenray_collection::csptr(eigenrays);
+    };
+
+    wposition1 old_source(45.0, 45.0, -1000.0);
+    wposition old_targets(1, 1, 45.0, 46.0, -1200.0);
+    wposition1 new_source(45.0, 45.01, -1000.0);
+    wposition new_targets(1, 1, 45.0, 45.99, -1200.0);
+    cout << "propagate wavefronts for " << time_max << " secs" << endl;
+    auto old_rays = propagate(old_source, old_targets);
+    auto new_rays = propagate(new_source, new_targets);
+
+    const eigenray_list single = old_rays->dead_reckon(
+        0, 0, new_source, wposition1(new_targets, 0, 0), profile);
+    const auto batch = eigenray_collection::dead_reckon(
+        {old_rays}, {new_source}, {new_targets}, profile);
+    const eigenray_list modeled = new_rays->eigenrays(0, 0);
+    const eigenray_list original = old_rays->eigenrays(0, 0);
+    BOOST_REQUIRE(!modeled.empty());
+    for (const eigenray_list &reckon : {single, batch[0]->eigenrays(0, 0)}) {
+        auto theory = modeled.begin();
+        auto orig = original.begin();
+        for (const auto &ray : reckon) {
+            BOOST_CHECK_LT((*theory)->travel_time, (*orig)->travel_time - 0.5);
+            BOOST_CHECK_SMALL(ray->travel_time - (*theory)->travel_time, 0.01);
+            ++theory;
+            ++orig;
+            if (theory == modeled.end()) {
+                break;
+            }
+        }
+    }
+}
+
 /**
  * Tests the accuracy of the eigenverb contributions against analytic solution
  *
@@ -23,7 +23,8 @@ using namespace usml::waveq3d;
 wave_front::wave_front(const ocean_model::csptr& ocean,
                        const seq_vector::csptr& freq, size_t num_de,
                        size_t num_az, const wposition* targets,
-                       const matrix<double>* sin_theta)
+                       const matrix<double>* sin_theta,
+                       const target_grid* grid)
     : position(num_de, num_az),
       pos_gradient(num_de, num_az),
       ndirection(num_de, num_az),
@@ -41,6 +42,7 @@ wave_front::wave_front(const ocean_model::csptr& ocean,
       lower(num_de, num_az),
       on_edge(num_de, num_az),
       targets(targets),
+      grid(grid),
       _ocean(ocean),
       _frequencies(freq),
       _dc_c(num_de, num_az),
@@ -76,6 +78,13 @@ wave_front::wave_front(const ocean_model::csptr& ocean,
             }
         }
     }
+
+    if (this->grid != nullptr) {
+        grid_range.resize(num_de, num_az);
+        grid_bearing.resize(num_de, num_az);
+        grid_depth.resize(num_de, num_az);
+        grid_position = wposition(num_de, num_az);
+    }
 }
 
 /**
@@ -175,6 +184,10 @@ void wave_front::update() {
     if (targets != nullptr) {
         compute_target_distance();
     }
+    if (grid != nullptr) {
+        grid_position = position;
+        grid->coordinates(position, &grid_range, &grid_bearing, &grid_depth);
+    }
 }
 
 /**
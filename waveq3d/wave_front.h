@@ -10,6 +10,7 @@
 #include <usml/types/wposition1.h>
 #include <usml/types/wvector.h>
 #include <usml/usml_config.h>
+#include <usml/waveq3d/target_grid.h>
 
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
@@ -89,10 +90,15 @@ class USML_DECLSPEC wave_front {
      * @param  sin_theta    Reference to sin(theta) for each target.
      *                      Used to speed up compute_target_distance() calc.
      *                      Not used if eigenrays are not being computed.
+     * @param  grid         Structured lattice of targets. Lattice coordinates
+     *                      are computed for each point on the wavefront, in
+     *                      place of the distance to each target, if this
+     *                      is not nullptr.
      */
     wave_front(const ocean_model::csptr& ocean, const seq_vector::csptr& freq,
                size_t num_de, size_t num_az, const wposition* targets = nullptr,
-               const matrix<double>* sin_theta = nullptr);
+               const matrix<double>* sin_theta = nullptr,
+               const target_grid* grid = nullptr);
 
     /**
      * Number of D/E angles in the ray fan.
@@ -124,10 +130,17 @@ class USML_DECLSPEC wave_front {
      * Update wave element properties based on the current position
      * and direction vectors. For each point on the wavefront, it computes
      * ocean profile parameters, Adams-Bashforth derivatives, and the
-     * distance to each eigenray target.
+     * distance to each eigenray target, or the lattice coordinates of each
+     * point on the wavefront.
      */
     void update();
 
+    /**
+     * Sine of colatitude for each point on the wavefront.
+     * Computed by update().
+     */
+    inline const matrix<double>& sin_theta() const { return _sin_theta; }
+
     /**
      * Search for points on either side of wavefront folds.
      * When reflection or refraction causes the wavefront to fold, the distance
@@ -257,6 +270,38 @@ class USML_DECLSPEC wave_front {
      */
     matrix<matrix<double> > distance2;
 
+    /**
+     * Structured lattice of targets.
+     * Lattice coordinates are not computed if this reference is nullptr.
+     */
+    const target_grid* grid;
+
+    /**
+     * Great circle range from the lattice origin to each point on the
+     * wavefront (meters). Not used if grid attribute is nullptr.
+     */
+    matrix<double> grid_range;
+
+    /**
+     * True bearing from the lattice origin to each point on the
+     * wavefront (degrees). Not used if grid attribute is nullptr.
+     */
+    matrix<double> grid_bearing;
+
+    /**
+     * Depth of each point on the wavefront (meters).
+     * Not used if grid attribute is nullptr.
+     */
+    matrix<double> grid_depth;
+
+    /**
+     * Location of each point on the wavefront when its lattice coordinates
+     * were computed. Reflections move points after update(), but eigenray
+     * detection uses these locations, just like it uses the distance2
+     * values from update(). Not used if grid attribute is nullptr.
+     */
+    wposition grid_position;
+
    private:
     /**
      * Reference to the environmental parameters.
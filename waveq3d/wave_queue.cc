@@ -12,9 +12,11 @@
 #include <boost/numeric/ublas/lu.hpp>
 #include <boost/numeric/ublas/triangular.hpp>
 #include <boost/numeric/ublas/vector_proxy.hpp>
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <utility>
+#include <vector>
 
 // #define DEBUG_EIGENRAYS_DETAIL
 // #define DEBUG_EIGENRAYS
@@ -32,6 +34,41 @@ wave_queue::wave_queue(const ocean_model::csptr& ocean,
                        const seq_vector::csptr& de, const seq_vector::csptr& az,
                        double time_step, const wposition* target_pos,
                        spreading_type type)
+    : wave_queue(ocean, freq, pos, de, az, time_step, target_pos, nullptr,
+                 nullptr, type) {}
+
+/**
+ * Initialize a propagation scenario for a structured lattice of targets.
+ */
+wave_queue::wave_queue(const ocean_model::csptr& ocean,
+                       const seq_vector::csptr& freq, const wposition1& pos,
+                       const seq_vector::csptr& de, const seq_vector::csptr& az,
+                       double time_step, const target_grid& grid,
+                       spreading_type type)
+    : wave_queue(ocean, freq, pos, de, az, time_step, &grid.positions(),
+                 &grid, nullptr, type) {}
+
+/**
+ * Initialize a propagation scenario for targets that move along tracks.
+ */
+wave_queue::wave_queue(const ocean_model::csptr& ocean,
+                       const seq_vector::csptr& freq, const wposition1& pos,
+                       const seq_vector::csptr& de, const seq_vector::csptr& az,
+                       double time_step, const target_track& track,
+                       spreading_type type)
+    : wave_queue(ocean, freq, pos, de, az, time_step, nullptr, nullptr,
+                 &track, type) {}
+
+/**
+ * Initialize a propagation scenario for a list of targets, a structured
+ * lattice of targets, or targets that move along tracks.
+ */
+wave_queue::wave_queue(const ocean_model::csptr& ocean,
+                       const seq_vector::csptr& freq, const wposition1& pos,
+                       const seq_vector::csptr& de, const seq_vector::csptr& az,
+                       double time_step, const wposition* target_pos,
+                       const target_grid* grid, const target_track* track,
+                       spreading_type type)
     : _ocean(ocean),
       _frequencies(freq),
       _source_pos(pos),
@@ -42,6 +79,8 @@ wave_queue::wave_queue(const ocean_model::csptr& ocean,
       _time_step(time_step),
       _time(0.0),
       _target_pos(target_pos),
+      _target_grid(grid),
+      _target_track(track),
       _run_id(0),
       _nc_file(nullptr) {
     _az_boundary = false;
@@ -51,6 +90,11 @@ wave_queue::wave_queue(const ocean_model::csptr& ocean,
         _az_boundary =
             (fmod(az_first + 360.0, 360.0) == fmod(az_last + 360.0, 360.0));
     }
+    if (_target_track != nullptr) {
+        _track_pos = wposition(track->size1(), track->size2());
+        _target_track->position(_time, &_track_pos);
+        _target_pos = &_track_pos;
+    }
     if (_target_pos != nullptr) {
         _targets_sin_theta = sin(_target_pos->theta());
     }
@@ -68,15 +112,18 @@ wave_queue::wave_queue(const ocean_model::csptr& ocean,
     }
 
     // create storage space for all wavefront elements
+    // targets in a lattice are searched without storing their distances
 
+    const wposition* distance_targets =
+        (_target_grid == nullptr) ? _target_pos : nullptr;
     _past = new wave_front(_ocean, _frequencies, de->size(), az->size(),
-                           _target_pos, &_targets_sin_theta);
+                           distance_targets, &_targets_sin_theta, _target_grid);
     _prev = new wave_front(_ocean, _frequencies, de->size(), az->size(),
-                           _target_pos, &_targets_sin_theta);
+                           distance_targets, &_targets_sin_theta, _target_grid);
     _curr = new wave_front(_ocean, _frequencies, de->size(), az->size(),
-                           _target_pos, &_targets_sin_theta);
+                           distance_targets, &_targets_sin_theta, _target_grid);
     _next = new wave_front(_ocean, _frequencies, de->size(), az->size(),
-                           _target_pos, &_targets_sin_theta);
+                           distance_targets, &_targets_sin_theta, _target_grid);
 
     // initialize wave front elements
 
@@ -114,6 +161,7 @@ wave_queue::~wave_queue() {
 void wave_queue::init_wavefronts() {
     // Runge-Kutta to estimate _prev wavefront from _curr entry
 
+    move_targets(_time - _time_step);
     ode_integ::rk1_pos(-_time_step, _curr, _next);
     ode_integ::rk1_ndir(-_time_step, _curr, _next);
     _next->update();
@@ -128,6 +176,7 @@ void wave_queue::init_wavefronts() {
 
     // Runge-Kutta to estimate _past wavefront from _prev entry
 
+    move_targets(_time - 2.0 * _time_step);
     ode_integ::rk1_pos(-_time_step, _prev, _next);
     ode_integ::rk1_ndir(-_time_step, _prev, _next);
     _next->update();
@@ -143,10 +192,23 @@ void wave_queue::init_wavefronts() {
     // Adams-Bashforth to estimate _next wavefront
     // from _past, _prev, and _curr entries
 
+    move_targets(_time + _time_step);
     ode_integ::ab3_pos(_time_step, _past, _prev, _curr, _next);
     ode_integ::ab3_ndir(_time_step, _past, _prev, _curr, _next);
     _next->update();
     _next->path_length = _next->distance + _curr->path_length;
+    move_targets(_time);
+}
+
+/**
+ * Moves targets to their location at a specific travel time.
+ */
+void wave_queue::move_targets(double time) {
+    if (_target_track == nullptr) {
+        return;
+    }
+    _target_track->position(time, &_track_pos);
+    _targets_sin_theta = sin(_track_pos.theta());
 }
 
 /**
@@ -168,6 +230,7 @@ void wave_queue::step() {
 
     // compute position, direction, and environment parameters for next entry
 
+    move_targets(_time + _time_step);
     ode_integ::ab3_pos(_time_step, _past, _prev, _curr, _next);
     ode_integ::ab3_ndir(_time_step, _past, _prev, _curr, _next);
 
@@ -184,6 +247,7 @@ void wave_queue::step() {
 
     // search for eigenray collisions with acoustic targets
 
+    move_targets(_time);
     detect_eigenrays();
 
     // notify listeners that this step is complete
@@ -352,6 +416,10 @@ void wave_queue::detect_eigenrays() {
     if (_target_pos == nullptr) {
         return;
     }
+    if (_target_grid != nullptr) {
+        detect_grid_eigenrays();
+        return;
+    }
 
     double distance2[3][3][3];
     double& center = distance2[1][1][1];
@@ -403,6 +471,136 @@ void wave_queue::detect_eigenrays() {
     }              // end t1 loop
 }
 
+/**
+ * Distance squared from a target to one point on a wavefront.
+ */
+inline double wave_queue::target_distance2(const wave_front* front, size_t t1,
+                                           size_t t2, size_t de,
+                                           size_t az) const {
+    if (_target_grid == nullptr) {
+        return front->distance2(t1, t2)(de, az);
+    }
+
+    // same approximation as wave_front::compute_target_distance()
+
+    const wposition& position = front->grid_position;
+    const double rho = position.rho(de, az);
+    const double from_rho = _target_pos->rho(t1, t2);
+    const double dtheta =
+        0.5 * (position.theta(de, az) - _target_pos->theta(t1, t2));
+    const double dphi = 0.5 * (position.phi(de, az) - _target_pos->phi(t1, t2));
+    return abs(rho * rho + from_rho * from_rho -
+               2.0 * from_rho *
+                   (rho * (1.0 - 2.0 * (dtheta * dtheta +
+                                        _targets_sin_theta(t1, t2) *
+                                            (front->sin_theta()(de, az) *
+                                             (dphi * dphi))))));
+}
+
+/**
+ * Search for CPA with the nodes of a structured lattice of targets.
+ */
+//NOLINTNEXTLINE(readability-function-cognitive-complexity)
+void wave_queue::detect_grid_eigenrays() {
+    double distance2[3][3][3];
+    double& center = distance2[1][1][1];
+    const size_t az_start = (_az_boundary) ? 0 : 1;
+    const wave_front* fronts[3] = {_prev, _curr, _next};
+    std::vector<size_t> bearings;
+    bearings.reserve(_target_grid->bearings()->size());
+
+    for (size_t de = 1; de < _max_de; ++de) {
+        for (size_t az = az_start; az < _max_az; ++az) {
+            if (_curr->on_edge(de, az)) {
+                continue;
+            }
+
+            // find the box that surrounds the 27 neighbors of this ray,
+            // with bearings measured relative to the central ray,
+            // then double its size around the central ray, because
+            // is_closest_ray() extrapolates past the neighbors near folds
+
+            const double range0 = _curr->grid_range(de, az);
+            const double depth0 = _curr->grid_depth(de, az);
+            const double bearing0 = _curr->grid_bearing(de, az);
+            double range[2] = {range0, range0};
+            double depth[2] = {depth0, depth0};
+            double bearing[2] = {0.0, 0.0};
+            for (const wave_front* front : fronts) {
+                for (size_t nde = 0; nde < 3; ++nde) {
+                    for (size_t naz = 0; naz < 3; ++naz) {
+                        size_t d = de + nde - 1;
+                        size_t a = az + naz - 1;
+                        if (_az_boundary) {
+                            if (az + naz == 0) {  // aka if a < 0
+                                a = num_az() - 2;
+                            } else if (a >= _max_az) {
+                                a = 0;
+                            }
+                        }
+                        range[0] = std::min(range[0], front->grid_range(d, a));
+                        range[1] = std::max(range[1], front->grid_range(d, a));
+                        depth[0] = std::min(depth[0], front->grid_depth(d, a));
+                        depth[1] = std::max(depth[1], front->grid_depth(d, a));
+                        double offset = front->grid_bearing(d, a) - bearing0;
+                        if (offset >= 180.0) {
+                            offset -= 360.0;
+                        } else if (offset < -180.0) {
+                            offset += 360.0;
+                        }
+                        bearing[0] = std::min(bearing[0], offset);
+                        bearing[1] = std::max(bearing[1], offset);
+                    }
+                }
+            }
+            range[0] = range0 - 2.0 * (range0 - range[0]);
+            range[1] = range0 + 2.0 * (range[1] - range0);
+            depth[0] = depth0 - 2.0 * (depth0 - depth[0]);
+            depth[1] = depth0 + 2.0 * (depth[1] - depth0);
+            bearing[0] = bearing0 + 2.0 * bearing[0];
+            bearing[1] = bearing0 + 2.0 * bearing[1];
+            size_t range_index[2];
+            size_t depth_index[2];
+            if (!_target_grid->find_nodes(range, depth, bearing, range_index,
+                                          depth_index, &bearings)) {
+                continue;
+            }
+
+            // test each node in the box, like detect_eigenrays()
+
+            for (size_t b : bearings) {
+                for (size_t r = range_index[0]; r <= range_index[1]; ++r) {
+                    const size_t t1 = _target_grid->row(b, r);
+                    for (size_t t2 = depth_index[0]; t2 <= depth_index[1];
+                         ++t2) {
+                        _de_branch =
+                            abs(_source_pos.latitude() -
+                                _target_pos->latitude(t1, t2)) < 1e-4 &&
+                            abs(_source_pos.longitude() -
+                                _target_pos->longitude(t1, t2)) < 1e-4;
+
+                        center = target_distance2(_curr, t1, t2, de, az);
+                        distance2[2][1][1] =
+                            target_distance2(_next, t1, t2, de, az);
+                        if (distance2[2][1][1] <= center) {
+                            continue;
+                        }
+                        distance2[0][1][1] =
+                            target_distance2(_prev, t1, t2, de, az);
+                        if (distance2[0][1][1] < center) {
+                            continue;
+                        }
+                        if (is_closest_ray(t1, t2, de, az, center,
+                                           distance2)) {
+                            build_eigenray(t1, t2, de, az, distance2);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 /**
  * Used by detect_eigenrays() to discover if the current ray is the
  * closest point of approach to the current target.
@@ -430,9 +628,9 @@ bool wave_queue::is_closest_ray(size_t t1, size_t t2, size_t de, size_t az,
                 }
             }
 
-            distance2[0][nde][naz] = _prev->distance2(t1, t2)(d, a);
-            distance2[1][nde][naz] = _curr->distance2(t1, t2)(d, a);
-            distance2[2][nde][naz] = _next->distance2(t1, t2)(d, a);
+            distance2[0][nde][naz] = target_distance2(_prev, t1, t2, d, a);
+            distance2[1][nde][naz] = target_distance2(_curr, t1, t2, d, a);
+            distance2[2][nde][naz] = target_distance2(_next, t1, t2, d, a);
 
             // skip to next iteration if tested ray is on edge of ray family
             // allows extrapolation outside of ray family
@@ -499,7 +697,7 @@ void wave_queue::build_eigenray(size_t t1, size_t t2, size_t de, size_t az,
     }
 #ifdef DEBUG_EIGENRAYS_DETAIL
     // cout << "*** wave_queue::step: time=" << time() << endl ;
-    wposition1 tgt(*(_curr->targets), t1, t2);
+    wposition1 tgt(*_target_pos, t1, t2);
     cout << "*** wave_queue::build_eigenray:" << endl
          << "\ttarget(" << t1 << "," << t2 << ")=" << tgt.altitude() << ","
          << tgt.latitude() << "," << tgt.longitude() << " time=" << _time
@@ -581,7 +779,7 @@ void wave_queue::build_eigenray(size_t t1, size_t t2, size_t de, size_t az,
     // compute spreading components of intensity
 
     const vector<double> spread_intensity = _spreading_model->intensity(
-        wposition1(*(_curr->targets), t1, t2), de, az, offset, distance);
+        wposition1(*_target_pos, t1, t2), de, az, offset, distance);
     for (size_t i = 0; i < ray->intensity.size(); ++i) {
         if (std::isnan(spread_intensity(i))) {
             #ifdef USML_DEBUG
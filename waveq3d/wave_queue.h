@@ -11,6 +11,8 @@
 #include <usml/types/wposition1.h>
 #include <usml/usml_config.h>
 #include <usml/waveq3d/reflection_notifier.h>
+#include <usml/waveq3d/target_grid.h>
+#include <usml/waveq3d/target_track.h>
 #include <usml/waveq3d/wave_thresholds.h>
 
 #include <boost/numeric/ublas/matrix.hpp>
@@ -125,6 +127,74 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
                const wposition* target_pos = nullptr,
                spreading_type type = HYBRID_GAUSSIAN);
 
+    /**
+     * Initialize a propagation scenario for a structured lattice of targets.
+     * Used to compute transmission loss maps on dense grids of ranges,
+     * depths, and bearings. Instead of computing the distance from every
+     * target to every point on the wavefront, each wavefront computes the
+     * lattice coordinates of its own points, and detect_eigenrays() only
+     * tests the targets inside of a box around the neighborhood of each
+     * ray. Memory use is proportional to the number of rays, plus
+     * the location of each node, rather than the product of the two.
+     *
+     * Eigenrays are reported to listeners using the row and column of
+     * each node in target_grid::positions(). Unlike the general target
+     * search, nodes outside of the region swept by the ray fan do not
+     * receive eigenrays extrapolated from the edge of the fan.
+     *
+     * @param  ocean        Reference to the environmental parameters.
+     * @param  freq         Frequencies over which to compute propagation (Hz).
+     * @param  pos          Location of the wavefront source in spherical
+     *                      earth coordinates.
+     * @param  de           Initial depression/elevation angles at the
+     *                      source location (degrees, positive is up).
+     * @param  az           Initial azimuthal angle at the source location
+     *                      (degrees, clockwise from true north).
+     * @param  time_step    Propagation step size (seconds).
+     * @param  grid         Lattice of acoustic targets. Must exist for
+     *                      the lifetime of this wave_queue.
+     * @param  type         Type of spreading model to use: CLASSIC_RAY
+     *                      or HYBRID_GAUSSIAN.
+     */
+    wave_queue(const ocean_model::csptr& ocean, const seq_vector::csptr& freq,
+               const wposition1& pos, const seq_vector::csptr& de,
+               const seq_vector::csptr& az, double time_step,
+               const target_grid& grid, spreading_type type = HYBRID_GAUSSIAN);
+
+    /**
+     * Initialize a propagation scenario for targets that move along
+     * piecewise linear tracks. Before each wavefront computes its distance
+     * to the targets, the targets are moved to their locations at the
+     * travel time of that wavefront. The closest point of approach is then
+     * found relative to the moving targets, and each eigenray is computed
+     * for the location of its target at the travel time of the eigenray.
+     * Use this instead of repeating the propagation for each update of
+     * the receiver location.
+     *
+     * Eigenrays are reported to listeners using the row and column of
+     * each target in the track. The targets() method returns the location
+     * of each target at the time of the current wavefront.
+     *
+     * @param  ocean        Reference to the environmental parameters.
+     * @param  freq         Frequencies over which to compute propagation (Hz).
+     * @param  pos          Location of the wavefront source in spherical
+     *                      earth coordinates.
+     * @param  de           Initial depression/elevation angles at the
+     *                      source location (degrees, positive is up).
+     * @param  az           Initial azimuthal angle at the source location
+     *                      (degrees, clockwise from true north).
+     * @param  time_step    Propagation step size (seconds).
+     * @param  track        Trajectories of acoustic targets. Must exist for
+     *                      the lifetime of this wave_queue.
+     * @param  type         Type of spreading model to use: CLASSIC_RAY
+     *                      or HYBRID_GAUSSIAN.
+     */
+    wave_queue(const ocean_model::csptr& ocean, const seq_vector::csptr& freq,
+               const wposition1& pos, const seq_vector::csptr& de,
+               const seq_vector::csptr& az, double time_step,
+               const target_track& track,
+               spreading_type type = HYBRID_GAUSSIAN);
+
     /** Destroy all temporary memory. */
     virtual ~wave_queue();
 
@@ -175,6 +245,16 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      */
     inline const wposition* targets() const { return _target_pos; }
 
+    /**
+     * Structured lattice of acoustic targets, nullptr if not used.
+     */
+    inline const target_grid* grid() const { return _target_grid; }
+
+    /**
+     * Trajectories of acoustic targets, nullptr if not used.
+     */
+    inline const target_track* track() const { return _target_track; }
+
     /**
      * Return next element in the wavefront.
      */
@@ -317,6 +397,25 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      */
     const wposition* _target_pos;
 
+    /**
+     * Structured lattice of acoustic targets, nullptr if not used.
+     * Targets are searched using lattice coordinates if this is defined.
+     */
+    const target_grid* _target_grid;
+
+    /**
+     * Trajectories of acoustic targets, nullptr if not used.
+     * Targets are moved to their location at the time of each wavefront
+     * if this is defined.
+     */
+    const target_track* _target_track;
+
+    /**
+     * Location of each target at the time of the last call to
+     * move_targets(). Not used if _target_track is nullptr.
+     */
+    wposition _track_pos;
+
     /** Run identification number. */
     size_t _run_id;
 
@@ -380,6 +479,16 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      */
     void init_wavefronts();
 
+    /**
+     * Moves targets to their location at a specific travel time,
+     * and updates the sine of their colatitudes. Called before each
+     * wavefront computes its distance to the targets. Does nothing if
+     * targets are not defined by a target_track.
+     *
+     * @param time          Travel time from the source (seconds).
+     */
+    void move_targets(double time);
+
     //**************************************************
     // reflections and caustics
 
@@ -467,6 +576,34 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      */
     void detect_eigenrays();
 
+    /**
+     * Used by detect_eigenrays() to search for CPA with the nodes of a
+     * structured lattice of targets. Computes the box, in lattice
+     * coordinates, that surrounds the 27 neighbors of each ray, doubles
+     * its size around the central ray, and only tests the nodes inside of
+     * that box. The extra margin catches nodes near folds in the
+     * wavefront, where the closest ray may not be surrounded by its
+     * neighbors. Because each ray only tests a
+     * few nodes, target distances are computed as they are needed, rather
+     * than being stored for every target and every ray.
+     */
+    void detect_grid_eigenrays();
+
+    /**
+     * Distance squared from a target to one point on a wavefront. Uses the
+     * distances stored in the wave_front by compute_target_distance(),
+     * or the same approximation computed for a single point of
+     * wave_front::grid_position, if targets are searched using a lattice.
+     *
+     * @param   front       Wavefront that contains the point.
+     * @param   t1          Row number of the target.
+     * @param   t2          Column number of the target.
+     * @param   de          D/E angle index number.
+     * @param   az          AZ angle index number.
+     */
+    double target_distance2(const wave_front* front, size_t t1, size_t t2,
+                            size_t de, size_t az) const;
+
     /**
      * Used by detect_eigenrays() to discover if the current ray is the
      * closest point of approach (CPA) to the current target. Computes the
@@ -743,6 +880,17 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
     // wavefront_netcdf routines
 
    private:
+    /**
+     * Initialize a propagation scenario for a list of targets, a
+     * structured lattice of targets, or targets that move along tracks.
+     * Implements the public constructors.
+     */
+    wave_queue(const ocean_model::csptr& ocean, const seq_vector::csptr& freq,
+               const wposition1& pos, const seq_vector::csptr& de,
+               const seq_vector::csptr& az, double time_step,
+               const wposition* target_pos, const target_grid* grid,
+               const target_track* track, spreading_type type);
+
     /**
      * The netCDF file used to record the wavefront log.
      */
@@ -63,6 +63,16 @@
  *   propagation loss estimates at all depths and ranges, but it may
  *   run significantly slower and with significantly greater memory
  *   requirements than a scenario with just ship and submarine targets.
+ *   Full field estimates on regular grids of ranges, depths, and bearings
+ *   should use a target_grid, which avoids most of this overhead.
+ *
+ * - Targets that move while the wavefront is propagating, like towed
+ *   arrays, can be modeled with a target_track. Each wavefront computes
+ *   its distance to the targets at their location at the travel time
+ *   of that wavefront, so that a single propagation serves a whole
+ *   segment of the receiver track. The distance that targets move in
+ *   one time step is assumed to be small compared to the spacing
+ *   between rays.
  *
  * - The accuracy of the attenuation calculation is limited by the
  *   accuracy of the path length estimate between wavefronts. The
@@ -88,5 +98,7 @@
  */
 #pragma once
 
+#include <usml/waveq3d/target_grid.h>
+#include <usml/waveq3d/target_track.h>
 #include <usml/waveq3d/wave_front.h>
 #include <usml/waveq3d/wave_queue.h>